@@ -0,0 +1,219 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Formatting of AES-CCM messages for AESCCMKernel, and selection of the
+ *      kernel matching the instructions of the CPU.
+ */
+
+#if CHIP_HAVE_CONFIG_H
+#include <crypto/CryptoBuildConfig.h>
+#endif
+
+#include "AESCCMKernel.h"
+#include "AESCCMKernelImpl.h"
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <support/CodeUtils.h>
+
+#include <string.h>
+
+#if CHIP_CRYPTO_AES_CCM_KERNEL && (defined(__x86_64__) || defined(__i386__))
+#define CHIP_CRYPTO_AES_CCM_KERNEL_AESNI 1
+#include <cpuid.h>
+#elif CHIP_CRYPTO_AES_CCM_KERNEL && defined(__aarch64__)
+#define CHIP_CRYPTO_AES_CCM_KERNEL_ARMV8 1
+#if defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+#endif
+
+namespace chip {
+namespace Crypto {
+
+namespace {
+
+constexpr size_t kMinNonceLength = 7;
+constexpr size_t kMaxNonceLength = 13;
+
+const AESCCMKernelOps * SelectKernel()
+{
+#if CHIP_CRYPTO_AES_CCM_KERNEL_AESNI
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_AES) != 0 && (ecx & bit_SSSE3) != 0)
+    {
+        return &gAESNIKernelOps;
+    }
+#elif CHIP_CRYPTO_AES_CCM_KERNEL_ARMV8
+#if defined(__linux__)
+    if ((getauxval(AT_HWCAP) & HWCAP_AES) != 0)
+    {
+        return &gARMv8KernelOps;
+    }
+#elif defined(__APPLE__) || defined(__ARM_FEATURE_CRYPTO)
+    // Every 64-bit Apple CPU has the extension, other systems tell at build time
+    return &gARMv8KernelOps;
+#endif
+#endif
+
+    return nullptr;
+}
+
+const AESCCMKernelOps * GetKernel()
+{
+    static const AESCCMKernelOps * const sKernel = SelectKernel();
+    return sKernel;
+}
+
+bool IsValidTagLength(size_t tag_length)
+{
+    return tag_length >= 4 && tag_length <= 16 && tag_length % 2 == 0;
+}
+
+/// Returns true if the length of a message fits in the bytes of the counter left by the nonce.
+bool FitsCounter(size_t length, size_t iv_length)
+{
+    const size_t counterBits = 8 * (15 - iv_length);
+    return static_cast<uint64_t>(length) <= UINT32_MAX && (counterBits >= 32 || (length >> counterBits) == 0);
+}
+
+} // namespace
+
+bool AESCCMKernel::IsSupported()
+{
+    return GetKernel() != nullptr;
+}
+
+CHIP_ERROR AESCCMKernel::SetKey(const uint8_t * key, size_t key_length)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+
+    VerifyOrExit(key != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(Supports(key_length), error = CHIP_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
+
+    mOps = GetKernel();
+    mOps->ExpandKey(key, mRoundKeys);
+
+exit:
+    return error;
+}
+
+CHIP_ERROR AESCCMKernel::Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                                 const uint8_t * iv, size_t iv_length, uint8_t * ciphertext, uint8_t * tag, size_t tag_length)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    uint8_t fullTag[kBlockSize];
+
+    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    SuccessOrExit(error = Process(false, plaintext, plaintext_length, aad, aad_length, iv, iv_length, ciphertext, fullTag,
+                                  tag_length));
+
+    memcpy(tag, fullTag, tag_length);
+
+exit:
+    return error;
+}
+
+CHIP_ERROR AESCCMKernel::Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                                 const uint8_t * tag, size_t tag_length, const uint8_t * iv, size_t iv_length, uint8_t * plaintext)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    uint8_t fullTag[kBlockSize];
+    uint8_t difference = 0;
+
+    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    SuccessOrExit(error = Process(true, ciphertext, ciphertext_length, aad, aad_length, iv, iv_length, plaintext, fullTag,
+                                  tag_length));
+
+    // Compare every byte, so that the time taken does not tell how much of the tag matched
+    for (size_t i = 0; i < tag_length; i++)
+    {
+        difference = static_cast<uint8_t>(difference | (fullTag[i] ^ tag[i]));
+    }
+
+    if (difference != 0)
+    {
+        ClearSecretData(plaintext, static_cast<uint32_t>(ciphertext_length));
+        error = CHIP_ERROR_INTERNAL;
+    }
+
+exit:
+    return error;
+}
+
+CHIP_ERROR AESCCMKernel::Process(bool decrypt, const uint8_t * in, size_t length, const uint8_t * aad, size_t aad_length,
+                                 const uint8_t * iv, size_t iv_length, uint8_t * out, uint8_t * tag, size_t tag_length)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    AESCCMKernelMessage message;
+
+    VerifyOrExit(HasKey(), error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(length == 0 || (in != nullptr && out != nullptr), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(aad_length == 0 || aad != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(static_cast<uint64_t>(aad_length) <= UINT32_MAX, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv_length >= kMinNonceLength && iv_length <= kMaxNonceLength, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(IsValidTagLength(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(FitsCounter(length, iv_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    // B0 is flags | nonce | message length and A0 is flags | nonce | 0, as in RFC 3610, the counter taking the bytes left
+    // by the nonce
+    message.mB0[0] =
+        static_cast<uint8_t>(((aad_length > 0) ? 0x40 : 0) | (((tag_length - 2) / 2) << 3) | (kMaxNonceLength + 1 - iv_length));
+    memcpy(&message.mB0[1], iv, iv_length);
+    for (size_t i = kBlockSize - 1, remaining = length; i > iv_length; i--, remaining >>= 8)
+    {
+        message.mB0[i] = static_cast<uint8_t>(remaining);
+    }
+
+    memset(message.mA0, 0, sizeof(message.mA0));
+    message.mA0[0] = static_cast<uint8_t>(kMaxNonceLength + 1 - iv_length);
+    memcpy(&message.mA0[1], iv, iv_length);
+
+    message.mAAD       = aad;
+    message.mAADLength = aad_length;
+    message.mIn        = in;
+    message.mLength    = length;
+    message.mOut       = out;
+
+    if (decrypt)
+    {
+        mOps->Decrypt(mRoundKeys, message, tag);
+    }
+    else
+    {
+        mOps->Encrypt(mRoundKeys, message, tag);
+    }
+
+exit:
+    return error;
+}
+
+void AESCCMKernel::Clear()
+{
+    if (mOps != nullptr)
+    {
+        ClearSecretData(mRoundKeys, sizeof(mRoundKeys));
+        mOps = nullptr;
+    }
+}
+
+} // namespace Crypto
+} // namespace chip
@@ -0,0 +1,107 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Header that exposes an AES-CCM-128 implementation built on the
+ *      AES instructions of the CPU.
+ */
+
+#pragma once
+
+#include <core/CHIPError.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace Crypto {
+
+struct AESCCMKernelOps;
+
+/**
+ * AES-CCM-128 computed with the AES instructions of the CPU: AES-NI on x86,
+ * the cryptography extension on ARMv8.
+ *
+ * Each block of a message goes through the CTR keystream and the CBC-MAC in
+ * the same pass, the two AES computations being interleaved so that they
+ * overlap in the pipeline of the CPU.
+ *
+ * The instructions are looked for once at run time. When the CPU has none of
+ * them, or the kernel was left out with the chip_crypto_aes_ccm_kernel build
+ * argument, IsSupported() returns false and the AES-CCM functions of the
+ * crypto backend are used instead.
+ */
+class AESCCMKernel
+{
+public:
+    static constexpr size_t kKeyLength = 16;
+
+    AESCCMKernel() = default;
+    ~AESCCMKernel() { Clear(); }
+
+    AESCCMKernel(const AESCCMKernel &) = delete;
+    AESCCMKernel & operator=(const AESCCMKernel &) = delete;
+
+    /// Returns true if the kernel was built in and the CPU has the instructions it needs.
+    static bool IsSupported();
+
+    /// Returns true if messages encrypted with a key of the given length can go through the kernel.
+    static bool Supports(size_t key_length) { return key_length == kKeyLength && IsSupported(); }
+
+    /**
+     * @brief Expands the key used by the following Encrypt and Decrypt calls
+     * @param key Encryption key
+     * @param key_length Length of encryption key, which must be kKeyLength
+     * @return Returns CHIP_ERROR_UNSUPPORTED_ENCRYPTION_TYPE if the kernel does not support the key, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR SetKey(const uint8_t * key, size_t key_length);
+
+    /// Returns true if a key was set since construction or the last Clear.
+    bool HasKey() const { return mOps != nullptr; }
+
+    /**
+     * Same as AES_CCM_encrypt, using the key of the kernel. The nonce is 7 to
+     * 13 bytes long and the tag an even number of bytes from 4 to 16.
+     */
+    CHIP_ERROR Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * iv, size_t iv_length, uint8_t * ciphertext, uint8_t * tag, size_t tag_length);
+
+    /**
+     * Same as AES_CCM_decrypt, using the key of the kernel. The plaintext is
+     * cleared if the tag does not match.
+     */
+    CHIP_ERROR Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * tag, size_t tag_length, const uint8_t * iv, size_t iv_length, uint8_t * plaintext);
+
+    /// Forgets the key.
+    void Clear();
+
+private:
+    static constexpr size_t kBlockSize       = 16;
+    static constexpr size_t kRoundKeysLength = 11 * kBlockSize;
+
+    /// Encrypts or decrypts a message, writing the whole kBlockSize bytes of its tag to tag.
+    CHIP_ERROR Process(bool decrypt, const uint8_t * in, size_t length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * iv, size_t iv_length, uint8_t * out, uint8_t * tag, size_t tag_length);
+
+    const AESCCMKernelOps * mOps = nullptr; ///< instructions the key was expanded for, nullptr if there is no key
+    alignas(16) uint8_t mRoundKeys[kRoundKeysLength];
+};
+
+} // namespace Crypto
+} // namespace chip
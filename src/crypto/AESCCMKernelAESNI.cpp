@@ -0,0 +1,138 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      AESCCMKernel for x86 CPUs with AES-NI and SSSE3. This file is built
+ *      with the flags enabling their intrinsics, and only called once
+ *      AESCCMKernel::IsSupported() found them on the CPU.
+ */
+
+#include "AESCCMKernelImpl.h"
+
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+namespace chip {
+namespace Crypto {
+
+namespace {
+
+struct AESNICipher
+{
+    using Block = __m128i;
+
+    struct Keys
+    {
+        __m128i mRounds[11];
+    };
+
+    /// Counter block with its bytes reversed, so that the big endian counter is the first 32 bits lane.
+    using Counter = __m128i;
+
+    static Block Load(const uint8_t * data) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)); }
+    static void Store(uint8_t * data, Block block) { _mm_storeu_si128(reinterpret_cast<__m128i *>(data), block); }
+    static Block Xor(Block a, Block b) { return _mm_xor_si128(a, b); }
+
+    static void LoadKeys(const uint8_t * roundKeys, Keys & keys)
+    {
+        for (size_t i = 0; i < 11; i++)
+        {
+            keys.mRounds[i] = Load(&roundKeys[i * 16]);
+        }
+    }
+
+    static Block Encrypt(const Keys & keys, Block block)
+    {
+        block = _mm_xor_si128(block, keys.mRounds[0]);
+        for (size_t i = 1; i < 10; i++)
+        {
+            block = _mm_aesenc_si128(block, keys.mRounds[i]);
+        }
+        return _mm_aesenclast_si128(block, keys.mRounds[10]);
+    }
+
+    static void Encrypt2(const Keys & keys, Block & a, Block & b)
+    {
+        a = _mm_xor_si128(a, keys.mRounds[0]);
+        b = _mm_xor_si128(b, keys.mRounds[0]);
+        for (size_t i = 1; i < 10; i++)
+        {
+            a = _mm_aesenc_si128(a, keys.mRounds[i]);
+            b = _mm_aesenc_si128(b, keys.mRounds[i]);
+        }
+        a = _mm_aesenclast_si128(a, keys.mRounds[10]);
+        b = _mm_aesenclast_si128(b, keys.mRounds[10]);
+    }
+
+    static Block ReverseBytes(Block block)
+    {
+        return _mm_shuffle_epi8(block, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    }
+
+    static Counter LoadCounter(const uint8_t * a0) { return ReverseBytes(Load(a0)); }
+
+    static Block NextCounter(Counter & counter)
+    {
+        counter = _mm_add_epi32(counter, _mm_set_epi32(0, 0, 0, 1));
+        return ReverseBytes(counter);
+    }
+};
+
+template <int kRoundConstant>
+__m128i ExpandRoundKey(__m128i key)
+{
+    const __m128i word = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(key, kRoundConstant), 0xff);
+
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, word);
+}
+
+void ExpandKey(const uint8_t * key, uint8_t * roundKeys)
+{
+    __m128i rounds[11];
+
+    rounds[0]  = AESNICipher::Load(key);
+    rounds[1]  = ExpandRoundKey<0x01>(rounds[0]);
+    rounds[2]  = ExpandRoundKey<0x02>(rounds[1]);
+    rounds[3]  = ExpandRoundKey<0x04>(rounds[2]);
+    rounds[4]  = ExpandRoundKey<0x08>(rounds[3]);
+    rounds[5]  = ExpandRoundKey<0x10>(rounds[4]);
+    rounds[6]  = ExpandRoundKey<0x20>(rounds[5]);
+    rounds[7]  = ExpandRoundKey<0x40>(rounds[6]);
+    rounds[8]  = ExpandRoundKey<0x80>(rounds[7]);
+    rounds[9]  = ExpandRoundKey<0x1b>(rounds[8]);
+    rounds[10] = ExpandRoundKey<0x36>(rounds[9]);
+
+    for (size_t i = 0; i < 11; i++)
+    {
+        AESNICipher::Store(&roundKeys[i * 16], rounds[i]);
+    }
+}
+
+} // namespace
+
+const AESCCMKernelOps gAESNIKernelOps = {
+    ExpandKey,
+    AESCCMKernelDriver<AESNICipher>::Encrypt,
+    AESCCMKernelDriver<AESNICipher>::Decrypt,
+};
+
+} // namespace Crypto
+} // namespace chip
@@ -0,0 +1,139 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      AESCCMKernel for ARMv8 CPUs with the cryptography extension. This
+ *      file is built with the flags enabling its intrinsics, and only called
+ *      once AESCCMKernel::IsSupported() found it on the CPU.
+ */
+
+#include "AESCCMKernelImpl.h"
+
+#include <arm_neon.h>
+
+namespace chip {
+namespace Crypto {
+
+namespace {
+
+struct ARMv8Cipher
+{
+    using Block = uint8x16_t;
+
+    struct Keys
+    {
+        uint8x16_t mRounds[11];
+    };
+
+    /// Counter block, and its big endian counter in the last 32 bits.
+    struct Counter
+    {
+        uint8x16_t mBlock;
+        uint32_t mValue;
+    };
+
+    static Block Load(const uint8_t * data) { return vld1q_u8(data); }
+    static void Store(uint8_t * data, Block block) { vst1q_u8(data, block); }
+    static Block Xor(Block a, Block b) { return veorq_u8(a, b); }
+
+    static void LoadKeys(const uint8_t * roundKeys, Keys & keys)
+    {
+        for (size_t i = 0; i < 11; i++)
+        {
+            keys.mRounds[i] = Load(&roundKeys[i * 16]);
+        }
+    }
+
+    // AESE adds the round key before substituting and shifting, so the last round key is added on its own
+    static Block Encrypt(const Keys & keys, Block block)
+    {
+        for (size_t i = 0; i < 9; i++)
+        {
+            block = vaesmcq_u8(vaeseq_u8(block, keys.mRounds[i]));
+        }
+        return veorq_u8(vaeseq_u8(block, keys.mRounds[9]), keys.mRounds[10]);
+    }
+
+    static void Encrypt2(const Keys & keys, Block & a, Block & b)
+    {
+        for (size_t i = 0; i < 9; i++)
+        {
+            a = vaesmcq_u8(vaeseq_u8(a, keys.mRounds[i]));
+            b = vaesmcq_u8(vaeseq_u8(b, keys.mRounds[i]));
+        }
+        a = veorq_u8(vaeseq_u8(a, keys.mRounds[9]), keys.mRounds[10]);
+        b = veorq_u8(vaeseq_u8(b, keys.mRounds[9]), keys.mRounds[10]);
+    }
+
+    static Counter LoadCounter(const uint8_t * a0)
+    {
+        Counter counter;
+
+        counter.mBlock = Load(a0);
+        counter.mValue = (static_cast<uint32_t>(a0[12]) << 24) | (static_cast<uint32_t>(a0[13]) << 16) |
+            (static_cast<uint32_t>(a0[14]) << 8) | a0[15];
+        return counter;
+    }
+
+    static Block NextCounter(Counter & counter)
+    {
+        counter.mValue++;
+
+        const uint32x4_t words = vsetq_lane_u32(__builtin_bswap32(counter.mValue), vreinterpretq_u32_u8(counter.mBlock), 3);
+        return vreinterpretq_u8_u32(words);
+    }
+};
+
+/// Applies the S-box to the bytes of a word, with AESE on a block made of four copies of it so that ShiftRows has no effect.
+uint32_t SubWord(uint32_t word)
+{
+    const uint8x16_t block = vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(word)), vdupq_n_u8(0));
+    return vgetq_lane_u32(vreinterpretq_u32_u8(block), 0);
+}
+
+void ExpandKey(const uint8_t * key, uint8_t * roundKeys)
+{
+    static const uint8_t kRoundConstants[10] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1b, 0x36 };
+    uint32_t words[44];
+
+    // Words are kept in the byte order of the key, the CPU being little endian
+    memcpy(words, key, 16);
+    for (size_t i = 4; i < 44; i++)
+    {
+        uint32_t word = words[i - 1];
+
+        if (i % 4 == 0)
+        {
+            word = SubWord((word >> 8) | (word << 24)) ^ kRoundConstants[i / 4 - 1];
+        }
+        words[i] = words[i - 4] ^ word;
+    }
+
+    memcpy(roundKeys, words, sizeof(words));
+}
+
+} // namespace
+
+const AESCCMKernelOps gARMv8KernelOps = {
+    ExpandKey,
+    AESCCMKernelDriver<ARMv8Cipher>::Encrypt,
+    AESCCMKernelDriver<ARMv8Cipher>::Decrypt,
+};
+
+} // namespace Crypto
+} // namespace chip
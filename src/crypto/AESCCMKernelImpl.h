@@ -0,0 +1,252 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Internal header of AESCCMKernel, shared with the implementations of
+ *      the kernel for each instruction set.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace chip {
+namespace Crypto {
+
+/**
+ * A message to encrypt or decrypt, with the blocks depending on its nonce
+ * and lengths formatted as specified by RFC 3610.
+ */
+struct AESCCMKernelMessage
+{
+    uint8_t mB0[16];      ///< first block of the CBC-MAC: flags, nonce and message length
+    uint8_t mA0[16];      ///< counter block of the tag, incremented for each block of the message
+    const uint8_t * mAAD; ///< additional authentication data
+    size_t mAADLength;    ///< length of mAAD, below 2^32
+    const uint8_t * mIn;  ///< plaintext or ciphertext
+    size_t mLength;       ///< length of mIn and mOut
+    uint8_t * mOut;       ///< ciphertext or plaintext, may be equal to mIn
+};
+
+/**
+ * The kernel for one instruction set.
+ */
+struct AESCCMKernelOps
+{
+    /// Expands a 16 bytes key into 11 round keys of 16 bytes.
+    void (*ExpandKey)(const uint8_t * key, uint8_t * roundKeys);
+
+    /// Encrypts a message, writing 16 bytes of tag.
+    void (*Encrypt)(const uint8_t * roundKeys, const AESCCMKernelMessage & message, uint8_t * tag);
+
+    /// Decrypts a message, writing the 16 bytes of tag it should come with.
+    void (*Decrypt)(const uint8_t * roundKeys, const AESCCMKernelMessage & message, uint8_t * tag);
+};
+
+extern const AESCCMKernelOps gAESNIKernelOps;
+extern const AESCCMKernelOps gARMv8KernelOps;
+
+/**
+ * CCM over the AES-128 block cipher of an instruction set.
+ *
+ * @tparam Cipher provides the Block, Keys and Counter types, and the static
+ *         LoadKeys, Load, Store, Xor, Encrypt, Encrypt2, LoadCounter and
+ *         NextCounter functions operating on them. Encrypt2 encrypts two
+ *         independent blocks at once.
+ *
+ * Instantiated in the translation unit of the instruction set only, which is
+ * the one built with the flags enabling its intrinsics.
+ */
+template <typename Cipher>
+class AESCCMKernelDriver
+{
+public:
+    using Block   = typename Cipher::Block;
+    using Keys    = typename Cipher::Keys;
+    using Counter = typename Cipher::Counter;
+
+    static constexpr size_t kBlockSize = 16;
+
+    static void Encrypt(const uint8_t * roundKeys, const AESCCMKernelMessage & message, uint8_t * tag)
+    {
+        Keys keys;
+        Cipher::LoadKeys(roundKeys, keys);
+
+        Counter counter    = Cipher::LoadCounter(message.mA0);
+        Block mac          = Cipher::Load(message.mB0);
+        Block tagStream    = Cipher::Load(message.mA0);
+        const uint8_t * in = message.mIn;
+        uint8_t * out      = message.mOut;
+        size_t remaining   = message.mLength;
+
+        Cipher::Encrypt2(keys, mac, tagStream);
+        mac = AuthenticateAAD(keys, mac, message.mAAD, message.mAADLength);
+
+        // The plaintext is known up front, so both the MAC and the keystream of a block are computed at once
+        for (; remaining >= kBlockSize; remaining -= kBlockSize, in += kBlockSize, out += kBlockSize)
+        {
+            Block plaintext = Cipher::Load(in);
+            Block keystream = Cipher::NextCounter(counter);
+
+            mac = Cipher::Xor(mac, plaintext);
+            Cipher::Encrypt2(keys, mac, keystream);
+            Cipher::Store(out, Cipher::Xor(plaintext, keystream));
+        }
+
+        if (remaining > 0)
+        {
+            Block plaintext = LoadPartial(in, remaining);
+            Block keystream = Cipher::NextCounter(counter);
+
+            mac = Cipher::Xor(mac, plaintext);
+            Cipher::Encrypt2(keys, mac, keystream);
+            StorePartial(out, Cipher::Xor(plaintext, keystream), remaining);
+        }
+
+        Cipher::Store(tag, Cipher::Xor(mac, tagStream));
+    }
+
+    static void Decrypt(const uint8_t * roundKeys, const AESCCMKernelMessage & message, uint8_t * tag)
+    {
+        Keys keys;
+        Cipher::LoadKeys(roundKeys, keys);
+
+        Counter counter    = Cipher::LoadCounter(message.mA0);
+        Block mac          = Cipher::Load(message.mB0);
+        Block tagStream    = Cipher::Load(message.mA0);
+        Block keystream    = {};
+        const uint8_t * in = message.mIn;
+        uint8_t * out      = message.mOut;
+        size_t remaining   = message.mLength;
+
+        Cipher::Encrypt2(keys, mac, tagStream);
+        mac = AuthenticateAAD(keys, mac, message.mAAD, message.mAADLength);
+
+        if (remaining > 0)
+        {
+            keystream = Cipher::Encrypt(keys, Cipher::NextCounter(counter));
+        }
+
+        // The MAC of a block needs its plaintext, so it is computed along with the keystream of the next block
+        while (remaining > 0)
+        {
+            const size_t length = (remaining < kBlockSize) ? remaining : kBlockSize;
+            Block plaintext;
+
+            if (length == kBlockSize)
+            {
+                plaintext = Cipher::Xor(Cipher::Load(in), keystream);
+                Cipher::Store(out, plaintext);
+            }
+            else
+            {
+                // Only the bytes of the message are authenticated, the padding stays zero
+                uint8_t buffer[kBlockSize];
+
+                Cipher::Store(buffer, Cipher::Xor(LoadPartial(in, length), keystream));
+                memset(&buffer[length], 0, kBlockSize - length);
+                memcpy(out, buffer, length);
+                plaintext = Cipher::Load(buffer);
+            }
+
+            mac = Cipher::Xor(mac, plaintext);
+            remaining -= length;
+            in += length;
+            out += length;
+
+            if (remaining > 0)
+            {
+                keystream = Cipher::NextCounter(counter);
+                Cipher::Encrypt2(keys, mac, keystream);
+            }
+            else
+            {
+                mac = Cipher::Encrypt(keys, mac);
+            }
+        }
+
+        Cipher::Store(tag, Cipher::Xor(mac, tagStream));
+    }
+
+private:
+    static Block LoadPartial(const uint8_t * data, size_t length)
+    {
+        uint8_t buffer[kBlockSize] = {};
+
+        memcpy(buffer, data, length);
+        return Cipher::Load(buffer);
+    }
+
+    static void StorePartial(uint8_t * data, Block block, size_t length)
+    {
+        uint8_t buffer[kBlockSize];
+
+        Cipher::Store(buffer, block);
+        memcpy(data, buffer, length);
+    }
+
+    /// Adds the length of the AAD and the AAD to the CBC-MAC, padded to whole blocks.
+    static Block AuthenticateAAD(const Keys & keys, Block mac, const uint8_t * aad, size_t length)
+    {
+        uint8_t first[kBlockSize] = {};
+        size_t used               = 0;
+
+        if (length == 0)
+        {
+            return mac;
+        }
+
+        if (length < 0xFF00)
+        {
+            first[used++] = static_cast<uint8_t>(length >> 8);
+            first[used++] = static_cast<uint8_t>(length);
+        }
+        else
+        {
+            first[used++] = 0xFF;
+            first[used++] = 0xFE;
+            first[used++] = static_cast<uint8_t>(length >> 24);
+            first[used++] = static_cast<uint8_t>(length >> 16);
+            first[used++] = static_cast<uint8_t>(length >> 8);
+            first[used++] = static_cast<uint8_t>(length);
+        }
+
+        const size_t firstLength = (length < kBlockSize - used) ? length : kBlockSize - used;
+        memcpy(&first[used], aad, firstLength);
+        mac = Cipher::Encrypt(keys, Cipher::Xor(mac, Cipher::Load(first)));
+        aad += firstLength;
+        length -= firstLength;
+
+        for (; length >= kBlockSize; length -= kBlockSize, aad += kBlockSize)
+        {
+            mac = Cipher::Encrypt(keys, Cipher::Xor(mac, Cipher::Load(aad)));
+        }
+
+        if (length > 0)
+        {
+            mac = Cipher::Encrypt(keys, Cipher::Xor(mac, LoadPartial(aad, length)));
+        }
+
+        return mac;
+    }
+};
+
+} // namespace Crypto
+} // namespace chip
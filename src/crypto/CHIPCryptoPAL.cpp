@@ -440,5 +440,263 @@ exit:
     return error;
 }
 
+// Incremental AES-CCM, following the formatting of RFC 3610 section 2. The backends only provide
+// the block cipher, so the plaintext can be passed in pieces, which their one-shot CCM cannot do.
+CHIP_ERROR AES_CCM_Context::EncryptBegin(size_t plaintext_length, const uint8_t * aad, size_t aad_length, const uint8_t * iv,
+                                         size_t iv_length, size_t tag_length)
+{
+    return IncrementalBegin(false, plaintext_length, aad, aad_length, iv, iv_length, tag_length);
+}
+
+CHIP_ERROR AES_CCM_Context::EncryptUpdate(const uint8_t * plaintext, size_t length, uint8_t * ciphertext)
+{
+    return IncrementalUpdate(false, plaintext, length, ciphertext);
+}
+
+CHIP_ERROR AES_CCM_Context::EncryptFinish(uint8_t * tag, size_t tag_length)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    uint8_t computed[kBlockSize];
+
+    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(tag_length == mTagLength, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    SuccessOrExit(error = IncrementalFinish(false, computed));
+    memcpy(tag, computed, tag_length);
+
+exit:
+    mTagLength = 0;
+    memset(computed, 0, sizeof(computed));
+    return error;
+}
+
+CHIP_ERROR AES_CCM_Context::DecryptBegin(size_t ciphertext_length, const uint8_t * aad, size_t aad_length, const uint8_t * iv,
+                                         size_t iv_length, size_t tag_length)
+{
+    return IncrementalBegin(true, ciphertext_length, aad, aad_length, iv, iv_length, tag_length);
+}
+
+CHIP_ERROR AES_CCM_Context::DecryptUpdate(const uint8_t * ciphertext, size_t length, uint8_t * plaintext)
+{
+    return IncrementalUpdate(true, ciphertext, length, plaintext);
+}
+
+CHIP_ERROR AES_CCM_Context::DecryptFinish(const uint8_t * tag, size_t tag_length)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    uint8_t difference = 0;
+    uint8_t expected[kBlockSize];
+
+    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(tag_length == mTagLength, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    SuccessOrExit(error = IncrementalFinish(true, expected));
+
+    // Compare in constant time
+    for (size_t i = 0; i < tag_length; i++)
+    {
+        difference = static_cast<uint8_t>(difference | (expected[i] ^ tag[i]));
+    }
+
+    VerifyOrExit(difference == 0, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    mTagLength = 0;
+    memset(expected, 0, sizeof(expected));
+    return error;
+}
+
+CHIP_ERROR AES_CCM_Context::IncrementalBegin(bool decrypt, size_t total_length, const uint8_t * aad, size_t aad_length,
+                                             const uint8_t * iv, size_t iv_length, size_t tag_length)
+{
+    CHIP_ERROR error        = CHIP_NO_ERROR;
+    const uint64_t length   = total_length;
+    const uint64_t aadLen   = aad_length;
+    uint8_t aadHeader[10]   = { 0 };
+    size_t aadHeaderLength  = 0;
+    size_t lengthFieldBytes = 0;
+
+    mTagLength = 0;
+
+    VerifyOrExit(HasKey(), error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(total_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(aad_length == 0 || aad != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv_length >= 7 && iv_length <= 13, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(tag_length >= 4 && tag_length <= kBlockSize && (tag_length % 2) == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    // The nonce leaves the rest of a block to encode the plaintext length and the block counter
+    lengthFieldBytes = kBlockSize - 1 - iv_length;
+    VerifyOrExit(lengthFieldBytes >= sizeof(length) || (length >> (8 * lengthFieldBytes)) == 0,
+                 error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    // B0: flags, nonce and plaintext length
+    mMac[0] = static_cast<uint8_t>((aad_length > 0 ? 0x40 : 0) | (((tag_length - 2) / 2) << 3) | (lengthFieldBytes - 1));
+    memcpy(&mMac[1], iv, iv_length);
+    for (size_t i = 0; i < lengthFieldBytes; i++)
+    {
+        mMac[kBlockSize - 1 - i] = static_cast<uint8_t>(length >> (8 * i));
+    }
+
+    SuccessOrExit(error = EncryptBlock(mMac, mMac));
+    mMacUsed = 0;
+
+    if (aad_length > 0)
+    {
+        // AAD length: 2 bytes, or a 2 bytes marker followed by 4 or 8 bytes
+        size_t aadLengthBytes = 2;
+
+        if (aadLen >= 0xFF00)
+        {
+            aadLengthBytes = (aadLen <= UINT32_MAX) ? 4 : 8;
+            aadHeader[0]   = 0xFF;
+            aadHeader[1]   = (aadLen <= UINT32_MAX) ? 0xFE : 0xFF;
+        }
+
+        aadHeaderLength = (aadLengthBytes == 2) ? 2 : 2 + aadLengthBytes;
+        for (size_t i = 0; i < aadLengthBytes; i++)
+        {
+            aadHeader[aadHeaderLength - 1 - i] = static_cast<uint8_t>(aadLen >> (8 * i));
+        }
+
+        SuccessOrExit(error = Authenticate(aadHeader, aadHeaderLength));
+        SuccessOrExit(error = Authenticate(aad, aad_length));
+
+        // The AAD is zero padded to a whole block
+        if (mMacUsed > 0)
+        {
+            SuccessOrExit(error = EncryptBlock(mMac, mMac));
+            mMacUsed = 0;
+        }
+    }
+
+    // Counter blocks: flags, nonce and counter, starting at 1 for the plaintext
+    mCounter[0] = static_cast<uint8_t>(lengthFieldBytes - 1);
+    memcpy(&mCounter[1], iv, iv_length);
+    memset(&mCounter[1 + iv_length], 0, lengthFieldBytes);
+    mKeystreamUsed = kBlockSize;
+
+    mRemaining  = total_length;
+    mTagLength  = static_cast<uint8_t>(tag_length);
+    mDecrypting = decrypt;
+
+exit:
+    return error;
+}
+
+CHIP_ERROR AES_CCM_Context::IncrementalUpdate(bool decrypt, const uint8_t * in, size_t length, uint8_t * out)
+{
+    CHIP_ERROR error              = CHIP_NO_ERROR;
+    const size_t lengthFieldBytes = static_cast<size_t>(mCounter[0] & 0x07) + 1;
+
+    VerifyOrExit(mTagLength != 0 && mDecrypting == decrypt, error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(length <= mRemaining, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(length == 0 || (in != nullptr && out != nullptr), error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Whole blocks go through at once, only the head and tail of an update that is not block aligned are partial
+    for (size_t i = 0; i < length;)
+    {
+        uint8_t input[kBlockSize];
+        uint8_t output[kBlockSize];
+        size_t chunk = 0;
+
+        if (mKeystreamUsed == kBlockSize)
+        {
+            for (size_t j = kBlockSize - 1; j >= kBlockSize - lengthFieldBytes && ++mCounter[j] == 0; j--)
+            {
+            }
+
+            SuccessOrExit(error = EncryptBlock(mCounter, mKeystream));
+            mKeystreamUsed = 0;
+        }
+
+        chunk = kBlockSize - mKeystreamUsed;
+        chunk = (length - i < chunk) ? length - i : chunk;
+
+        // Read the input first, as the output may be the same buffer
+        memcpy(input, &in[i], chunk);
+        for (size_t j = 0; j < chunk; j++)
+        {
+            output[j] = static_cast<uint8_t>(input[j] ^ mKeystream[mKeystreamUsed + j]);
+        }
+        mKeystreamUsed = static_cast<uint8_t>(mKeystreamUsed + chunk);
+
+        // The MAC covers the plaintext, which is the input when encrypting and the output when decrypting
+        SuccessOrExit(error = Authenticate(decrypt ? output : input, chunk));
+        memcpy(&out[i], output, chunk);
+        i += chunk;
+    }
+
+    mRemaining -= length;
+
+exit:
+    if (error != CHIP_NO_ERROR)
+    {
+        // The message can not be completed anymore
+        mTagLength = 0;
+    }
+
+    return error;
+}
+
+// Outputs the full length tag, callers truncate it to mTagLength.
+CHIP_ERROR AES_CCM_Context::IncrementalFinish(bool decrypt, uint8_t * tag)
+{
+    CHIP_ERROR error              = CHIP_NO_ERROR;
+    const size_t lengthFieldBytes = static_cast<size_t>(mCounter[0] & 0x07) + 1;
+
+    VerifyOrExit(mTagLength != 0 && mDecrypting == decrypt, error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(mRemaining == 0, error = CHIP_ERROR_INCORRECT_STATE);
+
+    // The plaintext is zero padded to a whole block
+    if (mMacUsed > 0)
+    {
+        SuccessOrExit(error = EncryptBlock(mMac, mMac));
+        mMacUsed = 0;
+    }
+
+    // The tag is the CBC-MAC encrypted with counter block 0
+    memset(&mCounter[kBlockSize - lengthFieldBytes], 0, lengthFieldBytes);
+    SuccessOrExit(error = EncryptBlock(mCounter, mKeystream));
+
+    for (size_t i = 0; i < kBlockSize; i++)
+    {
+        tag[i] = static_cast<uint8_t>(mMac[i] ^ mKeystream[i]);
+    }
+
+exit:
+    memset(mMac, 0, sizeof(mMac));
+    memset(mKeystream, 0, sizeof(mKeystream));
+
+    return error;
+}
+
+CHIP_ERROR AES_CCM_Context::Authenticate(const uint8_t * data, size_t length)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+
+    while (length > 0 && error == CHIP_NO_ERROR)
+    {
+        const size_t chunk = (length < kBlockSize - mMacUsed) ? length : kBlockSize - mMacUsed;
+
+        for (size_t i = 0; i < chunk; i++)
+        {
+            mMac[mMacUsed + i] ^= data[i];
+        }
+
+        mMacUsed = static_cast<uint8_t>(mMacUsed + chunk);
+        data += chunk;
+        length -= chunk;
+
+        if (mMacUsed == kBlockSize)
+        {
+            error    = EncryptBlock(mMac, mMac);
+            mMacUsed = 0;
+        }
+    }
+
+    return error;
+}
+
 } // namespace Crypto
 } // namespace chip
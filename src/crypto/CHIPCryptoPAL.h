@@ -30,6 +30,10 @@
 #include <core/CHIPError.h>
 #include <support/CodeUtils.h>
 
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+#include <crypto/AESCCMKernel.h>
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
 #include <stddef.h>
 #include <string.h>
 
@@ -57,6 +61,7 @@ const size_t kP256_PublicKey_Length  = 65;
 const size_t kMAX_Spake2p_Context_Size     = 1024;
 const size_t kMAX_Hash_SHA256_Context_Size = 256;
 const size_t kMAX_P256Keypair_Context_Size = 512;
+const size_t kMAX_AES_CCM_Context_Size     = 128;
 
 /**
  * Spake2+ parameters for P256
@@ -338,6 +343,152 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
                            const uint8_t * tag, size_t tag_length, const uint8_t * key, size_t key_length, const uint8_t * iv,
                            size_t iv_length, uint8_t * plaintext);
 
+/**
+ * @brief A class that keeps an AES-CCM key expanded across messages
+ *
+ * Equivalent to AES_CCM_encrypt and AES_CCM_decrypt, except that the key is
+ * provided once: the key schedule and cipher setup are done on the first use
+ * of each direction, and only the nonce is reset for every message. Intended
+ * for sessions that encrypt many messages with the same key.
+ *
+ * Contexts are not copyable, as they may own backend resources.
+ **/
+
+struct AESCCMOpaqueContext
+{
+    alignas(alignof(void *)) uint8_t mOpaque[kMAX_AES_CCM_Context_Size];
+};
+
+class AES_CCM_Context
+{
+public:
+    AES_CCM_Context();
+    ~AES_CCM_Context();
+
+    AES_CCM_Context(const AES_CCM_Context &) = delete;
+    AES_CCM_Context & operator=(const AES_CCM_Context &) = delete;
+
+    /**
+     * @brief Sets the key used by the following Encrypt and Decrypt calls
+     * @param key Encryption key
+     * @param key_length Length of encryption key (in bytes)
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR SetKey(const uint8_t * key, size_t key_length);
+
+    /// Returns true if a key was set since construction or the last Clear.
+    bool HasKey() const;
+
+    /// Same as AES_CCM_encrypt, using the key of the context.
+    CHIP_ERROR Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * iv, size_t iv_length, uint8_t * ciphertext, uint8_t * tag, size_t tag_length);
+
+    /// Same as AES_CCM_decrypt, using the key of the context.
+    CHIP_ERROR Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                       const uint8_t * tag, size_t tag_length, const uint8_t * iv, size_t iv_length, uint8_t * plaintext);
+
+    /**
+     * @brief Starts an encryption whose plaintext is passed in several pieces
+     *
+     * Following EncryptUpdate calls pass the plaintext, possibly spread over
+     * several non-contiguous buffers, and EncryptFinish outputs the tag. The
+     * result is the same as a single Encrypt call over the whole plaintext.
+     *
+     * @param plaintext_length Total length of the plaintext passed to EncryptUpdate
+     * @param aad Additional authentication data
+     * @param aad_length Length of additional authentication data
+     * @param iv Initial vector
+     * @param iv_length Length of initial vector
+     * @param tag_length Expected length of tag
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR EncryptBegin(size_t plaintext_length, const uint8_t * aad, size_t aad_length, const uint8_t * iv, size_t iv_length,
+                            size_t tag_length);
+
+    /**
+     * @brief Encrypts the next piece of plaintext of an encryption started by EncryptBegin
+     * @param plaintext Plaintext to encrypt
+     * @param length Length of plaintext
+     * @param ciphertext Buffer to write length bytes of ciphertext into, may be equal to plaintext
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR EncryptUpdate(const uint8_t * plaintext, size_t length, uint8_t * ciphertext);
+
+    /**
+     * @brief Completes an encryption once all of the plaintext was passed to EncryptUpdate
+     * @param tag Buffer to write tag into
+     * @param tag_length Length of tag, as passed to EncryptBegin
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR EncryptFinish(uint8_t * tag, size_t tag_length);
+
+    /**
+     * @brief Starts a decryption whose ciphertext is passed in several pieces
+     *
+     * Counterpart of EncryptBegin. The plaintext output by DecryptUpdate MUST
+     * NOT be used unless DecryptFinish succeeds.
+     *
+     * @param ciphertext_length Total length of the ciphertext passed to DecryptUpdate
+     * @param aad Additional authentication data
+     * @param aad_length Length of additional authentication data
+     * @param iv Initial vector
+     * @param iv_length Length of initial vector
+     * @param tag_length Length of tag
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR DecryptBegin(size_t ciphertext_length, const uint8_t * aad, size_t aad_length, const uint8_t * iv,
+                            size_t iv_length, size_t tag_length);
+
+    /**
+     * @brief Decrypts the next piece of ciphertext of a decryption started by DecryptBegin
+     * @param ciphertext Ciphertext to decrypt
+     * @param length Length of ciphertext
+     * @param plaintext Buffer to write length bytes of plaintext into, may be equal to ciphertext
+     * @return Returns a CHIP_ERROR on error, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR DecryptUpdate(const uint8_t * ciphertext, size_t length, uint8_t * plaintext);
+
+    /**
+     * @brief Completes a decryption once all of the ciphertext was passed to DecryptUpdate
+     * @param tag Tag to check the decrypted message against
+     * @param tag_length Length of tag, as passed to DecryptBegin
+     * @return Returns a CHIP_ERROR if the tag does not match, CHIP_NO_ERROR otherwise
+     **/
+    CHIP_ERROR DecryptFinish(const uint8_t * tag, size_t tag_length);
+
+    /// Forgets the key and releases any backend resources.
+    void Clear();
+
+private:
+    static constexpr size_t kBlockSize = 16;
+
+    /// Encrypts a single block with the key of the context, implemented by the backend.
+    CHIP_ERROR EncryptBlock(const uint8_t * in, uint8_t * out);
+
+    CHIP_ERROR IncrementalBegin(bool decrypt, size_t total_length, const uint8_t * aad, size_t aad_length, const uint8_t * iv,
+                                size_t iv_length, size_t tag_length);
+    CHIP_ERROR IncrementalUpdate(bool decrypt, const uint8_t * in, size_t length, uint8_t * out);
+    CHIP_ERROR IncrementalFinish(bool decrypt, uint8_t * tag);
+
+    /// Adds data to the CBC-MAC of an incremental encryption or decryption.
+    CHIP_ERROR Authenticate(const uint8_t * data, size_t length);
+
+    AESCCMOpaqueContext mContext;
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    AESCCMKernel mKernel; ///< used by Encrypt and Decrypt instead of the backend when it supports the key
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
+    // State of an incremental encryption or decryption, see EncryptBegin and DecryptBegin
+    uint8_t mMac[kBlockSize];       ///< CBC-MAC state
+    uint8_t mCounter[kBlockSize];   ///< last counter block used for the keystream
+    uint8_t mKeystream[kBlockSize]; ///< encrypted counter block
+    size_t mRemaining      = 0;     ///< input still expected by the Update calls
+    uint8_t mMacUsed       = 0;     ///< bytes of mMac that were added to since it was last encrypted
+    uint8_t mKeystreamUsed = 0;     ///< bytes of mKeystream that were already used
+    uint8_t mTagLength     = 0;     ///< tag length passed to the Begin call, 0 if nothing is in progress
+    bool mDecrypting       = false; ///< true if DecryptBegin started the operation in progress
+};
+
 /**
  * @brief A function that implements SHA-256 hash
  * @param data The data to hash
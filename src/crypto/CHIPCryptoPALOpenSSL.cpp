@@ -139,6 +139,17 @@ CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, c
     VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrExit(_isValidTagLength(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
 
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    if (AESCCMKernel::Supports(key_length))
+    {
+        // Expanding the key costs less than setting up a cipher context for a single message
+        AESCCMKernel kernel;
+
+        SuccessOrExit(error = kernel.SetKey(key, key_length));
+        ExitNow(error = kernel.Encrypt(plaintext, plaintext_length, aad, aad_length, iv, iv_length, ciphertext, tag, tag_length));
+    }
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
     // 16 bytes key for AES-CCM-128
     type = (key_length == 16) ? EVP_aes_128_ccm() : EVP_aes_256_ccm();
 
@@ -222,6 +233,17 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
     VerifyOrExit(iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrExit(iv_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
 
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    if (AESCCMKernel::Supports(key_length))
+    {
+        // Expanding the key costs less than setting up a cipher context for a single message
+        AESCCMKernel kernel;
+
+        SuccessOrExit(error = kernel.SetKey(key, key_length));
+        ExitNow(error = kernel.Decrypt(ciphertext, ciphertext_length, aad, aad_length, tag, tag_length, iv, iv_length, plaintext));
+    }
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
     // 16 bytes key for AES-CCM-128
     type = (key_length == 16) ? EVP_aes_128_ccm() : EVP_aes_256_ccm();
 
@@ -278,6 +300,345 @@ exit:
     return error;
 }
 
+namespace {
+
+/// One direction of an AES_CCM_Context: a cipher context holding the expanded key.
+struct AESCCMDirection
+{
+    EVP_CIPHER_CTX * mContext;
+    size_t mIVLength;  ///< IV length the context was set up for, 0 if it needs to be set up
+    size_t mTagLength; ///< tag length the context was set up for
+};
+
+struct AESCCMContext
+{
+    AESCCMDirection mEncrypt;
+    AESCCMDirection mDecrypt;
+    EVP_CIPHER_CTX * mBlock; ///< raw block cipher for incremental encryption, set up on first use
+    uint8_t mKey[32];
+    size_t mKeyLength;
+};
+
+} // namespace
+
+static inline AESCCMContext * to_inner_aes_ccm_context(AESCCMOpaqueContext * context)
+{
+    nlSTATIC_ASSERT_PRINT(sizeof(AESCCMOpaqueContext) >= sizeof(AESCCMContext), "Need more memory for AES-CCM Context");
+    return reinterpret_cast<AESCCMContext *>(context->mOpaque);
+}
+
+static inline const AESCCMContext * to_inner_aes_ccm_context(const AESCCMOpaqueContext * context)
+{
+    return reinterpret_cast<const AESCCMContext *>(context->mOpaque);
+}
+
+// CCM binds the IV and tag lengths into the cipher state when the key is set, so the
+// key schedule is redone only when a message uses different lengths than the previous one.
+static CHIP_ERROR _setupAESCCMDirection(AESCCMContext * context, AESCCMDirection & direction, int enc, size_t iv_length,
+                                        size_t tag_length)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 1;
+
+    // 16 bytes key for AES-CCM-128
+    const EVP_CIPHER * type = (context->mKeyLength == 16) ? EVP_aes_128_ccm() : EVP_aes_256_ccm();
+
+    VerifyOrExit(CanCastTo<int>(iv_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    direction.mIVLength = 0;
+
+    if (direction.mContext == nullptr)
+    {
+        direction.mContext = EVP_CIPHER_CTX_new();
+        VerifyOrExit(direction.mContext != nullptr, error = CHIP_ERROR_INTERNAL);
+    }
+    else
+    {
+        result = EVP_CIPHER_CTX_reset(direction.mContext);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    }
+
+    // Pass in cipher
+    result = EVP_CipherInit_ex(direction.mContext, type, nullptr, nullptr, nullptr, enc);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    // Pass in IV length.  Cast is safe because we checked with CanCastTo.
+    result = EVP_CIPHER_CTX_ctrl(direction.mContext, EVP_CTRL_CCM_SET_IVLEN, static_cast<int>(iv_length), nullptr);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    // Pass in tag length. Cast is safe because callers checked _isValidTagLength.
+    result = EVP_CIPHER_CTX_ctrl(direction.mContext, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length), nullptr);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    // Pass in key
+    result = EVP_CipherInit_ex(direction.mContext, nullptr, nullptr, Uint8::to_const_uchar(context->mKey), nullptr, enc);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    direction.mIVLength  = iv_length;
+    direction.mTagLength = tag_length;
+
+exit:
+    return error;
+}
+
+static void _clearAESCCMDirection(AESCCMDirection & direction)
+{
+    if (direction.mContext != nullptr)
+    {
+        EVP_CIPHER_CTX_free(direction.mContext);
+    }
+
+    direction.mContext   = nullptr;
+    direction.mIVLength  = 0;
+    direction.mTagLength = 0;
+}
+
+AES_CCM_Context::AES_CCM_Context()
+{
+    AESCCMContext * context = to_inner_aes_ccm_context(&mContext);
+
+    context->mEncrypt   = AESCCMDirection{ nullptr, 0, 0 };
+    context->mDecrypt   = AESCCMDirection{ nullptr, 0, 0 };
+    context->mBlock     = nullptr;
+    context->mKeyLength = 0;
+}
+
+AES_CCM_Context::~AES_CCM_Context()
+{
+    Clear();
+}
+
+CHIP_ERROR AES_CCM_Context::SetKey(const uint8_t * key, size_t key_length)
+{
+    CHIP_ERROR error        = CHIP_NO_ERROR;
+    AESCCMContext * context = to_inner_aes_ccm_context(&mContext);
+
+    VerifyOrExit(key != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidKeyLength(key_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+
+    Clear();
+
+    memcpy(context->mKey, key, key_length);
+    context->mKeyLength = key_length;
+
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    if (AESCCMKernel::Supports(key_length))
+    {
+        SuccessOrExit(error = mKernel.SetKey(key, key_length));
+    }
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
+exit:
+    return error;
+}
+
+bool AES_CCM_Context::HasKey() const
+{
+    return to_inner_aes_ccm_context(&mContext)->mKeyLength != 0;
+}
+
+CHIP_ERROR AES_CCM_Context::Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * iv, size_t iv_length, uint8_t * ciphertext, uint8_t * tag, size_t tag_length)
+{
+    AESCCMContext * context     = to_inner_aes_ccm_context(&mContext);
+    AESCCMDirection & direction = context->mEncrypt;
+    int bytesWritten            = 0;
+    size_t ciphertext_length    = 0;
+    CHIP_ERROR error            = CHIP_NO_ERROR;
+    int result                  = 1;
+
+    VerifyOrExit(HasKey(), error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(plaintext != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(plaintext_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidTagLength(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    if (mKernel.HasKey())
+    {
+        ExitNow(error = mKernel.Encrypt(plaintext, plaintext_length, aad, aad_length, iv, iv_length, ciphertext, tag, tag_length));
+    }
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
+    if (direction.mIVLength != iv_length || direction.mTagLength != tag_length)
+    {
+        SuccessOrExit(error = _setupAESCCMDirection(context, direction, 1, iv_length, tag_length));
+    }
+
+    // Pass in iv, the key is already set up
+    result = EVP_EncryptInit_ex(direction.mContext, nullptr, nullptr, nullptr, Uint8::to_const_uchar(iv));
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    // Pass in plain text length
+    VerifyOrExit(CanCastTo<int>(plaintext_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    result = EVP_EncryptUpdate(direction.mContext, nullptr, &bytesWritten, nullptr, static_cast<int>(plaintext_length));
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    // Pass in AAD
+    if (aad_length > 0 && aad != nullptr)
+    {
+        VerifyOrExit(CanCastTo<int>(aad_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+        result = EVP_EncryptUpdate(direction.mContext, nullptr, &bytesWritten, Uint8::to_const_uchar(aad),
+                                   static_cast<int>(aad_length));
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    }
+
+    // Encrypt
+    result = EVP_EncryptUpdate(direction.mContext, Uint8::to_uchar(ciphertext), &bytesWritten, Uint8::to_const_uchar(plaintext),
+                               static_cast<int>(plaintext_length));
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(bytesWritten >= 0, error = CHIP_ERROR_INTERNAL);
+    ciphertext_length = static_cast<unsigned int>(bytesWritten);
+
+    // Finalize encryption
+    result = EVP_EncryptFinal_ex(direction.mContext, ciphertext + ciphertext_length, &bytesWritten);
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    VerifyOrExit(bytesWritten >= 0, error = CHIP_ERROR_INTERNAL);
+
+    // Get tag
+    result = EVP_CIPHER_CTX_ctrl(direction.mContext, EVP_CTRL_CCM_GET_TAG, static_cast<int>(tag_length), Uint8::to_uchar(tag));
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    if (error == CHIP_ERROR_INTERNAL)
+    {
+        // The cipher state is unknown, set it up again for the next message
+        direction.mIVLength = 0;
+    }
+
+    return error;
+}
+
+CHIP_ERROR AES_CCM_Context::Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * tag, size_t tag_length, const uint8_t * iv, size_t iv_length,
+                                    uint8_t * plaintext)
+{
+    AESCCMContext * context     = to_inner_aes_ccm_context(&mContext);
+    AESCCMDirection & direction = context->mDecrypt;
+    CHIP_ERROR error            = CHIP_NO_ERROR;
+    int bytesOutput             = 0;
+    int result                  = 1;
+
+    VerifyOrExit(HasKey(), error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(ciphertext != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(ciphertext_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidTagLength(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    if (mKernel.HasKey())
+    {
+        ExitNow(error = mKernel.Decrypt(ciphertext, ciphertext_length, aad, aad_length, tag, tag_length, iv, iv_length, plaintext));
+    }
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
+    if (direction.mIVLength != iv_length || direction.mTagLength != tag_length)
+    {
+        SuccessOrExit(error = _setupAESCCMDirection(context, direction, 0, iv_length, tag_length));
+    }
+
+    // Pass in expected tag
+    // Removing "const" from |tag| here should hopefully be safe as
+    // we're writing the tag, not reading.
+    result = EVP_CIPHER_CTX_ctrl(direction.mContext, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length),
+                                 const_cast<void *>(static_cast<const void *>(tag)));
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    // Pass in iv, the key is already set up
+    result = EVP_DecryptInit_ex(direction.mContext, nullptr, nullptr, nullptr, Uint8::to_const_uchar(iv));
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    // Pass in cipher text length
+    VerifyOrExit(CanCastTo<int>(ciphertext_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    result = EVP_DecryptUpdate(direction.mContext, nullptr, &bytesOutput, nullptr, static_cast<int>(ciphertext_length));
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+    // Pass in aad
+    if (aad_length > 0 && aad != nullptr)
+    {
+        VerifyOrExit(CanCastTo<int>(aad_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+        result = EVP_DecryptUpdate(direction.mContext, nullptr, &bytesOutput, Uint8::to_const_uchar(aad),
+                                   static_cast<int>(aad_length));
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    }
+
+    // Pass in ciphertext. We wont get anything if validation fails.
+    result = EVP_DecryptUpdate(direction.mContext, Uint8::to_uchar(plaintext), &bytesOutput, Uint8::to_const_uchar(ciphertext),
+                               static_cast<int>(ciphertext_length));
+    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    if (error == CHIP_ERROR_INTERNAL)
+    {
+        // The cipher state is unknown, set it up again for the next message
+        direction.mIVLength = 0;
+    }
+
+    return error;
+}
+
+void AES_CCM_Context::Clear()
+{
+    AESCCMContext * context = to_inner_aes_ccm_context(&mContext);
+
+    _clearAESCCMDirection(context->mEncrypt);
+    _clearAESCCMDirection(context->mDecrypt);
+
+    if (context->mBlock != nullptr)
+    {
+        EVP_CIPHER_CTX_free(context->mBlock);
+        context->mBlock = nullptr;
+    }
+
+    OPENSSL_cleanse(context->mKey, sizeof(context->mKey));
+    context->mKeyLength = 0;
+    mTagLength          = 0;
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    mKernel.Clear();
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+}
+
+CHIP_ERROR AES_CCM_Context::EncryptBlock(const uint8_t * in, uint8_t * out)
+{
+    AESCCMContext * context = to_inner_aes_ccm_context(&mContext);
+    CHIP_ERROR error        = CHIP_NO_ERROR;
+    int bytesWritten        = 0;
+    int result              = 1;
+
+    if (context->mBlock == nullptr)
+    {
+        // 16 bytes key for AES-128
+        const EVP_CIPHER * type = (context->mKeyLength == 16) ? EVP_aes_128_ecb() : EVP_aes_256_ecb();
+
+        context->mBlock = EVP_CIPHER_CTX_new();
+        VerifyOrExit(context->mBlock != nullptr, error = CHIP_ERROR_INTERNAL);
+
+        result = EVP_EncryptInit_ex(context->mBlock, type, nullptr, Uint8::to_const_uchar(context->mKey), nullptr);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+
+        // Whole blocks are passed one at a time, so there is nothing to pad
+        result = EVP_CIPHER_CTX_set_padding(context->mBlock, 0);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    }
+
+    result = EVP_EncryptUpdate(context->mBlock, Uint8::to_uchar(out), &bytesWritten, Uint8::to_const_uchar(in),
+                               static_cast<int>(kBlockSize));
+    VerifyOrExit(result == 1 && bytesWritten == static_cast<int>(kBlockSize), error = CHIP_ERROR_INTERNAL);
+
+exit:
+    if (error != CHIP_NO_ERROR && context->mBlock != nullptr)
+    {
+        EVP_CIPHER_CTX_free(context->mBlock);
+        context->mBlock = nullptr;
+    }
+
+    return error;
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     CHIP_ERROR error = CHIP_NO_ERROR;
@@ -111,6 +111,17 @@ CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, c
         VerifyOrExit(aad != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
     }
 
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    if (AESCCMKernel::Supports(key_length))
+    {
+        // Expanding the key costs less than setting up a CCM context for a single message
+        AESCCMKernel kernel;
+
+        SuccessOrExit(error = kernel.SetKey(key, key_length));
+        ExitNow(error = kernel.Encrypt(plaintext, plaintext_length, aad, aad_length, iv, iv_length, ciphertext, tag, tag_length));
+    }
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
     // Size of key = key_length * number of bits in a byte (8)
     // Cast is safe because we called _isValidKeyLength above.
     result =
@@ -152,6 +163,17 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_len, co
         VerifyOrExit(aad != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
     }
 
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    if (AESCCMKernel::Supports(key_length))
+    {
+        // Expanding the key costs less than setting up a CCM context for a single message
+        AESCCMKernel kernel;
+
+        SuccessOrExit(error = kernel.SetKey(key, key_length));
+        ExitNow(error = kernel.Decrypt(ciphertext, ciphertext_len, aad, aad_len, tag, tag_length, iv, iv_length, plaintext));
+    }
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
     // Size of key = key_length * number of bits in a byte (8)
     // Cast is safe because we called _isValidKeyLength above.
     result =
@@ -170,6 +192,184 @@ exit:
     return error;
 }
 
+namespace {
+
+struct AESCCMContext
+{
+    mbedtls_ccm_context mContext; ///< holds the expanded key once mKeySet is true
+    bool mKeySet;
+};
+
+} // namespace
+
+static inline AESCCMContext * to_inner_aes_ccm_context(AESCCMOpaqueContext * context)
+{
+    nlSTATIC_ASSERT_PRINT(sizeof(AESCCMOpaqueContext) >= sizeof(AESCCMContext), "Need more memory for AES-CCM Context");
+    return reinterpret_cast<AESCCMContext *>(context->mOpaque);
+}
+
+static inline const AESCCMContext * to_inner_aes_ccm_context(const AESCCMOpaqueContext * context)
+{
+    return reinterpret_cast<const AESCCMContext *>(context->mOpaque);
+}
+
+AES_CCM_Context::AES_CCM_Context()
+{
+    AESCCMContext * context = to_inner_aes_ccm_context(&mContext);
+
+    mbedtls_ccm_init(&context->mContext);
+    context->mKeySet = false;
+}
+
+AES_CCM_Context::~AES_CCM_Context()
+{
+    mbedtls_ccm_free(&to_inner_aes_ccm_context(&mContext)->mContext);
+}
+
+CHIP_ERROR AES_CCM_Context::SetKey(const uint8_t * key, size_t key_length)
+{
+    CHIP_ERROR error        = CHIP_NO_ERROR;
+    int result              = 1;
+    AESCCMContext * context = to_inner_aes_ccm_context(&mContext);
+
+    VerifyOrExit(key != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidKeyLength(key_length), error = CHIP_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
+
+    Clear();
+
+    // Size of key = key_length * number of bits in a byte (8)
+    // Cast is safe because we called _isValidKeyLength above.
+    result = mbedtls_ccm_setkey(&context->mContext, MBEDTLS_CIPHER_ID_AES, Uint8::to_const_uchar(key),
+                                static_cast<unsigned int>(key_length * 8));
+    _log_mbedTLS_error(result);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    if (AESCCMKernel::Supports(key_length))
+    {
+        SuccessOrExit(error = mKernel.SetKey(key, key_length));
+    }
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
+    context->mKeySet = true;
+
+exit:
+    return error;
+}
+
+bool AES_CCM_Context::HasKey() const
+{
+    return to_inner_aes_ccm_context(&mContext)->mKeySet;
+}
+
+CHIP_ERROR AES_CCM_Context::Encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * iv, size_t iv_length, uint8_t * ciphertext, uint8_t * tag, size_t tag_length)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 1;
+
+    VerifyOrExit(HasKey(), error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(plaintext != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(plaintext_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidTagLength(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    if (aad_length > 0)
+    {
+        VerifyOrExit(aad != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    }
+
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    if (mKernel.HasKey())
+    {
+        ExitNow(error = mKernel.Encrypt(plaintext, plaintext_length, aad, aad_length, iv, iv_length, ciphertext, tag, tag_length));
+    }
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
+    // Encrypt, reusing the key schedule of the context
+    result = mbedtls_ccm_encrypt_and_tag(&to_inner_aes_ccm_context(&mContext)->mContext, plaintext_length,
+                                         Uint8::to_const_uchar(iv), iv_length, Uint8::to_const_uchar(aad), aad_length,
+                                         Uint8::to_const_uchar(plaintext), Uint8::to_uchar(ciphertext), Uint8::to_uchar(tag),
+                                         tag_length);
+    _log_mbedTLS_error(result);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    return error;
+}
+
+CHIP_ERROR AES_CCM_Context::Decrypt(const uint8_t * ciphertext, size_t ciphertext_length, const uint8_t * aad, size_t aad_length,
+                                    const uint8_t * tag, size_t tag_length, const uint8_t * iv, size_t iv_length,
+                                    uint8_t * plaintext)
+{
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    int result       = 1;
+
+    VerifyOrExit(HasKey(), error = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(ciphertext != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(ciphertext_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(tag != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(_isValidTagLength(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(iv_length > 0, error = CHIP_ERROR_INVALID_ARGUMENT);
+    if (aad_length > 0)
+    {
+        VerifyOrExit(aad != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
+    }
+
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    if (mKernel.HasKey())
+    {
+        ExitNow(error = mKernel.Decrypt(ciphertext, ciphertext_length, aad, aad_length, tag, tag_length, iv, iv_length, plaintext));
+    }
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
+    // Decrypt, reusing the key schedule of the context
+    result = mbedtls_ccm_auth_decrypt(&to_inner_aes_ccm_context(&mContext)->mContext, ciphertext_length,
+                                      Uint8::to_const_uchar(iv), iv_length, Uint8::to_const_uchar(aad), aad_length,
+                                      Uint8::to_const_uchar(ciphertext), Uint8::to_uchar(plaintext), Uint8::to_const_uchar(tag),
+                                      tag_length);
+    _log_mbedTLS_error(result);
+    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    return error;
+}
+
+void AES_CCM_Context::Clear()
+{
+    AESCCMContext * context = to_inner_aes_ccm_context(&mContext);
+
+    // mbedtls_ccm_free zeroizes the key schedule
+    mbedtls_ccm_free(&context->mContext);
+    mbedtls_ccm_init(&context->mContext);
+    context->mKeySet = false;
+    mTagLength       = 0;
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    mKernel.Clear();
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+}
+
+CHIP_ERROR AES_CCM_Context::EncryptBlock(const uint8_t * in, uint8_t * out)
+{
+    CHIP_ERROR error        = CHIP_NO_ERROR;
+    AESCCMContext * context = to_inner_aes_ccm_context(&mContext);
+    size_t outLength        = 0;
+    int result              = 1;
+
+    VerifyOrExit(context->mKeySet, error = CHIP_ERROR_INCORRECT_STATE);
+
+    // The CCM context keeps the expanded key in a block cipher context of its own
+    result = mbedtls_cipher_update(&context->mContext.cipher_ctx, Uint8::to_const_uchar(in), kBlockSize, Uint8::to_uchar(out),
+                                   &outLength);
+    _log_mbedTLS_error(result);
+    VerifyOrExit(result == 0 && outLength == kBlockSize, error = CHIP_ERROR_INTERNAL);
+
+exit:
+    return error;
+}
+
 CHIP_ERROR Hash_SHA256(const uint8_t * data, const size_t data_length, uint8_t * out_buffer)
 {
     CHIP_ERROR error = CHIP_NO_ERROR;
@@ -390,6 +390,305 @@ static void TestAES_CCM_128DecryptTestVectors(nlTestSuite * inSuite, void * inCo
     NL_TEST_ASSERT(inSuite, numOfTestsRan > 0);
 }
 
+static void TestAES_CCM_128ContextTestVectors(nlTestSuite * inSuite, void * inContext)
+{
+    int numOfTestVectors = ArraySize(ccm_128_test_vectors);
+    int numOfTestsRan    = 0;
+    AES_CCM_Context context;
+
+    NL_TEST_ASSERT(inSuite, !context.HasKey());
+
+    for (int vectorIndex = 0; vectorIndex < numOfTestVectors; vectorIndex++)
+    {
+        const ccm_128_test_vector * vector = ccm_128_test_vectors[vectorIndex];
+        if (vector->pt_len > 0 && vector->result == CHIP_NO_ERROR)
+        {
+            numOfTestsRan++;
+            chip::Platform::ScopedMemoryBuffer<uint8_t> out_ct;
+            out_ct.Alloc(vector->ct_len);
+            NL_TEST_ASSERT(inSuite, out_ct);
+            chip::Platform::ScopedMemoryBuffer<uint8_t> out_tag;
+            out_tag.Alloc(vector->tag_len);
+            NL_TEST_ASSERT(inSuite, out_tag);
+            chip::Platform::ScopedMemoryBuffer<uint8_t> out_pt;
+            out_pt.Alloc(vector->pt_len);
+            NL_TEST_ASSERT(inSuite, out_pt);
+
+            CHIP_ERROR err = context.SetKey(vector->key, vector->key_len);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, context.HasKey());
+
+            // Every message after the first one reuses the expanded key
+            for (int round = 0; round < 2; round++)
+            {
+                err = context.Encrypt(vector->pt, vector->pt_len, vector->aad, vector->aad_len, vector->iv, vector->iv_len,
+                                      out_ct.Get(), out_tag.Get(), vector->tag_len);
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, memcmp(out_ct.Get(), vector->ct, vector->ct_len) == 0);
+                NL_TEST_ASSERT(inSuite, memcmp(out_tag.Get(), vector->tag, vector->tag_len) == 0);
+
+                err = context.Decrypt(vector->ct, vector->ct_len, vector->aad, vector->aad_len, vector->tag, vector->tag_len,
+                                      vector->iv, vector->iv_len, out_pt.Get());
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, memcmp(out_pt.Get(), vector->pt, vector->pt_len) == 0);
+            }
+
+            // A tampered tag fails, and does not break the following messages
+            out_tag.Get()[0] ^= 0x01;
+            err = context.Decrypt(vector->ct, vector->ct_len, vector->aad, vector->aad_len, out_tag.Get(), vector->tag_len,
+                                  vector->iv, vector->iv_len, out_pt.Get());
+            NL_TEST_ASSERT(inSuite, err != CHIP_NO_ERROR);
+
+            err = context.Decrypt(vector->ct, vector->ct_len, vector->aad, vector->aad_len, vector->tag, vector->tag_len,
+                                  vector->iv, vector->iv_len, out_pt.Get());
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, memcmp(out_pt.Get(), vector->pt, vector->pt_len) == 0);
+        }
+    }
+    NL_TEST_ASSERT(inSuite, numOfTestsRan > 0);
+
+    context.Clear();
+    NL_TEST_ASSERT(inSuite, !context.HasKey());
+}
+
+static void TestAES_CCM_128IncrementalTestVectors(nlTestSuite * inSuite, void * inContext)
+{
+    int numOfTestVectors         = ArraySize(ccm_128_test_vectors);
+    int numOfTestsRan            = 0;
+    const size_t kPieceLengths[] = { 1, 5, 16, 17 };
+    AES_CCM_Context context;
+
+    for (int vectorIndex = 0; vectorIndex < numOfTestVectors; vectorIndex++)
+    {
+        const ccm_128_test_vector * vector = ccm_128_test_vectors[vectorIndex];
+        if (vector->pt_len > 0 && vector->result == CHIP_NO_ERROR)
+        {
+            numOfTestsRan++;
+            chip::Platform::ScopedMemoryBuffer<uint8_t> buffer;
+            buffer.Alloc(vector->pt_len);
+            NL_TEST_ASSERT(inSuite, buffer);
+            chip::Platform::ScopedMemoryBuffer<uint8_t> out_tag;
+            out_tag.Alloc(vector->tag_len);
+            NL_TEST_ASSERT(inSuite, out_tag);
+
+            CHIP_ERROR err = context.SetKey(vector->key, vector->key_len);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+            for (size_t pieceLength : kPieceLengths)
+            {
+                // Encrypt in place, a piece at a time
+                memcpy(buffer.Get(), vector->pt, vector->pt_len);
+
+                err = context.EncryptBegin(vector->pt_len, vector->aad, vector->aad_len, vector->iv, vector->iv_len,
+                                           vector->tag_len);
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+                for (size_t offset = 0; offset < vector->pt_len; offset += pieceLength)
+                {
+                    size_t length = (vector->pt_len - offset < pieceLength) ? vector->pt_len - offset : pieceLength;
+                    err           = context.EncryptUpdate(&buffer.Get()[offset], length, &buffer.Get()[offset]);
+                    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                }
+
+                err = context.EncryptFinish(out_tag.Get(), vector->tag_len);
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, memcmp(buffer.Get(), vector->ct, vector->ct_len) == 0);
+                NL_TEST_ASSERT(inSuite, memcmp(out_tag.Get(), vector->tag, vector->tag_len) == 0);
+
+                // And decrypt it back in place, a piece at a time
+                err = context.DecryptBegin(vector->ct_len, vector->aad, vector->aad_len, vector->iv, vector->iv_len,
+                                           vector->tag_len);
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+                for (size_t offset = 0; offset < vector->ct_len; offset += pieceLength)
+                {
+                    size_t length = (vector->ct_len - offset < pieceLength) ? vector->ct_len - offset : pieceLength;
+                    err           = context.DecryptUpdate(&buffer.Get()[offset], length, &buffer.Get()[offset]);
+                    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                }
+
+                err = context.DecryptFinish(vector->tag, vector->tag_len);
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, memcmp(buffer.Get(), vector->pt, vector->pt_len) == 0);
+            }
+
+            // A tampered tag fails
+            out_tag.Get()[0] ^= 0x01;
+            err = context.DecryptBegin(vector->ct_len, vector->aad, vector->aad_len, vector->iv, vector->iv_len, vector->tag_len);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            err = context.DecryptUpdate(vector->ct, vector->ct_len, buffer.Get());
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            err = context.DecryptFinish(out_tag.Get(), vector->tag_len);
+            NL_TEST_ASSERT(inSuite, err != CHIP_NO_ERROR);
+
+            // The tag is only available once all of the announced plaintext was passed
+            err = context.EncryptBegin(vector->pt_len, vector->aad, vector->aad_len, vector->iv, vector->iv_len, vector->tag_len);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            err = context.EncryptUpdate(vector->pt, vector->pt_len - 1, buffer.Get());
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            err = context.EncryptFinish(out_tag.Get(), vector->tag_len);
+            NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_INCORRECT_STATE);
+            err = context.EncryptUpdate(vector->pt, 1, buffer.Get());
+            NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_INCORRECT_STATE);
+        }
+    }
+    NL_TEST_ASSERT(inSuite, numOfTestsRan > 0);
+}
+
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+static void TestAES_CCM_128KernelTestVectors(nlTestSuite * inSuite, void * inContext)
+{
+    int numOfTestVectors = ArraySize(ccm_128_test_vectors);
+    int numOfTestsRan    = 0;
+    AESCCMKernel kernel;
+
+    if (!AESCCMKernel::IsSupported())
+    {
+        // The backend handles every key then
+        CHIP_ERROR err = kernel.SetKey(ccm_128_test_vectors[0]->key, ccm_128_test_vectors[0]->key_len);
+        NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
+        NL_TEST_ASSERT(inSuite, !kernel.HasKey());
+        return;
+    }
+
+    for (int vectorIndex = 0; vectorIndex < numOfTestVectors; vectorIndex++)
+    {
+        const ccm_128_test_vector * vector = ccm_128_test_vectors[vectorIndex];
+        if (vector->pt_len > 0)
+        {
+            numOfTestsRan++;
+            chip::Platform::ScopedMemoryBuffer<uint8_t> out_ct;
+            out_ct.Alloc(vector->ct_len);
+            NL_TEST_ASSERT(inSuite, out_ct);
+            chip::Platform::ScopedMemoryBuffer<uint8_t> out_tag;
+            out_tag.Alloc(vector->tag_len);
+            NL_TEST_ASSERT(inSuite, out_tag);
+            chip::Platform::ScopedMemoryBuffer<uint8_t> out_pt;
+            out_pt.Alloc(vector->pt_len);
+            NL_TEST_ASSERT(inSuite, out_pt);
+
+            CHIP_ERROR err = kernel.SetKey(vector->key, vector->key_len);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, kernel.HasKey());
+
+            if (vector->result == CHIP_NO_ERROR)
+            {
+                err = kernel.Encrypt(vector->pt, vector->pt_len, vector->aad, vector->aad_len, vector->iv, vector->iv_len,
+                                     out_ct.Get(), out_tag.Get(), vector->tag_len);
+                NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, memcmp(out_ct.Get(), vector->ct, vector->ct_len) == 0);
+                NL_TEST_ASSERT(inSuite, memcmp(out_tag.Get(), vector->tag, vector->tag_len) == 0);
+            }
+
+            err = kernel.Decrypt(vector->ct, vector->ct_len, vector->aad, vector->aad_len, vector->tag, vector->tag_len, vector->iv,
+                                 vector->iv_len, out_pt.Get());
+            NL_TEST_ASSERT(inSuite, (err == CHIP_NO_ERROR) == (vector->result == CHIP_NO_ERROR));
+            if (err == CHIP_NO_ERROR)
+            {
+                NL_TEST_ASSERT(inSuite, memcmp(out_pt.Get(), vector->pt, vector->pt_len) == 0);
+            }
+        }
+    }
+    NL_TEST_ASSERT(inSuite, numOfTestsRan > 0);
+
+    kernel.Clear();
+    NL_TEST_ASSERT(inSuite, !kernel.HasKey());
+}
+
+static void TestAES_CCM_128KernelSecureSessionLayout(nlTestSuite * inSuite, void * inContext)
+{
+    // Packet vector #1 of RFC 3610, with a 13 bytes nonce
+    const uint8_t kKey[]        = { 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+                                    0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf };
+    const uint8_t kNonce[]      = { 0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5 };
+    const uint8_t kAAD[]        = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 };
+    const uint8_t kPlaintext[]  = { 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13,
+                                    0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e };
+    const uint8_t kCiphertext[] = { 0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2, 0xf0, 0x66, 0xd0, 0xc2,
+                                    0xc0, 0xf9, 0x89, 0x80, 0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84 };
+    const uint8_t kTag[]        = { 0x17, 0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0 };
+
+    // Messages the length of a few blocks and partial blocks, with a header as AAD, under the 16 bytes tag of SecureSession
+    const size_t kMaxLength    = 80;
+    const size_t kAADLengths[] = { 0, 8, 14, 24 };
+    const size_t kTagLength    = 16;
+    AESCCMKernel kernel;
+    AES_CCM_Context context;
+    uint8_t message[kMaxLength];
+    uint8_t aad[32];
+    uint8_t out[sizeof(kCiphertext)];
+    uint8_t tag[kTagLength];
+    CHIP_ERROR err;
+
+    if (!AESCCMKernel::IsSupported())
+    {
+        return;
+    }
+
+    err = kernel.SetKey(kKey, sizeof(kKey));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = kernel.Encrypt(kPlaintext, sizeof(kPlaintext), kAAD, sizeof(kAAD), kNonce, sizeof(kNonce), out, tag, sizeof(kTag));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, memcmp(out, kCiphertext, sizeof(kCiphertext)) == 0);
+    NL_TEST_ASSERT(inSuite, memcmp(tag, kTag, sizeof(kTag)) == 0);
+
+    // Compare with the incremental encryption of the context, which goes through the block cipher of the backend
+    err = context.SetKey(kKey, sizeof(kKey));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    for (size_t i = 0; i < sizeof(aad); i++)
+    {
+        aad[i] = static_cast<uint8_t>(0xa0 + i);
+    }
+
+    for (size_t aadLength : kAADLengths)
+    {
+        for (size_t length = 1; length <= kMaxLength; length++)
+        {
+            uint8_t expected[kMaxLength];
+            uint8_t expectedTag[kTagLength];
+
+            for (size_t i = 0; i < length; i++)
+            {
+                message[i] = static_cast<uint8_t>(i * 7 + length);
+            }
+
+            err = context.EncryptBegin(length, aad, aadLength, kNonce, sizeof(kNonce), kTagLength);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            err = context.EncryptUpdate(message, length, expected);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            err = context.EncryptFinish(expectedTag, kTagLength);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+            // In place, as SecureSession does
+            err = kernel.Encrypt(message, length, aad, aadLength, kNonce, sizeof(kNonce), message, tag, kTagLength);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, memcmp(message, expected, length) == 0);
+            NL_TEST_ASSERT(inSuite, memcmp(tag, expectedTag, kTagLength) == 0);
+
+            err = kernel.Decrypt(message, length, aad, aadLength, tag, kTagLength, kNonce, sizeof(kNonce), message);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+            for (size_t i = 0; i < length; i++)
+            {
+                NL_TEST_ASSERT(inSuite, message[i] == static_cast<uint8_t>(i * 7 + length));
+            }
+
+            // A tampered tag fails, and the plaintext is not handed out
+            tag[kTagLength - 1] ^= 0x80;
+            err = kernel.Decrypt(expected, length, aad, aadLength, tag, kTagLength, kNonce, sizeof(kNonce), message);
+            NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_INTERNAL);
+            for (size_t i = 0; i < length; i++)
+            {
+                NL_TEST_ASSERT(inSuite, message[i] == 0);
+            }
+        }
+    }
+
+    // Nonces longer than 13 bytes leave no room for the counter
+    err = kernel.Encrypt(message, 16, aad, 0, aad, 14, out, tag, kTagLength);
+    NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_INVALID_ARGUMENT);
+}
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
+
 static void TestAES_CCM_128EncryptInvalidPlainText(nlTestSuite * inSuite, void * inContext)
 {
     int numOfTestVectors = ArraySize(ccm_128_test_vectors);
@@ -1373,6 +1672,12 @@ static const nlTest sTests[] = {
 
     NL_TEST_DEF("Test encrypting AES-CCM-128 test vectors", TestAES_CCM_128EncryptTestVectors),
     NL_TEST_DEF("Test decrypting AES-CCM-128 test vectors", TestAES_CCM_128DecryptTestVectors),
+    NL_TEST_DEF("Test AES-CCM-128 test vectors with a reused context", TestAES_CCM_128ContextTestVectors),
+    NL_TEST_DEF("Test AES-CCM-128 test vectors processed in pieces", TestAES_CCM_128IncrementalTestVectors),
+#if CHIP_CRYPTO_AES_CCM_KERNEL
+    NL_TEST_DEF("Test AES-CCM-128 test vectors with the kernel", TestAES_CCM_128KernelTestVectors),
+    NL_TEST_DEF("Test AES-CCM-128 kernel with the nonce and tag of SecureSession", TestAES_CCM_128KernelSecureSessionLayout),
+#endif // CHIP_CRYPTO_AES_CCM_KERNEL
     NL_TEST_DEF("Test encrypting AES-CCM-128 invalid plain text", TestAES_CCM_128EncryptInvalidPlainText),
     NL_TEST_DEF("Test encrypting AES-CCM-128 using nil key", TestAES_CCM_128EncryptNilKey),
     NL_TEST_DEF("Test encrypting AES-CCM-128 using invalid IV", TestAES_CCM_128EncryptInvalidIVLen),
@@ -57,6 +57,7 @@ CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_InitChipStack()
     CHIP_ERROR err = CHIP_NO_ERROR;
 
     mChipStackLock = PTHREAD_MUTEX_INITIALIZER;
+    mChipEventsPending.store(false, std::memory_order_relaxed);
 
     // Call up to the base class _InitChipStack() to perform the bulk of the initialization.
     err = GenericPlatformManagerImpl<ImplClass>::_InitChipStack();
@@ -98,17 +99,31 @@ CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_StartChipTimer(int64_t
 template <class ImplClass>
 void GenericPlatformManagerImpl_POSIX<ImplClass>::_PostEvent(const ChipDeviceEvent * event)
 {
-    mChipEventQueue.push(*event); // Thread safe due to ChipStackLock taken by App thread
-    SysOnEventSignal(this);       // Trigger wake select on CHIP thread
+    // May be called from any thread, without holding the CHIP stack lock.
+    if (!mChipEventQueue.TryPush(*event))
+    {
+        ChipLogError(DeviceLayer, "Failed to post event to CHIP Platform event queue");
+        return;
+    }
+
+    // Only the first event posted since the queue was last drained needs to wake the CHIP thread.
+    if (!mChipEventsPending.exchange(true, std::memory_order_acq_rel))
+    {
+        SysOnEventSignal(this); // Trigger wake select on CHIP thread
+    }
 }
 
 template <class ImplClass>
 void GenericPlatformManagerImpl_POSIX<ImplClass>::ProcessDeviceEvents()
 {
-    while (!mChipEventQueue.empty())
+    ChipDeviceEvent event;
+
+    // Re-arm the wake-up before draining, so that an event posted after the queue was found empty wakes the loop again.
+    mChipEventsPending.exchange(false, std::memory_order_acq_rel);
+
+    while (mChipEventQueue.TryPop(event))
     {
-        Impl()->DispatchEvent(&mChipEventQueue.front());
-        mChipEventQueue.pop();
+        Impl()->DispatchEvent(&event);
     }
 }
 
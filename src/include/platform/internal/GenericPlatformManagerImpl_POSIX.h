@@ -25,6 +25,7 @@
 #pragma once
 
 #include <platform/internal/GenericPlatformManagerImpl.h>
+#include <support/MPSCQueue.h>
 
 #include <fcntl.h>
 #include <sched.h>
@@ -34,7 +35,6 @@
 
 #include <atomic>
 #include <pthread.h>
-#include <queue>
 
 namespace chip {
 namespace DeviceLayer {
@@ -61,7 +61,8 @@ protected:
 
     // OS-specific members (pthread)
     pthread_mutex_t mChipStackLock;
-    std::queue<ChipDeviceEvent> mChipEventQueue;
+    MPSCQueue<ChipDeviceEvent, CHIP_DEVICE_CONFIG_MAX_EVENT_QUEUE_SIZE> mChipEventQueue;
+    std::atomic<bool> mChipEventsPending; // set by the first event posted since the event loop last drained the queue
 
     pthread_t mChipTask;
     pthread_attr_t mChipTaskAttr;
@@ -27,6 +27,9 @@
 
 #include <inet/InetLayer.h>
 
+#include <support/ErrorStr.h>
+#include <support/logging/CHIPLogging.h>
+
 namespace chip {
 namespace Inet {
 
@@ -41,8 +44,61 @@ void EndPointBasis::InitEndPointBasis(InetLayer & aInetLayer, void * aAppState)
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS
     mSocket = INET_INVALID_SOCKET_FD;
     mPendingIO.Clear();
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    mWatchedIO.Clear();
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 }
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+/**
+ *  Bring the epoll registration of the socket in line with the events the endpoint is interested in.
+ *
+ *  The System Layer is only called when the interest differs from the current registration. A socket without any interest
+ *  is not registered at all, since epoll would otherwise keep reporting a hung up socket.
+ *
+ *  @param[in]    aInterest   The events the endpoint is interested in, as returned by its PrepareIO() method.
+ *
+ */
+void EndPointBasis::WatchSocket(SocketEvents aInterest)
+{
+    chip::System::Layer & lSystemLayer = SystemLayer();
+    INET_ERROR lError                  = INET_NO_ERROR;
+
+    if (mSocket == INET_INVALID_SOCKET_FD || aInterest.Value == mWatchedIO.Value)
+        return;
+
+    if (!aInterest.IsSet())
+        lError = lSystemLayer.UnwatchSocket(mSocket, this);
+    else if (!mWatchedIO.IsSet())
+        lError = lSystemLayer.WatchSocket(mSocket, aInterest.ToEpollEvents(), this);
+    else
+        lError = lSystemLayer.UpdateSocketWatch(mSocket, aInterest.ToEpollEvents(), this);
+
+    if (lError != INET_NO_ERROR)
+    {
+        // Keep the previous registration, so that the update is retried on the next event loop iteration.
+        ChipLogError(Inet, "Failed to watch socket %d: %s", mSocket, ErrorStr(lError));
+        return;
+    }
+
+    mWatchedIO = aInterest;
+}
+
+/**
+ *  Remove the epoll registration of the socket, if any. This must be called before the socket is closed.
+ *
+ */
+void EndPointBasis::UnwatchSocket()
+{
+    if (mSocket != INET_INVALID_SOCKET_FD && mWatchedIO.IsSet())
+    {
+        SystemLayer().UnwatchSocket(mSocket, this);
+    }
+
+    mWatchedIO.Clear();
+}
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
 } // namespace Inet
 } // namespace chip
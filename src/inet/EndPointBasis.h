@@ -61,6 +61,8 @@ namespace Inet {
  */
 class DLL_EXPORT EndPointBasis : public InetLayerBasis
 {
+    friend class InetLayer;
+
 public:
     /** Common state codes */
     enum
@@ -96,6 +98,9 @@ protected:
     int mSocket;             /**< Encapsulated socket descriptor. */
     IPAddressType mAddrType; /**< Protocol family, i.e. IPv4 or IPv6. */
     SocketEvents mPendingIO; /**< Socket event masks */
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    SocketEvents mWatchedIO; /**< Socket events registered with the System Layer epoll instance */
+#endif                       // CHIP_SYSTEM_CONFIG_USE_EPOLL
 #endif                       // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
@@ -130,6 +135,11 @@ protected:
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 
     void InitEndPointBasis(InetLayer & aInetLayer, void * aAppState = nullptr);
+
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    void WatchSocket(SocketEvents aInterest);
+    void UnwatchSocket();
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
 };
 
 #if CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
@@ -108,6 +108,124 @@ union PeerSockAddr
     sockaddr_in in;
     sockaddr_in6 in6;
 };
+
+/// Storage referenced by the message header of a datagram being sent.
+struct IPEndPointBasis::SendMsgScratch
+{
+    struct msghdr mHeader;
+    struct iovec mIOV[INET_CONFIG_MAX_SEND_SEGMENTS];
+    PeerSockAddr mPeerSockAddr;
+    union
+    {
+        struct cmsghdr mAlign;
+        uint8_t mControlData[64]; ///< room for one IP_PKTINFO or IPV6_PKTINFO control message
+    };
+};
+
+namespace {
+
+/// A datagram being received, along with the storage referenced by its message header.
+struct ReceiveMsgScratch
+{
+    System::PacketBufferHandle mBuffer;
+    struct msghdr mHeader;
+    struct iovec mIOV;
+    PeerSockAddr mPeerSockAddr;
+    size_t mLength;
+    union
+    {
+        struct cmsghdr mAlign;
+        uint8_t mControlData[64]; ///< room for the IP_PKTINFO or IPV6_PKTINFO control message requested on the socket
+    };
+
+    void Prepare()
+    {
+        mIOV.iov_base = mBuffer->Start();
+        mIOV.iov_len  = mBuffer->AvailableDataLength();
+
+        memset(&mPeerSockAddr, 0, sizeof(mPeerSockAddr));
+        memset(&mHeader, 0, sizeof(mHeader));
+
+        mHeader.msg_name       = &mPeerSockAddr;
+        mHeader.msg_namelen    = sizeof(mPeerSockAddr);
+        mHeader.msg_iov        = &mIOV;
+        mHeader.msg_iovlen     = 1;
+        mHeader.msg_control    = mControlData;
+        mHeader.msg_controllen = sizeof(mControlData);
+        mLength                = 0;
+    }
+};
+
+/**
+ *  Sets the data length of a received datagram, and fills in the source and
+ *  destination information of \c aPacketInfo from its message header.
+ */
+INET_ERROR DecodeReceivedMsg(ReceiveMsgScratch & aScratch, IPPacketInfo & aPacketInfo)
+{
+    const PeerSockAddr & lPeerSockAddr = aScratch.mPeerSockAddr;
+
+    if (aScratch.mLength > aScratch.mBuffer->AvailableDataLength())
+    {
+        return INET_ERROR_INBOUND_MESSAGE_TOO_BIG;
+    }
+
+    aScratch.mBuffer->SetDataLength(static_cast<uint16_t>(aScratch.mLength));
+
+    if (lPeerSockAddr.any.sa_family == AF_INET6)
+    {
+        aPacketInfo.SrcAddress = IPAddress::FromIPv6(lPeerSockAddr.in6.sin6_addr);
+        aPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in6.sin6_port);
+    }
+#if INET_CONFIG_ENABLE_IPV4
+    else if (lPeerSockAddr.any.sa_family == AF_INET)
+    {
+        aPacketInfo.SrcAddress = IPAddress::FromIPv4(lPeerSockAddr.in.sin_addr);
+        aPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in.sin_port);
+    }
+#endif // INET_CONFIG_ENABLE_IPV4
+    else
+    {
+        return INET_ERROR_INCORRECT_STATE;
+    }
+
+    for (struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&aScratch.mHeader); controlHdr != nullptr;
+         controlHdr                  = CMSG_NXTHDR(&aScratch.mHeader, controlHdr))
+    {
+#if INET_CONFIG_ENABLE_IPV4
+#ifdef IP_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
+        {
+            struct in_pktinfo * inPktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
+            if (!CanCastTo<InterfaceId>(inPktInfo->ipi_ifindex))
+            {
+                return INET_ERROR_INCORRECT_STATE;
+            }
+            aPacketInfo.Interface   = static_cast<InterfaceId>(inPktInfo->ipi_ifindex);
+            aPacketInfo.DestAddress = IPAddress::FromIPv4(inPktInfo->ipi_addr);
+            continue;
+        }
+#endif // defined(IP_PKTINFO)
+#endif // INET_CONFIG_ENABLE_IPV4
+
+#ifdef IPV6_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
+        {
+            struct in6_pktinfo * in6PktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
+            if (!CanCastTo<InterfaceId>(in6PktInfo->ipi6_ifindex))
+            {
+                return INET_ERROR_INCORRECT_STATE;
+            }
+            aPacketInfo.Interface   = static_cast<InterfaceId>(in6PktInfo->ipi6_ifindex);
+            aPacketInfo.DestAddress = IPAddress::FromIPv6(in6PktInfo->ipi6_addr);
+            continue;
+        }
+#endif // defined(IPV6_PKTINFO)
+    }
+
+    return INET_NO_ERROR;
+}
+
+} // namespace
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
@@ -604,7 +722,9 @@ void IPEndPointBasis::Init(InetLayer * aInetLayer)
     InitEndPointBasis(*aInetLayer);
 
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS
-    mBoundIntfId = INET_NULL_INTERFACEID;
+    mBoundIntfId      = INET_NULL_INTERFACEID;
+    mReceiveBatchSize = INET_CONFIG_UDP_RECEIVE_BATCH_SIZE;
+    mReceiveBatchFill = 1;
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 }
 
@@ -793,27 +913,43 @@ INET_ERROR IPEndPointBasis::BindInterface(IPAddressType aAddressType, InterfaceI
     return (lRetval);
 }
 
-INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo * aPktInfo, chip::System::PacketBuffer * aBuffer, uint16_t aSendFlags)
+/**
+ *  Fills in the message header of \c aScratch to send \c aBuffer as described
+ *  by \c aPktInfo, without sending it yet.
+ */
+INET_ERROR IPEndPointBasis::PrepareSendMsg(const IPPacketInfo * aPktInfo, chip::System::PacketBuffer * aBuffer,
+                                           SendMsgScratch & aScratch)
 {
-    INET_ERROR res = INET_NO_ERROR;
-    PeerSockAddr peerSockAddr;
-    struct iovec msgIOV;
-    uint8_t controlData[256];
-    struct msghdr msgHeader;
-    InterfaceId intfId = aPktInfo->Interface;
+    INET_ERROR res              = INET_NO_ERROR;
+    PeerSockAddr & peerSockAddr = aScratch.mPeerSockAddr;
+    struct iovec * msgIOV       = aScratch.mIOV;
+    size_t msgIOVCount          = 0;
+    uint8_t * controlData       = aScratch.mControlData;
+    struct msghdr & msgHeader   = aScratch.mHeader;
+    InterfaceId intfId          = aPktInfo->Interface;
 
     // Ensure the destination address type is compatible with the endpoint address type.
     VerifyOrExit(mAddrType == aPktInfo->DestAddress.Type(), res = INET_ERROR_BAD_ARGS);
 
-    // For now the entire message must fit within a single buffer.
-    VerifyOrExit(aBuffer->Next() == nullptr, res = INET_ERROR_MESSAGE_TOO_LONG);
-
     memset(&msgHeader, 0, sizeof(msgHeader));
 
-    msgIOV.iov_base      = aBuffer->Start();
-    msgIOV.iov_len       = aBuffer->DataLength();
-    msgHeader.msg_iov    = &msgIOV;
-    msgHeader.msg_iovlen = 1;
+    // Gather the buffers of the chain, so the message is sent without coalescing it first.
+    for (chip::System::PacketBuffer * segment = aBuffer; segment != nullptr; segment = segment->Next())
+    {
+        if (segment->DataLength() == 0)
+        {
+            continue;
+        }
+
+        VerifyOrExit(msgIOVCount < INET_CONFIG_MAX_SEND_SEGMENTS, res = INET_ERROR_MESSAGE_TOO_LONG);
+
+        msgIOV[msgIOVCount].iov_base = segment->Start();
+        msgIOV[msgIOVCount].iov_len  = segment->DataLength();
+        msgIOVCount++;
+    }
+
+    msgHeader.msg_iov    = msgIOV;
+    msgHeader.msg_iovlen = static_cast<decltype(msgHeader.msg_iovlen)>(msgIOVCount);
 
     // Construct a sockaddr_in/sockaddr_in6 structure containing the destination information.
     memset(&peerSockAddr, 0, sizeof(peerSockAddr));
@@ -853,9 +989,9 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo * aPktInfo, chip::System:
     if (intfId != INET_NULL_INTERFACEID || aPktInfo->SrcAddress.Type() != kIPAddressType_Any)
     {
 #if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
-        memset(controlData, 0, sizeof(controlData));
+        memset(controlData, 0, sizeof(aScratch.mControlData));
         msgHeader.msg_control    = controlData;
-        msgHeader.msg_controllen = sizeof(controlData);
+        msgHeader.msg_controllen = sizeof(aScratch.mControlData);
 
         struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&msgHeader);
 
@@ -912,12 +1048,22 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo * aPktInfo, chip::System:
 #endif // !(defined(IP_PKTINFO) && defined(IPV6_PKTINFO))
     }
 
+exit:
+    return (res);
+}
+
+INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo * aPktInfo, chip::System::PacketBuffer * aBuffer, uint16_t aSendFlags)
+{
+    SendMsgScratch lScratch;
+    INET_ERROR res = PrepareSendMsg(aPktInfo, aBuffer, lScratch);
+    SuccessOrExit(res);
+
     // Send IP packet.
     {
-        const ssize_t lenSent = sendmsg(mSocket, &msgHeader, 0);
+        const ssize_t lenSent = sendmsg(mSocket, &lScratch.mHeader, 0);
         if (lenSent == -1)
             res = chip::System::MapErrorPOSIX(errno);
-        else if (lenSent != aBuffer->DataLength())
+        else if (lenSent != aBuffer->TotalLength())
             res = INET_ERROR_OUTBOUND_MESSAGE_TRUNCATED;
     }
 
@@ -925,6 +1071,91 @@ exit:
     return (res);
 }
 
+/**
+ *  Sends several datagrams, with as few system calls as possible.
+ *
+ *  A datagram that fails to send does not keep the following ones from
+ *  being sent. The error of the first datagram that failed is returned,
+ *  and \c aSentCount is set to the number of datagrams that were sent.
+ */
+INET_ERROR IPEndPointBasis::SendMsgs(const IPPacketInfo * aPktInfos, chip::System::PacketBuffer * const * aBuffers, size_t aCount,
+                                     size_t & aSentCount)
+{
+    INET_ERROR res = INET_NO_ERROR;
+
+    aSentCount = 0;
+
+#if HAVE_SENDMMSG
+    SendMsgScratch lScratch[INET_CONFIG_UDP_SEND_BATCH_SIZE];
+    struct mmsghdr lMsgs[INET_CONFIG_UDP_SEND_BATCH_SIZE];
+    size_t lNext = 0;
+
+    while (lNext < aCount)
+    {
+        INET_ERROR lPrepareErr = INET_NO_ERROR;
+        size_t lBatchCount     = 0;
+        size_t lDone           = 0;
+
+        // Gather datagrams until the batch is full, or one of them can not be sent.
+        while (lNext + lBatchCount < aCount && lBatchCount < INET_CONFIG_UDP_SEND_BATCH_SIZE)
+        {
+            lPrepareErr = PrepareSendMsg(&aPktInfos[lNext + lBatchCount], aBuffers[lNext + lBatchCount], lScratch[lBatchCount]);
+            if (lPrepareErr != INET_NO_ERROR)
+                break;
+
+            lMsgs[lBatchCount].msg_hdr = lScratch[lBatchCount].mHeader;
+            lMsgs[lBatchCount].msg_len = 0;
+            lBatchCount++;
+        }
+
+        // sendmmsg() stops at the first datagram that fails, which is then skipped.
+        while (lDone < lBatchCount)
+        {
+            const int lSent = sendmmsg(mSocket, &lMsgs[lDone], static_cast<unsigned int>(lBatchCount - lDone), 0);
+
+            if (lSent <= 0)
+            {
+                if (res == INET_NO_ERROR)
+                    res = (lSent < 0) ? chip::System::MapErrorPOSIX(errno) : INET_ERROR_OUTBOUND_MESSAGE_TRUNCATED;
+                lDone++;
+                continue;
+            }
+
+            for (size_t i = lDone; i < lDone + static_cast<size_t>(lSent); i++)
+            {
+                if (lMsgs[i].msg_len == aBuffers[lNext + i]->TotalLength())
+                    aSentCount++;
+                else if (res == INET_NO_ERROR)
+                    res = INET_ERROR_OUTBOUND_MESSAGE_TRUNCATED;
+            }
+
+            lDone += static_cast<size_t>(lSent);
+        }
+
+        lNext += lBatchCount;
+
+        if (lPrepareErr != INET_NO_ERROR)
+        {
+            if (res == INET_NO_ERROR)
+                res = lPrepareErr;
+            lNext++;
+        }
+    }
+#else  // !HAVE_SENDMMSG
+    for (size_t i = 0; i < aCount; i++)
+    {
+        INET_ERROR lErr = SendMsg(&aPktInfos[i], aBuffers[i], 0);
+
+        if (lErr == INET_NO_ERROR)
+            aSentCount++;
+        else if (res == INET_NO_ERROR)
+            res = lErr;
+    }
+#endif // !HAVE_SENDMMSG
+
+    return (res);
+}
+
 INET_ERROR IPEndPointBasis::GetSocket(IPAddressType aAddressType, int aType, int aProtocol)
 {
     INET_ERROR res = INET_NO_ERROR;
@@ -1050,120 +1281,139 @@ SocketEvents IPEndPointBasis::PrepareIO()
 void IPEndPointBasis::HandlePendingIO(uint16_t aPort)
 {
     INET_ERROR lStatus = INET_NO_ERROR;
-    IPPacketInfo lPacketInfo;
-    System::PacketBufferHandle lBuffer;
+    ReceiveMsgScratch lScratch[INET_CONFIG_UDP_RECEIVE_BATCH_SIZE];
+    size_t lBatchSize = mReceiveBatchSize;
+    size_t lCount     = 0;
+    size_t lReceived  = 0;
 
-    lPacketInfo.Clear();
-    lPacketInfo.DestPort = aPort;
-
-    lBuffer = PacketBuffer::New(0);
+    if (lBatchSize == 0 || lBatchSize > INET_CONFIG_UDP_RECEIVE_BATCH_SIZE)
+    {
+        lBatchSize = INET_CONFIG_UDP_RECEIVE_BATCH_SIZE;
+    }
 
-    if (!lBuffer.IsNull())
+    if (mReceiveBatchFill < lBatchSize)
     {
-        struct iovec msgIOV;
-        PeerSockAddr lPeerSockAddr;
-        uint8_t controlData[256];
-        struct msghdr msgHeader;
+        lBatchSize = (mReceiveBatchFill > 0) ? mReceiveBatchFill : 1;
+    }
 
-        msgIOV.iov_base = lBuffer->Start();
-        msgIOV.iov_len  = lBuffer->AvailableDataLength();
+    // Allocate a buffer for as many datagrams as the previous readable event found, so a burst can be read at once
+    // without holding buffers for datagrams that are not there.
+    while (lCount < lBatchSize)
+    {
+        lScratch[lCount].mBuffer = PacketBuffer::New(0);
+        if (lScratch[lCount].mBuffer.IsNull())
+            break;
 
-        memset(&lPeerSockAddr, 0, sizeof(lPeerSockAddr));
+        lScratch[lCount].Prepare();
+        lCount++;
+    }
 
-        memset(&msgHeader, 0, sizeof(msgHeader));
+    if (lCount == 0)
+    {
+        lStatus = INET_ERROR_NO_MEMORY;
+    }
+#if HAVE_RECVMMSG
+    else if (lCount > 1)
+    {
+        struct mmsghdr lMsgs[INET_CONFIG_UDP_RECEIVE_BATCH_SIZE];
 
-        msgHeader.msg_name       = &lPeerSockAddr;
-        msgHeader.msg_namelen    = sizeof(lPeerSockAddr);
-        msgHeader.msg_iov        = &msgIOV;
-        msgHeader.msg_iovlen     = 1;
-        msgHeader.msg_control    = controlData;
-        msgHeader.msg_controllen = sizeof(controlData);
+        for (size_t i = 0; i < lCount; i++)
+        {
+            lMsgs[i].msg_hdr = lScratch[i].mHeader;
+            lMsgs[i].msg_len = 0;
+        }
 
-        ssize_t rcvLen = recvmsg(mSocket, &msgHeader, MSG_DONTWAIT);
+        const int lResult = recvmmsg(mSocket, lMsgs, static_cast<unsigned int>(lCount), MSG_DONTWAIT, nullptr);
 
-        if (rcvLen < 0)
+        if (lResult < 0)
         {
             lStatus = chip::System::MapErrorPOSIX(errno);
         }
-        else if (rcvLen > lBuffer->AvailableDataLength())
-        {
-            lStatus = INET_ERROR_INBOUND_MESSAGE_TOO_BIG;
-        }
         else
         {
-            lBuffer->SetDataLength(static_cast<uint16_t>(rcvLen));
+            lReceived = static_cast<size_t>(lResult);
 
-            if (lPeerSockAddr.any.sa_family == AF_INET6)
-            {
-                lPacketInfo.SrcAddress = IPAddress::FromIPv6(lPeerSockAddr.in6.sin6_addr);
-                lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in6.sin6_port);
-            }
-#if INET_CONFIG_ENABLE_IPV4
-            else if (lPeerSockAddr.any.sa_family == AF_INET)
+            for (size_t i = 0; i < lReceived; i++)
             {
-                lPacketInfo.SrcAddress = IPAddress::FromIPv4(lPeerSockAddr.in.sin_addr);
-                lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in.sin_port);
+                lScratch[i].mHeader = lMsgs[i].msg_hdr;
+                lScratch[i].mLength = lMsgs[i].msg_len;
             }
-#endif // INET_CONFIG_ENABLE_IPV4
-            else
+        }
+    }
+#endif // HAVE_RECVMMSG
+    else
+    {
+        // Without recvmmsg(), read datagrams one by one until the socket runs dry.
+        while (lReceived < lCount)
+        {
+            ssize_t rcvLen = recvmsg(mSocket, &lScratch[lReceived].mHeader, MSG_DONTWAIT);
+
+            if (rcvLen < 0)
             {
-                lStatus = INET_ERROR_INCORRECT_STATE;
+                if (lReceived == 0)
+                    lStatus = chip::System::MapErrorPOSIX(errno);
+                break;
             }
+
+            lScratch[lReceived].mLength = static_cast<size_t>(rcvLen);
+            lReceived++;
         }
+    }
 
-        if (lStatus == INET_NO_ERROR)
-        {
-            for (struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&msgHeader); controlHdr != nullptr;
-                 controlHdr                  = CMSG_NXTHDR(&msgHeader, controlHdr))
-            {
-#if INET_CONFIG_ENABLE_IPV4
-#ifdef IP_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
-                {
-                    struct in_pktinfo * inPktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
-                    if (!CanCastTo<InterfaceId>(inPktInfo->ipi_ifindex))
-                    {
-                        lStatus = INET_ERROR_INCORRECT_STATE;
-                        break;
-                    }
-                    lPacketInfo.Interface   = static_cast<InterfaceId>(inPktInfo->ipi_ifindex);
-                    lPacketInfo.DestAddress = IPAddress::FromIPv4(inPktInfo->ipi_addr);
-                    continue;
-                }
-#endif // defined(IP_PKTINFO)
-#endif // INET_CONFIG_ENABLE_IPV4
+    // Twice as many buffers are allocated next time while a burst fills them all, as few as were used otherwise.
+    if (lStatus == INET_NO_ERROR && lReceived == lCount)
+    {
+        int lPending = 1;
 
-#ifdef IPV6_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
-                {
-                    struct in6_pktinfo * in6PktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
-                    if (!CanCastTo<InterfaceId>(in6PktInfo->ipi6_ifindex))
-                    {
-                        lStatus = INET_ERROR_INCORRECT_STATE;
-                        break;
-                    }
-                    lPacketInfo.Interface   = static_cast<InterfaceId>(in6PktInfo->ipi6_ifindex);
-                    lPacketInfo.DestAddress = IPAddress::FromIPv6(in6PktInfo->ipi6_addr);
-                    continue;
-                }
-#endif // defined(IPV6_PKTINFO)
-            }
+#ifdef FIONREAD
+        // One datagram per event is the common case, so only grow if another one is already waiting.
+        if (ioctl(mSocket, FIONREAD, &lPending) != 0)
+            lPending = 1;
+#endif // defined(FIONREAD)
+
+        size_t lNextFill = (lPending > 0) ? 2 * lCount : lCount;
+
+        if (lNextFill > INET_CONFIG_UDP_RECEIVE_BATCH_SIZE)
+        {
+            lNextFill = INET_CONFIG_UDP_RECEIVE_BATCH_SIZE;
         }
+        mReceiveBatchFill = static_cast<uint8_t>(lNextFill);
     }
-    else
+    else if (lCount > 0)
     {
-        lStatus = INET_ERROR_NO_MEMORY;
+        mReceiveBatchFill = static_cast<uint8_t>((lReceived > 0) ? lReceived : 1);
     }
 
-    if (lStatus == INET_NO_ERROR)
+    if (lStatus != INET_NO_ERROR)
     {
-        OnMessageReceived(this, std::move(lBuffer), &lPacketInfo);
+        if (OnReceiveError != nullptr && lStatus != chip::System::MapErrorPOSIX(EAGAIN))
+            OnReceiveError(this, lStatus, nullptr);
+        return;
     }
-    else
+
+    // A handler may close the end point, so hold on to it until the whole batch was dispatched.
+    Retain();
+
+    for (size_t i = 0; i < lReceived && mState == kState_Listening && OnMessageReceived != nullptr; i++)
     {
-        if (OnReceiveError != nullptr && lStatus != chip::System::MapErrorPOSIX(EAGAIN))
+        IPPacketInfo lPacketInfo;
+
+        lPacketInfo.Clear();
+        lPacketInfo.DestPort = aPort;
+
+        lStatus = DecodeReceivedMsg(lScratch[i], lPacketInfo);
+
+        if (lStatus == INET_NO_ERROR)
+        {
+            OnMessageReceived(this, std::move(lScratch[i].mBuffer), &lPacketInfo);
+        }
+        else if (OnReceiveError != nullptr)
+        {
             OnReceiveError(this, lStatus, nullptr);
+        }
     }
+
+    Release();
 }
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 
@@ -131,10 +131,14 @@ protected:
 
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS
     InterfaceId mBoundIntfId;
+    uint8_t mReceiveBatchSize; ///< number of datagrams read per readable event, at most INET_CONFIG_UDP_RECEIVE_BATCH_SIZE
+    uint8_t mReceiveBatchFill; ///< buffers allocated on the next readable event, grown while datagrams arrive in bursts
 
     INET_ERROR Bind(IPAddressType aAddressType, const IPAddress & aAddress, uint16_t aPort, InterfaceId aInterfaceId);
     INET_ERROR BindInterface(IPAddressType aAddressType, InterfaceId aInterfaceId);
     INET_ERROR SendMsg(const IPPacketInfo * aPktInfo, chip::System::PacketBuffer * aBuffer, uint16_t aSendFlags);
+    INET_ERROR SendMsgs(const IPPacketInfo * aPktInfos, chip::System::PacketBuffer * const * aBuffers, size_t aCount,
+                        size_t & aSentCount);
     INET_ERROR GetSocket(IPAddressType aAddressType, int aType, int aProtocol);
     SocketEvents PrepareIO();
     void HandlePendingIO(uint16_t aPort);
@@ -165,6 +169,12 @@ protected:
 #endif // CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
 
 private:
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS
+    struct SendMsgScratch;
+
+    INET_ERROR PrepareSendMsg(const IPPacketInfo * aPktInfo, chip::System::PacketBuffer * aBuffer, SendMsgScratch & aScratch);
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
     IPEndPointBasis()                        = delete;
     IPEndPointBasis(const IPEndPointBasis &) = delete;
     ~IPEndPointBasis()                       = delete;
@@ -259,6 +259,61 @@
 #define INET_CONFIG_NUM_UDP_ENDPOINTS                       64
 #endif // INET_CONFIG_NUM_UDP_ENDPOINTS
 
+/**
+ *  @def INET_CONFIG_MAX_SEND_SEGMENTS
+ *
+ *  @brief
+ *    This is the maximum number of buffers in a chain that UDP and raw
+ *    end points hand to a single sendmsg() call, when using sockets.
+ *
+ *    Chains of more buffers are rejected with
+ *    #INET_ERROR_MESSAGE_TOO_LONG, as they would otherwise need to be
+ *    copied into one buffer.
+ *
+ */
+#ifndef INET_CONFIG_MAX_SEND_SEGMENTS
+#define INET_CONFIG_MAX_SEND_SEGMENTS                       8
+#endif // INET_CONFIG_MAX_SEND_SEGMENTS
+
+/**
+ *  @def INET_CONFIG_UDP_RECEIVE_BATCH_SIZE
+ *
+ *  @brief
+ *    This is the maximum number of datagrams that UDP and raw end
+ *    points read each time their socket becomes readable, when using
+ *    sockets.
+ *
+ *    A packet buffer is allocated upfront for every datagram of a
+ *    batch, the batch starting at one datagram and doubling while
+ *    datagrams arrive in bursts. Where recvmmsg() is available, the
+ *    whole batch is read with a single system call.
+ *
+ */
+#ifndef INET_CONFIG_UDP_RECEIVE_BATCH_SIZE
+#if HAVE_RECVMMSG
+#define INET_CONFIG_UDP_RECEIVE_BATCH_SIZE                  8
+#else  // !HAVE_RECVMMSG
+#define INET_CONFIG_UDP_RECEIVE_BATCH_SIZE                  1
+#endif // !HAVE_RECVMMSG
+#endif // INET_CONFIG_UDP_RECEIVE_BATCH_SIZE
+
+/**
+ *  @def INET_CONFIG_UDP_SEND_BATCH_SIZE
+ *
+ *  @brief
+ *    This is the maximum number of datagrams that UDP end points hand
+ *    to a single sendmmsg() call, when using sockets, and the number
+ *    of messages a UDP transport queues before flushing a batch.
+ *
+ */
+#ifndef INET_CONFIG_UDP_SEND_BATCH_SIZE
+#if HAVE_SENDMMSG
+#define INET_CONFIG_UDP_SEND_BATCH_SIZE                     8
+#else  // !HAVE_SENDMMSG
+#define INET_CONFIG_UDP_SEND_BATCH_SIZE                     1
+#endif // !HAVE_SENDMMSG
+#endif // INET_CONFIG_UDP_SEND_BATCH_SIZE
+
 /**
  *  @def INET_CONFIG_NUM_DNS_RESOLVERS
  *
@@ -450,6 +505,19 @@
 #define INET_CONFIG_ENABLE_TCP_SEND_IDLE_CALLBACKS         0
 #endif // INET_CONFIG_ENABLE_TCP_SEND_IDLE_CALLBACKS
 
+/**
+ *  @def INET_CONFIG_TCP_SEND_IOVEC_COUNT
+ *
+ *  @brief
+ *    The maximum number of buffers of the send queue of a
+ *    TCP endpoint written to its socket with a single
+ *    vectored send, when using sockets.
+ *
+ */
+#ifndef INET_CONFIG_TCP_SEND_IOVEC_COUNT
+#define INET_CONFIG_TCP_SEND_IOVEC_COUNT                   16
+#endif // INET_CONFIG_TCP_SEND_IOVEC_COUNT
+
 /**
  *  @def INET_CONFIG_TCP_SEND_QUEUE_POLL_INTERVAL_MSEC
  *
@@ -1140,6 +1140,12 @@ exit:
  *
  * @param[in]      sleepTimeTV A pointer to a structure specifying how long the select should sleep
  *
+ *  @note
+ *    With #CHIP_SYSTEM_CONFIG_USE_EPOLL, the endpoint sockets are not
+ *    added to the sets. Their epoll registrations are updated instead,
+ *    for those endpoints whose interest changed since the last call, and
+ *    the epoll instance is watched through System::Layer::PrepareSelect.
+ *
  */
 void InetLayer::PrepareSelect(int & nfds, fd_set * readfds, fd_set * writefds, fd_set * exceptfds, struct timeval & sleepTimeTV)
 {
@@ -1151,7 +1157,11 @@ void InetLayer::PrepareSelect(int & nfds, fd_set * readfds, fd_set * writefds, f
     {
         RawEndPoint * lEndPoint = RawEndPoint::sPool.Get(*mSystemLayer, i);
         if ((lEndPoint != nullptr) && lEndPoint->IsCreatedByInetLayer(*this))
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+            lEndPoint->WatchSocket(lEndPoint->PrepareIO());
+#else  // CHIP_SYSTEM_CONFIG_USE_EPOLL
             lEndPoint->PrepareIO().SetFDs(lEndPoint->mSocket, nfds, readfds, writefds, exceptfds);
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
     }
 #endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
 
@@ -1160,7 +1170,11 @@ void InetLayer::PrepareSelect(int & nfds, fd_set * readfds, fd_set * writefds, f
     {
         TCPEndPoint * lEndPoint = TCPEndPoint::sPool.Get(*mSystemLayer, i);
         if ((lEndPoint != nullptr) && lEndPoint->IsCreatedByInetLayer(*this))
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+            lEndPoint->WatchSocket(lEndPoint->PrepareIO());
+#else  // CHIP_SYSTEM_CONFIG_USE_EPOLL
             lEndPoint->PrepareIO().SetFDs(lEndPoint->mSocket, nfds, readfds, writefds, exceptfds);
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
     }
 #endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
 
@@ -1169,7 +1183,11 @@ void InetLayer::PrepareSelect(int & nfds, fd_set * readfds, fd_set * writefds, f
     {
         UDPEndPoint * lEndPoint = UDPEndPoint::sPool.Get(*mSystemLayer, i);
         if ((lEndPoint != nullptr) && lEndPoint->IsCreatedByInetLayer(*this))
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+            lEndPoint->WatchSocket(lEndPoint->PrepareIO());
+#else  // CHIP_SYSTEM_CONFIG_USE_EPOLL
             lEndPoint->PrepareIO().SetFDs(lEndPoint->mSocket, nfds, readfds, writefds, exceptfds);
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
     }
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
 }
@@ -1211,6 +1229,21 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set * readfds, fd_set * wri
 
     if (selectRes > 0)
     {
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+        // Set the pending I/O field for each ready endpoint based on the sockets the System Layer retrieved from epoll.
+        int lReadyCount;
+        const struct epoll_event * lReady = mSystemLayer->GetReadySockets(lReadyCount);
+
+        for (int i = 0; i < lReadyCount; i++)
+        {
+            EndPointBasis * lEndPoint = static_cast<EndPointBasis *>(lReady[i].data.ptr);
+            if ((lEndPoint != nullptr) && lEndPoint->IsCreatedByInetLayer(*this))
+            {
+                lEndPoint->mPendingIO       = SocketEvents::FromEpollEvents(lReady[i].events);
+                lEndPoint->mPendingIO.Value &= lEndPoint->mWatchedIO.Value;
+            }
+        }
+#else  // CHIP_SYSTEM_CONFIG_USE_EPOLL
         // Set the pending I/O field for each active endpoint based on the value returned by select.
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
         for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
@@ -1244,6 +1277,7 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set * readfds, fd_set * wri
             }
         }
 #endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
 
         // Now call each active endpoint to handle its pending I/O.
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
@@ -25,6 +25,10 @@
 
 #include "InetLayerBasis.h"
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+#include <sys/epoll.h>
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
 namespace chip {
 namespace Inet {
 
@@ -87,6 +91,51 @@ SocketEvents SocketEvents::FromFDs(int socket, fd_set * readfds, fd_set * writef
 
     return res;
 }
+
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+/**
+ *  Convert the bit flags to the epoll events watching for them.
+ *
+ *  @return The epoll events of interest.
+ *
+ */
+uint32_t SocketEvents::ToEpollEvents() const
+{
+    uint32_t events = 0;
+
+    if (IsReadable())
+        events |= EPOLLIN;
+    if (IsWriteable())
+        events |= EPOLLOUT;
+    if (IsError())
+        events |= EPOLLPRI;
+
+    return events;
+}
+
+/**
+ *  Set the read, write or exception bit flags from the events reported by epoll.
+ *
+ *  As with select(), a socket that hung up or failed is reported as both readable and writable, so that the
+ *  subsequent read or write surfaces the error.
+ *
+ *  @param[in]    events    The events reported by epoll_wait().
+ *
+ */
+SocketEvents SocketEvents::FromEpollEvents(uint32_t events)
+{
+    SocketEvents res;
+
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+        res.SetRead();
+    if (events & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+        res.SetWrite();
+    if (events & EPOLLPRI)
+        res.SetError();
+
+    return res;
+}
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 
 } // namespace Inet
@@ -207,6 +207,11 @@ public:
 
     void SetFDs(int socket, int & nfds, fd_set * readfds, fd_set * writefds, fd_set * exceptfds);
     static SocketEvents FromFDs(int socket, fd_set * readfds, fd_set * writefds, fd_set * exceptfds);
+
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    uint32_t ToEpollEvents() const;
+    static SocketEvents FromEpollEvents(uint32_t events);
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
 };
 
 /**
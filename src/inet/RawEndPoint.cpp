@@ -473,6 +473,10 @@ void RawEndPoint::Close()
             // Wake the thread calling select so that it recognizes the socket is closed.
             lSystemLayer.WakeSelect();
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+            UnwatchSocket();
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
             close(mSocket);
             mSocket = INET_INVALID_SOCKET_FD;
         }
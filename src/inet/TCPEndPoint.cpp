@@ -55,6 +55,7 @@
 #include <sys/ioctl.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 
@@ -722,10 +723,20 @@ INET_ERROR TCPEndPoint::Send(PacketBuffer * data, bool push)
 
     if (push)
         res = DriveSending();
+    else
+        mSendCorked = true;
 
     return res;
 }
 
+INET_ERROR TCPEndPoint::PushSendQueue()
+{
+    if (State != kState_Connected && State != kState_ReceiveShutdown)
+        return INET_ERROR_INCORRECT_STATE;
+
+    return DriveSending();
+}
+
 void TCPEndPoint::DisableReceive()
 {
     ReceiveEnabled = false;
@@ -1141,6 +1152,8 @@ void TCPEndPoint::Init(InetLayer * inetLayer)
 {
     InitEndPointBasis(*inetLayer);
     ReceiveEnabled = true;
+    mSendCorked    = false;
+    mWriteCount    = 0;
 
     // Initialize to zero for using system defaults.
     mConnectTimeoutMsecs = 0;
@@ -1178,6 +1191,9 @@ INET_ERROR TCPEndPoint::DriveSending()
 {
     INET_ERROR err = INET_NO_ERROR;
 
+    // Whatever was queued is now pushed
+    mSendCorked = false;
+
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
 
     // Lock LwIP stack
@@ -1256,6 +1272,7 @@ INET_ERROR TCPEndPoint::DriveSending()
             if (err == INET_NO_ERROR)
             {
                 lwipErr = tcp_output(mTCP);
+                mWriteCount++;
 
                 if (lwipErr != ERR_OK)
                     err = chip::System::MapErrorLwIP(lwipErr);
@@ -1299,9 +1316,26 @@ INET_ERROR TCPEndPoint::DriveSending()
 
     while (mSendQueue != nullptr)
     {
-        uint16_t bufLen = mSendQueue->DataLength();
+        struct iovec iov[INET_CONFIG_TCP_SEND_IOVEC_COUNT];
+        struct msghdr msg        = {};
+        const PacketBuffer * buf = mSendQueue;
+        size_t iovCount          = 0;
+        size_t queuedLen         = 0;
+
+        // Write as many of the queued buffers as possible with a single call.
+        while (buf != nullptr && iovCount < INET_CONFIG_TCP_SEND_IOVEC_COUNT)
+        {
+            iov[iovCount].iov_base = buf->Start();
+            iov[iovCount].iov_len  = buf->DataLength();
+            queuedLen += buf->DataLength();
+            iovCount++;
+            buf = buf->Next();
+        }
+        msg.msg_iov    = iov;
+        msg.msg_iovlen = static_cast<decltype(msg.msg_iovlen)>(iovCount);
 
-        ssize_t lenSentRaw = send(mSocket, mSendQueue->Start(), bufLen, sendFlags);
+        ssize_t lenSentRaw = sendmsg(mSocket, &msg, sendFlags);
+        mWriteCount++;
 
         if (lenSentRaw == -1)
         {
@@ -1310,25 +1344,32 @@ INET_ERROR TCPEndPoint::DriveSending()
             break;
         }
 
-        if (lenSentRaw < 0 || lenSentRaw > bufLen)
+        if (lenSentRaw < 0 || static_cast<size_t>(lenSentRaw) > queuedLen)
         {
             err = INET_ERROR_INCORRECT_STATE;
             break;
         }
 
-        // Cast is safe because bufLen is uint16_t.
-        uint16_t lenSent = static_cast<uint16_t>(lenSentRaw);
+        size_t lenSent = static_cast<size_t>(lenSentRaw);
 
         // Mark the connection as being active.
         MarkActive();
 
-        if (lenSent < bufLen)
-            mSendQueue->ConsumeHead(lenSent);
-        else
-            mSendQueue = PacketBuffer::FreeHead_ForNow(mSendQueue);
+        // Free the buffers sent in full, including empty ones, and consume what was sent of the next one.
+        for (size_t remaining = lenSent; mSendQueue != nullptr && (remaining > 0 || mSendQueue->DataLength() == 0);)
+        {
+            uint16_t bufLen  = mSendQueue->DataLength();
+            uint16_t bufSent = (remaining < bufLen) ? static_cast<uint16_t>(remaining) : bufLen;
 
-        if (OnDataSent != nullptr)
-            OnDataSent(this, lenSent);
+            if (bufSent < bufLen)
+                mSendQueue->ConsumeHead(bufSent);
+            else
+                mSendQueue = PacketBuffer::FreeHead_ForNow(mSendQueue);
+            remaining -= bufSent;
+
+            if (OnDataSent != nullptr && bufSent > 0)
+                OnDataSent(this, bufSent);
+        }
 
 #if INET_CONFIG_ENABLE_TCP_SEND_IDLE_CALLBACKS
         // TCP Send is not Idle; Set state and notify if needed
@@ -1337,7 +1378,7 @@ INET_ERROR TCPEndPoint::DriveSending()
 #endif // INET_CONFIG_ENABLE_TCP_SEND_IDLE_CALLBACKS
 
 #if INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
-        mBytesWrittenSinceLastProbe += lenSent;
+        mBytesWrittenSinceLastProbe += static_cast<uint32_t>(lenSent);
 
         bool isProgressing = false;
 
@@ -1363,7 +1404,7 @@ INET_ERROR TCPEndPoint::DriveSending()
         }
 #endif // INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
 
-        if (lenSent < bufLen)
+        if (lenSent < queuedLen)
             break;
     }
 
@@ -1437,7 +1478,11 @@ INET_ERROR TCPEndPoint::DoClose(INET_ERROR err, bool suppressCallback)
     // ... THEN enter the Closing state, allowing the queued data to drain,
     // ... OTHERWISE go straight to the Closed state.
     if (IsConnected() && err == INET_NO_ERROR && (mSendQueue != nullptr || !mRcvQueue.IsNull()))
-        State = kState_Closing;
+    {
+        // The queued data is drained whether or not it was pushed
+        State       = kState_Closing;
+        mSendCorked = false;
+    }
     else
         State = kState_Closed;
 
@@ -1540,6 +1585,10 @@ INET_ERROR TCPEndPoint::DoClose(INET_ERROR err, bool suppressCallback)
                     ChipLogError(Inet, "SO_LINGER: %d", errno);
             }
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+            UnwatchSocket();
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
             if (close(mSocket) != 0 && err == INET_NO_ERROR)
                 err = chip::System::MapErrorPOSIX(errno);
             mSocket = INET_INVALID_SOCKET_FD;
@@ -2342,9 +2391,9 @@ SocketEvents TCPEndPoint::PrepareIO()
     SocketEvents ioType;
 
     // If initiating a new connection...
-    // OR if connected and there is data to be sent...
+    // OR if connected and there is pushed data to be sent...
     // THEN arrange for the kernel to alert us when the socket is ready to be written.
-    if (State == kState_Connecting || (IsConnected() && mSendQueue != nullptr))
+    if (State == kState_Connecting || (IsConnected() && mSendQueue != nullptr && !mSendCorked))
         ioType.SetWrite();
 
     // If listening for incoming connections and the app is ready to receive a connection...
@@ -2390,9 +2439,9 @@ void TCPEndPoint::HandlePendingIO()
 
     else
     {
-        // If in a state where sending is allowed, and there is data to be sent, and the socket is ready for
+        // If in a state where sending is allowed, and there is pushed data to be sent, and the socket is ready for
         // writing, drive outbound data into the connection.
-        if (IsConnected() && mSendQueue != nullptr && mPendingIO.IsWriteable())
+        if (IsConnected() && mSendQueue != nullptr && !mSendCorked && mPendingIO.IsWriteable())
             DriveSending();
 
         // If in a state were receiving is allowed, and the app is ready to receive data, and data is ready
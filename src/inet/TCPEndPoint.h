@@ -188,7 +188,7 @@ public:
      * @brief   Send message text on TCP connection.
      *
      * @param[out]  data    Message text to send.
-     * @param[out]  push    If \c true, then send immediately, otherwise queue.
+     * @param[out]  push    If \c true, then send immediately, otherwise queue until PushSendQueue() or a pushing Send().
      *
      * @retval  INET_NO_ERROR           success: address and port extracted.
      * @retval  INET_ERROR_INCORRECT_STATE  TCP connection not established.
@@ -199,6 +199,19 @@ public:
      */
     INET_ERROR Send(chip::System::PacketBuffer * data, bool push = true);
 
+    /**
+     * @brief   Send the data queued by calls to Send() that did not push it.
+     *
+     * @retval  INET_NO_ERROR           success: queued data is being sent.
+     * @retval  INET_ERROR_INCORRECT_STATE  TCP connection not established.
+     */
+    INET_ERROR PushSendQueue();
+
+    /**
+     * @brief   Get the number of writes to the socket, or of outputs of the LwIP PCB, since the endpoint was created.
+     */
+    uint32_t GetWriteCount() const { return mWriteCount; }
+
     /**
      * @brief   Disable reception.
      *
@@ -566,6 +579,8 @@ private:
 
     chip::System::PacketBufferHandle mRcvQueue;
     chip::System::PacketBuffer * mSendQueue;
+    bool mSendCorked;     // The send queue holds data Send() did not push, and is left alone until it is pushed.
+    uint32_t mWriteCount; // Writes to the socket, or outputs of the PCB.
 #if INET_TCP_IDLE_CHECK_INTERVAL > 0
     uint16_t mIdleTimeout;       // in units of INET_TCP_IDLE_CHECK_INTERVAL; zero means no timeout
     uint16_t mRemainingIdleTime; // in units of INET_TCP_IDLE_CHECK_INTERVAL
@@ -52,6 +52,9 @@
 #include <sys/socket.h>
 #endif // HAVE_SYS_SOCKET_H
 #include <errno.h>
+#ifdef __linux__
+#include <linux/filter.h>
+#endif // defined(__linux__)
 #include <net/if.h>
 #include <netinet/in.h>
 #include <unistd.h>
@@ -410,6 +413,10 @@ void UDPEndPoint::Close()
             // Wake the thread calling select so that it recognizes the socket is closed.
             lSystemLayer.WakeSelect();
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+            UnwatchSocket();
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
             close(mSocket);
             mSocket = INET_INVALID_SOCKET_FD;
         }
@@ -662,6 +669,137 @@ exit:
     return res;
 }
 
+/**
+ * @brief   Send several UDP messages, each to its own destination.
+ *
+ * @param[in]   pktInfos    source and destination information, one per message
+ * @param[in]   msgs        the packet buffers containing the UDP messages
+ * @param[in]   count       number of messages
+ * @param[out]  sentCount   optional, set to the number of messages that were sent
+ *
+ * @retval  INET_NO_ERROR   success: all messages are queued for transmit.
+ *
+ * @retval  other
+ *      the error of the first message that could not be sent, see SendMsg().
+ *
+ * @details
+ *      Ownership of every packet buffer passes to the endpoint. When using
+ *      sockets, the messages are handed to the system with as few calls
+ *      as possible (see #INET_CONFIG_UDP_SEND_BATCH_SIZE), which is cheaper
+ *      than calling SendMsg() for each of them. A message that fails to
+ *      send does not keep the following ones from being sent.
+ */
+INET_ERROR UDPEndPoint::SendMsgs(const IPPacketInfo * pktInfos, chip::System::PacketBuffer * const * msgs, size_t count,
+                                 size_t * sentCount)
+{
+    INET_ERROR res = INET_NO_ERROR;
+    size_t sent    = 0;
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
+    if (count > 0)
+    {
+        // Make sure we have the appropriate type of socket based on the
+        // destination address. Messages to other address types fail below.
+        res = GetSocket(pktInfos[0].DestAddress.Type());
+
+        if (res == INET_NO_ERROR)
+        {
+            res = IPEndPointBasis::SendMsgs(pktInfos, msgs, count, sent);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        PacketBuffer::Free(msgs[i]);
+    }
+
+    CHIP_SYSTEM_FAULT_INJECT_ASYNC_EVENT();
+
+#else  // !CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
+    for (size_t i = 0; i < count; i++)
+    {
+        INET_ERROR err = SendMsg(&pktInfos[i], msgs[i]);
+
+        if (err == INET_NO_ERROR)
+            sent++;
+        else if (res == INET_NO_ERROR)
+            res = err;
+    }
+
+#endif // !CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
+    if (sentCount != nullptr)
+    {
+        *sentCount = sent;
+    }
+
+    return res;
+}
+
+/**
+ * @brief   Set how many datagrams are read each time the endpoint becomes readable.
+ *
+ * @param[in]   batchSize   number of datagrams, capped at #INET_CONFIG_UDP_RECEIVE_BATCH_SIZE
+ *
+ * @details
+ *      Reading several datagrams at once saves system calls and event loop
+ *      iterations under load, at the cost of allocating a packet buffer for
+ *      each of them upfront. Only as many buffers as the previous event
+ *      found datagrams are allocated, doubling up to the batch size while
+ *      a burst lasts. A batch size of one reads a single datagram per
+ *      event. This only has an effect when using sockets.
+ */
+void UDPEndPoint::SetReceiveBatchSize(uint8_t batchSize)
+{
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS
+    mReceiveBatchSize = batchSize;
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
+}
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS
+/**
+ * @brief   Choose which socket of a port shared with SO_REUSEPORT receives each datagram.
+ *
+ * @param[in]   program     classic BPF program, run on the UDP payload of every datagram
+ *                          received on the port
+ *
+ * @param[in]   length      number of instructions of \c program
+ *
+ * @retval  INET_NO_ERROR               success: the program steers datagrams of the bound port
+ * @retval  INET_ERROR_INCORRECT_STATE  the endpoint is not bound
+ * @retval  INET_ERROR_NOT_IMPLEMENTED  the platform does not support steering
+ * @retval  other                       another system or platform error
+ *
+ * @details
+ *      The value returned by the program is the index of the receiving
+ *      socket among those bound to the port, in the order they were bound.
+ *      A value that is not a valid index leaves the choice to the kernel's
+ *      default hash of the source address. The program applies to every
+ *      socket of the port, whichever of them it was attached through.
+ */
+INET_ERROR UDPEndPoint::AttachReusePortFilter(const struct sock_filter * program, uint16_t length)
+{
+    if (mState != kState_Bound && mState != kState_Listening)
+        return INET_ERROR_INCORRECT_STATE;
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    struct sock_fprog filter;
+
+    filter.len    = length;
+    filter.filter = const_cast<struct sock_filter *>(program);
+
+    if (setsockopt(mSocket, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &filter, sizeof(filter)) != 0)
+        return chip::System::MapErrorPOSIX(errno);
+
+    return INET_NO_ERROR;
+#else  // !defined(SO_ATTACH_REUSEPORT_CBPF)
+    return INET_ERROR_NOT_IMPLEMENTED;
+#endif // !defined(SO_ATTACH_REUSEPORT_CBPF)
+}
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
 /**
  * @brief   Bind the endpoint to a network interface.
  *
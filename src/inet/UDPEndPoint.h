@@ -33,6 +33,10 @@
 
 #include <system/SystemPacketBuffer.h>
 
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS
+struct sock_filter;
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
 namespace chip {
 namespace Inet {
 
@@ -61,6 +65,12 @@ public:
     INET_ERROR SendTo(const IPAddress & addr, uint16_t port, InterfaceId intfId, chip::System::PacketBuffer * msg,
                       uint16_t sendFlags = 0);
     INET_ERROR SendMsg(const IPPacketInfo * pktInfo, chip::System::PacketBuffer * msg, uint16_t sendFlags = 0);
+    INET_ERROR SendMsgs(const IPPacketInfo * pktInfos, chip::System::PacketBuffer * const * msgs, size_t count,
+                        size_t * sentCount = nullptr);
+    void SetReceiveBatchSize(uint8_t batchSize);
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS
+    INET_ERROR AttachReusePortFilter(const struct sock_filter * program, uint16_t length);
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
     void Close();
     void Free();
 
@@ -1235,11 +1235,27 @@
  *    Maximum number of simultaneously active unsolicited message
  *    handlers.
  *
+ *    Handlers are kept in a table per protocol, indexed by message
+ *    type; the table of a protocol is allocated from the platform heap
+ *    when a handler is first registered for one of its message types.
+ *
  */
 #ifndef CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS
 #define CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS       32
 #endif // CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS
 
+/**
+ *  @def CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS
+ *
+ *  @brief
+ *    Maximum number of distinct protocols with simultaneously active
+ *    unsolicited message handlers.
+ *
+ */
+#ifndef CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS
+#define CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS      8
+#endif // CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS
+
 /**
  *  @def CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS
  *
@@ -1251,6 +1267,49 @@
 #define CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS                  16
 #endif // CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS
 
+/**
+ *  @def CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+ *
+ *  @brief
+ *    Let the exchange context pool grow on the platform heap once all
+ *    CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS contexts are in use, instead of
+ *    failing the new exchange.
+ *
+ *    The pool grows in chunks of CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_CHUNK_SIZE
+ *    contexts up to CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_MAX_SIZE, and gives the
+ *    chunks back when the ExchangeManager is shut down. It suits controllers
+ *    running many concurrent transactions; memory constrained devices should
+ *    keep the fixed pool.
+ *
+ */
+#ifndef CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+#define CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC          0
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+
+/**
+ *  @def CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_CHUNK_SIZE
+ *
+ *  @brief
+ *    Number of exchange contexts allocated at once when the dynamic
+ *    exchange context pool needs to grow.
+ *
+ */
+#ifndef CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_CHUNK_SIZE
+#define CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_CHUNK_SIZE       16
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_CHUNK_SIZE
+
+/**
+ *  @def CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_MAX_SIZE
+ *
+ *  @brief
+ *    Upper bound on the number of simultaneously active exchange
+ *    contexts when the dynamic exchange context pool is enabled.
+ *
+ */
+#ifndef CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_MAX_SIZE
+#define CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_MAX_SIZE         1024
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_MAX_SIZE
+
 
 /**
  *  @def CHIP_CONFIG_CONNECT_IP_ADDRS
@@ -2253,6 +2312,42 @@
 #define CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE                   16
 #endif // CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE
 
+/**
+ * @def CHIP_CONFIG_PEER_CONNECTION_POOL_DYNAMIC
+ *
+ * @brief Allocate CHIP Peer connection states at runtime instead of
+ * using a fixed array of CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE entries.
+ *
+ * The dynamic pool grows in chunks of CHIP_CONFIG_PEER_CONNECTION_POOL_CHUNK_SIZE
+ * states up to CHIP_CONFIG_PEER_CONNECTION_POOL_MAX_SIZE, and gives chunks back
+ * to the platform heap once they are no longer used. It suits controllers
+ * tracking a large number of peers; memory constrained devices should keep
+ * the fixed pool.
+ */
+#ifndef CHIP_CONFIG_PEER_CONNECTION_POOL_DYNAMIC
+#define CHIP_CONFIG_PEER_CONNECTION_POOL_DYNAMIC                0
+#endif // CHIP_CONFIG_PEER_CONNECTION_POOL_DYNAMIC
+
+/**
+ * @def CHIP_CONFIG_PEER_CONNECTION_POOL_CHUNK_SIZE
+ *
+ * @brief Number of CHIP Peer connection states allocated at once when
+ * the dynamic pool needs to grow.
+ */
+#ifndef CHIP_CONFIG_PEER_CONNECTION_POOL_CHUNK_SIZE
+#define CHIP_CONFIG_PEER_CONNECTION_POOL_CHUNK_SIZE             16
+#endif // CHIP_CONFIG_PEER_CONNECTION_POOL_CHUNK_SIZE
+
+/**
+ * @def CHIP_CONFIG_PEER_CONNECTION_POOL_MAX_SIZE
+ *
+ * @brief Upper bound on the number of concurrent CHIP Peer connections
+ * tracked by the dynamic pool.
+ */
+#ifndef CHIP_CONFIG_PEER_CONNECTION_POOL_MAX_SIZE
+#define CHIP_CONFIG_PEER_CONNECTION_POOL_MAX_SIZE               4096
+#endif // CHIP_CONFIG_PEER_CONNECTION_POOL_MAX_SIZE
+
 /**
  * @def CHIP_PEER_CONNECTION_TIMEOUT_MS
  *
@@ -2266,12 +2361,49 @@
 /**
  * @def CHIP_PEER_CONNECTION_TIMEOUT_CHECK_FREQUENCY_MS
  *
- * @brief How frequent are peer connections checked for timeouts.
+ * @brief Minimum delay between two checks of peer connections for timeouts.
+ *
+ * Checks are scheduled for when the least recently active connection is due,
+ * so idle devices are not woken up periodically. This bounds how often that
+ * can happen and lets expiries close in time be handled together.
  */
 #ifndef CHIP_PEER_CONNECTION_TIMEOUT_CHECK_FREQUENCY_MS
 #define CHIP_PEER_CONNECTION_TIMEOUT_CHECK_FREQUENCY_MS      5000
 #endif // CHIP_PEER_CONNECTION_TIMEOUT_CHECK_FREQUENCY_MS
 
+/**
+ * @def CHIP_CONFIG_MAX_UDP_SHARDS
+ *
+ * @brief Maximum number of UDP transports, each serviced by its own
+ * thread, that a Transport::UDPShardGroup spreads a listening port over.
+ */
+#ifndef CHIP_CONFIG_MAX_UDP_SHARDS
+#define CHIP_CONFIG_MAX_UDP_SHARDS                           8
+#endif // CHIP_CONFIG_MAX_UDP_SHARDS
+
+/**
+ * @def CHIP_CONFIG_UDP_SHARD_HANDOFF_QUEUE_SIZE
+ *
+ * @brief Number of received messages that can wait for each shard of a
+ * Transport::UDPShardGroup after being received by another shard.
+ * Messages handed off to a shard whose queue is full are dropped.
+ */
+#ifndef CHIP_CONFIG_UDP_SHARD_HANDOFF_QUEUE_SIZE
+#define CHIP_CONFIG_UDP_SHARD_HANDOFF_QUEUE_SIZE             32
+#endif // CHIP_CONFIG_UDP_SHARD_HANDOFF_QUEUE_SIZE
+
+/**
+ * @def CHIP_CONFIG_TCP_MAX_PENDING_PACKETS_PER_PEER
+ *
+ * @brief Default number of packets a TCP transport queues for a single
+ * peer while connecting to it, so that one unreachable peer can not take
+ * the whole pending packet pool of the transport. See
+ * Transport::TcpListenParameters::SetMaxPendingPacketsPerPeer.
+ */
+#ifndef CHIP_CONFIG_TCP_MAX_PENDING_PACKETS_PER_PEER
+#define CHIP_CONFIG_TCP_MAX_PENDING_PACKETS_PER_PEER         4
+#endif // CHIP_CONFIG_TCP_MAX_PENDING_PACKETS_PER_PEER
+
 /**
    *  @def CHIP_CONFIG_MAX_BINDINGS
    *
@@ -1761,6 +1761,15 @@ typedef CHIP_CONFIG_ERROR_TYPE CHIP_ERROR;
  */
 #define CHIP_ERROR_IM_MALFORMED_STATUS_CODE                      _CHIP_ERROR(187)
 
+/**
+ * @def CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED
+ *
+ * @brief
+ *   A message was dropped because its message ID was already received
+ *   on the session, or is too old to tell.
+ */
+#define CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED                    _CHIP_ERROR(188)
+
 /**
  *  @}
  */
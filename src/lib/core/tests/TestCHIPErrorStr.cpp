@@ -225,6 +225,7 @@ static int32_t sContext[] =
     CHIP_ERROR_IM_MALFORMED_COMMAND_DATA_ELEMENT,
     CHIP_ERROR_IM_MALFORMED_EVENT_DATA_ELEMENT,
     CHIP_ERROR_IM_MALFORMED_STATUS_CODE,
+    CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED,
 };
 // clang-format on
 
@@ -0,0 +1,64 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Utilities for hash tables with a power of two number of buckets,
+ *      indexed by the low bits of a hash.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+
+/**
+ * Finalization step of MurmurHash3: cheap, and spreads every input bit over
+ * the result, so its low bits can select a bucket.
+ */
+inline uint32_t HashMix(uint32_t h)
+{
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+/**
+ * Fold another value into a hash, e.g. to hash a key made of several
+ * integers.
+ */
+inline uint32_t HashCombine(uint32_t seed, uint32_t value)
+{
+    return HashMix(seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2)));
+}
+
+/**
+ * Smallest power of two bucket count, starting from `buckets`, suitable for
+ * looking up `count` entries.
+ */
+constexpr size_t HashBucketCountFor(size_t count, size_t buckets = 1)
+{
+    return (buckets >= count) ? buckets : HashBucketCountFor(count, buckets * 2);
+}
+
+} // namespace chip
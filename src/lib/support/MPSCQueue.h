@@ -0,0 +1,138 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Defines a bounded lock-free queue with many producer threads and
+ *      a single consumer thread.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+
+/**
+ * A fixed capacity ring of items, which any number of threads can push to
+ * without taking a lock, and a single thread pops from.
+ *
+ * Every slot carries a sequence number telling whether it is free for the
+ * producer of a given position, or holds the item of that position for the
+ * consumer. Producers claim a position with a compare-and-swap on the tail
+ * and publish the item by advancing the slot's sequence number; neither side
+ * ever waits for the other.
+ *
+ * An item whose producer claimed its slot but did not publish it yet hides
+ * the items behind it from the consumer until it is published.
+ *
+ * @tparam T  The item type, which must be copy assignable.
+ * @tparam N  The capacity of the queue.
+ */
+template <typename T, size_t N>
+class MPSCQueue
+{
+public:
+    static_assert(N > 0, "MPSCQueue needs room for at least one item");
+
+    MPSCQueue() : mTail(0), mHead(0)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            mSlots[i].mSequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue & operator=(const MPSCQueue &) = delete;
+
+    /**
+     * Append an item to the queue. May be called from any thread.
+     *
+     * @return true if the item was queued, false if the queue is full.
+     */
+    bool TryPush(const T & aItem)
+    {
+        size_t position = mTail.load(std::memory_order_relaxed);
+        Slot * slot;
+
+        for (;;)
+        {
+            slot                  = &mSlots[position % N];
+            const size_t sequence = slot->mSequence.load(std::memory_order_acquire);
+            const intptr_t lag    = static_cast<intptr_t>(sequence - position);
+
+            if (lag == 0)
+            {
+                // The slot is free for this position: try to claim it.
+                if (mTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (lag < 0)
+            {
+                // The slot still holds the item of the previous lap, which the consumer did not pop yet.
+                return false;
+            }
+            else
+            {
+                // Another producer claimed this position first.
+                position = mTail.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->mItem = aItem;
+        slot->mSequence.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Remove the oldest published item from the queue. Must only be called
+     * from the consumer thread.
+     *
+     * @return true if an item was popped, false if there was none.
+     */
+    bool TryPop(T & aItem)
+    {
+        Slot & slot = mSlots[mHead % N];
+
+        if (slot.mSequence.load(std::memory_order_acquire) != mHead + 1)
+            return false;
+
+        aItem = slot.mItem;
+        slot.mSequence.store(mHead + N, std::memory_order_release);
+        mHead++;
+
+        return true;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> mSequence;
+        T mItem;
+    };
+
+    Slot mSlots[N];
+    std::atomic<size_t> mTail; ///< next position to be claimed by a producer
+    size_t mHead;              ///< next position to be popped, only touched by the consumer
+};
+
+} // namespace chip
@@ -0,0 +1,182 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "TestSupport.h"
+
+#include <support/MPSCQueue.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#include <pthread.h>
+
+using namespace chip;
+
+namespace {
+
+constexpr size_t kProducerCount     = 4;
+constexpr uint32_t kItemsPerProducer = 10000;
+
+void TestFifoOrder(nlTestSuite * inSuite, void * inContext)
+{
+    MPSCQueue<uint32_t, 4> queue;
+    uint32_t item;
+
+    NL_TEST_ASSERT(inSuite, !queue.TryPop(item));
+
+    NL_TEST_ASSERT(inSuite, queue.TryPush(1));
+    NL_TEST_ASSERT(inSuite, queue.TryPush(2));
+    NL_TEST_ASSERT(inSuite, queue.TryPush(3));
+
+    NL_TEST_ASSERT(inSuite, queue.TryPop(item) && item == 1);
+    NL_TEST_ASSERT(inSuite, queue.TryPop(item) && item == 2);
+    NL_TEST_ASSERT(inSuite, queue.TryPop(item) && item == 3);
+    NL_TEST_ASSERT(inSuite, !queue.TryPop(item));
+}
+
+void TestFull(nlTestSuite * inSuite, void * inContext)
+{
+    MPSCQueue<uint32_t, 4> queue;
+    uint32_t item;
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        NL_TEST_ASSERT(inSuite, queue.TryPush(i));
+    }
+    NL_TEST_ASSERT(inSuite, !queue.TryPush(4));
+
+    // Popping one item makes room for exactly one more
+    NL_TEST_ASSERT(inSuite, queue.TryPop(item) && item == 0);
+    NL_TEST_ASSERT(inSuite, queue.TryPush(4));
+    NL_TEST_ASSERT(inSuite, !queue.TryPush(5));
+}
+
+void TestWrapAround(nlTestSuite * inSuite, void * inContext)
+{
+    MPSCQueue<uint32_t, 3> queue;
+    uint32_t item;
+    bool ordered = true;
+
+    // Go around the ring many times, with the queue at various fill levels
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        NL_TEST_ASSERT(inSuite, queue.TryPush(2 * i));
+        NL_TEST_ASSERT(inSuite, queue.TryPush(2 * i + 1));
+
+        ordered &= queue.TryPop(item) && item == 2 * i;
+        ordered &= queue.TryPop(item) && item == 2 * i + 1;
+    }
+
+    NL_TEST_ASSERT(inSuite, ordered);
+    NL_TEST_ASSERT(inSuite, !queue.TryPop(item));
+}
+
+struct ProducerContext
+{
+    MPSCQueue<uint32_t, 64> * mQueue;
+    uint32_t mProducer;
+};
+
+void * Produce(void * context)
+{
+    ProducerContext * producer = static_cast<ProducerContext *>(context);
+
+    for (uint32_t i = 0; i < kItemsPerProducer;)
+    {
+        // Items carry the producer in their high bits and a sequence number in their low bits
+        if (producer->mQueue->TryPush((producer->mProducer << 24) | i))
+        {
+            i++;
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+
+    return nullptr;
+}
+
+void TestManyProducers(nlTestSuite * inSuite, void * inContext)
+{
+    MPSCQueue<uint32_t, 64> queue;
+    ProducerContext producers[kProducerCount];
+    pthread_t threads[kProducerCount];
+    uint32_t expected[kProducerCount] = {};
+    size_t received                   = 0;
+    bool ordered                      = true;
+    uint32_t item;
+
+    for (uint32_t i = 0; i < kProducerCount; i++)
+    {
+        producers[i] = { &queue, i };
+        NL_TEST_ASSERT(inSuite, pthread_create(&threads[i], nullptr, Produce, &producers[i]) == 0);
+    }
+
+    // Every item is received exactly once, and the items of each producer in the order they were pushed
+    while (received < kProducerCount * kItemsPerProducer)
+    {
+        if (!queue.TryPop(item))
+        {
+            sched_yield();
+            continue;
+        }
+
+        const uint32_t producer = item >> 24;
+        if (producer >= kProducerCount || (item & 0xFFFFFF) != expected[producer])
+        {
+            ordered = false;
+            break;
+        }
+
+        expected[producer]++;
+        received++;
+    }
+
+    for (pthread_t thread : threads)
+    {
+        pthread_join(thread, nullptr);
+    }
+
+    NL_TEST_ASSERT(inSuite, ordered);
+    NL_TEST_ASSERT(inSuite, !queue.TryPop(item));
+}
+
+} // namespace
+
+#define NL_TEST_DEF_FN(fn) NL_TEST_DEF("Test " #fn, fn)
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF_FN(TestFifoOrder),     //
+    NL_TEST_DEF_FN(TestFull),          //
+    NL_TEST_DEF_FN(TestWrapAround),    //
+    NL_TEST_DEF_FN(TestManyProducers), //
+    NL_TEST_SENTINEL()                 //
+};
+
+int TestMPSCQueue(void)
+{
+    nlTestSuite theSuite = { "CHIP MPSCQueue tests", &sTests[0], nullptr, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestMPSCQueue)
@@ -0,0 +1,168 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a contention benchmark of MPSCQueue, as used
+ *      for the device event queue: several threads post events which a
+ *      single thread drains, against a std::queue guarded by a mutex.
+ *      Throughput is printed for both queues and each number of threads.
+ *
+ */
+
+#include "TestSupport.h"
+
+#include <support/MPSCQueue.h>
+#include <support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#include <chrono>
+#include <mutex>
+#include <queue>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+using namespace chip;
+
+namespace {
+
+constexpr size_t kQueueSize          = 100; // CHIP_DEVICE_CONFIG_MAX_EVENT_QUEUE_SIZE
+constexpr uint32_t kEventsPerThread  = 100000;
+constexpr size_t kMaxProducerThreads = 8;
+
+struct Event
+{
+    uint32_t mType;
+    uint32_t mValue;
+    uint8_t mPayload[32];
+};
+
+class LockedQueue
+{
+public:
+    bool TryPush(const Event & event)
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (mQueue.size() >= kQueueSize)
+            return false;
+        mQueue.push(event);
+        return true;
+    }
+
+    bool TryPop(Event & event)
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (mQueue.empty())
+            return false;
+        event = mQueue.front();
+        mQueue.pop();
+        return true;
+    }
+
+private:
+    std::mutex mLock;
+    std::queue<Event> mQueue;
+};
+
+template <typename Queue>
+uint64_t RunBenchmark(size_t producerCount)
+{
+    Queue queue;
+    std::vector<std::thread> producers;
+    const uint64_t total = producerCount * kEventsPerThread;
+    uint64_t received    = 0;
+    Event event          = {};
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < producerCount; i++)
+    {
+        producers.emplace_back([&queue] {
+            Event posted = {};
+            for (uint32_t n = 0; n < kEventsPerThread;)
+            {
+                posted.mValue = n;
+                if (queue.TryPush(posted))
+                {
+                    n++;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    while (received < total)
+    {
+        if (queue.TryPop(event))
+        {
+            received++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    for (std::thread & producer : producers)
+    {
+        producer.join();
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return (elapsed > 0) ? (received * 1000000 / static_cast<uint64_t>(elapsed)) : 0;
+}
+
+void TestContention(nlTestSuite * inSuite, void * inContext)
+{
+    for (size_t producerCount = 1; producerCount <= kMaxProducerThreads; producerCount *= 2)
+    {
+        const uint64_t locked   = RunBenchmark<LockedQueue>(producerCount);
+        const uint64_t lockFree = RunBenchmark<MPSCQueue<Event, kQueueSize>>(producerCount);
+
+        printf("%zu posting thread(s): mutex %9llu events/s, lock-free %9llu events/s\n", producerCount,
+               static_cast<unsigned long long>(locked), static_cast<unsigned long long>(lockFree));
+
+        NL_TEST_ASSERT(inSuite, locked > 0 && lockFree > 0);
+    }
+}
+
+} // namespace
+
+#define NL_TEST_DEF_FN(fn) NL_TEST_DEF("Test " #fn, fn)
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF_FN(TestContention), //
+    NL_TEST_SENTINEL()              //
+};
+
+int TestMPSCQueueBenchmark(void)
+{
+    nlTestSuite theSuite = { "CHIP MPSCQueue benchmark", &sTests[0], nullptr, nullptr };
+
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestMPSCQueueBenchmark)
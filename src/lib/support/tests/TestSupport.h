@@ -39,6 +39,8 @@ int TestScopedBuffer(void);
 int TestSafeInt();
 int TestSerializableIntegerSet(void);
 int TestBufferReader();
+int TestMPSCQueue(void);
+int TestMPSCQueueBenchmark(void);
 
 #ifdef __cplusplus
 }
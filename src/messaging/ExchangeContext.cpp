@@ -228,6 +228,7 @@ void ExchangeContext::Free()
     mExchangeMgr = nullptr;
 
     em->DecrementContextsInUse();
+    em->ReleaseContext(this);
 
 #if defined(CHIP_EXCHANGE_CONTEXT_DETAIL_LOGGING)
     ChipLogProgress(ExchangeManager, "ec-- id: %d [%04" PRIX16 "], inUse: %d, addr: 0x%x", (this - em->ContextPool + 1),
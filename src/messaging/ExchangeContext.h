@@ -37,6 +37,25 @@ namespace Messaging {
 class ExchangeManager;
 class ExchangeContext;
 
+/**
+ * Link through which the ExchangeManager owning a context chains it, either on
+ * its free list or in the bucket of its exchange index. It is deliberately NOT
+ * carried over when a context is assigned (see ExchangeContext::Reset): the
+ * link belongs to the pool slot, not to the value.
+ */
+class ExchangeContextPoolHook
+{
+public:
+    ExchangeContextPoolHook() {}
+    ExchangeContextPoolHook(const ExchangeContextPoolHook &) {}
+    ExchangeContextPoolHook & operator=(const ExchangeContextPoolHook &) { return *this; }
+
+private:
+    friend class ExchangeManager;
+
+    ExchangeContext * mNext = nullptr; ///< next context on the free list or in the index bucket
+};
+
 class ExchangeContextDeletor
 {
 public:
@@ -164,6 +183,8 @@ private:
 
     BitFlags<uint16_t, ExFlagValues> mFlags; // Internal state flags
 
+    ExchangeContextPoolHook mPoolHook;
+
     /**
      *  Search for an existing exchange that the message applies to.
      *
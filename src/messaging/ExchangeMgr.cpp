@@ -31,6 +31,7 @@
 
 #include <cstring>
 #include <inttypes.h>
+#include <new>
 #include <stddef.h>
 
 #include <core/CHIPCore.h>
@@ -38,7 +39,9 @@
 #include <messaging/ExchangeContext.h>
 #include <messaging/ExchangeMgr.h>
 #include <support/CHIPFaultInjection.h>
+#include <support/CHIPMem.h>
 #include <support/CodeUtils.h>
+#include <support/HashUtils.h>
 #include <support/RandUtils.h>
 #include <support/logging/CHIPLogging.h>
 
@@ -61,6 +64,24 @@ namespace Messaging {
 ExchangeManager::ExchangeManager()
 {
     mState = State::kState_NotInitialized;
+
+    mIndexBuckets     = mFixedIndexBuckets;
+    mIndexBucketCount = kFixedIndexBucketCount;
+#if CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+    mContextChunks = nullptr;
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+
+    ResetContextPool();
+
+    memset(UMProtocolTable, 0, sizeof(UMProtocolTable));
+    mUMProtocolCount = 0;
+    mUMHandlerCount  = 0;
+}
+
+ExchangeManager::~ExchangeManager()
+{
+    ShrinkContextPool();
+    UnregisterAllUMHs();
 }
 
 CHIP_ERROR ExchangeManager::Init(SecureSessionMgr * sessionMgr)
@@ -73,8 +94,9 @@ CHIP_ERROR ExchangeManager::Init(SecureSessionMgr * sessionMgr)
     mNextExchangeId = GetRandU16();
 
     mContextsInUse = 0;
+    ResetContextPool();
 
-    memset(UMHandlerPool, 0, sizeof(UMHandlerPool));
+    UnregisterAllUMHs();
     OnExchangeContextChanged = nullptr;
 
     sessionMgr->SetDelegate(this);
@@ -94,6 +116,14 @@ CHIP_ERROR ExchangeManager::Shutdown()
 
     OnExchangeContextChanged = nullptr;
 
+    UnregisterAllUMHs();
+
+    // Contexts still in use may live in the chunks the pool grew, which are then kept until destruction
+    if (mContextsInUse == 0)
+    {
+        ShrinkContextPool();
+    }
+
     mState = State::kState_NotInitialized;
 
     return CHIP_NO_ERROR;
@@ -106,14 +136,15 @@ ExchangeContext * ExchangeManager::NewContext(const NodeId & peerNodeId, Exchang
 
 ExchangeContext * ExchangeManager::FindContext(NodeId peerNodeId, ExchangeDelegate * delegate, bool isInitiator)
 {
-    for (auto & ec : ContextPool)
-    {
-        if (ec.GetReferenceCount() > 0 && ec.GetPeerNodeId() == peerNodeId && ec.GetDelegate() == delegate &&
-            ec.IsInitiator() == isInitiator)
-            return &ec;
-    }
+    ExchangeContext * found = nullptr;
 
-    return nullptr;
+    ForEachContext([&](ExchangeContext * ec) {
+        if (found == nullptr && ec->GetPeerNodeId() == peerNodeId && ec->GetDelegate() == delegate &&
+            ec->IsInitiator() == isInitiator)
+            found = ec;
+    });
+
+    return found;
 }
 
 CHIP_ERROR ExchangeManager::RegisterUnsolicitedMessageHandler(uint32_t protocolId, ExchangeDelegate * delegate)
@@ -146,32 +177,217 @@ ExchangeContext * ExchangeManager::AllocContext(uint16_t ExchangeId, uint64_t Pe
 {
     CHIP_FAULT_INJECT(FaultInjection::kFault_AllocExchangeContext, return nullptr);
 
-    for (auto & ec : ContextPool)
+    if (mFreeContexts == nullptr && !GrowContextPool())
+    {
+        ChipLogError(ExchangeManager, "Alloc ctxt FAILED");
+        SYSTEM_STATS_INCREMENT(chip::System::Stats::kExchangeMgr_NumContextAllocFailures);
+        return nullptr;
+    }
+
+    ExchangeContext * ec = mFreeContexts;
+    mFreeContexts        = ec->mPoolHook.mNext;
+
+    ec->Alloc(this, ExchangeId, PeerNodeId, Initiator, delegate);
+
+    ExchangeContext ** bucket = IndexBucket(ec->mExchangeId, ec->mPeerNodeId, ec->IsInitiator());
+    ec->mPoolHook.mNext       = *bucket;
+    *bucket                   = ec;
+
+    return ec;
+}
+
+void ExchangeManager::ReleaseContext(ExchangeContext * ec)
+{
+    for (ExchangeContext ** link = IndexBucket(ec->mExchangeId, ec->mPeerNodeId, ec->IsInitiator()); *link != nullptr;
+         link                    = &(*link)->mPoolHook.mNext)
+    {
+        if (*link == ec)
+        {
+            *link = ec->mPoolHook.mNext;
+            break;
+        }
+    }
+
+    ec->mPoolHook.mNext = mFreeContexts;
+    mFreeContexts       = ec;
+}
+
+ExchangeContext * ExchangeManager::LookupContext(uint16_t exchangeId, NodeId peerNodeId, bool isInitiator)
+{
+    for (ExchangeContext * ec = *IndexBucket(exchangeId, peerNodeId, isInitiator); ec != nullptr; ec = ec->mPoolHook.mNext)
     {
-        if (ec.GetReferenceCount() == 0)
+        if (ec->mExchangeId == exchangeId && ec->mPeerNodeId == peerNodeId && ec->IsInitiator() == isInitiator)
         {
-            return ec.Alloc(this, ExchangeId, PeerNodeId, Initiator, delegate);
+            return ec;
         }
     }
 
-    ChipLogError(ExchangeManager, "Alloc ctxt FAILED");
     return nullptr;
 }
 
+ExchangeContext ** ExchangeManager::IndexBucket(uint16_t exchangeId, NodeId peerNodeId, bool isInitiator)
+{
+    uint32_t hash = HashCombine(HashMix(exchangeId | (isInitiator ? 0x10000u : 0u)), static_cast<uint32_t>(peerNodeId));
+
+    hash = HashCombine(hash, static_cast<uint32_t>(peerNodeId >> 32));
+
+    return &mIndexBuckets[hash & (mIndexBucketCount - 1)];
+}
+
+void ExchangeManager::ResetContextPool()
+{
+    mFreeContexts    = nullptr;
+    mContextCapacity = ContextPool.size();
+
+    // Chain the free contexts in pool order, so they are handed out in the same order as before
+    for (size_t i = ContextPool.size(); i > 0; i--)
+    {
+        ContextPool[i - 1].mPoolHook.mNext = mFreeContexts;
+        mFreeContexts                      = &ContextPool[i - 1];
+    }
+
+#if CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+    for (ContextChunk * chunk = mContextChunks; chunk != nullptr; chunk = chunk->mNext)
+    {
+        ChainFreeContexts(chunk);
+    }
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+
+    for (size_t i = 0; i < mIndexBucketCount; i++)
+    {
+        mIndexBuckets[i] = nullptr;
+    }
+}
+
+bool ExchangeManager::GrowContextPool()
+{
+#if CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+    constexpr size_t kChunkSize = CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_CHUNK_SIZE;
+
+    void * memory = (mContextCapacity + kChunkSize <= CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_MAX_SIZE)
+        ? Platform::MemoryAlloc(sizeof(ContextChunk))
+        : nullptr;
+
+    if (memory == nullptr)
+    {
+        return false;
+    }
+
+    ContextChunk * chunk = new (memory) ContextChunk();
+    chunk->mNext         = mContextChunks;
+    mContextChunks       = chunk;
+    ChainFreeContexts(chunk);
+    ResizeIndex();
+
+    return true;
+#else  // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+    return false;
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+}
+
+#if CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+void ExchangeManager::ChainFreeContexts(ContextChunk * chunk)
+{
+    for (size_t i = CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_CHUNK_SIZE; i > 0; i--)
+    {
+        chunk->mContexts[i - 1].mPoolHook.mNext = mFreeContexts;
+        mFreeContexts                           = &chunk->mContexts[i - 1];
+    }
+
+    mContextCapacity += CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_CHUNK_SIZE;
+}
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+
+void ExchangeManager::ShrinkContextPool()
+{
+#if CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+    while (mContextChunks != nullptr)
+    {
+        ContextChunk * chunk = mContextChunks;
+        mContextChunks       = chunk->mNext;
+
+        chunk->~ContextChunk();
+        Platform::MemoryFree(chunk);
+    }
+
+    if (mIndexBuckets != mFixedIndexBuckets)
+    {
+        Platform::MemoryFree(mIndexBuckets);
+        mIndexBuckets     = mFixedIndexBuckets;
+        mIndexBucketCount = kFixedIndexBucketCount;
+    }
+
+    ResetContextPool();
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+}
+
+void ExchangeManager::ResizeIndex()
+{
+    const size_t bucketCount = HashBucketCountFor(mContextCapacity);
+
+    if (bucketCount <= mIndexBucketCount)
+    {
+        return;
+    }
+
+    ExchangeContext ** buckets = static_cast<ExchangeContext **>(Platform::MemoryAlloc(sizeof(ExchangeContext *) * bucketCount));
+
+    if (buckets == nullptr)
+    {
+        return; // keep the current buckets, lookups remain correct with longer chains
+    }
+
+    ExchangeContext ** oldBuckets = mIndexBuckets;
+    const size_t oldBucketCount   = mIndexBucketCount;
+
+    mIndexBuckets     = buckets;
+    mIndexBucketCount = bucketCount;
+    for (size_t i = 0; i < bucketCount; i++)
+    {
+        mIndexBuckets[i] = nullptr;
+    }
+
+    for (size_t i = 0; i < oldBucketCount; i++)
+    {
+        while (oldBuckets[i] != nullptr)
+        {
+            ExchangeContext * ec = oldBuckets[i];
+            oldBuckets[i]        = ec->mPoolHook.mNext;
+
+            ExchangeContext ** bucket = IndexBucket(ec->mExchangeId, ec->mPeerNodeId, ec->IsInitiator());
+            ec->mPoolHook.mNext       = *bucket;
+            *bucket                   = ec;
+        }
+    }
+
+    if (oldBuckets != mFixedIndexBuckets)
+    {
+        Platform::MemoryFree(oldBuckets);
+    }
+}
+
 void ExchangeManager::DispatchMessage(const PacketHeader & packetHeader, const PayloadHeader & payloadHeader,
                                       System::PacketBufferHandle msgBuf)
 {
-    UnsolicitedMessageHandler * umh         = nullptr;
-    UnsolicitedMessageHandler * matchingUMH = nullptr;
-    CHIP_ERROR err                          = CHIP_NO_ERROR;
+    ExchangeDelegate * matchingUMH = nullptr;
+    CHIP_ERROR err                 = CHIP_NO_ERROR;
 
-    // Search for an existing exchange that the message applies to. If a match is found...
-    for (auto & ec : ContextPool)
+    // Search for an existing exchange that the message applies to: one with the peer node that sent it, or with any
+    // peer node, and on the other side of the exchange than the sender. If a match is found...
     {
-        if (ec.GetReferenceCount() > 0 && ec.MatchExchange(packetHeader, payloadHeader))
+        const uint16_t exchangeId = payloadHeader.GetExchangeID();
+        const bool isInitiator    = !payloadHeader.IsInitiator();
+        ExchangeContext * ec      = LookupContext(exchangeId, packetHeader.GetSourceNodeId().ValueOr(kAnyNodeId), isInitiator);
+
+        if (ec == nullptr)
+        {
+            ec = LookupContext(exchangeId, kAnyNodeId, isInitiator);
+        }
+
+        if (ec != nullptr)
         {
             // Matched ExchangeContext; send to message handler.
-            ec.HandleMessage(packetHeader, payloadHeader, std::move(msgBuf));
+            ec->HandleMessage(packetHeader, payloadHeader, std::move(msgBuf));
 
             ExitNow(err = CHIP_NO_ERROR);
         }
@@ -184,23 +400,15 @@ void ExchangeManager::DispatchMessage(const PacketHeader & packetHeader, const P
     {
         // Search for an unsolicited message handler that can handle the message. Prefer handlers that can explicitly
         // handle the message type over handlers that handle all messages for a profile.
-        umh = (UnsolicitedMessageHandler *) UMHandlerPool;
-
-        matchingUMH = nullptr;
+        UnsolicitedMessageProtocol * protocol = FindUMProtocol(payloadHeader.GetProtocolID());
 
-        for (int i = 0; i < CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS; i++, umh++)
+        if (protocol != nullptr)
         {
-            if (umh->Delegate != nullptr && umh->ProtocolId == payloadHeader.GetProtocolID())
-            {
-                if (umh->MessageType == payloadHeader.GetMessageType())
-                {
-                    matchingUMH = umh;
-                    break;
-                }
-
-                if (umh->MessageType == kAnyMessageType)
-                    matchingUMH = umh;
-            }
+            if (protocol->MessageTypes != nullptr)
+                matchingUMH = protocol->MessageTypes[payloadHeader.GetMessageType()];
+
+            if (matchingUMH == nullptr)
+                matchingUMH = protocol->AnyMessageType;
         }
     }
     // Discard the message if it isn't marked as being sent by an initiator.
@@ -212,12 +420,10 @@ void ExchangeManager::DispatchMessage(const PacketHeader & packetHeader, const P
     // If we found a handler or we need to create a new exchange context (EC).
     if (matchingUMH != nullptr)
     {
-        auto * ec =
-            AllocContext(payloadHeader.GetExchangeID(), packetHeader.GetSourceNodeId().Value(), false, matchingUMH->Delegate);
+        auto * ec = AllocContext(payloadHeader.GetExchangeID(), packetHeader.GetSourceNodeId().Value(), false, matchingUMH);
         VerifyOrExit(ec != nullptr, err = CHIP_ERROR_NO_MEMORY);
 
-        ChipLogProgress(ExchangeManager, "ec pos: %d, id: %d, Delegate: 0x%x", ec - ContextPool.begin(), ec->GetExchangeId(),
-                        ec->GetDelegate());
+        ChipLogProgress(ExchangeManager, "ec id: %d, Delegate: 0x%x", ec->GetExchangeId(), ec->GetDelegate());
 
         ec->HandleMessage(packetHeader, payloadHeader, std::move(msgBuf));
     }
@@ -231,29 +437,40 @@ exit:
 
 CHIP_ERROR ExchangeManager::RegisterUMH(uint32_t protocolId, int16_t msgType, ExchangeDelegate * delegate)
 {
-    UnsolicitedMessageHandler * umh      = UMHandlerPool;
-    UnsolicitedMessageHandler * selected = nullptr;
+    UnsolicitedMessageProtocol * protocol = FindUMProtocol(protocolId);
+    ExchangeDelegate ** umh               = (protocol != nullptr) ? UMHSlot(protocol, msgType) : nullptr;
 
-    for (int i = 0; i < CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS; i++, umh++)
+    if (umh != nullptr && *umh != nullptr)
     {
-        if (umh->Delegate == nullptr)
-        {
-            if (selected == nullptr)
-                selected = umh;
-        }
-        else if (umh->ProtocolId == protocolId && umh->MessageType == msgType)
-        {
-            umh->Delegate = delegate;
-            return CHIP_NO_ERROR;
-        }
+        *umh = delegate;
+        return CHIP_NO_ERROR;
     }
 
-    if (selected == nullptr)
+    if (mUMHandlerCount >= CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS)
         return CHIP_ERROR_TOO_MANY_UNSOLICITED_MESSAGE_HANDLERS;
 
-    selected->Delegate    = delegate;
-    selected->ProtocolId  = protocolId;
-    selected->MessageType = msgType;
+    if (protocol == nullptr)
+    {
+        protocol = AddUMProtocol(protocolId);
+        if (protocol == nullptr)
+            return CHIP_ERROR_TOO_MANY_UNSOLICITED_MESSAGE_HANDLERS;
+    }
+
+    if (msgType != kAnyMessageType && protocol->MessageTypes == nullptr)
+    {
+        protocol->MessageTypes =
+            static_cast<ExchangeDelegate **>(chip::Platform::MemoryCalloc(kMessageTypeCount, sizeof(ExchangeDelegate *)));
+        if (protocol->MessageTypes == nullptr)
+        {
+            if (protocol->HandlerCount == 0)
+                RemoveUMProtocol(protocol);
+            return CHIP_ERROR_NO_MEMORY;
+        }
+    }
+
+    *UMHSlot(protocol, msgType) = delegate;
+    protocol->HandlerCount++;
+    mUMHandlerCount++;
 
     SYSTEM_STATS_INCREMENT(chip::System::Stats::kExchangeMgr_NumUMHandlers);
 
@@ -262,19 +479,110 @@ CHIP_ERROR ExchangeManager::RegisterUMH(uint32_t protocolId, int16_t msgType, Ex
 
 CHIP_ERROR ExchangeManager::UnregisterUMH(uint32_t protocolId, int16_t msgType)
 {
-    UnsolicitedMessageHandler * umh = UMHandlerPool;
+    UnsolicitedMessageProtocol * protocol = FindUMProtocol(protocolId);
+    ExchangeDelegate ** umh               = (protocol != nullptr) ? UMHSlot(protocol, msgType) : nullptr;
+
+    if (umh == nullptr || *umh == nullptr)
+        return CHIP_ERROR_NO_UNSOLICITED_MESSAGE_HANDLER;
+
+    *umh = nullptr;
+    protocol->HandlerCount--;
+    mUMHandlerCount--;
+    SYSTEM_STATS_DECREMENT(chip::System::Stats::kExchangeMgr_NumUMHandlers);
+
+    // Give the message type table back along with the last handler in it
+    if (protocol->HandlerCount == ((protocol->AnyMessageType != nullptr) ? 1 : 0) && protocol->MessageTypes != nullptr)
+    {
+        chip::Platform::MemoryFree(protocol->MessageTypes);
+        protocol->MessageTypes = nullptr;
+    }
+
+    if (protocol->HandlerCount == 0)
+        RemoveUMProtocol(protocol);
+
+    return CHIP_NO_ERROR;
+}
+
+void ExchangeManager::UnregisterAllUMHs()
+{
+    for (auto & protocol : UMProtocolTable)
+    {
+        if (protocol.HandlerCount != 0)
+        {
+            chip::Platform::MemoryFree(protocol.MessageTypes);
+        }
+    }
+
+    SYSTEM_STATS_DECREMENT_BY_N(chip::System::Stats::kExchangeMgr_NumUMHandlers,
+                                static_cast<chip::System::Stats::count_t>(mUMHandlerCount));
 
-    for (int i = 0; i < CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS; i++, umh++)
+    memset(UMProtocolTable, 0, sizeof(UMProtocolTable));
+    mUMProtocolCount = 0;
+    mUMHandlerCount  = 0;
+}
+
+ExchangeManager::UnsolicitedMessageProtocol * ExchangeManager::FindUMProtocol(uint32_t protocolId)
+{
+    for (size_t i = HashMix(protocolId) & (kUMProtocolTableSize - 1); UMProtocolTable[i].HandlerCount != 0;
+         i        = (i + 1) & (kUMProtocolTableSize - 1))
     {
-        if (umh->Delegate != nullptr && umh->ProtocolId == protocolId && umh->MessageType == msgType)
+        if (UMProtocolTable[i].ProtocolId == protocolId)
+            return &UMProtocolTable[i];
+    }
+
+    return nullptr;
+}
+
+ExchangeManager::UnsolicitedMessageProtocol * ExchangeManager::AddUMProtocol(uint32_t protocolId)
+{
+    size_t i = HashMix(protocolId) & (kUMProtocolTableSize - 1);
+
+    // The table is kept at most half full, so probe sequences stay short
+    if (mUMProtocolCount >= CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS)
+        return nullptr;
+
+    while (UMProtocolTable[i].HandlerCount != 0)
+    {
+        i = (i + 1) & (kUMProtocolTableSize - 1);
+    }
+
+    // The entry only counts as taken once its first handler is registered
+    UMProtocolTable[i].ProtocolId     = protocolId;
+    UMProtocolTable[i].AnyMessageType = nullptr;
+    UMProtocolTable[i].MessageTypes   = nullptr;
+    mUMProtocolCount++;
+
+    return &UMProtocolTable[i];
+}
+
+void ExchangeManager::RemoveUMProtocol(UnsolicitedMessageProtocol * protocol)
+{
+    constexpr size_t kMask = kUMProtocolTableSize - 1;
+    size_t hole            = static_cast<size_t>(protocol - UMProtocolTable);
+
+    protocol->HandlerCount = 0;
+    mUMProtocolCount--;
+
+    // Shift back the entries probed past the freed one, so lookups still find them without tombstones
+    for (size_t i = (hole + 1) & kMask; UMProtocolTable[i].HandlerCount != 0; i = (i + 1) & kMask)
+    {
+        size_t home = HashMix(UMProtocolTable[i].ProtocolId) & kMask;
+
+        if (((i - home) & kMask) >= ((i - hole) & kMask))
         {
-            umh->Delegate = nullptr;
-            SYSTEM_STATS_DECREMENT(chip::System::Stats::kExchangeMgr_NumUMHandlers);
-            return CHIP_NO_ERROR;
+            UMProtocolTable[hole]           = UMProtocolTable[i];
+            UMProtocolTable[i].HandlerCount = 0;
+            hole                            = i;
         }
     }
+}
 
-    return CHIP_ERROR_NO_UNSOLICITED_MESSAGE_HANDLER;
+ExchangeDelegate ** ExchangeManager::UMHSlot(UnsolicitedMessageProtocol * protocol, int16_t msgType)
+{
+    if (msgType == kAnyMessageType)
+        return &protocol->AnyMessageType;
+
+    return (protocol->MessageTypes != nullptr) ? &protocol->MessageTypes[msgType] : nullptr;
 }
 
 void ExchangeManager::OnMessageReceived(const PacketHeader & packetHeader, const PayloadHeader & payloadHeader,
@@ -286,14 +594,13 @@ void ExchangeManager::OnMessageReceived(const PacketHeader & packetHeader, const
 
 void ExchangeManager::OnConnectionExpired(const Transport::PeerConnectionState * state, SecureSessionMgr * mgr)
 {
-    for (auto & ec : ContextPool)
-    {
-        if (ec.GetReferenceCount() > 0 && ec.mPeerNodeId == state->GetPeerNodeId())
+    ForEachContext([state](ExchangeContext * ec) {
+        if (ec->mPeerNodeId == state->GetPeerNodeId())
         {
-            ec.Close();
+            ec->Close();
             // Continue iterate because there can be multiple contexts associated with the connection.
         }
-    }
+    });
 }
 
 void ExchangeManager::IncrementContextsInUse()
@@ -28,6 +28,7 @@
 
 #include <messaging/ExchangeContext.h>
 #include <support/DLLUtil.h>
+#include <support/HashUtils.h>
 #include <transport/SecureSessionMgr.h>
 
 namespace chip {
@@ -48,6 +49,7 @@ class DLL_EXPORT ExchangeManager : public SecureSessionMgrDelegate
 {
 public:
     ExchangeManager();
+    ~ExchangeManager();
     ExchangeManager(const ExchangeManager &) = delete;
     ExchangeManager operator=(const ExchangeManager &) = delete;
 
@@ -72,7 +74,8 @@ public:
      *
      *  @note
      *     The protocol should only call this function after ensuring that
-     *     there are no active ExchangeContext objects. Furthermore, it is the
+     *     there are no active ExchangeContext objects; exchange contexts the
+     *     pool grew on the heap are only given back then. Furthermore, it is the
      *     onus of the application to de-allocate the ExchangeManager
      *     object after calling ExchangeManager::Shutdown().
      *
@@ -167,18 +170,34 @@ public:
 
     size_t GetContextsInUse() const { return mContextsInUse; }
 
+    /// Number of exchange contexts that can be in use at the same time without growing the pool.
+    size_t GetContextCapacity() const { return mContextCapacity; }
+
 private:
+    friend class ExchangeContext;
+
+    static constexpr size_t kFixedIndexBucketCount = HashBucketCountFor(CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS);
+
     enum class State
     {
         kState_NotInitialized = 0, // Used to indicate that the ExchangeManager is not initialized.
         kState_Initialized    = 1  // Used to indicate that the ExchangeManager is initialized.
     };
 
-    struct UnsolicitedMessageHandler
+    static constexpr size_t kMessageTypeCount    = UINT8_MAX + 1;
+    static constexpr size_t kUMProtocolTableSize = HashBucketCountFor(2 * CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS);
+
+    /**
+     * The unsolicited message handlers registered for a protocol: one per
+     * message type, indexed by message type, and one for the message types
+     * without a handler of their own.
+     */
+    struct UnsolicitedMessageProtocol
     {
-        ExchangeDelegate * Delegate;
         uint32_t ProtocolId;
-        int16_t MessageType;
+        uint16_t HandlerCount; // number of handlers registered, 0 if the entry is free
+        ExchangeDelegate * AnyMessageType;
+        ExchangeDelegate ** MessageTypes; // kMessageTypeCount entries, nullptr while no message type has a handler
     };
 
     uint16_t mNextExchangeId;
@@ -187,16 +206,85 @@ private:
 
     std::array<ExchangeContext, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS> ContextPool;
     size_t mContextsInUse;
+    size_t mContextCapacity;
+
+    // Contexts not in use, chained through their pool hook.
+    ExchangeContext * mFreeContexts;
+
+    // Contexts in use, hashed by exchange ID, peer node ID and initiator flag and
+    // chained through their pool hook. The buckets are mFixedIndexBuckets until
+    // the pool grows past them.
+    ExchangeContext ** mIndexBuckets;
+    size_t mIndexBucketCount;
+    ExchangeContext * mFixedIndexBuckets[kFixedIndexBucketCount];
 
-    UnsolicitedMessageHandler UMHandlerPool[CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS];
+#if CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+    struct ContextChunk
+    {
+        ContextChunk * mNext;
+        ExchangeContext mContexts[CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_CHUNK_SIZE];
+    };
+
+    // Contexts added to ContextPool when it runs out, allocated from the platform heap.
+    ContextChunk * mContextChunks;
+
+    void ChainFreeContexts(ContextChunk * chunk);
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+
+    // Protocols with unsolicited message handlers, hashed by protocol ID with linear probing.
+    UnsolicitedMessageProtocol UMProtocolTable[kUMProtocolTableSize];
+    size_t mUMProtocolCount;
+    size_t mUMHandlerCount;
     void (*OnExchangeContextChanged)(size_t numContextsInUse);
 
     ExchangeContext * AllocContext(uint16_t ExchangeId, uint64_t PeerNodeId, bool Initiator, ExchangeDelegate * delegate);
 
+    /// Unindex a context being freed and put it back on the free list; called by ExchangeContext::Free.
+    void ReleaseContext(ExchangeContext * ec);
+
+    ExchangeContext * LookupContext(uint16_t exchangeId, NodeId peerNodeId, bool isInitiator);
+    ExchangeContext ** IndexBucket(uint16_t exchangeId, NodeId peerNodeId, bool isInitiator);
+    void ResetContextPool();
+    bool GrowContextPool();
+    void ShrinkContextPool();
+    void ResizeIndex();
+
+    /// Call `function` on every context in use.
+    template <typename Function>
+    void ForEachContext(Function function)
+    {
+        for (auto & ec : ContextPool)
+        {
+            if (ec.GetReferenceCount() > 0)
+            {
+                function(&ec);
+            }
+        }
+
+#if CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+        for (ContextChunk * chunk = mContextChunks; chunk != nullptr; chunk = chunk->mNext)
+        {
+            for (auto & ec : chunk->mContexts)
+            {
+                if (ec.GetReferenceCount() > 0)
+                {
+                    function(&ec);
+                }
+            }
+        }
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+    }
+
     void DispatchMessage(const PacketHeader & packetHeader, const PayloadHeader & payloadHeader, System::PacketBufferHandle msgBuf);
 
     CHIP_ERROR RegisterUMH(uint32_t protocolId, int16_t msgType, ExchangeDelegate * delegate);
     CHIP_ERROR UnregisterUMH(uint32_t protocolId, int16_t msgType);
+    void UnregisterAllUMHs();
+
+    UnsolicitedMessageProtocol * FindUMProtocol(uint32_t protocolId);
+    UnsolicitedMessageProtocol * AddUMProtocol(uint32_t protocolId);
+    void RemoveUMProtocol(UnsolicitedMessageProtocol * protocol);
+    static ExchangeDelegate ** UMHSlot(UnsolicitedMessageProtocol * protocol, int16_t msgType);
 
     void OnReceiveError(CHIP_ERROR error, const Transport::PeerAddress & source, SecureSessionMgr * msgLayer) override;
 
@@ -42,10 +42,15 @@ void ReliableMessageContextDeletor::Release(ReliableMessageContext * obj)
 }
 
 ReliableMessageContext::ReliableMessageContext() :
-    mConfig(gDefaultReliableMessageProtocolConfig), mNextAckTimeTick(0), mThrottleTimeoutTick(0), mPendingPeerAckId(0),
-    mDelegate(nullptr)
+    mManager(nullptr), mConfig(gDefaultReliableMessageProtocolConfig), mPeerNodeId(kUndefinedNodeId), mNextAckTimeTick(0),
+    mThrottleTimeoutTick(0), mPendingPeerAckId(0), mPrevPendingAck(nullptr), mNextPendingAck(nullptr), mDelegate(nullptr)
 {}
 
+ReliableMessageContext::~ReliableMessageContext()
+{
+    SetAckPending(false);
+}
+
 /**
  *  Determine whether there is already an acknowledgment pending to be sent
  *  to the peer on this exchange.
@@ -102,6 +107,19 @@ void ReliableMessageContext::SetMsgRcvdFromPeer(bool inMsgRcvdFromPeer)
  */
 void ReliableMessageContext::SetAckPending(bool inAckPending)
 {
+    // Keep the manager's list of contexts with an acknowledgment pending up to date
+    if (inAckPending != IsAckPending() && mManager != nullptr)
+    {
+        if (inAckPending)
+        {
+            mManager->AddPendingAck(this);
+        }
+        else
+        {
+            mManager->RemovePendingAck(this);
+        }
+    }
+
     mFlags.Set(Flags::kFlagAckPending, inAckPending);
 }
 
@@ -162,6 +180,7 @@ CHIP_ERROR ReliableMessageContext::FlushAcks()
 #if !defined(NDEBUG)
             ChipLogProgress(ExchangeManager, "Flushed pending ack for MsgId:%08" PRIX32, mPendingPeerAckId);
 #endif
+            SetAckPending(false);
         }
     }
 
@@ -177,7 +196,9 @@ CHIP_ERROR ReliableMessageContext::FlushAcks()
  */
 uint64_t ReliableMessageContext::GetCurrentRetransmitTimeoutTick()
 {
-    return (HasRcvdMsgFromPeer() ? mConfig.mActiveRetransTimeoutTick : mConfig.mInitialRetransTimeoutTick);
+    uint64_t configTimeoutTick = HasRcvdMsgFromPeer() ? mConfig.mActiveRetransTimeoutTick : mConfig.mInitialRetransTimeoutTick;
+
+    return mManager->GetRetransmitTimeoutTick(mPeerNodeId, configTimeoutTick);
 }
 
 /**
@@ -347,9 +368,6 @@ CHIP_ERROR ReliableMessageContext::HandleNeedsAck(uint32_t MessageId, BitFlags<u
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
 
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    mManager->ExpireTicks();
-
     // If the message IS a duplicate.
     if (MsgFlags.Has(MessageFlagValues::kMessageFlag_DuplicateMessage))
     {
@@ -394,8 +412,8 @@ CHIP_ERROR ReliableMessageContext::HandleNeedsAck(uint32_t MessageId, BitFlags<u
 
         // Replace the Pending ack id.
         mPendingPeerAckId = MessageId;
-        mNextAckTimeTick  = static_cast<uint16_t>(mConfig.mAckPiggybackTimeoutTick +
-                                                 mManager->GetTickCounterFromTimeDelta(System::Timer::GetCurrentEpoch()));
+        mNextAckTimeTick =
+            mConfig.mAckPiggybackTimeoutTick + mManager->GetTickCounterFromTimeDelta(System::Timer::GetCurrentEpoch());
         SetAckPending(true);
     }
 
@@ -407,16 +425,12 @@ exit:
 
 CHIP_ERROR ReliableMessageContext::HandleThrottleFlow(uint32_t PauseTimeMillis)
 {
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    mManager->ExpireTicks();
-
     // Flow Control Message Received; Adjust Throttle timeout accordingly.
     // A PauseTimeMillis of zero indicates that peer is unthrottling this Exchange.
 
     if (0 != PauseTimeMillis)
     {
-        mThrottleTimeoutTick =
-            static_cast<uint16_t>(mManager->GetTickCounterFromTimeDelta(System::Timer::GetCurrentEpoch() + PauseTimeMillis));
+        mThrottleTimeoutTick = mManager->GetTickCounterFromTimeDelta(System::Timer::GetCurrentEpoch() + PauseTimeMillis);
         mManager->PauseRetransTable(this, PauseTimeMillis);
     }
     else
@@ -457,6 +471,10 @@ CHIP_ERROR ReliableMessageContext::SendCommonNullMessage()
     err = mManager->SendMessage(this, chip::Protocols::kProtocol_Protocol_Common, chip::Protocols::Common::kMsgType_Null,
                                 msgBuf.Release_ForNow(),
                                 BitFlags<uint16_t, SendMessageFlags>{ SendMessageFlags::kSendFlag_NoAutoRequestAck });
+    if (err == CHIP_NO_ERROR)
+    {
+        mManager->mAckStats.standalone++;
+    }
 
 exit:
     if (IsSendErrorNonCritical(err))
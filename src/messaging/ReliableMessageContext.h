@@ -67,9 +67,12 @@ public:
     friend class ReliableMessageContextDeletor;
 
     ReliableMessageContext();
+    ~ReliableMessageContext();
 
     void Init(ReliableMessageManager * manager) { mManager = manager; }
     void SetConfig(ReliableMessageProtocolConfig config) { mConfig = config; }
+    void SetPeerNodeId(NodeId peerNodeId) { mPeerNodeId = peerNodeId; }
+    NodeId GetPeerNodeId() const { return mPeerNodeId; }
     void SetDelegate(ReliableMessageDelegate * delegate) { mDelegate = delegate; }
 
     CHIP_ERROR FlushAcks();
@@ -124,9 +127,12 @@ private:
 
     ReliableMessageManager * mManager;
     ReliableMessageProtocolConfig mConfig;
-    uint16_t mNextAckTimeTick;     // Next time for triggering Solo Ack
-    uint16_t mThrottleTimeoutTick; // Timeout until when Throttle is On when ThrottleEnabled is set
+    NodeId mPeerNodeId;            // Node ID of the peer, whose round-trip time sets the retransmission timeout
+    uint64_t mNextAckTimeTick;     // Next time for triggering Solo Ack
+    uint64_t mThrottleTimeoutTick; // Timeout until when Throttle is On when ThrottleEnabled is set
     uint32_t mPendingPeerAckId;
+    ReliableMessageContext * mPrevPendingAck; // Links in the manager's list of contexts with an acknowledgment pending
+    ReliableMessageContext * mNextPendingAck;
 
     ReliableMessageDelegate * mDelegate;
 };
@@ -21,6 +21,7 @@
  *
  */
 
+#include <algorithm>
 #include <inttypes.h>
 
 #include <messaging/ReliableMessageManager.h>
@@ -37,32 +38,50 @@ namespace chip {
 namespace Messaging {
 
 ReliableMessageManager::RetransTableEntry::RetransTableEntry() :
-    rc(nullptr), msgBuf(nullptr), msgId(0), msgSendFlags(0), nextRetransTimeTick(0), sendCount(0)
+    rc(nullptr), msgBuf(nullptr), msgId(0), msgSendFlags(0), nextRetransTimeTick(0), firstSendTime(0), retransTimeoutTick(0),
+    sendCount(0), next(nullptr), heapIndex(0)
 {}
 
 ReliableMessageManager::ReliableMessageManager() :
     mTimeStampBase(System::Timer::GetCurrentEpoch()), mCurrentTimerExpiry(0),
-    mTimerIntervalShift(CHIP_CONFIG_RMP_TIMER_DEFAULT_PERIOD_SHIFT)
-{}
+    mTimerIntervalShift(CHIP_CONFIG_RMP_TIMER_DEFAULT_PERIOD_SHIFT),
+    mAdaptiveRetransTimeout(CHIP_CONFIG_RMP_ADAPTIVE_RETRANS_TIMEOUT != 0), mSendWindow(CHIP_CONFIG_RMP_SEND_WINDOW != 0),
+    mSendingQueuedMessages(false), mFreeRetransEntries(nullptr), mRetransCount(0), mFreeQueuedMessages(nullptr),
+    mPendingAcks(nullptr), mAckStats()
+{
+    for (size_t i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    {
+        mRetransHeap[i]      = nullptr;
+        mRetransBuckets[i]   = nullptr;
+        RetransTable[i].next = mFreeRetransEntries;
+        mFreeRetransEntries  = &RetransTable[i];
+    }
+
+    for (PeerState & peer : mPeers)
+    {
+        peer = PeerState();
+    }
+
+    for (QueuedMessage & message : mSendQueue)
+    {
+        message.next        = mFreeQueuedMessages;
+        mFreeQueuedMessages = &message;
+    }
+}
 
 ReliableMessageManager::~ReliableMessageManager() {}
 
 void ReliableMessageManager::ProcessDelayedDeliveryMessage(ReliableMessageContext * rc, uint32_t PauseTimeMillis)
 {
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    ExpireTicks();
-
     // Go through the retrans table entries for that node and adjust the timer.
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    for (RetransTableEntry * entry = *RetransBucket(rc); entry != nullptr; entry = entry->next)
     {
-        // Exchcontext is the sentinel object to ascertain validity of the element
-        if (RetransTable[i].rc && RetransTable[i].rc == rc)
+        if (entry->rc == rc)
         {
             // Paustime is specified in milliseconds; Update retrans values
-            RetransTable[i].nextRetransTimeTick =
-                static_cast<uint16_t>(RetransTable[i].nextRetransTimeTick + (PauseTimeMillis >> mTimerIntervalShift));
-        } // exchContext
-    }     // for loop in table entry
+            SetRetransTime(*entry, entry->nextRetransTimeTick + GetTickCounterFromTimePeriod(PauseTimeMillis));
+        }
+    }
 
     // Schedule next physical wakeup
     StartTimer();
@@ -92,18 +111,311 @@ uint64_t ReliableMessageManager::GetTickCounterFromTimeDelta(uint64_t newTime)
     return GetTickCounterFromTimePeriod(newTime - mTimeStampBase);
 }
 
+/**
+ * Return the bucket of the retransmission table entries of a context.
+ */
+ReliableMessageManager::RetransTableEntry ** ReliableMessageManager::RetransBucket(const ReliableMessageContext * rc)
+{
+    // Fibonacci hashing spreads the aligned context addresses over the buckets
+    uint64_t hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(rc)) * UINT64_C(0x9E3779B97F4A7C15);
+    return &mRetransBuckets[(hash >> 32) % CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE];
+}
+
+/**
+ * Return the first retransmission table entry of a context, or nullptr if it has none.
+ */
+ReliableMessageManager::RetransTableEntry * ReliableMessageManager::FindRetransEntry(ReliableMessageContext * rc)
+{
+    RetransTableEntry * entry = *RetransBucket(rc);
+
+    while (entry != nullptr && entry->rc != rc)
+    {
+        entry = entry->next;
+    }
+
+    return entry;
+}
+
+/**
+ * Set the retransmission tick of an entry in use, and restore the heap order around it.
+ */
+void ReliableMessageManager::SetRetransTime(RetransTableEntry & entry, uint64_t tick)
+{
+    uint64_t previous         = entry.nextRetransTimeTick;
+    entry.nextRetransTimeTick = tick;
+
+    if (tick < previous)
+    {
+        SiftUpRetransHeap(entry.heapIndex);
+    }
+    else
+    {
+        SiftDownRetransHeap(entry.heapIndex);
+    }
+}
+
+void ReliableMessageManager::SwapRetransHeap(size_t a, size_t b)
+{
+    RetransTableEntry * entry = mRetransHeap[a];
+
+    mRetransHeap[a]            = mRetransHeap[b];
+    mRetransHeap[b]            = entry;
+    mRetransHeap[a]->heapIndex = a;
+    mRetransHeap[b]->heapIndex = b;
+}
+
+void ReliableMessageManager::SiftUpRetransHeap(size_t index)
+{
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+
+        if (mRetransHeap[parent]->nextRetransTimeTick <= mRetransHeap[index]->nextRetransTimeTick)
+            break;
+
+        SwapRetransHeap(parent, index);
+        index = parent;
+    }
+}
+
+void ReliableMessageManager::SiftDownRetransHeap(size_t index)
+{
+    for (;;)
+    {
+        size_t earliest = index;
+        size_t left     = 2 * index + 1;
+        size_t right    = left + 1;
+
+        if (left < mRetransCount && mRetransHeap[left]->nextRetransTimeTick < mRetransHeap[earliest]->nextRetransTimeTick)
+            earliest = left;
+        if (right < mRetransCount && mRetransHeap[right]->nextRetransTimeTick < mRetransHeap[earliest]->nextRetransTimeTick)
+            earliest = right;
+        if (earliest == index)
+            break;
+
+        SwapRetransHeap(index, earliest);
+        index = earliest;
+    }
+}
+
+/**
+ * Return the state of a peer.
+ *
+ * @param[in]  peerNodeId  The node ID of the peer.
+ * @param[in]  create      Whether to take over the state of the idle peer used least recently if the peer has none yet.
+ *
+ * @return The state of the peer, or nullptr if it has none and none could be taken over.
+ */
+ReliableMessageManager::PeerState * ReliableMessageManager::FindPeerState(NodeId peerNodeId, bool create)
+{
+    PeerState * oldest = nullptr;
+
+    if (peerNodeId == kUndefinedNodeId)
+        return nullptr;
+
+    for (PeerState & peer : mPeers)
+    {
+        if (peer.peerNodeId == peerNodeId)
+        {
+            return &peer;
+        }
+        if (peer.IsIdle() && (oldest == nullptr || peer.lastUsedTime < oldest->lastUsedTime))
+        {
+            oldest = &peer;
+        }
+    }
+
+    if (!create || oldest == nullptr)
+        return nullptr;
+
+    *oldest            = PeerState();
+    oldest->peerNodeId = peerNodeId;
+    oldest->sendWindow = CHIP_CONFIG_RMP_INITIAL_SEND_WINDOW;
+    return oldest;
+}
+
+/**
+ * Account for the acknowledgment of a retransmission table entry in the
+ * round-trip time of its peer.
+ *
+ * The round-trip time is smoothed as for TCP (RFC 6298). Acknowledgments of
+ * retransmitted messages are not measured, since they cannot be told apart
+ * from those of the earlier transmissions (Karn's algorithm). The timeout
+ * backed off by their retransmissions is kept until a measurement is made.
+ */
+void ReliableMessageManager::UpdatePeerRtt(PeerState & peer, const RetransTableEntry & entry)
+{
+    uint64_t now = System::Timer::GetCurrentEpoch();
+
+    if (entry.sendCount > 1)
+    {
+        peer.ignoredSampleCount++;
+        return;
+    }
+
+    AddRttSample(peer, static_cast<uint32_t>(std::min<uint64_t>(now - entry.firstSendTime, UINT32_MAX >> 3)));
+}
+
+/**
+ * Smooth a round-trip time measured to a peer into its statistics, and drop
+ * the timeout backed off since the previous measurement.
+ */
+void ReliableMessageManager::AddRttSample(PeerState & peer, uint32_t rtt)
+{
+    peer.backoffTimeoutTick = 0;
+
+    if (peer.sampleCount == 0)
+    {
+        peer.smoothedRtt = rtt << 3;
+        peer.rttVariance = rtt << 1;
+    }
+    else
+    {
+        // srtt += (rtt - srtt) / 8 and rttvar += (|rtt - srtt| - rttvar) / 4, in their fixed point units
+        uint32_t srtt  = peer.smoothedRtt >> 3;
+        uint32_t delta = (rtt > srtt) ? rtt - srtt : srtt - rtt;
+
+        peer.smoothedRtt = peer.smoothedRtt - srtt + rtt;
+        peer.rttVariance = peer.rttVariance - (peer.rttVariance >> 2) + delta;
+    }
+    peer.sampleCount++;
+
+#if !defined(NDEBUG)
+    ChipLogDetail(ExchangeManager, "RTT to peer %" PRIX64 ": %" PRIu32 " ms, smoothed %" PRIu32 " ms, variance %" PRIu32 " ms",
+                  peer.peerNodeId, rtt, peer.smoothedRtt >> 3, peer.rttVariance >> 2);
+#endif
+}
+
+/**
+ * Grow the send window of a peer by one message for every window of messages
+ * acknowledged (additive increase).
+ */
+void ReliableMessageManager::GrowSendWindow(PeerState & peer)
+{
+    if (++peer.windowAckCount < peer.sendWindow)
+        return;
+
+    peer.windowAckCount = 0;
+    if (peer.sendWindow < CHIP_CONFIG_RMP_MAX_SEND_WINDOW)
+    {
+        peer.sendWindow++;
+    }
+}
+
+/**
+ * Halve the send window of a peer on the retransmission of a message to it
+ * (multiplicative decrease).
+ *
+ * The retransmissions of the messages sent before the window was last halved
+ * are due to the same congestion, so they do not halve it again.
+ */
+void ReliableMessageManager::ShrinkSendWindow(PeerState & peer, const RetransTableEntry & entry)
+{
+    peer.retransCount++;
+
+    if (entry.firstSendTime <= peer.windowDecreaseTime)
+        return;
+
+    peer.sendWindow         = static_cast<uint16_t>(std::max(peer.sendWindow / 2, 1));
+    peer.windowAckCount     = 0;
+    peer.windowDecreaseTime = System::Timer::GetCurrentEpoch();
+}
+
+uint64_t ReliableMessageManager::GetRetransmitTimeoutTick(const PeerState & peer)
+{
+    // RTO = SRTT + max(G, 4 * RTTVAR), where the clock granularity G is a tick
+    uint64_t tickMillis   = uint64_t(1) << mTimerIntervalShift;
+    uint64_t rtoMillis    = (peer.smoothedRtt >> 3) + std::max<uint64_t>(tickMillis, peer.rttVariance);
+    uint64_t timeoutTicks = (rtoMillis + tickMillis - 1) >> mTimerIntervalShift;
+
+    return std::min<uint64_t>(std::max<uint64_t>(timeoutTicks, CHIP_CONFIG_RMP_MIN_RETRANS_TIMEOUT_TICK),
+                              CHIP_CONFIG_RMP_MAX_RETRANS_TIMEOUT_TICK);
+}
+
+/**
+ * Double the retransmission timeout of a peer on the retransmission of a
+ * message to it, up to CHIP_CONFIG_RMP_MAX_RETRANS_TIMEOUT_TICK (RFC 6298
+ * section 5.5).
+ *
+ * The timeout is doubled from the one the message was sent with, so that the
+ * messages which time out together double it once.
+ */
+void ReliableMessageManager::BackOffRetransmitTimeout(PeerState & peer, const RetransTableEntry & entry)
+{
+    uint64_t timeoutTick = std::min<uint64_t>(std::max<uint64_t>(entry.retransTimeoutTick, 1) * 2,
+                                              CHIP_CONFIG_RMP_MAX_RETRANS_TIMEOUT_TICK);
+
+    peer.backoffTimeoutTick = std::max(peer.backoffTimeoutTick, timeoutTick);
+}
+
+/**
+ * Return the retransmission timeout of the messages sent to a peer.
+ *
+ * @param[in]  peerNodeId         The node ID of the peer, or kUndefinedNodeId if unknown.
+ * @param[in]  configTimeoutTick  The configured timeout, used until the round-trip time to the peer has been measured.
+ *
+ * @return The timeout in ticks, backed off if messages were retransmitted since the last measurement.
+ */
+uint64_t ReliableMessageManager::GetRetransmitTimeoutTick(NodeId peerNodeId, uint64_t configTimeoutTick)
+{
+    if (!mAdaptiveRetransTimeout || peerNodeId == kUndefinedNodeId)
+        return configTimeoutTick;
+
+    for (const PeerState & peer : mPeers)
+    {
+        if (peer.peerNodeId == peerNodeId)
+        {
+            if (peer.backoffTimeoutTick > 0)
+                return peer.backoffTimeoutTick;
+            return (peer.sampleCount > 0) ? GetRetransmitTimeoutTick(peer) : configTimeoutTick;
+        }
+    }
+
+    return configTimeoutTick;
+}
+
+/**
+ * Retrieve the round-trip time and send window statistics of a peer.
+ *
+ * @param[in]   peerNodeId  The node ID of the peer.
+ * @param[out]  stats       The statistics of the peer.
+ *
+ * @retval #CHIP_ERROR_KEY_NOT_FOUND If no message was exchanged with the peer lately.
+ * @retval #CHIP_NO_ERROR On success.
+ */
+CHIP_ERROR ReliableMessageManager::GetPeerStats(NodeId peerNodeId, PeerStats & stats)
+{
+    for (const PeerState & peer : mPeers)
+    {
+        if (peer.peerNodeId == peerNodeId && peerNodeId != kUndefinedNodeId)
+        {
+            stats.smoothedRttMillis  = peer.smoothedRtt >> 3;
+            stats.rttVarianceMillis  = peer.rttVariance >> 2;
+            stats.retransTimeoutTick = peer.backoffTimeoutTick;
+            if (stats.retransTimeoutTick == 0 && peer.sampleCount > 0)
+                stats.retransTimeoutTick = GetRetransmitTimeoutTick(peer);
+            stats.sampleCount        = peer.sampleCount;
+            stats.ignoredSampleCount = peer.ignoredSampleCount;
+            stats.sendWindow         = peer.sendWindow;
+            stats.inFlightCount      = peer.inFlightCount;
+            stats.queuedCount        = peer.queuedCount;
+            stats.retransCount       = peer.retransCount;
+            return CHIP_NO_ERROR;
+        }
+    }
+
+    return CHIP_ERROR_KEY_NOT_FOUND;
+}
+
 #if defined(RMP_TICKLESS_DEBUG)
 void ReliableMessageManager::TicklessDebugDumpRetransTable(const char * log)
 {
     ChipLogProgress(ExchangeManager, log);
 
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    for (size_t i = 0; i < mRetransCount; i++)
     {
-        if (RetransTable[i].rc)
-        {
-            ChipLogProgress(ExchangeManager, "EC:%04" PRIX16 " MsgId:%08" PRIX32 " NextRetransTimeCtr:%04" PRIX16,
-                            RetransTable[i].rc, RetransTable[i].msgId, RetransTable[i].nextRetransTimeTick);
-        }
+        ChipLogProgress(ExchangeManager, "EC:%p MsgId:%08" PRIX32 " NextRetransTimeCtr:%08" PRIX64, mRetransHeap[i]->rc,
+                        mRetransHeap[i]->msgId, mRetransHeap[i]->nextRetransTimeTick);
     }
 }
 #else
@@ -114,67 +426,66 @@ void ReliableMessageManager::TicklessDebugDumpRetransTable(const char * log)
 #endif // RMP_TICKLESS_DEBUG
 
 /**
- * Iterate through active exchange contexts and retrans table entries.  If an
- * action needs to be triggered by ReliableMessageProtocol time facilities,
- * execute that action.
+ * Iterate through active exchange contexts and the retrans table entries that
+ * are due.  If an action needs to be triggered by ReliableMessageProtocol time
+ * facilities, execute that action.
  */
 void ReliableMessageManager::ExecuteActions()
 {
+    const uint64_t now = GetCurrentTick();
+
 #if defined(RMP_TICKLESS_DEBUG)
     ChipLogProgress(ExchangeManager, "ReliableMessageManager::ExecuteActions");
 #endif
 
-    ExecuteForAllContext([](ReliableMessageContext * rc) {
-        if (rc->IsAckPending())
-        {
-            if (0 == rc->mNextAckTimeTick)
-            {
-#if defined(RMP_TICKLESS_DEBUG)
-                ChipLogProgress(ExchangeManager, "ReliableMessageManager::ExecuteActions sending ACK");
-#endif
-                // Send the Ack in a Common::Null message
-                rc->SendCommonNullMessage();
-                rc->SetAckPending(false);
-            }
-        }
-    });
+    FlushDueAcks(now);
 
     TicklessDebugDumpRetransTable("ReliableMessageManager::ExecuteActions Dumping RetransTable entries before processing");
 
     // Retransmit / cancel anything in the retrans table whose retrans timeout
-    // has expired
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    // has expired, earliest first
+    while (mRetransCount > 0 && mRetransHeap[0]->nextRetransTimeTick <= now)
     {
-        ReliableMessageContext * rc = RetransTable[i].rc;
+        RetransTableEntry & entry   = *mRetransHeap[0];
+        ReliableMessageContext * rc = entry.rc;
         CHIP_ERROR err              = CHIP_NO_ERROR;
 
-        if (!rc || RetransTable[i].nextRetransTimeTick != 0)
-            continue;
-
-        uint8_t sendCount = RetransTable[i].sendCount;
+        uint8_t sendCount = entry.sendCount;
 
-        if (sendCount == rc->mConfig.mMaxRetrans)
+        if (sendCount >= rc->mConfig.mMaxRetrans)
         {
             err = CHIP_ERROR_MESSAGE_NOT_ACKNOWLEDGED;
 
             ChipLogError(ExchangeManager, "Failed to Send CHIP MsgId:%08" PRIX32 " sendCount: %" PRIu8 " max retries: %" PRIu8,
-                         RetransTable[i].msgId, sendCount, rc->mConfig.mMaxRetrans);
+                         entry.msgId, sendCount, rc->mConfig.mMaxRetrans);
 
             // Remove from Table
-            ClearRetransmitTable(RetransTable[i]);
+            ClearRetransmitTable(entry);
+        }
+
+        if (err == CHIP_NO_ERROR && sendCount > 0)
+        {
+            PeerState * peer = FindPeerState(rc->GetPeerNodeId(), false);
+            if (peer != nullptr)
+            {
+                ShrinkSendWindow(*peer, entry);
+                if (mAdaptiveRetransTimeout)
+                    BackOffRetransmitTimeout(*peer, entry);
+            }
         }
 
         // Resend from Table (if the operation fails, the entry is cleared)
         if (err == CHIP_NO_ERROR)
-            err = SendFromRetransTable(&(RetransTable[i]));
+            err = SendFromRetransTable(&entry);
 
         if (err == CHIP_NO_ERROR)
         {
-            // If the retransmission was successful, update the passive timer
-            RetransTable[i].nextRetransTimeTick = static_cast<uint16_t>(rc->GetCurrentRetransmitTimeoutTick());
+            // If the retransmission was successful, update the passive timer. The entry is due
+            // at least a tick from now, so that it is not sent again in this pass.
+            entry.retransTimeoutTick = rc->GetCurrentRetransmitTimeoutTick();
+            SetRetransTime(entry, now + (entry.retransTimeoutTick > 0 ? entry.retransTimeoutTick : 1));
 #if !defined(NDEBUG)
-            ChipLogProgress(ExchangeManager, "Retransmit MsgId:%08" PRIX32 " Send Cnt %d", RetransTable[i].msgId,
-                            RetransTable[i].sendCount);
+            ChipLogProgress(ExchangeManager, "Retransmit MsgId:%08" PRIX32 " Send Cnt %d", entry.msgId, entry.sendCount);
 #endif
         }
 
@@ -185,84 +496,56 @@ void ReliableMessageManager::ExecuteActions()
     TicklessDebugDumpRetransTable("ReliableMessageManager::ExecuteActions Dumping RetransTable entries after processing");
 }
 
-static void TickProceed(uint16_t & time, uint64_t ticks)
+void ReliableMessageManager::AddPendingAck(ReliableMessageContext * rc)
+{
+    rc->mPrevPendingAck = nullptr;
+    rc->mNextPendingAck = mPendingAcks;
+    if (mPendingAcks != nullptr)
+    {
+        mPendingAcks->mPrevPendingAck = rc;
+    }
+    mPendingAcks = rc;
+}
+
+void ReliableMessageManager::RemovePendingAck(ReliableMessageContext * rc)
 {
-    if (time >= ticks)
+    if (rc->mPrevPendingAck != nullptr)
     {
-        time = static_cast<uint16_t>(time - ticks);
+        rc->mPrevPendingAck->mNextPendingAck = rc->mNextPendingAck;
     }
     else
     {
-        time = 0;
+        mPendingAcks = rc->mNextPendingAck;
     }
+    if (rc->mNextPendingAck != nullptr)
+    {
+        rc->mNextPendingAck->mPrevPendingAck = rc->mPrevPendingAck;
+    }
+    rc->mPrevPendingAck = nullptr;
+    rc->mNextPendingAck = nullptr;
 }
 
 /**
- * Calculate number of virtual ReliableMessageProtocol ticks that have expired
- * since we last called this function. Iterate through active exchange contexts
- * and retrans table entries, subtracting expired virtual ticks to synchronize
- * wakeup times with the current system time. Do not perform any actions beyond
- * updating tick counts, actions will be performed by the physical
- * ReliableMessageProtocol timer tick expiry.
- *
+ * Send the pending acknowledgments that are due in standalone Common::Null
+ * messages, in a single pass over the contexts with one pending.
  */
-void ReliableMessageManager::ExpireTicks()
+void ReliableMessageManager::FlushDueAcks(uint64_t now)
 {
-    uint64_t now = System::Timer::GetCurrentEpoch();
-
-    // Number of full ticks elapsed since last timer processing.  We always round down
-    // to the previous tick.  If we are between tick boundaries, the extra time since the
-    // last virtual tick is not accounted for here (it will be accounted for when resetting
-    // the ReliableMessageProtocol timer)
-    uint64_t deltaTicks = GetTickCounterFromTimeDelta(now);
-
-#if defined(RMP_TICKLESS_DEBUG)
-    ChipLogProgress(ExchangeManager, "ReliableMessageManager::ExpireTicks at %" PRIu64 ", %" PRIu64 ", %u", now, mTimeStampBase,
-                    deltaTicks);
-#endif
-
-    ExecuteForAllContext([deltaTicks](ReliableMessageContext * rc) {
-        if (rc->IsAckPending())
-        {
-            // Decrement counter of Ack timestamp by the elapsed timer ticks
-            TickProceed(rc->mNextAckTimeTick, deltaTicks);
-#if defined(RMP_TICKLESS_DEBUG)
-            ChipLogProgress(ExchangeManager, "ReliableMessageManager::ExpireTicks set mNextAckTimeTick to %u",
-                            rc->mNextAckTimeTick);
-#endif
-        }
-    });
-
-    // Process Throttle Time
-    // Check Throttle timeout stored in EC to set/unset Throttle flag
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    for (ReliableMessageContext *rc = mPendingAcks, *next; rc != nullptr; rc = next)
     {
-        ReliableMessageContext * rc = RetransTable[i].rc;
-        if (rc)
-        {
-            // Process Retransmit Table
-            // Decrement Throttle timeout by elapsed timeticks
-            TickProceed(rc->mThrottleTimeoutTick, deltaTicks);
-#if defined(RMP_TICKLESS_DEBUG)
-            ChipLogProgress(ExchangeManager, "ReliableMessageManager::ExpireTicks set mThrottleTimeoutTick to %u",
-                            RetransTable[i].nextRetransTimeTick);
-#endif
+        // Sending the acknowledgment takes the context off the list
+        next = rc->mNextPendingAck;
 
-            // Decrement Retransmit timeout by elapsed timeticks
-            TickProceed(RetransTable[i].nextRetransTimeTick, deltaTicks);
-#if defined(RMP_TICKLESS_DEBUG)
-            ChipLogProgress(ExchangeManager, "ReliableMessageManager::ExpireTicks set nextRetransTimeTick to %u",
-                            RetransTable[i].nextRetransTimeTick);
-#endif
-        } // rc entry is allocated
-    }
-
-    // Re-Adjust the base time stamp to the most recent tick boundary
-    mTimeStampBase += (deltaTicks << mTimerIntervalShift);
+        if (rc->mNextAckTimeTick > now)
+            continue;
 
 #if defined(RMP_TICKLESS_DEBUG)
-    ChipLogProgress(ExchangeManager, "ReliableMessageManager::ExpireTicks mTimeStampBase to %" PRIu64, mTimeStampBase);
+        ChipLogProgress(ExchangeManager, "ReliableMessageManager::ExecuteActions sending ACK");
 #endif
+        // Send the Ack in a Common::Null message
+        rc->SendCommonNullMessage();
+        rc->SetAckPending(false);
+    }
 }
 
 /**
@@ -279,8 +562,8 @@ void ReliableMessageManager::Timeout(System::Layer * aSystemLayer, void * aAppSt
     ChipLogProgress(ExchangeManager, "ReliableMessageManager::Timeout\n");
 #endif
 
-    // Make sure all tick counts are sync'd to the current time
-    manager->ExpireTicks();
+    // The timer has fired, so the next wakeup must be set whatever it is
+    manager->mCurrentTimerExpiry = 0;
 
     // Execute any actions that are due this tick
     manager->ExecuteActions();
@@ -289,6 +572,182 @@ void ReliableMessageManager::Timeout(System::Layer * aSystemLayer, void * aAppSt
     manager->StartTimer();
 }
 
+/**
+ *  Send a CHIP message to be retransmitted until acknowledged. The message is
+ *  sent right away if the send window of the peer of the context and the
+ *  room left in the retransmission table allow it, and is otherwise queued
+ *  until they do.
+ *
+ *  @param[in]    rc            A pointer to the ExchangeContext object.
+ *
+ *  @param[in]    msgBuf        A pointer to the message buffer holding the CHIP message, which is taken over.
+ *
+ *  @param[in]    messageId     The message identifier of the CHIP message.
+ *
+ *  @param[in]    msgSendFlags  The flags to send the message with.
+ *
+ *  @retval  #CHIP_ERROR_NO_MEMORY If the message had to be queued but the send queue is full.
+ *  @retval  #CHIP_NO_ERROR On success.
+ *  @retval  other Another error returned by AddToRetransTable() or SendFromRetransTable().
+ *
+ */
+CHIP_ERROR ReliableMessageManager::SendReliableMessage(ReliableMessageContext * rc, System::PacketBuffer * msgBuf,
+                                                       uint32_t messageId, uint16_t msgSendFlags)
+{
+    PeerState * peer = mSendWindow ? FindPeerState(rc->GetPeerNodeId(), true) : nullptr;
+
+    if (peer == nullptr ||
+        (peer->queueHead == nullptr && peer->inFlightCount < peer->sendWindow && mFreeRetransEntries != nullptr))
+    {
+        return SendNow(rc, msgBuf, messageId, msgSendFlags);
+    }
+
+    QueuedMessage * message = mFreeQueuedMessages;
+    if (message == nullptr)
+    {
+        ChipLogError(ExchangeManager, "Send queue full, dropping MsgId:%08" PRIX32, messageId);
+        System::PacketBuffer::Free(msgBuf);
+        return CHIP_ERROR_NO_MEMORY;
+    }
+    mFreeQueuedMessages = message->next;
+
+    message->rc           = rc;
+    message->msgBuf       = msgBuf;
+    message->msgId        = messageId;
+    message->msgSendFlags = msgSendFlags;
+    message->next         = nullptr;
+
+    if (peer->queueTail != nullptr)
+    {
+        peer->queueTail->next = message;
+    }
+    else
+    {
+        peer->queueHead = message;
+    }
+    peer->queueTail = message;
+    peer->queuedCount++;
+
+    // Increment the reference count
+    rc->Retain();
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ReliableMessageManager::SendNow(ReliableMessageContext * rc, System::PacketBuffer * msgBuf, uint32_t messageId,
+                                           uint16_t msgSendFlags)
+{
+    RetransTableEntry * entry;
+    CHIP_ERROR err = AddToRetransTable(rc, msgBuf, messageId, msgSendFlags, &entry);
+
+    if (err != CHIP_NO_ERROR)
+    {
+        System::PacketBuffer::Free(msgBuf);
+        return err;
+    }
+
+    // If the operation fails, the entry is cleared
+    return SendFromRetransTable(entry);
+}
+
+/**
+ *  Send the queued messages that the send windows of their peers allow, as
+ *  long as the retransmission table has room for them.
+ */
+void ReliableMessageManager::SendQueuedMessages()
+{
+    // Sending a message may clear a table entry, which comes back here
+    if (mSendingQueuedMessages)
+        return;
+
+    mSendingQueuedMessages = true;
+
+    for (PeerState & peer : mPeers)
+    {
+        while (peer.queueHead != nullptr && (!mSendWindow || peer.inFlightCount < peer.sendWindow) &&
+               mFreeRetransEntries != nullptr)
+        {
+            QueuedMessage * message = peer.queueHead;
+            ReliableMessageContext * rc = message->rc;
+
+            peer.queueHead = message->next;
+            if (peer.queueHead == nullptr)
+            {
+                peer.queueTail = nullptr;
+            }
+            peer.queuedCount--;
+
+            CHIP_ERROR err = SendNow(rc, message->msgBuf, message->msgId, message->msgSendFlags);
+
+            message->next       = mFreeQueuedMessages;
+            mFreeQueuedMessages = message;
+
+            if (err != CHIP_NO_ERROR)
+            {
+                rc->mDelegate->OnSendError(err);
+            }
+            rc->Release();
+        }
+    }
+
+    mSendingQueuedMessages = false;
+}
+
+/**
+ *  Drop the queued messages of a context.
+ *
+ *  @param[in]    rc       A pointer to the ExchangeContext object.
+ *
+ *  @param[in]    err      The error to report for each message dropped.
+ *
+ *  @param[in]    notify   Whether to report the error to the application.
+ *
+ */
+void ReliableMessageManager::DropQueuedMessages(ReliableMessageContext * rc, CHIP_ERROR err, bool notify)
+{
+    PeerState * peer          = FindPeerState(rc->GetPeerNodeId(), false);
+    QueuedMessage * previous  = nullptr;
+    QueuedMessage * message   = (peer != nullptr) ? peer->queueHead : nullptr;
+
+    while (message != nullptr)
+    {
+        QueuedMessage * next = message->next;
+
+        if (message->rc != rc)
+        {
+            previous = message;
+            message  = next;
+            continue;
+        }
+
+        if (previous != nullptr)
+        {
+            previous->next = next;
+        }
+        else
+        {
+            peer->queueHead = next;
+        }
+        if (peer->queueTail == message)
+        {
+            peer->queueTail = previous;
+        }
+        peer->queuedCount--;
+
+        System::PacketBuffer::Free(message->msgBuf);
+        message->next       = mFreeQueuedMessages;
+        mFreeQueuedMessages = message;
+
+        if (notify)
+        {
+            rc->mDelegate->OnSendError(err);
+        }
+        rc->Release();
+
+        message = next;
+    }
+}
+
 /**
  *  Add a CHIP message into the retransmission table to be subsequently resent if a corresponding acknowledgment
  *  is not received within the retransmission timeout.
@@ -308,78 +767,95 @@ void ReliableMessageManager::Timeout(System::Layer * aSystemLayer, void * aAppSt
 CHIP_ERROR ReliableMessageManager::AddToRetransTable(ReliableMessageContext * rc, System::PacketBuffer * msgBuf, uint32_t messageId,
                                                      uint16_t msgSendFlags, RetransTableEntry ** rEntry)
 {
-    bool added     = false;
-    CHIP_ERROR err = CHIP_NO_ERROR;
+    RetransTableEntry * entry = mFreeRetransEntries;
 
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    if (entry == nullptr)
     {
-        // Check the exchContext pointer for finding an empty slot in Table
-        if (!RetransTable[i].rc)
-        {
-            // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-            ExpireTicks();
-
-            RetransTable[i].rc                  = rc;
-            RetransTable[i].msgId               = messageId;
-            RetransTable[i].msgBuf              = msgBuf;
-            RetransTable[i].msgSendFlags        = msgSendFlags;
-            RetransTable[i].sendCount           = 0;
-            RetransTable[i].nextRetransTimeTick = static_cast<uint16_t>(
-                rc->GetCurrentRetransmitTimeoutTick() + GetTickCounterFromTimeDelta(System::Timer::GetCurrentEpoch()));
-
-            *rEntry = &RetransTable[i];
-            // Increment the reference count
-            rc->Retain();
-            added = true;
-
-            // Check if the timer needs to be started and start it.
-            StartTimer();
-            break;
-        }
+        ChipLogError(ExchangeManager, "RetransTable Already Full");
+        return CHIP_ERROR_RETRANS_TABLE_FULL;
     }
 
-    if (!added)
+    mFreeRetransEntries = entry->next;
+
+    entry->rc                  = rc;
+    entry->msgId               = messageId;
+    entry->msgBuf              = msgBuf;
+    entry->msgSendFlags        = msgSendFlags;
+    entry->sendCount           = 0;
+    entry->firstSendTime       = System::Timer::GetCurrentEpoch();
+    entry->retransTimeoutTick  = rc->GetCurrentRetransmitTimeoutTick();
+    entry->nextRetransTimeTick = entry->retransTimeoutTick + GetCurrentTick();
+
+    // Link the entry into the bucket of its context, and into the heap
+    RetransTableEntry ** bucket = RetransBucket(rc);
+    entry->next                 = *bucket;
+    *bucket                     = entry;
+
+    entry->heapIndex            = mRetransCount;
+    mRetransHeap[mRetransCount] = entry;
+    mRetransCount++;
+    SiftUpRetransHeap(entry->heapIndex);
+
+    PeerState * peer = FindPeerState(rc->GetPeerNodeId(), true);
+    if (peer != nullptr)
     {
-        ChipLogError(ExchangeManager, "RetransTable Already Full");
-        err = CHIP_ERROR_RETRANS_TABLE_FULL;
+        peer->inFlightCount++;
+        peer->lastUsedTime = entry->firstSendTime;
     }
 
-    return err;
+    *rEntry = entry;
+    // Increment the reference count
+    rc->Retain();
+
+    // Check if the timer needs to be started and start it.
+    StartTimer();
+
+    return CHIP_NO_ERROR;
 }
 
 void ReliableMessageManager::PauseRetransTable(ReliableMessageContext * rc, uint32_t PauseTimeMillis)
 {
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    for (RetransTableEntry * entry = *RetransBucket(rc); entry != nullptr; entry = entry->next)
     {
-        if (RetransTable[i].rc == rc)
+        if (entry->rc == rc)
         {
-            RetransTable[i].nextRetransTimeTick =
-                static_cast<uint16_t>(RetransTable[i].nextRetransTimeTick + (PauseTimeMillis >> mTimerIntervalShift));
-            break;
+            SetRetransTime(*entry, entry->nextRetransTimeTick + GetTickCounterFromTimePeriod(PauseTimeMillis));
         }
     }
+
+    StartTimer();
 }
 
 void ReliableMessageManager::ResumeRetransTable(ReliableMessageContext * rc)
 {
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    const uint64_t now = GetCurrentTick();
+
+    for (RetransTableEntry * entry = *RetransBucket(rc); entry != nullptr; entry = entry->next)
     {
-        if (RetransTable[i].rc == rc)
+        if (entry->rc == rc)
         {
-            RetransTable[i].nextRetransTimeTick = 0;
-            break;
+            SetRetransTime(*entry, now);
         }
     }
+
+    StartTimer();
 }
 
 bool ReliableMessageManager::CheckAndRemRetransTable(ReliableMessageContext * rc, uint32_t ackMsgId)
 {
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    for (RetransTableEntry * entry = *RetransBucket(rc); entry != nullptr; entry = entry->next)
     {
-        if ((RetransTable[i].rc == rc) && RetransTable[i].msgId == ackMsgId)
+        if (entry->rc == rc && entry->msgId == ackMsgId)
         {
+            PeerState * peer = FindPeerState(rc->GetPeerNodeId(), true);
+            if (peer != nullptr)
+            {
+                UpdatePeerRtt(*peer, *entry);
+                GrowSendWindow(*peer);
+            }
+
             // Clear the entry from the retransmision table.
-            ClearRetransmitTable(RetransTable[i]);
+            ClearRetransmitTable(*entry);
 
 #if !defined(NDEBUG)
             ChipLogProgress(ExchangeManager, "Rxd Ack; Removing MsgId:%08" PRIX32 " from Retrans Table", ackMsgId);
@@ -409,7 +885,7 @@ CHIP_ERROR ReliableMessageManager::SendFromRetransTable(RetransTableEntry * entr
     // restart the timer immediately, and ExitNow.
 
     CHIP_FAULT_INJECT(FaultInjection::kFault_RMPSendError, entry->sendCount = static_cast<uint8_t>(rc->mConfig.mMaxRetrans + 1);
-                      entry->nextRetransTimeTick = 0; StartTimer(); ExitNow());
+                      SetRetransTime(*entry, GetCurrentTick()); StartTimer(); ExitNow());
 
     if (rc)
     {
@@ -466,13 +942,14 @@ exit:
  */
 void ReliableMessageManager::ClearRetransmitTable(ReliableMessageContext * rc)
 {
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    RetransTableEntry * entry;
+
+    DropQueuedMessages(rc, CHIP_NO_ERROR, false);
+
+    while ((entry = FindRetransEntry(rc)) != nullptr)
     {
-        if (RetransTable[i].rc == rc)
-        {
-            // Clear the retransmit table entry.
-            ClearRetransmitTable(RetransTable[i]);
-        }
+        // Clear the retransmit table entry.
+        ClearRetransmitTable(*entry);
     }
 }
 
@@ -486,11 +963,26 @@ void ReliableMessageManager::ClearRetransmitTable(RetransTableEntry & rEntry)
 {
     if (rEntry.rc)
     {
-        // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-        ExpireTicks();
+        ReliableMessageContext * rc = rEntry.rc;
 
-        rEntry.rc->Release();
-        rEntry.rc = nullptr;
+        // Unlink the entry from the bucket of its context
+        RetransTableEntry ** link = RetransBucket(rc);
+        while (*link != &rEntry)
+        {
+            link = &(*link)->next;
+        }
+        *link = rEntry.next;
+
+        // Move the last entry of the heap in its place
+        size_t index = rEntry.heapIndex;
+        mRetransCount--;
+        if (index != mRetransCount)
+        {
+            SwapRetransHeap(index, mRetransCount);
+            SiftUpRetransHeap(index);
+            SiftDownRetransHeap(index);
+        }
+        mRetransHeap[mRetransCount] = nullptr;
 
         if (rEntry.msgBuf)
         {
@@ -498,8 +990,21 @@ void ReliableMessageManager::ClearRetransmitTable(RetransTableEntry & rEntry)
             rEntry.msgBuf = nullptr;
         }
 
-        // Clear all other fields
-        rEntry = RetransTableEntry();
+        // Clear all other fields, and return the entry to the free list
+        rEntry              = RetransTableEntry();
+        rEntry.next         = mFreeRetransEntries;
+        mFreeRetransEntries = &rEntry;
+
+        PeerState * peer = FindPeerState(rc->GetPeerNodeId(), false);
+        if (peer != nullptr && peer->inFlightCount > 0)
+        {
+            peer->inFlightCount--;
+        }
+
+        rc->Release();
+
+        // The send window of the peer, or room in the table, may have opened for queued messages
+        SendQueuedMessages();
 
         // Schedule next physical wakeup
         StartTimer();
@@ -516,24 +1021,27 @@ void ReliableMessageManager::ClearRetransmitTable(RetransTableEntry & rEntry)
  */
 void ReliableMessageManager::FailRetransmitTableEntries(ReliableMessageContext * rc, CHIP_ERROR err)
 {
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    RetransTableEntry * entry;
+
+    DropQueuedMessages(rc, err, true);
+
+    // Look the next entry up again after each callback, which may clear entries itself
+    while ((entry = FindRetransEntry(rc)) != nullptr)
     {
-        if (RetransTable[i].rc == rc)
-        {
-            // Remove the entry from the retransmission table.
-            ClearRetransmitTable(RetransTable[i]);
+        // Remove the entry from the retransmission table.
+        ClearRetransmitTable(*entry);
 
-            // Application callback OnSendError.
-            rc->mDelegate->OnSendError(err);
-        }
+        // Application callback OnSendError.
+        rc->mDelegate->OnSendError(err);
     }
 }
 
 /**
- * Iterate through active exchange contexts and retrans table entries.
- * Determine how many ReliableMessageProtocol ticks we need to sleep before we
- * need to physically wake the CPU to perform an action.  Set a timer to go off
- * when we next need to wake the system.
+ * Iterate through active exchange contexts and take the earliest retrans table
+ * entry.  Determine how many ReliableMessageProtocol ticks we need to sleep
+ * before we need to physically wake the CPU to perform an action.  Set a timer
+ * to go off when we next need to wake the system, unless it is already set for
+ * that time.
  */
 void ReliableMessageManager::StartTimer()
 {
@@ -542,43 +1050,28 @@ void ReliableMessageManager::StartTimer()
     bool foundWake            = false;
 
     // When do we need to next wake up to send an ACK?
-
-    ExecuteForAllContext([&nextWakeTimeTick, &foundWake](ReliableMessageContext * rc) {
-        if (rc->IsAckPending() && rc->mNextAckTimeTick < nextWakeTimeTick)
+    for (ReliableMessageContext * rc = mPendingAcks; rc != nullptr; rc = rc->mNextPendingAck)
+    {
+        if (rc->mNextAckTimeTick < nextWakeTimeTick)
         {
             nextWakeTimeTick = rc->mNextAckTimeTick;
             foundWake        = true;
 #if defined(RMP_TICKLESS_DEBUG)
-            ChipLogProgress(ExchangeManager, "ReliableMessageManager::StartTimer next ACK time %u", nextWakeTimeTick);
+            ChipLogProgress(ExchangeManager, "ReliableMessageManager::StartTimer next ACK time %" PRIu64, nextWakeTimeTick);
 #endif
         }
-    });
+    }
 
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    // When do we need to next wake up for ReliableMessageProtocol retransmit? Throttled
+    // entries have had their retransmission time pushed back, so they need no wakeup of
+    // their own.
+    if (mRetransCount > 0 && mRetransHeap[0]->nextRetransTimeTick < nextWakeTimeTick)
     {
-        ReliableMessageContext * rc = RetransTable[i].rc;
-        if (rc)
-        {
-            // When do we need to next wake up for throttle retransmission?
-            if (rc->mThrottleTimeoutTick != 0 && rc->mThrottleTimeoutTick < nextWakeTimeTick)
-            {
-                nextWakeTimeTick = rc->mThrottleTimeoutTick;
-                foundWake        = true;
+        nextWakeTimeTick = mRetransHeap[0]->nextRetransTimeTick;
+        foundWake        = true;
 #if defined(RMP_TICKLESS_DEBUG)
-                ChipLogProgress(ExchangeManager, "ReliableMessageManager::StartTimer throttle timeout %u", nextWakeTimeTick);
+        ChipLogProgress(ExchangeManager, "ReliableMessageManager::StartTimer RetransTime %" PRIu64, nextWakeTimeTick);
 #endif
-            }
-
-            // When do we need to next wake up for ReliableMessageProtocol retransmit?
-            if (RetransTable[i].nextRetransTimeTick < nextWakeTimeTick)
-            {
-                nextWakeTimeTick = RetransTable[i].nextRetransTimeTick;
-                foundWake        = true;
-#if defined(RMP_TICKLESS_DEBUG)
-                ChipLogProgress(ExchangeManager, "ReliableMessageManager::StartTimer RetransTime %u", nextWakeTimeTick);
-#endif
-            }
-        }
     }
 
     if (foundWake)
@@ -620,6 +1113,7 @@ void ReliableMessageManager::StartTimer()
                         System::Timer::GetCurrentEpoch());
 #endif
         StopTimer();
+        mCurrentTimerExpiry = 0;
     }
 
     TicklessDebugDumpRetransTable("ReliableMessageManager::StartTimer Dumping RetransTable entries after setting wakeup times");
@@ -632,14 +1126,22 @@ void ReliableMessageManager::StopTimer()
 
 int ReliableMessageManager::TestGetCountRetransTable()
 {
-    int count = 0;
-    for (int i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
-    {
-        ReliableMessageContext * rc = RetransTable[i].rc;
-        if (rc)
-            count++;
-    }
-    return count;
+    return static_cast<int>(mRetransCount);
+}
+
+CHIP_ERROR ReliableMessageManager::TestHandleNeedsAck(ReliableMessageContext * rc, uint32_t messageId)
+{
+    return rc->HandleNeedsAck(messageId, BitFlags<uint32_t, MessageFlagValues>());
+}
+
+CHIP_ERROR ReliableMessageManager::TestAddRttSample(NodeId peerNodeId, uint32_t rttMillis)
+{
+    PeerState * peer = FindPeerState(peerNodeId, true);
+    if (peer == nullptr)
+        return CHIP_ERROR_NO_MEMORY;
+
+    AddRttSample(*peer, std::min<uint32_t>(rttMillis, UINT32_MAX >> 3));
+    return CHIP_NO_ERROR;
 }
 
 } // namespace Messaging
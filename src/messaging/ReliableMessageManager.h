@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <messaging/ReliableMessageProtocolConfig.h>
@@ -61,8 +62,43 @@ public:
         System::PacketBuffer * msgBuf; /**< A pointer to the PacketBuffer object holding the CHIP message. */
         uint32_t msgId;                /**< The message identifier of the CHIP message awaiting acknowledgment. */
         uint16_t msgSendFlags;
-        uint16_t nextRetransTimeTick; /**< A counter representing the next retransmission time for the message. */
+        uint64_t nextRetransTimeTick; /**< The tick at which the message is next due for retransmission. */
+        uint64_t firstSendTime;       /**< The time the message was first sent at, for measuring the round-trip time. */
+        uint64_t retransTimeoutTick;  /**< The retransmission timeout the message was last sent with. */
         uint8_t sendCount;            /**< A counter representing the number of times the message has been sent. */
+
+    private:
+        friend class ReliableMessageManager;
+
+        RetransTableEntry * next; /**< The next entry of the same bucket, or of the free list. */
+        size_t heapIndex;         /**< The position of the entry in the deadline heap. */
+    };
+
+    /**
+     *  @brief
+     *    The statistics of a peer: its round-trip time, measured from the acknowledgments of the messages sent to it,
+     *    and its send window.
+     */
+    struct PeerStats
+    {
+        uint32_t smoothedRttMillis;  /**< The smoothed round-trip time to the peer. */
+        uint32_t rttVarianceMillis;  /**< The smoothed mean deviation of the round-trip time to the peer. */
+        uint64_t retransTimeoutTick; /**< The retransmission timeout derived from the round-trip time, or backed off. */
+        uint32_t sampleCount;        /**< The number of round-trip times measured. */
+        uint32_t ignoredSampleCount; /**< The number of acknowledgments of retransmitted messages, which were not measured. */
+        uint16_t sendWindow;         /**< The number of messages that may await acknowledgment from the peer. */
+        uint16_t inFlightCount;      /**< The number of messages awaiting acknowledgment from the peer. */
+        uint16_t queuedCount;        /**< The number of messages waiting for the send window. */
+        uint32_t retransCount;       /**< The number of retransmissions to the peer. */
+    };
+
+    /**
+     *  @brief
+     *    The counts of the acknowledgments sent to peers.
+     */
+    struct AckStats
+    {
+        uint32_t standalone; /**< The number of acknowledgments sent in standalone Common::Null messages. */
     };
 
 public:
@@ -81,6 +117,8 @@ public:
     void ProcessDelayedDeliveryMessage(ReliableMessageContext * rc, uint32_t PauseTimeMillis);
     static void Timeout(System::Layer * aSystemLayer, void * aAppState, System::Error aError);
 
+    CHIP_ERROR SendReliableMessage(ReliableMessageContext * rc, System::PacketBuffer * msgBuf, uint32_t messageId,
+                                   uint16_t msgSendFlags);
     CHIP_ERROR AddToRetransTable(ReliableMessageContext * rc, System::PacketBuffer * msgBuf, uint32_t messageId,
                                  uint16_t msgSendFlags, RetransTableEntry ** rEntry);
     void PauseRetransTable(ReliableMessageContext * rc, uint32_t PauseTimeMillis);
@@ -93,10 +131,18 @@ public:
 
     void StartTimer();
     void StopTimer();
-    void ExpireTicks();
+
+    uint64_t GetRetransmitTimeoutTick(NodeId peerNodeId, uint64_t configTimeoutTick);
+    CHIP_ERROR GetPeerStats(NodeId peerNodeId, PeerStats & stats);
+    void SetAdaptiveRetransTimeout(bool enabled) { mAdaptiveRetransTimeout = enabled; }
+    void SetSendWindow(bool enabled) { mSendWindow = enabled; }
+
+    const AckStats & GetAckStats() const { return mAckStats; }
 
     // Functions for testing
     int TestGetCountRetransTable();
+    CHIP_ERROR TestHandleNeedsAck(ReliableMessageContext * rc, uint32_t messageId);
+    CHIP_ERROR TestAddRttSample(NodeId peerNodeId, uint32_t rttMillis);
     void TestSetIntervalShift(uint16_t value) { mTimerIntervalShift = value; }
 
 public:
@@ -106,20 +152,90 @@ public:
                            BitFlags<uint16_t, SendMessageFlags> sendFlags);
 
 private:
+    friend class ReliableMessageContext;
+
     chip::System::Layer * mSystemLayer;
-    uint64_t mTimeStampBase;                  // ReliableMessageProtocol timer base value to add offsets to evaluate timeouts
+    uint64_t mTimeStampBase;                  // ReliableMessageProtocol timer base value, at which the tick count starts from 0
     System::Timer::Epoch mCurrentTimerExpiry; // Tracks when the ReliableMessageProtocol timer will next expire
     uint16_t mTimerIntervalShift;             // ReliableMessageProtocol Timer tick period shift
+    bool mAdaptiveRetransTimeout;             // Whether retransmission timeouts follow the measured round-trip times
+    bool mSendWindow;                         // Whether messages to each peer are limited to its send window
+    bool mSendingQueuedMessages;              // Whether queued messages are being sent, so that it is not done recursively
 
-    /* Placeholder function to run a function for all exchanges */
-    template <typename Function>
-    void ExecuteForAllContext(Function function)
-    {}
+    struct QueuedMessage
+    {
+        ReliableMessageContext * rc;
+        System::PacketBuffer * msgBuf;
+        uint32_t msgId;
+        uint16_t msgSendFlags;
+        QueuedMessage * next;
+    };
+
+    struct PeerState
+    {
+        NodeId peerNodeId;
+        uint32_t smoothedRtt; // Smoothed round-trip time, in 1/8 milliseconds
+        uint32_t rttVariance; // Smoothed mean deviation of the round-trip time, in 1/4 milliseconds
+        uint32_t sampleCount;
+        uint32_t ignoredSampleCount;
+        uint64_t backoffTimeoutTick; // Timeout doubled by the retransmissions since the last measurement, 0 if none
+        uint64_t lastUsedTime;
+
+        uint16_t sendWindow;
+        uint16_t windowAckCount;     // Acknowledgments since the send window last grew
+        uint64_t windowDecreaseTime; // Losses of messages first sent before then do not shrink the window again
+        uint16_t inFlightCount;
+        uint16_t queuedCount;
+        QueuedMessage * queueHead;
+        QueuedMessage * queueTail;
+        uint32_t retransCount;
+
+        bool IsIdle() const { return inFlightCount == 0 && queueHead == nullptr; }
+    };
 
     void TicklessDebugDumpRetransTable(const char * log);
 
+    uint64_t GetCurrentTick() { return GetTickCounterFromTimeDelta(System::Timer::GetCurrentEpoch()); }
+
+    RetransTableEntry ** RetransBucket(const ReliableMessageContext * rc);
+    RetransTableEntry * FindRetransEntry(ReliableMessageContext * rc);
+    void SetRetransTime(RetransTableEntry & entry, uint64_t tick);
+    void SwapRetransHeap(size_t a, size_t b);
+    void SiftUpRetransHeap(size_t index);
+    void SiftDownRetransHeap(size_t index);
+
+    void AddPendingAck(ReliableMessageContext * rc);
+    void RemovePendingAck(ReliableMessageContext * rc);
+    void FlushDueAcks(uint64_t now);
+
+    PeerState * FindPeerState(NodeId peerNodeId, bool create);
+    void UpdatePeerRtt(PeerState & peer, const RetransTableEntry & entry);
+    void AddRttSample(PeerState & peer, uint32_t rtt);
+    void GrowSendWindow(PeerState & peer);
+    void ShrinkSendWindow(PeerState & peer, const RetransTableEntry & entry);
+    CHIP_ERROR SendNow(ReliableMessageContext * rc, System::PacketBuffer * msgBuf, uint32_t messageId, uint16_t msgSendFlags);
+    void SendQueuedMessages();
+    void DropQueuedMessages(ReliableMessageContext * rc, CHIP_ERROR err, bool notify);
+    uint64_t GetRetransmitTimeoutTick(const PeerState & peer);
+    void BackOffRetransmitTimeout(PeerState & peer, const RetransTableEntry & entry);
+
     // ReliableMessageProtocol Global tables for timer context
     RetransTableEntry RetransTable[CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE];
+
+    // The entries in use, ordered as a binary min-heap on their retransmission tick, and hashed on
+    // their context into buckets chained through their next link. Free entries are chained the same way.
+    RetransTableEntry * mRetransHeap[CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE];
+    RetransTableEntry * mRetransBuckets[CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE];
+    RetransTableEntry * mFreeRetransEntries;
+    size_t mRetransCount;
+
+    PeerState mPeers[CHIP_CONFIG_RMP_PEER_TABLE_SIZE];
+    QueuedMessage mSendQueue[CHIP_CONFIG_RMP_SEND_QUEUE_SIZE];
+    QueuedMessage * mFreeQueuedMessages;
+
+    // The contexts with an acknowledgment pending, doubly linked through their pending ack links
+    ReliableMessageContext * mPendingAcks;
+    AckStats mAckStats;
 };
 
 } // namespace Messaging
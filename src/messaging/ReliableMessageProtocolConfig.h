@@ -86,8 +86,11 @@ namespace Messaging {
 #ifndef CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE
 #ifdef PBUF_POOL_SIZE
 #define CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE (PBUF_POOL_SIZE)
-#else
+#elif CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
 #define CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE (CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC)
+#else
+// Packet buffers are allocated dynamically, so they do not bound the table
+#define CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE 15
 #endif // PBUF_POOL_SIZE
 #endif // CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE
 
@@ -102,6 +105,106 @@ namespace Messaging {
 #define CHIP_CONFIG_RMP_DEFAULT_MAX_RETRANS (3)
 #endif // CHIP_CONFIG_RMP_DEFAULT_MAX_RETRANS
 
+/**
+ *  @def CHIP_CONFIG_RMP_ADAPTIVE_RETRANS_TIMEOUT
+ *
+ *  @brief
+ *    Enable (1) or disable (0) deriving the retransmission timeout to a
+ *    peer from the round-trip times measured to it, once there are any,
+ *    instead of using the configured timeouts.
+ *
+ */
+#ifndef CHIP_CONFIG_RMP_ADAPTIVE_RETRANS_TIMEOUT
+#define CHIP_CONFIG_RMP_ADAPTIVE_RETRANS_TIMEOUT 1
+#endif // CHIP_CONFIG_RMP_ADAPTIVE_RETRANS_TIMEOUT
+
+/**
+ *  @def CHIP_CONFIG_RMP_MIN_RETRANS_TIMEOUT_TICK
+ *
+ *  @brief
+ *    The lower bound, in ticks, of the retransmission timeouts derived
+ *    from measured round-trip times. Timeouts run from the start of the
+ *    current tick, so a bound of one tick could expire right away.
+ *
+ */
+#ifndef CHIP_CONFIG_RMP_MIN_RETRANS_TIMEOUT_TICK
+#define CHIP_CONFIG_RMP_MIN_RETRANS_TIMEOUT_TICK (2)
+#endif // CHIP_CONFIG_RMP_MIN_RETRANS_TIMEOUT_TICK
+
+/**
+ *  @def CHIP_CONFIG_RMP_MAX_RETRANS_TIMEOUT_TICK
+ *
+ *  @brief
+ *    The upper bound, in ticks, of the retransmission timeouts derived
+ *    from measured round-trip times.
+ *
+ */
+#ifndef CHIP_CONFIG_RMP_MAX_RETRANS_TIMEOUT_TICK
+#define CHIP_CONFIG_RMP_MAX_RETRANS_TIMEOUT_TICK (64)
+#endif // CHIP_CONFIG_RMP_MAX_RETRANS_TIMEOUT_TICK
+
+/**
+ *  @def CHIP_CONFIG_RMP_PEER_TABLE_SIZE
+ *
+ *  @brief
+ *    The number of peers whose round-trip times and send windows are
+ *    tracked. The idle peer used least recently is forgotten to make room
+ *    for a new one.
+ *
+ */
+#ifndef CHIP_CONFIG_RMP_PEER_TABLE_SIZE
+#define CHIP_CONFIG_RMP_PEER_TABLE_SIZE (8)
+#endif // CHIP_CONFIG_RMP_PEER_TABLE_SIZE
+
+/**
+ *  @def CHIP_CONFIG_RMP_SEND_WINDOW
+ *
+ *  @brief
+ *    Enable (1) or disable (0) limiting the number of messages awaiting
+ *    acknowledgment from each peer to a send window, which grows by one
+ *    message for each window of messages acknowledged and is halved when
+ *    a message has to be retransmitted. Messages beyond the window wait
+ *    in a send queue of their peer.
+ *
+ */
+#ifndef CHIP_CONFIG_RMP_SEND_WINDOW
+#define CHIP_CONFIG_RMP_SEND_WINDOW 1
+#endif // CHIP_CONFIG_RMP_SEND_WINDOW
+
+/**
+ *  @def CHIP_CONFIG_RMP_INITIAL_SEND_WINDOW
+ *
+ *  @brief
+ *    The send window of a peer no message was sent to yet, in messages.
+ *
+ */
+#ifndef CHIP_CONFIG_RMP_INITIAL_SEND_WINDOW
+#define CHIP_CONFIG_RMP_INITIAL_SEND_WINDOW (2)
+#endif // CHIP_CONFIG_RMP_INITIAL_SEND_WINDOW
+
+/**
+ *  @def CHIP_CONFIG_RMP_MAX_SEND_WINDOW
+ *
+ *  @brief
+ *    The largest send window of a peer, in messages.
+ *
+ */
+#ifndef CHIP_CONFIG_RMP_MAX_SEND_WINDOW
+#define CHIP_CONFIG_RMP_MAX_SEND_WINDOW (16)
+#endif // CHIP_CONFIG_RMP_MAX_SEND_WINDOW
+
+/**
+ *  @def CHIP_CONFIG_RMP_SEND_QUEUE_SIZE
+ *
+ *  @brief
+ *    The number of messages that may wait for the send windows of their
+ *    peers, all peers together.
+ *
+ */
+#ifndef CHIP_CONFIG_RMP_SEND_QUEUE_SIZE
+#define CHIP_CONFIG_RMP_SEND_QUEUE_SIZE (32)
+#endif // CHIP_CONFIG_RMP_SEND_QUEUE_SIZE
+
 /**
  *  @brief
  *    The ReliableMessageProtocol configuration.
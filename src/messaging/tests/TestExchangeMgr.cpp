@@ -76,11 +76,13 @@ public:
                            System::PacketBufferHandle buffer) override
     {
         IsOnMessageReceivedCalled = true;
+        ReceivedCount++;
     }
 
     void OnResponseTimeout(ExchangeContext * ec) override {}
 
     bool IsOnMessageReceivedCalled = false;
+    size_t ReceivedCount           = 0;
 };
 
 void CheckSimpleInitTest(nlTestSuite * inSuite, void * inContext)
@@ -208,6 +210,59 @@ void CheckUmhRegistrationTest(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, err != CHIP_NO_ERROR);
 }
 
+void CheckUmhTableTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    TransportMgr<LoopbackTransport> transportMgr;
+    SecureSessionMgr secureSessionMgr;
+    CHIP_ERROR err;
+
+    ctx.GetInetLayer().SystemLayer()->Init(nullptr);
+
+    err = transportMgr.Init("LOOPBACK");
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = secureSessionMgr.Init(kSourceNodeId, ctx.GetInetLayer().SystemLayer(), &transportMgr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    ExchangeManager exchangeMgr;
+    err = exchangeMgr.Init(&secureSessionMgr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    MockAppDelegate mockAppDelegate;
+
+    // Fill the protocol table, with handlers for every message type of a protocol and some for single types
+    for (uint32_t protocolId = 0; protocolId < CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS; protocolId++)
+    {
+        err = exchangeMgr.RegisterUnsolicitedMessageHandler(protocolId << 16, &mockAppDelegate);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        err = exchangeMgr.RegisterUnsolicitedMessageHandler(protocolId << 16, static_cast<uint8_t>(protocolId), &mockAppDelegate);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    err = exchangeMgr.RegisterUnsolicitedMessageHandler(0xFFFF0000, &mockAppDelegate);
+    NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_TOO_MANY_UNSOLICITED_MESSAGE_HANDLERS);
+
+    // Removing the even protocols moves the others around, where they must still be found
+    for (uint32_t protocolId = 0; protocolId < CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS; protocolId += 2)
+    {
+        err = exchangeMgr.UnregisterUnsolicitedMessageHandler(protocolId << 16);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        err = exchangeMgr.UnregisterUnsolicitedMessageHandler(protocolId << 16, static_cast<uint8_t>(protocolId));
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    for (uint32_t protocolId = 0; protocolId < CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS; protocolId++)
+    {
+        const CHIP_ERROR expected = (protocolId % 2 == 0) ? CHIP_ERROR_NO_UNSOLICITED_MESSAGE_HANDLER : CHIP_NO_ERROR;
+
+        err = exchangeMgr.UnregisterUnsolicitedMessageHandler(protocolId << 16, static_cast<uint8_t>(protocolId));
+        NL_TEST_ASSERT(inSuite, err == expected);
+        err = exchangeMgr.UnregisterUnsolicitedMessageHandler(protocolId << 16);
+        NL_TEST_ASSERT(inSuite, err == expected);
+    }
+}
+
 void CheckExchangeMessages(nlTestSuite * inSuite, void * inContext)
 {
     TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
@@ -253,6 +308,96 @@ void CheckExchangeMessages(nlTestSuite * inSuite, void * inContext)
     // send a good packet
     ec1->SendMessage(0x0001, 0x0001, System::PacketBuffer::New(), SendFlags(Messaging::SendMessageFlags::kSendFlag_None));
     NL_TEST_ASSERT(inSuite, mockUnsolicitedAppDelegate.IsOnMessageReceivedCalled);
+
+    // messages of other types reach the handler of the whole protocol, while the handler of their type is preferred
+    MockAppDelegate mockProtocolAppDelegate;
+    err = exchangeMgr.RegisterUnsolicitedMessageHandler(0x0001, &mockProtocolAppDelegate);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    ExchangeContext * ec2 = exchangeMgr.NewContext(kDestinationNodeId, &mockSolicitedAppDelegate);
+    ec2->SendMessage(0x0001, 0x0002, System::PacketBuffer::New(), SendFlags(Messaging::SendMessageFlags::kSendFlag_None));
+    NL_TEST_ASSERT(inSuite, mockProtocolAppDelegate.ReceivedCount == 1);
+
+    ExchangeContext * ec3 = exchangeMgr.NewContext(kDestinationNodeId, &mockSolicitedAppDelegate);
+    ec3->SendMessage(0x0001, 0x0001, System::PacketBuffer::New(), SendFlags(Messaging::SendMessageFlags::kSendFlag_None));
+    NL_TEST_ASSERT(inSuite, mockProtocolAppDelegate.ReceivedCount == 1);
+    NL_TEST_ASSERT(inSuite, mockUnsolicitedAppDelegate.ReceivedCount == 2);
+}
+
+void CheckContextPoolTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    CHIP_ERROR err;
+
+    TransportMgr<LoopbackTransport> transportMgr;
+    SecureSessionMgr secureSessionMgr;
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+
+    ctx.GetInetLayer().SystemLayer()->Init(nullptr);
+
+    err = transportMgr.Init("LOOPBACK");
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = secureSessionMgr.Init(kSourceNodeId, ctx.GetInetLayer().SystemLayer(), &transportMgr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    ExchangeManager exchangeMgr;
+    err = exchangeMgr.Init(&secureSessionMgr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    SecurePairingUsingTestSecret pairing1(Optional<NodeId>::Value(kSourceNodeId), 1, 2);
+    Optional<Transport::PeerAddress> peer1(Transport::PeerAddress::UDP(addr, 1));
+    err = secureSessionMgr.NewPairing(peer1, kSourceNodeId, &pairing1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    SecurePairingUsingTestSecret pairing2(Optional<NodeId>::Value(kDestinationNodeId), 2, 1);
+    Optional<Transport::PeerAddress> peer2(Transport::PeerAddress::UDP(addr, 2));
+    err = secureSessionMgr.NewPairing(peer2, kDestinationNodeId, &pairing2);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    MockAppDelegate mockUnsolicitedAppDelegate;
+    err = exchangeMgr.RegisterUnsolicitedMessageHandler(0x0001, 0x0001, &mockUnsolicitedAppDelegate);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // Every exchange takes an initiator context, and a responder context once its first message is received.
+#if CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+    constexpr size_t kExchangeCount = CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS;
+#else
+    constexpr size_t kExchangeCount = CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS / 2;
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+    MockAppDelegate mockSolicitedAppDelegate;
+    ExchangeContext * initiators[kExchangeCount];
+
+    for (auto & ec : initiators)
+    {
+        ec = exchangeMgr.NewContext(kDestinationNodeId, &mockSolicitedAppDelegate);
+        NL_TEST_ASSERT(inSuite, ec != nullptr);
+        if (ec == nullptr)
+        {
+            return;
+        }
+
+        ec->SendMessage(0x0001, 0x0001, System::PacketBuffer::New(), SendFlags(Messaging::SendMessageFlags::kSendFlag_None));
+    }
+    NL_TEST_ASSERT(inSuite, mockUnsolicitedAppDelegate.ReceivedCount == kExchangeCount);
+    NL_TEST_ASSERT(inSuite, exchangeMgr.GetContextsInUse() == 2 * kExchangeCount);
+    NL_TEST_ASSERT(inSuite, exchangeMgr.GetContextCapacity() >= 2 * kExchangeCount);
+
+    // Later messages of the exchanges reach the responder contexts instead of opening new exchanges
+    for (auto & ec : initiators)
+    {
+        ec->SendMessage(0x0001, 0x0001, System::PacketBuffer::New(), SendFlags(Messaging::SendMessageFlags::kSendFlag_None));
+    }
+    NL_TEST_ASSERT(inSuite, mockUnsolicitedAppDelegate.ReceivedCount == 2 * kExchangeCount);
+    NL_TEST_ASSERT(inSuite, exchangeMgr.GetContextsInUse() == 2 * kExchangeCount);
+
+#if !CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+    // The fixed pool is exhausted
+    NL_TEST_ASSERT(inSuite, exchangeMgr.NewContext(kDestinationNodeId, &mockSolicitedAppDelegate) == nullptr);
+#endif // !CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+
+    // Closed contexts are handed out again
+    initiators[0]->Close();
+    NL_TEST_ASSERT(inSuite, exchangeMgr.NewContext(kDestinationNodeId, &mockSolicitedAppDelegate) != nullptr);
 }
 
 // Test Suite
@@ -267,7 +412,9 @@ const nlTest sTests[] =
     NL_TEST_DEF("Test ExchangeMgr::NewContext",               CheckNewContextTest),
     NL_TEST_DEF("Test ExchangeMgr::FindContext",              CheckFindContextTest),
     NL_TEST_DEF("Test ExchangeMgr::CheckUmhRegistrationTest", CheckUmhRegistrationTest),
+    NL_TEST_DEF("Test ExchangeMgr::CheckUmhTableTest",        CheckUmhTableTest),
     NL_TEST_DEF("Test ExchangeMgr::CheckExchangeMessages",    CheckExchangeMessages),
+    NL_TEST_DEF("Test ExchangeMgr::CheckContextPoolTest",     CheckContextPoolTest),
 
     NL_TEST_SENTINEL()
 };
@@ -25,6 +25,7 @@
 #include "TestMessagingLayer.h"
 
 #include <core/CHIPCore.h>
+#include <messaging/Flags.h>
 #include <messaging/ReliableMessageContext.h>
 #include <messaging/ReliableMessageManager.h>
 #include <protocols/Protocols.h>
@@ -74,6 +75,36 @@ public:
     bool SendErrorCalled = false;
 };
 
+/**
+ * A link to a peer which acknowledges the messages sent to it after a delay,
+ * and loses one transmission out of every few.
+ */
+struct LossyLink
+{
+    System::Layer * mSystemLayer;
+    ReliableMessageContext * mContext;
+    uint32_t mDelayMillis;
+    uint32_t mLossPeriod;
+    uint32_t mMessageId;
+    uint32_t mTransmissions;
+
+    void Transmit()
+    {
+        if (++mTransmissions % mLossPeriod != 0)
+        {
+            mSystemLayer->StartTimer(mDelayMillis, DeliverAck, this);
+        }
+    }
+
+    static void DeliverAck(System::Layer * aSystemLayer, void * aAppState, System::Error aError)
+    {
+        LossyLink * link = static_cast<LossyLink *>(aAppState);
+        manager.CheckAndRemRetransTable(link->mContext, link->mMessageId);
+    }
+};
+
+LossyLink * gLossyLink = nullptr;
+
 void CheckAddClearRetrans(nlTestSuite * inSuite, void * inContext)
 {
     TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
@@ -192,6 +223,391 @@ void CheckDelayDelivery(nlTestSuite * inSuite, void * inContext)
     m.Shutdown();
 }
 
+void CheckRetransTableOrder(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    auto & m          = manager;
+    m.TestSetIntervalShift(4); // 16ms per tick
+    m.Init(ctx.GetSystemLayer());
+    ReliableMessageDelegateObject delegate;
+    ReliableMessageContext fast, slow;
+    fast.Init(&m);
+    fast.SetDelegate(&delegate);
+    fast.SetConfig({
+        1, // CHIP_CONFIG_RMP_DEFAULT_INITIAL_RETRANS_TIMEOUT_TICK
+        1, // CHIP_CONFIG_RMP_DEFAULT_ACTIVE_RETRANS_TIMEOUT_TICK
+        1, // CHIP_CONFIG_RMP_DEFAULT_ACK_TIMEOUT_TICK
+        3, // CHIP_CONFIG_RMP_DEFAULT_MAX_RETRANS
+    });
+    slow.Init(&m);
+    slow.SetDelegate(&delegate);
+    slow.SetConfig({
+        100, // CHIP_CONFIG_RMP_DEFAULT_INITIAL_RETRANS_TIMEOUT_TICK
+        100, // CHIP_CONFIG_RMP_DEFAULT_ACTIVE_RETRANS_TIMEOUT_TICK
+        1,   // CHIP_CONFIG_RMP_DEFAULT_ACK_TIMEOUT_TICK
+        3,   // CHIP_CONFIG_RMP_DEFAULT_MAX_RETRANS
+    });
+
+    // Fill the table, alternating between the contexts
+    ReliableMessageManager::RetransTableEntry * entries[CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE];
+    for (uint32_t i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    {
+        auto buf = System::PacketBuffer::New();
+        NL_TEST_ASSERT(inSuite,
+                       m.AddToRetransTable((i % 2) ? &slow : &fast, buf.Release_ForNow(), i, 0, &entries[i]) == CHIP_NO_ERROR);
+    }
+    ReliableMessageManager::RetransTableEntry * entry;
+    NL_TEST_ASSERT(inSuite, m.AddToRetransTable(&fast, nullptr, CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE, 0, &entry) ==
+                       CHIP_ERROR_RETRANS_TABLE_FULL);
+
+    // Acknowledge every third message, latest first
+    uint32_t remaining = CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE;
+    for (uint32_t i = CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i-- > 0;)
+    {
+        if (i % 3 == 0)
+        {
+            ReliableMessageContext * rc = (i % 2) ? &slow : &fast;
+            NL_TEST_ASSERT(inSuite, !m.CheckAndRemRetransTable((i % 2) ? &fast : &slow, i));
+            NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(rc, i));
+            NL_TEST_ASSERT(inSuite, !m.CheckAndRemRetransTable(rc, i));
+            entries[i] = nullptr;
+            remaining--;
+        }
+    }
+    NL_TEST_ASSERT(inSuite, m.TestGetCountRetransTable() == static_cast<int>(remaining));
+
+    // Only the messages of the fast context are due
+    test_os_sleep_ms(20);
+    ReliableMessageManager::Timeout(&ctx.GetSystemLayer(), &m, CHIP_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, m.TestGetCountRetransTable() == static_cast<int>(remaining));
+    for (uint32_t i = 0; i < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE; i++)
+    {
+        if (entries[i] != nullptr)
+        {
+            NL_TEST_ASSERT(inSuite, entries[i]->sendCount == ((i % 2) ? 0 : 1));
+        }
+    }
+    NL_TEST_ASSERT(inSuite, !delegate.SendErrorCalled);
+
+    m.ClearRetransmitTable(&fast);
+    m.ClearRetransmitTable(&slow);
+    NL_TEST_ASSERT(inSuite, m.TestGetCountRetransTable() == 0);
+
+    m.Shutdown();
+}
+
+void CheckAdaptiveRetransTimeout(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    ReliableMessageManager::PeerStats stats;
+
+    // Round-trip times measured in turn, with the smoothed statistics and the timeout in 16ms ticks they lead to:
+    // RTO = SRTT + max(16, 4 * RTTVAR), rounded up to a tick
+    struct
+    {
+        uint32_t rtt;
+        uint32_t srtt;
+        uint32_t rttvar;
+        uint64_t rto;
+    } const samples[] = {
+        { 100, 100, 50, 19 },
+        { 100, 100, 37, 16 },
+        { 200, 112, 53, 21 },
+        { 50, 104, 55, 21 },
+    };
+
+    auto & m = manager;
+    m.TestSetIntervalShift(4); // 16ms per tick
+    m.Init(ctx.GetSystemLayer());
+    m.SetAdaptiveRetransTimeout(true);
+
+    // Until it is measured, the configured timeout is used
+    NL_TEST_ASSERT(inSuite, m.GetPeerStats(0x2222, stats) == CHIP_ERROR_KEY_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, m.GetRetransmitTimeoutTick(0x2222, 10) == 10);
+
+    for (uint32_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+    {
+        NL_TEST_ASSERT(inSuite, m.TestAddRttSample(0x2222, samples[i].rtt) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, m.GetPeerStats(0x2222, stats) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, stats.sampleCount == i + 1);
+        NL_TEST_ASSERT(inSuite, stats.smoothedRttMillis == samples[i].srtt);
+        NL_TEST_ASSERT(inSuite, stats.rttVarianceMillis == samples[i].rttvar);
+        NL_TEST_ASSERT(inSuite, stats.retransTimeoutTick == samples[i].rto);
+        NL_TEST_ASSERT(inSuite, m.GetRetransmitTimeoutTick(0x2222, 10) == samples[i].rto);
+    }
+
+    // The timeout is kept within its bounds
+    NL_TEST_ASSERT(inSuite, m.TestAddRttSample(0x2223, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, m.GetRetransmitTimeoutTick(0x2223, 10) == CHIP_CONFIG_RMP_MIN_RETRANS_TIMEOUT_TICK);
+    NL_TEST_ASSERT(inSuite, m.TestAddRttSample(0x2224, 2000) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, m.GetRetransmitTimeoutTick(0x2224, 10) == CHIP_CONFIG_RMP_MAX_RETRANS_TIMEOUT_TICK);
+
+    // Unless it is enabled, the configured timeout is used regardless
+    m.SetAdaptiveRetransTimeout(false);
+    NL_TEST_ASSERT(inSuite, m.GetRetransmitTimeoutTick(0x2222, 10) == 10);
+
+    m.SetAdaptiveRetransTimeout(CHIP_CONFIG_RMP_ADAPTIVE_RETRANS_TIMEOUT != 0);
+    m.Shutdown();
+}
+
+void CheckRetransTimeoutBackoff(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    ReliableMessageManager::PeerStats stats;
+
+    auto & m = manager;
+    m.TestSetIntervalShift(4); // 16ms per tick
+    m.Init(ctx.GetSystemLayer());
+    m.SetAdaptiveRetransTimeout(true);
+    ReliableMessageContext rc;
+    rc.Init(&m);
+    rc.SetPeerNodeId(0x4444);
+    ReliableMessageDelegateObject delegate;
+    rc.SetDelegate(&delegate);
+    rc.SetConfig({
+        10, // CHIP_CONFIG_RMP_DEFAULT_INITIAL_RETRANS_TIMEOUT_TICK
+        10, // CHIP_CONFIG_RMP_DEFAULT_ACTIVE_RETRANS_TIMEOUT_TICK
+        1,  // CHIP_CONFIG_RMP_DEFAULT_ACK_TIMEOUT_TICK
+        10, // CHIP_CONFIG_RMP_DEFAULT_MAX_RETRANS
+    });
+
+    // A link which loses nothing, and whose acknowledgments take 10ms at first
+    LossyLink link = { &ctx.GetSystemLayer(), &rc, 10, UINT32_MAX, 0, 0 };
+    gLossyLink     = &link;
+
+    auto send = [&](uint32_t messageId) {
+        ReliableMessageManager::RetransTableEntry * entry;
+        uint32_t transmissions = link.mTransmissions;
+
+        NL_TEST_ASSERT(inSuite, m.AddToRetransTable(&rc, System::PacketBuffer::New().Release_ForNow(), messageId, 0, &entry) ==
+                           CHIP_NO_ERROR);
+        link.mMessageId = messageId;
+        NL_TEST_ASSERT(inSuite, m.SendFromRetransTable(entry) == CHIP_NO_ERROR);
+        ctx.DriveIOUntil(2000, [&m]() { return m.TestGetCountRetransTable() == 0; });
+        NL_TEST_ASSERT(inSuite, m.TestGetCountRetransTable() == 0);
+        return link.mTransmissions - transmissions;
+    };
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        NL_TEST_ASSERT(inSuite, send(i) == 1);
+    }
+    NL_TEST_ASSERT(inSuite, m.GetPeerStats(0x4444, stats) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, stats.sampleCount == 4);
+    NL_TEST_ASSERT(inSuite, stats.retransTimeoutTick < 200 >> 4);
+
+    // The acknowledgments now take 200ms, longer than the timeout: it doubles on each retransmission until they arrive
+    link.mDelayMillis = 200;
+    NL_TEST_ASSERT(inSuite, send(4) > 1);
+    NL_TEST_ASSERT(inSuite, m.GetPeerStats(0x4444, stats) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, stats.sampleCount == 4);
+    NL_TEST_ASSERT(inSuite, stats.ignoredSampleCount == 1);
+    NL_TEST_ASSERT(inSuite, stats.retransTimeoutTick > 200 >> 4);
+    NL_TEST_ASSERT(inSuite, stats.retransTimeoutTick <= CHIP_CONFIG_RMP_MAX_RETRANS_TIMEOUT_TICK);
+
+    // The backed off timeout is kept, so the next message is sent once and measures the longer round-trip time
+    NL_TEST_ASSERT(inSuite, send(5) == 1);
+    NL_TEST_ASSERT(inSuite, m.GetPeerStats(0x4444, stats) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, stats.sampleCount == 5);
+    NL_TEST_ASSERT(inSuite, stats.smoothedRttMillis > 10);
+    NL_TEST_ASSERT(inSuite, stats.retransTimeoutTick > 200 >> 4);
+    NL_TEST_ASSERT(inSuite, !delegate.SendErrorCalled);
+
+    ctx.GetSystemLayer().CancelTimer(LossyLink::DeliverAck, &link);
+    gLossyLink = nullptr;
+    m.SetAdaptiveRetransTimeout(CHIP_CONFIG_RMP_ADAPTIVE_RETRANS_TIMEOUT != 0);
+    m.Shutdown();
+}
+
+void CheckSendWindow(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr uint32_t kMessageCount = 8;
+
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    ReliableMessageManager::PeerStats stats;
+
+    auto & m = manager;
+    m.TestSetIntervalShift(4); // 16ms per tick
+    m.Init(ctx.GetSystemLayer());
+    m.SetAdaptiveRetransTimeout(false);
+    ReliableMessageDelegateObject delegate;
+    ReliableMessageContext rc;
+    rc.Init(&m);
+    rc.SetDelegate(&delegate);
+    rc.SetConfig({
+        1,  // CHIP_CONFIG_RMP_DEFAULT_INITIAL_RETRANS_TIMEOUT_TICK
+        1,  // CHIP_CONFIG_RMP_DEFAULT_ACTIVE_RETRANS_TIMEOUT_TICK
+        1,  // CHIP_CONFIG_RMP_DEFAULT_ACK_TIMEOUT_TICK
+        10, // CHIP_CONFIG_RMP_DEFAULT_MAX_RETRANS
+    });
+
+    auto send = [&](uint32_t messageId) {
+        NL_TEST_ASSERT(inSuite, m.SendReliableMessage(&rc, System::PacketBuffer::New().Release_ForNow(), messageId, 0) ==
+                           CHIP_NO_ERROR);
+    };
+    auto check = [&](uint16_t sendWindow, uint16_t inFlightCount, uint16_t queuedCount) {
+        NL_TEST_ASSERT(inSuite, m.GetPeerStats(rc.GetPeerNodeId(), stats) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, stats.sendWindow == sendWindow);
+        NL_TEST_ASSERT(inSuite, stats.inFlightCount == inFlightCount);
+        NL_TEST_ASSERT(inSuite, stats.queuedCount == queuedCount);
+    };
+    auto loseInFlight = [&]() {
+        test_os_sleep_ms(40);
+        ReliableMessageManager::Timeout(&ctx.GetSystemLayer(), &m, CHIP_SYSTEM_NO_ERROR);
+    };
+
+    // Without the send window, a burst is sent at once
+    m.SetSendWindow(false);
+    rc.SetPeerNodeId(0x6666);
+    for (uint32_t i = 0; i < kMessageCount; i++)
+    {
+        send(i);
+    }
+    check(CHIP_CONFIG_RMP_INITIAL_SEND_WINDOW, kMessageCount, 0);
+    m.ClearRetransmitTable(&rc);
+
+    // With it, the burst waits for acknowledgments beyond the initial window
+    m.SetSendWindow(true);
+    rc.SetPeerNodeId(0x7777);
+    for (uint32_t i = 0; i < kMessageCount; i++)
+    {
+        send(i);
+    }
+    check(2, 2, 6);
+
+    // The window grows by one for every window of acknowledgments, each of which lets queued messages out
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 0));
+    check(2, 2, 5);
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 1));
+    check(3, 3, 3);
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 2));
+    check(3, 3, 2);
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 3));
+    check(3, 3, 1);
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 4));
+    check(4, 3, 0);
+
+    // Losing every message in flight halves it once: they were all sent before it was halved
+    loseInFlight();
+    check(2, 3, 0);
+    NL_TEST_ASSERT(inSuite, stats.retransCount == 3);
+
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 5));
+    check(2, 2, 0);
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 6));
+    check(3, 1, 0);
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 7));
+    check(3, 0, 0);
+
+    // Messages sent since it was halved halve it again, but losing them again does not
+    test_os_sleep_ms(2);
+    send(8);
+    send(9);
+    check(3, 2, 0);
+    loseInFlight();
+    check(1, 2, 0);
+    loseInFlight();
+    check(1, 2, 0);
+    NL_TEST_ASSERT(inSuite, stats.retransCount == 7);
+
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 8));
+    check(2, 1, 0);
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 9));
+    check(2, 0, 0);
+    NL_TEST_ASSERT(inSuite, !delegate.SendErrorCalled);
+
+    m.SetAdaptiveRetransTimeout(CHIP_CONFIG_RMP_ADAPTIVE_RETRANS_TIMEOUT != 0);
+    m.SetSendWindow(CHIP_CONFIG_RMP_SEND_WINDOW != 0);
+    m.Shutdown();
+}
+
+void CheckSendQueueDrop(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    auto & m          = manager;
+    m.Init(ctx.GetSystemLayer());
+    m.SetSendWindow(true);
+    ReliableMessageContext rc;
+    rc.Init(&m);
+    rc.SetPeerNodeId(0x8888);
+    ReliableMessageDelegateObject delegate;
+    rc.SetDelegate(&delegate);
+
+    // Messages beyond the initial window wait in the queue
+    for (uint32_t i = 0; i < CHIP_CONFIG_RMP_INITIAL_SEND_WINDOW + 2; i++)
+    {
+        NL_TEST_ASSERT(inSuite, m.SendReliableMessage(&rc, System::PacketBuffer::New().Release_ForNow(), i, 0) == CHIP_NO_ERROR);
+    }
+    ReliableMessageManager::PeerStats stats;
+    NL_TEST_ASSERT(inSuite, m.GetPeerStats(0x8888, stats) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, stats.inFlightCount == CHIP_CONFIG_RMP_INITIAL_SEND_WINDOW);
+    NL_TEST_ASSERT(inSuite, stats.queuedCount == 2);
+    NL_TEST_ASSERT(inSuite, m.TestGetCountRetransTable() == CHIP_CONFIG_RMP_INITIAL_SEND_WINDOW);
+
+    // An acknowledgment lets the next one out
+    NL_TEST_ASSERT(inSuite, m.CheckAndRemRetransTable(&rc, 0));
+    NL_TEST_ASSERT(inSuite, m.GetPeerStats(0x8888, stats) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, stats.inFlightCount == CHIP_CONFIG_RMP_INITIAL_SEND_WINDOW);
+    NL_TEST_ASSERT(inSuite, stats.queuedCount == 1);
+
+    // Failing the exchange fails the queued message too
+    m.FailRetransmitTableEntries(&rc, CHIP_ERROR_CONNECTION_ABORTED);
+    NL_TEST_ASSERT(inSuite, delegate.SendErrorCalled);
+    NL_TEST_ASSERT(inSuite, m.GetPeerStats(0x8888, stats) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, stats.inFlightCount == 0);
+    NL_TEST_ASSERT(inSuite, stats.queuedCount == 0);
+    NL_TEST_ASSERT(inSuite, m.TestGetCountRetransTable() == 0);
+
+    m.SetSendWindow(CHIP_CONFIG_RMP_SEND_WINDOW != 0);
+    m.Shutdown();
+}
+
+void CheckDueAckFlush(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    auto & m          = manager;
+    m.TestSetIntervalShift(4); // 16ms per tick
+    m.Init(ctx.GetSystemLayer());
+    const ReliableMessageManager::AckStats before = m.GetAckStats();
+
+    // Acknowledgments pending on three exchanges with one peer, only the first of which is due soon,
+    // and on one exchange with another peer
+    ReliableMessageContext first, second, third, other;
+    ReliableMessageContext * contexts[] = { &first, &second, &third, &other };
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        contexts[i]->Init(&m);
+        contexts[i]->SetPeerNodeId((contexts[i] == &other) ? 0x5555 : 0x4444);
+        contexts[i]->SetConfig({
+            1,                                 // CHIP_CONFIG_RMP_DEFAULT_INITIAL_RETRANS_TIMEOUT_TICK
+            1,                                 // CHIP_CONFIG_RMP_DEFAULT_ACTIVE_RETRANS_TIMEOUT_TICK
+            static_cast<uint16_t>(i ? 10 : 1), // CHIP_CONFIG_RMP_DEFAULT_ACK_TIMEOUT_TICK
+            1,                                 // CHIP_CONFIG_RMP_DEFAULT_MAX_RETRANS
+        });
+        NL_TEST_ASSERT(inSuite, m.TestHandleNeedsAck(contexts[i], i + 1) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, contexts[i]->IsAckPending());
+    }
+
+    // Only the due acknowledgment is sent, the others wait for a piggyback or their own deadline
+    test_os_sleep_ms(40);
+    ReliableMessageManager::Timeout(&ctx.GetSystemLayer(), &m, CHIP_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !first.IsAckPending());
+    NL_TEST_ASSERT(inSuite, second.IsAckPending());
+    NL_TEST_ASSERT(inSuite, third.IsAckPending());
+    NL_TEST_ASSERT(inSuite, other.IsAckPending());
+    NL_TEST_ASSERT(inSuite, m.GetAckStats().standalone - before.standalone == 1);
+
+    // Once they are all due, a single pass sends them whatever their peer
+    test_os_sleep_ms(160);
+    ReliableMessageManager::Timeout(&ctx.GetSystemLayer(), &m, CHIP_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !second.IsAckPending());
+    NL_TEST_ASSERT(inSuite, !third.IsAckPending());
+    NL_TEST_ASSERT(inSuite, !other.IsAckPending());
+    NL_TEST_ASSERT(inSuite, m.GetAckStats().standalone - before.standalone == 4);
+
+    m.Shutdown();
+}
+
 // Test Suite
 
 /**
@@ -204,6 +620,12 @@ const nlTest sTests[] =
     NL_TEST_DEF("Test ReliableMessageManager::CheckFailRetrans", CheckFailRetrans),
     NL_TEST_DEF("Test ReliableMessageManager::CheckRetransExpire", CheckRetransExpire),
     NL_TEST_DEF("Test ReliableMessageManager::CheckDelayDelivery", CheckDelayDelivery),
+    NL_TEST_DEF("Test ReliableMessageManager::CheckRetransTableOrder", CheckRetransTableOrder),
+    NL_TEST_DEF("Test ReliableMessageManager::CheckAdaptiveRetransTimeout", CheckAdaptiveRetransTimeout),
+    NL_TEST_DEF("Test ReliableMessageManager::CheckRetransTimeoutBackoff", CheckRetransTimeoutBackoff),
+    NL_TEST_DEF("Test ReliableMessageManager::CheckDueAckFlush", CheckDueAckFlush),
+    NL_TEST_DEF("Test ReliableMessageManager::CheckSendWindow", CheckSendWindow),
+    NL_TEST_DEF("Test ReliableMessageManager::CheckSendQueueDrop", CheckSendQueueDrop),
 
     NL_TEST_SENTINEL()
 };
@@ -248,6 +670,10 @@ namespace Messaging {
 // Stub implementation
 CHIP_ERROR ReliableMessageManager::SendMessage(ReliableMessageContext * context, System::PacketBuffer * msgBuf, uint16_t sendFlags)
 {
+    if (gLossyLink != nullptr)
+    {
+        gLossyLink->Transmit();
+    }
     return CHIP_NO_ERROR;
 }
 CHIP_ERROR ReliableMessageManager::SendMessage(ReliableMessageContext * context, uint32_t profileId, uint8_t msgType,
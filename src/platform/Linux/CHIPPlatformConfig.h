@@ -76,13 +76,25 @@ using CHIP_CONFIG_PERSISTED_STORAGE_KEY_TYPE = const char *;
 #endif // CHIP_CONFIG_MAX_PEER_NODES
 
 #ifndef CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS
-#define CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS 16
+#define CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS 256
 #endif // CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS
 
+#ifndef CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS
+#define CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS 32
+#endif // CHIP_CONFIG_MAX_UNSOLICITED_MESSAGE_PROTOCOLS
+
+#ifndef CHIP_CONFIG_PEER_CONNECTION_POOL_DYNAMIC
+#define CHIP_CONFIG_PEER_CONNECTION_POOL_DYNAMIC 1
+#endif // CHIP_CONFIG_PEER_CONNECTION_POOL_DYNAMIC
+
 #ifndef CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS
 #define CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS 8
 #endif // CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS
 
+#ifndef CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+#define CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC 1
+#endif // CHIP_CONFIG_EXCHANGE_CONTEXT_POOL_DYNAMIC
+
 #ifndef CHIP_CONFIG_RMP_TIMER_DEFAULT_PERIOD_SHIFT
 #define CHIP_CONFIG_RMP_TIMER_DEFAULT_PERIOD_SHIFT 6
 #endif // CHIP_CONFIG_RMP_TIMER_DEFAULT_PERIOD_SHIFT
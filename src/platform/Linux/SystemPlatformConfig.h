@@ -47,3 +47,8 @@ struct ChipDeviceEvent;
 #ifndef CHIP_SYSTEM_CONFIG_NUM_TIMERS
 #define CHIP_SYSTEM_CONFIG_NUM_TIMERS 16
 #endif // CHIP_SYSTEM_CONFIG_NUM_TIMERS
+
+// The peer connection and exchange context pools grow on Linux, so count past 127
+#ifndef CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH
+#define CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH 32
+#endif // CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH
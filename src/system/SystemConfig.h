@@ -335,6 +335,43 @@
 #define CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC 15
 #endif /* CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC */
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+ *
+ *  @brief
+ *      Allocate packet buffers from a slab allocator with a few size classes and per-thread caches.
+ *
+ *  The slab replaces the fixed pool of #CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC buffers, which is forced to zero, and
+ *  grows on demand. Small buffers, such as the ones of acknowledgements, take a block of a small class rather than a
+ *  full-sized one, and buffers are recycled without going through the heap.
+ *
+ *  Defaults to disabled; the GN build enables it with `chip_system_config_packetbuffer_slab`.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB 0
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+#if CHIP_SYSTEM_CONFIG_USE_LWIP
+#error "REQUIRED: CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB => !CHIP_SYSTEM_CONFIG_USE_LWIP"
+#endif // CHIP_SYSTEM_CONFIG_USE_LWIP
+#undef CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC 0
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB_MAGAZINE_SIZE
+ *
+ *  @brief
+ *      The number of free packet buffers of each size class a thread keeps for itself, when
+ *      #CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB is enabled.
+ *
+ *  Threads exchange free buffers with each other by half this number at a time.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB_MAGAZINE_SIZE
+#define CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB_MAGAZINE_SIZE 32
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB_MAGAZINE_SIZE
+
 /**
  *  @def CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX
  *
@@ -509,6 +546,17 @@ struct LwIPEvent;
 #define CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS 0
 #endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH
+ *
+ *  @brief
+ *      Width, in bits, of the signed counters of the CHIP System Layer statistics: 8, 16 or 32. Platforms that let resource pools
+ *      grow past 127 entries, e.g. with CHIP_CONFIG_PEER_CONNECTION_POOL_DYNAMIC, should widen the counters.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH
+#define CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH 8
+#endif // CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH
+
 /**
  *  @def CHIP_SYSTEM_CONFIG_TEST
  *
@@ -624,6 +672,38 @@ struct LwIPEvent;
 #endif
 #endif // CHIP_SYSTEM_CONFIG_USE_POSIX_PIPE
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_USE_EPOLL
+ *
+ *  @brief
+ *      Use the Linux epoll() API to watch sockets.
+ *
+ *  Sockets are registered with a single epoll instance owned by the System Layer, which only has to be updated when the
+ *  set of events a socket is interested in changes. PrepareSelect() then hands a single file descriptor to select(),
+ *  however many sockets are open.
+ *
+ *  Defaults to disabled; the GN build enables it on Linux.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_USE_EPOLL
+#define CHIP_SYSTEM_CONFIG_USE_EPOLL 0
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL && !CHIP_SYSTEM_CONFIG_USE_SOCKETS
+#error "REQUIRED: CHIP_SYSTEM_CONFIG_USE_EPOLL => CHIP_SYSTEM_CONFIG_USE_SOCKETS"
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL && !CHIP_SYSTEM_CONFIG_USE_SOCKETS
+
+/**
+ *  @def CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+ *
+ *  @brief
+ *      The maximum number of ready sockets retrieved from epoll per event loop iteration.
+ *
+ *  Sockets beyond that limit stay ready and are reported on the next iteration.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+#define CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS 16
+#endif // CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+
 #ifndef CHIP_SYSTEM_CONFIG_USE_ZEPHYR_SOCKET_EXTENSIONS
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS && __ZEPHYR__
 /**
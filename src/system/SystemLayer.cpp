@@ -94,15 +94,20 @@ Layer::Layer() : mLayerState(kLayerState_NotInitialized), mContext(nullptr), mPl
         sSystemEventHandlerDelegate.Init(HandleSystemLayerEvent);
 
     this->mEventDelegateList = NULL;
-    this->mTimerList         = NULL;
     this->mTimerComplete     = false;
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+    this->mScheduledWork = nullptr;
 #if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
     this->mHandleSelectThread = PTHREAD_NULL;
 #endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    this->mEpollFD          = -1;
+    this->mReadySocketCount = 0;
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
 }
 
 Error Layer::Init(void * aContext)
@@ -133,6 +138,28 @@ Error Layer::Init(void * aContext)
     SuccessOrExit(lReturn);
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    // Create the epoll instance watching the sockets, and have it report the wake event as well.
+    this->mEpollFD = epoll_create1(EPOLL_CLOEXEC);
+    if (this->mEpollFD < 0)
+    {
+        lReturn = MapErrorPOSIX(errno);
+        this->mWakeEvent.Close();
+        ExitNow();
+    }
+
+    this->mReadySocketCount = 0;
+
+    lReturn = this->WatchSocket(this->mWakeEvent.GetNotifFD(), EPOLLIN, &this->mWakeEvent);
+    if (lReturn != CHIP_SYSTEM_NO_ERROR)
+    {
+        close(this->mEpollFD);
+        this->mEpollFD = -1;
+        this->mWakeEvent.Close();
+        ExitNow();
+    }
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
     this->mLayerState = kLayerState_Initialized;
     this->mContext    = aContext;
 
@@ -158,6 +185,13 @@ Error Layer::Shutdown()
     SuccessOrExit(lReturn);
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    // Closing the epoll instance drops every registration left on it.
+    close(this->mEpollFD);
+    this->mEpollFD          = -1;
+    this->mReadySocketCount = 0;
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
     for (size_t i = 0; i < Timer::sPool.Size(); ++i)
     {
         Timer * lTimer = Timer::sPool.Get(*this, i);
@@ -168,6 +202,18 @@ Error Layer::Shutdown()
         }
     }
 
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+    // The work left was cancelled above, only the references held by the list remain.
+    for (Timer * lWork = this->TakeScheduledWork(); lWork != nullptr;)
+    {
+        Timer * lNext = lWork->mNextScheduled;
+
+        lWork->mNextScheduled = nullptr;
+        lWork->Release();
+        lWork = lNext;
+    }
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+
     this->mContext    = nullptr;
     this->mLayerState = kLayerState_NotInitialized;
 
@@ -214,6 +260,11 @@ Error Layer::NewTimer(Timer *& aTimerPtr)
         return CHIP_SYSTEM_ERROR_NO_MEMORY;
     }
 
+    lTimer->mHeapIndex = TimerHeap::kNotQueued;
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+    lTimer->mNextScheduled = nullptr;
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+
     return CHIP_SYSTEM_NO_ERROR;
 }
 
@@ -321,16 +372,38 @@ void Layer::CancelTimer(Layer::TimerCompleteFunct aOnComplete, void * aAppState)
     if (this->State() != kLayerState_Initialized)
         return;
 
+#if CHIP_SYSTEM_CONFIG_USE_LWIP
+    // Work scheduled through the event queue is not in the timer heap, so look at the whole pool.
     for (size_t i = 0; i < Timer::sPool.Size(); ++i)
     {
         Timer * lTimer = Timer::sPool.Get(*this, i);
+#else  // CHIP_SYSTEM_CONFIG_USE_LWIP
+    // Every armed timer is in the heap, which is usually much smaller than the pool.
+    for (size_t i = 0; i < this->mTimerHeap.Size(); ++i)
+    {
+        Timer * lTimer = this->mTimerHeap.At(i);
+#endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 
         if (lTimer != nullptr && lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState)
         {
             lTimer->Cancel();
-            break;
+            return;
         }
     }
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+    // Other threads only ever push in front of the scheduled work, so the list can be walked from its current head. A cancelled
+    // item stays on the list, which holds a reference to it, until the event loop takes it off.
+    for (Timer * lTimer = __atomic_load_n(&this->mScheduledWork, __ATOMIC_ACQUIRE); lTimer != nullptr;
+         lTimer         = lTimer->mNextScheduled)
+    {
+        if (lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState)
+        {
+            lTimer->Cancel();
+            return;
+        }
+    }
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
 }
 
 /**
@@ -588,6 +661,10 @@ void Layer::DispatchTimerCallbacks(const uint64_t kCurrentEpoch)
  *  @param[in]  aWriteSet       A pointer to the set of writable file descriptors.
  *  @param[in]  aExceptionSet   A pointer to the set of file descriptors with errors.
  *  @param[in]  aSleepTime      A reference to the maximum sleep time.
+ *
+ *  @note
+ *      With #CHIP_SYSTEM_CONFIG_USE_EPOLL, only the file descriptor of the epoll instance is added to the read set. It
+ *      becomes readable as soon as the wake event or any watched socket is ready.
  */
 void Layer::PrepareSelect(int & aSetSize, fd_set * aReadSet, fd_set * aWriteSet, fd_set * aExceptionSet,
                           struct timeval & aSleepTime)
@@ -595,7 +672,12 @@ void Layer::PrepareSelect(int & aSetSize, fd_set * aReadSet, fd_set * aWriteSet,
     if (this->State() != kLayerState_Initialized)
         return;
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    // The wake event and all sockets are registered with the epoll instance, which becomes readable when any of them is ready.
+    const int wakeEventFd = this->mEpollFD;
+#else  // CHIP_SYSTEM_CONFIG_USE_EPOLL
     const int wakeEventFd = this->mWakeEvent.GetNotifFD();
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
     FD_SET(wakeEventFd, aReadSet);
 
     if (wakeEventFd + 1 > aSetSize)
@@ -605,21 +687,18 @@ void Layer::PrepareSelect(int & aSetSize, fd_set * aReadSet, fd_set * aWriteSet,
     Timer::Epoch lAwakenEpoch =
         kCurrentEpoch + static_cast<Timer::Epoch>(aSleepTime.tv_sec) * 1000 + static_cast<uint32_t>(aSleepTime.tv_usec) / 1000;
 
-    for (size_t i = 0; i < Timer::sPool.Size(); i++)
-    {
-        Timer * lTimer = Timer::sPool.Get(*this, i);
+    const Timer * lTimer = this->mTimerHeap.Earliest();
 
-        if (lTimer != nullptr)
-        {
-            if (!Timer::IsEarlierEpoch(kCurrentEpoch, lTimer->mAwakenEpoch))
-            {
-                lAwakenEpoch = kCurrentEpoch;
-                break;
-            }
-
-            if (Timer::IsEarlierEpoch(lTimer->mAwakenEpoch, lAwakenEpoch))
-                lAwakenEpoch = lTimer->mAwakenEpoch;
-        }
+    if (__atomic_load_n(&this->mScheduledWork, __ATOMIC_ACQUIRE) != nullptr)
+    {
+        lAwakenEpoch = kCurrentEpoch;
+    }
+    else if (lTimer != nullptr)
+    {
+        if (!Timer::IsEarlierEpoch(kCurrentEpoch, lTimer->mAwakenEpoch))
+            lAwakenEpoch = kCurrentEpoch;
+        else if (Timer::IsEarlierEpoch(lTimer->mAwakenEpoch, lAwakenEpoch))
+            lAwakenEpoch = lTimer->mAwakenEpoch;
     }
 
     // check for an earlier callback timer, too
@@ -670,10 +749,20 @@ void Layer::HandleSelectResult(int aSetSize, fd_set * aReadSet, fd_set * aWriteS
     lThreadSelf = pthread_self();
 #endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    this->mReadySocketCount = 0;
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
     if (aSetSize > 0)
     {
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+        // Retrieve the ready sockets before any timer runs, so that a socket closed by a timer callback can drop its entry.
+        // If one of them is the wake event, clear the event before returning.
+        if (FD_ISSET(this->mEpollFD, aReadSet) && this->CollectReadySockets())
+#else  // CHIP_SYSTEM_CONFIG_USE_EPOLL
         // If we woke because of someone writing to the wake event, clear the event before returning.
         if (FD_ISSET(this->mWakeEvent.GetNotifFD(), aReadSet))
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
         {
             lReturn = this->mWakeEvent.Confirm();
             if (lReturn != CHIP_SYSTEM_NO_ERROR)
@@ -689,14 +778,28 @@ void Layer::HandleSelectResult(int aSetSize, fd_set * aReadSet, fd_set * aWriteS
     this->mHandleSelectThread = lThreadSelf;
 #endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
 
-    for (size_t i = 0; i < Timer::sPool.Size(); i++)
+    // Run the work scheduled so far, in the order it was scheduled. Work scheduled by these callbacks waits for the next pass.
+    for (Timer * lWork = this->TakeScheduledWork(); lWork != nullptr;)
     {
-        Timer * lTimer = Timer::sPool.Get(*this, i);
+        Timer * lNext = lWork->mNextScheduled;
 
-        if (lTimer != nullptr && !Timer::IsEarlierEpoch(kCurrentEpoch, lTimer->mAwakenEpoch))
-        {
-            lTimer->HandleComplete();
-        }
+        lWork->mNextScheduled = nullptr;
+        lWork->HandleComplete();
+        lWork->Release();
+        lWork = lNext;
+    }
+
+    // Complete the due timers, earliest first. Timers started by the callbacks may be due as well; bounding the loop by the
+    // number of timers armed beforehand keeps them from starving the rest of the event loop.
+    for (size_t lBudget = this->mTimerHeap.Size(); lBudget > 0; lBudget--)
+    {
+        Timer * lTimer = this->mTimerHeap.Earliest();
+
+        if (lTimer == nullptr || Timer::IsEarlierEpoch(kCurrentEpoch, lTimer->mAwakenEpoch))
+            break;
+
+        // HandleComplete() takes the timer out of the heap.
+        lTimer->HandleComplete();
     }
 
     DispatchTimerCallbacks(kCurrentEpoch);
@@ -706,6 +809,27 @@ void Layer::HandleSelectResult(int aSetSize, fd_set * aReadSet, fd_set * aWriteS
 #endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
 }
 
+/**
+ * Takes the whole list of work posted by ScheduleWork(), oldest first. The list keeps a reference to each work item, which the
+ * caller becomes responsible for.
+ */
+Timer * Layer::TakeScheduledWork()
+{
+    Timer * lWork     = __sync_lock_test_and_set(&this->mScheduledWork, nullptr);
+    Timer * lReversed = nullptr;
+
+    while (lWork != nullptr)
+    {
+        Timer * lNext = lWork->mNextScheduled;
+
+        lWork->mNextScheduled = lReversed;
+        lReversed             = lWork;
+        lWork                 = lNext;
+    }
+
+    return lReversed;
+}
+
 /**
  * Wake up the I/O thread that monitors the file descriptors using select() by writing a single byte to the wake pipe.
  *
@@ -738,6 +862,146 @@ void Layer::WakeSelect()
     }
 }
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+/**
+ * Start watching a socket for I/O readiness.
+ *
+ * The registration persists across event loop iterations until it is changed with @p UpdateSocketWatch() or removed with
+ * @p UnwatchSocket(), which must happen before the socket is closed.
+ *
+ *  @param[in]  aSocket     The socket to watch.
+ *  @param[in]  aEvents     The epoll events of interest, e.g. EPOLLIN and/or EPOLLOUT.
+ *  @param[in]  aWatcher    An opaque pointer identifying the owner of the socket, reported back by @p GetReadySockets().
+ *
+ *  @retval CHIP_SYSTEM_NO_ERROR                On success.
+ *  @retval CHIP_SYSTEM_ERROR_UNEXPECTED_STATE  If the layer has no epoll instance.
+ *  @retval other                               The mapped error from epoll_ctl().
+ */
+Error Layer::WatchSocket(int aSocket, uint32_t aEvents, void * aWatcher)
+{
+    struct epoll_event lEvent;
+
+    if (this->mEpollFD < 0)
+        return CHIP_SYSTEM_ERROR_UNEXPECTED_STATE;
+
+    lEvent.events   = aEvents;
+    lEvent.data.ptr = aWatcher;
+
+    if (epoll_ctl(this->mEpollFD, EPOLL_CTL_ADD, aSocket, &lEvent) != 0)
+        return MapErrorPOSIX(errno);
+
+    return CHIP_SYSTEM_NO_ERROR;
+}
+
+/**
+ * Change the events a watched socket is interested in.
+ *
+ *  @param[in]  aSocket     The watched socket.
+ *  @param[in]  aEvents     The new epoll events of interest.
+ *  @param[in]  aWatcher    The pointer the socket was registered with.
+ *
+ *  @retval CHIP_SYSTEM_NO_ERROR                On success.
+ *  @retval CHIP_SYSTEM_ERROR_UNEXPECTED_STATE  If the layer has no epoll instance.
+ *  @retval other                               The mapped error from epoll_ctl().
+ */
+Error Layer::UpdateSocketWatch(int aSocket, uint32_t aEvents, void * aWatcher)
+{
+    struct epoll_event lEvent;
+
+    if (this->mEpollFD < 0)
+        return CHIP_SYSTEM_ERROR_UNEXPECTED_STATE;
+
+    lEvent.events   = aEvents;
+    lEvent.data.ptr = aWatcher;
+
+    if (epoll_ctl(this->mEpollFD, EPOLL_CTL_MOD, aSocket, &lEvent) != 0)
+        return MapErrorPOSIX(errno);
+
+    return CHIP_SYSTEM_NO_ERROR;
+}
+
+/**
+ * Stop watching a socket.
+ *
+ * Readiness already retrieved for the socket but not yet handled is discarded, since the socket number may be reused before it
+ * would be acted upon.
+ *
+ *  @param[in]  aSocket     The watched socket.
+ *  @param[in]  aWatcher    The pointer the socket was registered with.
+ *
+ *  @retval CHIP_SYSTEM_NO_ERROR                On success.
+ *  @retval CHIP_SYSTEM_ERROR_UNEXPECTED_STATE  If the layer has no epoll instance.
+ *  @retval other                               The mapped error from epoll_ctl().
+ */
+Error Layer::UnwatchSocket(int aSocket, void * aWatcher)
+{
+    if (this->mEpollFD < 0)
+        return CHIP_SYSTEM_ERROR_UNEXPECTED_STATE;
+
+    for (int i = 0; i < this->mReadySocketCount; i++)
+    {
+        if (this->mReadySockets[i].data.ptr == aWatcher)
+        {
+            this->mReadySockets[i].events   = 0;
+            this->mReadySockets[i].data.ptr = nullptr;
+        }
+    }
+
+    if (epoll_ctl(this->mEpollFD, EPOLL_CTL_DEL, aSocket, nullptr) != 0)
+        return MapErrorPOSIX(errno);
+
+    return CHIP_SYSTEM_NO_ERROR;
+}
+
+/**
+ * Get the sockets found ready by the last call to @p HandleSelectResult().
+ *
+ * Entries of sockets unwatched since then have a null @c data.ptr and must be skipped.
+ *
+ *  @param[out] aCount  The number of entries.
+ *
+ *  @return The ready sockets, with @c data.ptr set to the watcher the socket was registered with.
+ */
+const struct epoll_event * Layer::GetReadySockets(int & aCount) const
+{
+    aCount = this->mReadySocketCount;
+    return this->mReadySockets;
+}
+
+/**
+ * Retrieve the ready sockets from the epoll instance without blocking.
+ *
+ * The wake event is taken out of the list, as it is not owned by any endpoint.
+ *
+ *  @return true if the wake event was among the ready sockets, false otherwise.
+ */
+bool Layer::CollectReadySockets()
+{
+    bool lWoken      = false;
+    const int lCount = epoll_wait(this->mEpollFD, this->mReadySockets, CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS, 0);
+
+    if (lCount < 0)
+    {
+        ChipLogError(chipSystemLayer, "epoll_wait failed: %s", ErrorStr(MapErrorPOSIX(errno)));
+        return false;
+    }
+
+    this->mReadySocketCount = lCount;
+
+    for (int i = 0; i < lCount; i++)
+    {
+        if (this->mReadySockets[i].data.ptr == &this->mWakeEvent)
+        {
+            this->mReadySockets[i].events   = 0;
+            this->mReadySockets[i].data.ptr = nullptr;
+            lWoken                          = true;
+        }
+    }
+
+    return lWoken;
+}
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
 
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
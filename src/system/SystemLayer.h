@@ -34,6 +34,7 @@
 #include <system/SystemError.h>
 #include <system/SystemEvent.h>
 #include <system/SystemObject.h>
+#include <system/SystemTimer.h>
 
 // Include dependent headers
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS
@@ -42,6 +43,10 @@
 #include <sys/select.h>
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+#include <sys/epoll.h>
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
 #if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
 #include <pthread.h>
 #endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
@@ -120,6 +125,9 @@ private:
  *      For \c CHIP_SYSTEM_CONFIG_USE_SOCKETS, event readiness notification is handled via traditional poll/select implementation on
  *      the platform adaptation.
  *
+ *      With \c CHIP_SYSTEM_CONFIG_USE_EPOLL, sockets are instead registered once with an epoll instance owned by the layer, and
+ *      select() only ever watches that instance's file descriptor.
+ *
  *      For \c CHIP_SYSTEM_CONFIG_USE_LWIP, event readiness notification is handle via events / messages and platform- and
  *      system-specific hooks for the event/message system.
  */
@@ -153,6 +161,14 @@ public:
     void WakeSelect();
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    // Socket Watches
+    Error WatchSocket(int aSocket, uint32_t aEvents, void * aWatcher);
+    Error UpdateSocketWatch(int aSocket, uint32_t aEvents, void * aWatcher);
+    Error UnwatchSocket(int aSocket, void * aWatcher);
+    const struct epoll_event * GetReadySockets(int & aCount) const;
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
     typedef Error (*EventHandler)(Object & aTarget, EventType aEventType, uintptr_t aArgument);
     Error AddEventHandlerDelegate(LwIPEventHandlerDelegate & aDelegate);
@@ -179,22 +195,35 @@ private:
     void * mContext;
     void * mPlatformData;
     chip::Callback::CallbackDeque mTimerCallbacks;
+    TimerHeap mTimerHeap;
 
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
     static LwIPEventHandlerDelegate sSystemEventHandlerDelegate;
 
     const LwIPEventHandlerDelegate * mEventDelegateList;
-    Timer * mTimerList;
     bool mTimerComplete;
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
     SystemWakeEvent mWakeEvent;
+    Timer * mScheduledWork; // Work posted by ScheduleWork() from any thread, most recent first.
 #if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
     pthread_t mHandleSelectThread;
 #endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
 
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+    int mEpollFD;
+    int mReadySocketCount;
+    struct epoll_event mReadySockets[CHIP_SYSTEM_CONFIG_EPOLL_MAX_EVENTS];
+
+    bool CollectReadySockets();
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+    Timer * TakeScheduledWork();
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
     static Error HandleSystemLayerEvent(Object & aTarget, EventType aEventType, uintptr_t aArgument);
 
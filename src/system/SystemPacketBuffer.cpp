@@ -40,6 +40,7 @@
 #include <support/logging/CHIPLogging.h>
 #include <system/SystemFaultInjection.h>
 #include <system/SystemMutex.h>
+#include <system/SystemPacketBufferSlab.h>
 #include <system/SystemStats.h>
 
 #include <stdint.h>
@@ -192,6 +193,39 @@ uint16_t PacketBuffer::TotalLength() const
     return this->tot_len;
 }
 
+/**
+ * Copy data out of the buffer chain starting with the current buffer, which may span several buffers.
+ *
+ *  @param[in]  aOffset     Offset of the data to copy, from the start of the current buffer.
+ *  @param[out] aDest       Where to copy the data.
+ *  @param[in]  aLength     Number of octets to copy.
+ *
+ *  @return the number of octets copied, less than \c aLength if the chain ends first.
+ */
+uint16_t PacketBuffer::Read(uint16_t aOffset, uint8_t * aDest, uint16_t aLength) const
+{
+    uint16_t lCopied = 0;
+
+    for (const PacketBuffer * lBuffer = this; lBuffer != nullptr && lCopied < aLength; lBuffer = lBuffer->Next())
+    {
+        if (aOffset >= lBuffer->len)
+        {
+            aOffset = static_cast<uint16_t>(aOffset - lBuffer->len);
+            continue;
+        }
+
+        uint16_t lCount = static_cast<uint16_t>(lBuffer->len - aOffset);
+        if (lCount > aLength - lCopied)
+            lCount = static_cast<uint16_t>(aLength - lCopied);
+
+        memcpy(&aDest[lCopied], static_cast<const uint8_t *>(lBuffer->payload) + aOffset, lCount);
+        lCopied = static_cast<uint16_t>(lCopied + lCount);
+        aOffset = 0;
+    }
+
+    return lCopied;
+}
+
 /**
  * Get the maximum amount, in bytes, of data that will fit in the buffer given the current start position and buffer size.
  *
@@ -227,6 +261,26 @@ uint16_t PacketBuffer::ReservedSize() const
     return static_cast<uint16_t>(kDelta - CHIP_SYSTEM_PACKETBUFFER_HEADER_SIZE);
 }
 
+/**
+ * Check whether the data of the current buffer is stored within the buffer itself.
+ *
+ *  This is always the case for buffers allocated by PacketBuffer. LwIP may however deliver received data in buffers referencing
+ *  memory they do not own (PBUF_REF, PBUF_ROM), which must not be modified in place.
+ *
+ * @return true if the data of the current buffer is stored within the buffer, false otherwise.
+ */
+bool PacketBuffer::IsDataInline() const
+{
+#if CHIP_SYSTEM_CONFIG_USE_LWIP
+    const uint8_t * const kStart = reinterpret_cast<const uint8_t *>(this) + CHIP_SYSTEM_PACKETBUFFER_HEADER_SIZE;
+    const uint8_t * const kData  = static_cast<const uint8_t *>(this->payload);
+
+    return kData >= kStart && kData + this->len <= kStart + this->AllocSize();
+#else  // !CHIP_SYSTEM_CONFIG_USE_LWIP
+    return true;
+#endif // !CHIP_SYSTEM_CONFIG_USE_LWIP
+}
+
 /**
  *
  * Add the given packet buffer to the end of the buffer chain, adjusting the total length of each buffer in the chain accordingly.
@@ -472,6 +526,7 @@ PacketBufferHandle PacketBuffer::NewWithAvailableSize(uint16_t aReservedSize, ui
 
     const size_t lAllocSize = aReservedSize + aAvailableSize;
     const size_t lBlockSize = CHIP_SYSTEM_PACKETBUFFER_HEADER_SIZE + lAllocSize;
+    size_t lCapacity        = lAllocSize;
     PacketBuffer * lPacket;
 
     CHIP_SYSTEM_FAULT_INJECT(FaultInjection::kFault_PacketBufferNew, return PacketBufferHandle());
@@ -504,12 +559,26 @@ PacketBufferHandle PacketBuffer::NewWithAvailableSize(uint16_t aReservedSize, ui
 
     UNLOCK_BUF_POOL();
 
-#else // !CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+#elif CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+
+    size_t lSlabSize = lBlockSize;
+
+    lPacket = static_cast<PacketBuffer *>(PacketBufferSlab::Allocate(lSlabSize));
+    if (lPacket != nullptr)
+    {
+        // Let the buffer use the whole block it was given
+        lCapacity = lSlabSize - CHIP_SYSTEM_PACKETBUFFER_HEADER_SIZE;
+        if (lCapacity > CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX)
+            lCapacity = CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX;
+    }
+    SYSTEM_STATS_INCREMENT(chip::System::Stats::kSystemLayer_NumPacketBufs);
+
+#else // !CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC && !CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
 
     lPacket = reinterpret_cast<PacketBuffer *>(chip::Platform::MemoryAlloc(lBlockSize));
     SYSTEM_STATS_INCREMENT(chip::System::Stats::kSystemLayer_NumPacketBufs);
 
-#endif // !CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+#endif // !CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC && !CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
 #endif // !CHIP_SYSTEM_CONFIG_USE_LWIP
 
     if (lPacket == nullptr)
@@ -523,7 +592,9 @@ PacketBufferHandle PacketBuffer::NewWithAvailableSize(uint16_t aReservedSize, ui
     lPacket->next                   = nullptr;
     lPacket->ref                    = 1;
 #if CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
-    lPacket->alloc_size = static_cast<uint16_t>(lAllocSize);
+    lPacket->alloc_size = static_cast<uint16_t>(lCapacity);
+#else  // CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC != 0
+    static_cast<void>(lCapacity);
 #endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
 
     return PacketBufferHandle(lPacket);
@@ -620,9 +691,11 @@ void PacketBuffer::Free(PacketBuffer * aPacket)
 #if CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
             aPacket->next = sFreeList;
             sFreeList     = aPacket;
-#else  // !CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+#elif CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+            PacketBufferSlab::Release(aPacket);
+#else  // !CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC && !CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
             chip::Platform::MemoryFree(aPacket);
-#endif // !CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+#endif // !CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC && !CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
             aPacket       = lNextPacket;
         }
         else
@@ -113,12 +113,15 @@ public:
     void SetDataLength(uint16_t aNewLen, PacketBuffer * aChainHead = nullptr);
 
     uint16_t TotalLength() const;
+    uint16_t Read(uint16_t aOffset, uint8_t * aDest, uint16_t aLength) const;
 
     uint16_t MaxDataLength() const;
     uint16_t AvailableDataLength() const;
 
     uint16_t ReservedSize() const;
 
+    bool IsDataInline() const;
+
     PacketBuffer * Next() const;
 
     // The raw PacketBuffer version of AddToEnd() will be removed when conversion to PacketBufferHandle is complete.
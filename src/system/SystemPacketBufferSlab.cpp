@@ -0,0 +1,375 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the size-class slab allocator backing
+ *      chip::System::PacketBuffer.
+ */
+
+// Include module header
+#include <system/SystemPacketBufferSlab.h>
+
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+
+#include <support/CHIPMem.h>
+#include <system/SystemAlignSize.h>
+#include <system/SystemPacketBuffer.h>
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+namespace chip {
+namespace System {
+
+namespace {
+
+/**
+ * Every block is preceded by a prefix telling which class and index it has,
+ * so it can be released without searching for its chunk.
+ */
+struct BlockPrefix
+{
+    uint32_t mIndex;
+    uint8_t mClass;
+};
+
+constexpr size_t kAlignment        = alignof(std::max_align_t);
+constexpr size_t kPrefixSize       = CHIP_SYSTEM_ALIGN_SIZE(sizeof(BlockPrefix), kAlignment);
+constexpr uint32_t kBlocksPerChunk = 32;
+constexpr uint32_t kMaxChunks      = 2048;
+constexpr uint32_t kNoBlock        = UINT32_MAX;
+constexpr size_t kMagazineSize     = CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB_MAGAZINE_SIZE;
+
+// Small classes fit acknowledgements and other short messages, the largest one a buffer of the maximum capacity.
+constexpr size_t kClassSizes[PacketBufferSlab::kNumClasses] = { 128, 256, 512,
+                                                                CHIP_SYSTEM_ALIGN_SIZE(CHIP_SYSTEM_PACKETBUFFER_SIZE, kAlignment) };
+
+static_assert(kClassSizes[PacketBufferSlab::kNumClasses - 2] < kClassSizes[PacketBufferSlab::kNumClasses - 1],
+              "Packet buffers of the maximum capacity must be larger than the small classes");
+static_assert(kMagazineSize >= 2, "Magazines are refilled and flushed by halves");
+
+// A chunk starts with the free list link of each of its blocks, followed by the blocks and their prefixes.
+constexpr size_t kLinksSize = CHIP_SYSTEM_ALIGN_SIZE(kBlocksPerChunk * sizeof(std::atomic<uint32_t>), kAlignment);
+
+/**
+ * The free blocks of a class, shared by all threads.
+ *
+ * Free blocks form a stack linked by block index. The head also holds a tag,
+ * bumped by every update, so a thread can not mistake a head that was popped
+ * and pushed back in the meantime for an unchanged one.
+ */
+struct SizeClass
+{
+    std::atomic<uint64_t> mFreeHead{ kNoBlock }; ///< tag in the high 32 bits, index of the first free block in the low ones
+    std::atomic<uint32_t> mChunkCount{ 0 };      ///< number of chunks allocated, the last ones possibly still being set up
+    std::atomic<uint8_t *> mChunks[kMaxChunks];
+};
+
+SizeClass sClasses[PacketBufferSlab::kNumClasses];
+
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+std::atomic<uint64_t> sAllocations{ 0 };
+std::atomic<uint64_t> sCacheHits{ 0 };
+std::atomic<uint64_t> sBlocks{ 0 };
+std::atomic<uint64_t> sBlocksInUse{ 0 };
+std::atomic<uint64_t> sBlocksInUseHighWatermark{ 0 };
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+constexpr size_t Stride(size_t aClass)
+{
+    return kPrefixSize + kClassSizes[aClass];
+}
+
+std::atomic<uint32_t> & Link(SizeClass & aClass, uint32_t aIndex)
+{
+    uint8_t * lChunk = aClass.mChunks[aIndex / kBlocksPerChunk].load(std::memory_order_acquire);
+    return reinterpret_cast<std::atomic<uint32_t> *>(lChunk)[aIndex % kBlocksPerChunk];
+}
+
+BlockPrefix * Prefix(size_t aClass, uint32_t aIndex)
+{
+    uint8_t * lChunk = sClasses[aClass].mChunks[aIndex / kBlocksPerChunk].load(std::memory_order_acquire);
+    return reinterpret_cast<BlockPrefix *>(lChunk + kLinksSize + (aIndex % kBlocksPerChunk) * Stride(aClass));
+}
+
+void * Block(size_t aClass, uint32_t aIndex)
+{
+    return reinterpret_cast<uint8_t *>(Prefix(aClass, aIndex)) + kPrefixSize;
+}
+
+BlockPrefix * PrefixOf(void * aBlock)
+{
+    return reinterpret_cast<BlockPrefix *>(static_cast<uint8_t *>(aBlock) - kPrefixSize);
+}
+
+uint64_t NextHead(uint64_t aHead, uint32_t aIndex)
+{
+    return (((aHead >> 32) + 1) << 32) | aIndex;
+}
+
+uint32_t Pop(SizeClass & aClass)
+{
+    uint64_t lHead = aClass.mFreeHead.load(std::memory_order_acquire);
+
+    while (static_cast<uint32_t>(lHead) != kNoBlock)
+    {
+        const uint32_t lNext = Link(aClass, static_cast<uint32_t>(lHead)).load(std::memory_order_relaxed);
+
+        if (aClass.mFreeHead.compare_exchange_weak(lHead, NextHead(lHead, lNext), std::memory_order_acquire,
+                                                   std::memory_order_acquire))
+        {
+            return static_cast<uint32_t>(lHead);
+        }
+    }
+
+    return kNoBlock;
+}
+
+/// Push blocks already linked from aFirst to aLast.
+void PushChain(SizeClass & aClass, uint32_t aFirst, uint32_t aLast)
+{
+    uint64_t lHead = aClass.mFreeHead.load(std::memory_order_relaxed);
+
+    do
+    {
+        Link(aClass, aLast).store(static_cast<uint32_t>(lHead), std::memory_order_relaxed);
+    } while (
+        !aClass.mFreeHead.compare_exchange_weak(lHead, NextHead(lHead, aFirst), std::memory_order_release, std::memory_order_relaxed));
+}
+
+/// Carve a new chunk of blocks out of the heap and make them free.
+bool Grow(size_t aClass)
+{
+    SizeClass & lClass = sClasses[aClass];
+    uint32_t lChunk    = lClass.mChunkCount.load(std::memory_order_relaxed);
+
+    if (lChunk >= kMaxChunks)
+        return false;
+
+    uint8_t * lMemory = static_cast<uint8_t *>(chip::Platform::MemoryAlloc(kLinksSize + kBlocksPerChunk * Stride(aClass)));
+    if (lMemory == nullptr)
+        return false;
+
+    // Only claim a chunk slot once its memory is there, so that failures do not use up slots
+    do
+    {
+        if (lChunk >= kMaxChunks)
+        {
+            chip::Platform::MemoryFree(lMemory);
+            return false;
+        }
+    } while (!lClass.mChunkCount.compare_exchange_weak(lChunk, lChunk + 1, std::memory_order_relaxed, std::memory_order_relaxed));
+
+    const uint32_t lFirst = lChunk * kBlocksPerChunk;
+    const uint32_t lLast  = lFirst + kBlocksPerChunk - 1;
+
+    for (uint32_t i = 0; i < kBlocksPerChunk; i++)
+    {
+        new (lMemory + i * sizeof(std::atomic<uint32_t>)) std::atomic<uint32_t>(lFirst + i + 1);
+    }
+    lClass.mChunks[lChunk].store(lMemory, std::memory_order_release);
+
+    for (uint32_t lIndex = lFirst; lIndex <= lLast; lIndex++)
+    {
+        BlockPrefix * lPrefix = Prefix(aClass, lIndex);
+        lPrefix->mIndex       = lIndex;
+        lPrefix->mClass       = static_cast<uint8_t>(aClass);
+    }
+
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    sBlocks.fetch_add(kBlocksPerChunk, std::memory_order_relaxed);
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+    PushChain(lClass, lFirst, lLast);
+
+    return true;
+}
+
+/**
+ * Free blocks of each class kept by a thread. Whatever is left when the
+ * thread exits goes back to the shared stacks.
+ */
+class ThreadCache
+{
+public:
+    ~ThreadCache()
+    {
+        for (size_t c = 0; c < PacketBufferSlab::kNumClasses; c++)
+        {
+            Flush(c, mMagazines[c].mCount);
+        }
+    }
+
+    void * Allocate(size_t aClass)
+    {
+        Magazine & lMagazine = mMagazines[aClass];
+        const bool lCacheHit = (lMagazine.mCount > 0);
+
+        if (!lCacheHit && !Refill(aClass))
+            return nullptr;
+
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+        sAllocations.fetch_add(1, std::memory_order_relaxed);
+        if (lCacheHit)
+        {
+            sCacheHits.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        const uint64_t lInUse   = sBlocksInUse.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint64_t lHighWatermark = sBlocksInUseHighWatermark.load(std::memory_order_relaxed);
+        while (lInUse > lHighWatermark &&
+               !sBlocksInUseHighWatermark.compare_exchange_weak(lHighWatermark, lInUse, std::memory_order_relaxed))
+        {
+            // A failed exchange reloaded lHighWatermark, which another thread may have raised past lInUse
+        }
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+        return lMagazine.mBlocks[--lMagazine.mCount];
+    }
+
+    void Release(size_t aClass, void * aBlock)
+    {
+        Magazine & lMagazine = mMagazines[aClass];
+
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+        sBlocksInUse.fetch_sub(1, std::memory_order_relaxed);
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+        if (lMagazine.mCount == kMagazineSize)
+        {
+            Flush(aClass, kMagazineSize / 2);
+        }
+
+        lMagazine.mBlocks[lMagazine.mCount++] = aBlock;
+    }
+
+private:
+    struct Magazine
+    {
+        size_t mCount = 0;
+        void * mBlocks[kMagazineSize];
+    };
+
+    /// Take half a magazine of blocks from the shared stack, growing it if needed.
+    bool Refill(size_t aClass)
+    {
+        Magazine & lMagazine = mMagazines[aClass];
+
+        while (lMagazine.mCount < kMagazineSize / 2)
+        {
+            uint32_t lIndex = Pop(sClasses[aClass]);
+
+            if (lIndex == kNoBlock)
+            {
+                if (lMagazine.mCount > 0 || !Grow(aClass))
+                    break;
+                continue;
+            }
+
+            lMagazine.mBlocks[lMagazine.mCount++] = Block(aClass, lIndex);
+        }
+
+        return lMagazine.mCount > 0;
+    }
+
+    /// Give the topmost blocks of a magazine back to the shared stack, in a single push.
+    void Flush(size_t aClass, size_t aCount)
+    {
+        Magazine & lMagazine = mMagazines[aClass];
+
+        if (aCount == 0)
+            return;
+
+        const size_t lBottom  = lMagazine.mCount - aCount;
+        const uint32_t lFirst = PrefixOf(lMagazine.mBlocks[lBottom])->mIndex;
+        uint32_t lLast        = lFirst;
+
+        for (size_t i = lBottom + 1; i < lMagazine.mCount; i++)
+        {
+            const uint32_t lIndex = PrefixOf(lMagazine.mBlocks[i])->mIndex;
+            Link(sClasses[aClass], lLast).store(lIndex, std::memory_order_relaxed);
+            lLast = lIndex;
+        }
+
+        PushChain(sClasses[aClass], lFirst, lLast);
+        lMagazine.mCount = lBottom;
+    }
+
+    Magazine mMagazines[PacketBufferSlab::kNumClasses];
+};
+
+thread_local ThreadCache sThreadCache;
+
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+Stats::count_t ToCount(uint64_t aValue)
+{
+    return (aValue > CHIP_SYS_STATS_COUNT_MAX) ? CHIP_SYS_STATS_COUNT_MAX : static_cast<Stats::count_t>(aValue);
+}
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+} // namespace
+
+void * PacketBufferSlab::Allocate(size_t & aSize)
+{
+    for (size_t c = 0; c < kNumClasses; c++)
+    {
+        if (aSize <= kClassSizes[c])
+        {
+            void * lBlock = sThreadCache.Allocate(c);
+
+            if (lBlock != nullptr)
+            {
+                aSize = kClassSizes[c];
+            }
+
+            return lBlock;
+        }
+    }
+
+    return nullptr;
+}
+
+void PacketBufferSlab::Release(void * aBlock)
+{
+    sThreadCache.Release(PrefixOf(aBlock)->mClass, aBlock);
+}
+
+size_t PacketBufferSlab::ClassSize(size_t aClass)
+{
+    return kClassSizes[aClass];
+}
+
+void PacketBufferSlab::GetStatistics(Stats::count_t & aAllocations, Stats::count_t & aCacheHits, Stats::count_t & aBlocks,
+                                     Stats::count_t & aBlocksInUse, Stats::count_t & aBlocksInUseHighWatermark)
+{
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    aAllocations              = ToCount(sAllocations.load(std::memory_order_relaxed));
+    aCacheHits                = ToCount(sCacheHits.load(std::memory_order_relaxed));
+    aBlocks                   = ToCount(sBlocks.load(std::memory_order_relaxed));
+    aBlocksInUse              = ToCount(sBlocksInUse.load(std::memory_order_relaxed));
+    aBlocksInUseHighWatermark = ToCount(sBlocksInUseHighWatermark.load(std::memory_order_relaxed));
+#else  // !CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    aAllocations = aCacheHits = aBlocks = aBlocksInUse = aBlocksInUseHighWatermark = 0;
+#endif // !CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+}
+
+} // namespace System
+} // namespace chip
+
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
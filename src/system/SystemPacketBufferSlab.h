@@ -0,0 +1,92 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file declares the size-class slab allocator backing
+ *      chip::System::PacketBuffer when
+ *      #CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB is enabled.
+ */
+
+#pragma once
+
+// Include configuration headers
+#include <system/SystemConfig.h>
+
+#include <system/SystemStats.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+
+namespace chip {
+namespace System {
+
+/**
+ * Allocator of packet buffer blocks, which hands out blocks from a few size
+ * classes instead of sizing every allocation exactly.
+ *
+ * Every thread keeps a small magazine of free blocks of each class, which it
+ * allocates from and frees to without any synchronization. A thread whose
+ * magazine runs empty refills it from a lock-free stack of free blocks shared
+ * by all threads, and one whose magazine is full returns half of it to that
+ * stack with a single atomic operation. Blocks are carved out of chunks taken
+ * from the platform heap when the shared stack is empty; chunks are never
+ * given back.
+ *
+ * A block may be freed by a different thread than the one that allocated it.
+ */
+class PacketBufferSlab
+{
+public:
+    static constexpr size_t kNumClasses = 4;
+
+    /**
+     * Allocate a block.
+     *
+     * @param[in,out] aSize  Requested size in bytes; set to the usable size of
+     *                       the returned block, which may be larger.
+     *
+     * @return the block, or nullptr if \c aSize exceeds the largest class or
+     *         no memory is left.
+     */
+    static void * Allocate(size_t & aSize);
+
+    /// Release a block returned by Allocate().
+    static void Release(void * aBlock);
+
+    /// Usable size of the blocks of each class, in increasing order.
+    static size_t ClassSize(size_t aClass);
+
+    /**
+     * Retrieve the allocator statistics.
+     *
+     * @param[out] aAllocations  Number of blocks allocated so far.
+     * @param[out] aCacheHits    Number of them served by the allocating thread's magazine.
+     * @param[out] aBlocks       Number of blocks carved out of the heap so far, in use or free.
+     * @param[out] aBlocksInUse  Number of blocks allocated and not released yet.
+     * @param[out] aBlocksInUseHighWatermark  Largest number of blocks in use at once so far.
+     */
+    static void GetStatistics(Stats::count_t & aAllocations, Stats::count_t & aCacheHits, Stats::count_t & aBlocks,
+                              Stats::count_t & aBlocksInUse, Stats::count_t & aBlocksInUseHighWatermark);
+};
+
+} // namespace System
+} // namespace chip
+
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
@@ -32,6 +32,7 @@
 #include <system/SystemStats.h>
 
 #include <support/SafeInt.h>
+#include <system/SystemPacketBufferSlab.h>
 
 #include <string.h>
 
@@ -48,6 +49,12 @@ static const Label sStatsStrings[chip::System::Stats::kNumEntries] = {
     "SystemLayer_NumPacketBufs",
 #endif
     "SystemLayer_NumTimersInUse",
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+    "SystemLayer_NumPacketBufSlabAllocs",
+    "SystemLayer_NumPacketBufSlabCacheHits",
+    "SystemLayer_NumPacketBufSlabBlocks",
+    "SystemLayer_NumPacketBufSlabBlocksInUse",
+#endif
 #if INET_CONFIG_NUM_RAW_ENDPOINTS
     "InetLayer_NumRawEpsInUse",
 #endif
@@ -60,8 +67,10 @@ static const Label sStatsStrings[chip::System::Stats::kNumEntries] = {
 #if INET_CONFIG_NUM_DNS_RESOLVERS
     "InetLayer_NumDNSResolversInUse",
 #endif
-    "ExchangeMgr_NumContextsInUse",   "ExchangeMgr_NumUMHandlersInUse",
-    "ExchangeMgr_NumBindings",        "MessageLayer_NumConnectionsInUse",
+    "ExchangeMgr_NumContextsInUse",   "ExchangeMgr_NumContextAllocFailures",
+    "ExchangeMgr_NumUMHandlersInUse", "ExchangeMgr_NumBindings",
+    "MessageLayer_NumConnectionsInUse", "Transport_NumPeerConnectionsInUse",
+    "Transport_NumPeerConnectionSlots",
 };
 
 count_t sResourcesInUse[kNumEntries];
@@ -90,6 +99,18 @@ void UpdateSnapshot(Snapshot & aSnapshot)
     chip::System::Timer::GetStatistics(aSnapshot.mResourcesInUse[kSystemLayer_NumTimers],
                                        aSnapshot.mHighWatermarks[kSystemLayer_NumTimers]);
 
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+    chip::System::PacketBufferSlab::GetStatistics(aSnapshot.mResourcesInUse[kSystemLayer_NumPacketBufSlabAllocs],
+                                                  aSnapshot.mResourcesInUse[kSystemLayer_NumPacketBufSlabCacheHits],
+                                                  aSnapshot.mResourcesInUse[kSystemLayer_NumPacketBufSlabBlocks],
+                                                  aSnapshot.mResourcesInUse[kSystemLayer_NumPacketBufSlabBlocksInUse],
+                                                  aSnapshot.mHighWatermarks[kSystemLayer_NumPacketBufSlabBlocksInUse]);
+    for (int i = kSystemLayer_NumPacketBufSlabAllocs; i <= kSystemLayer_NumPacketBufSlabBlocks; i++)
+    {
+        aSnapshot.mHighWatermarks[i] = aSnapshot.mResourcesInUse[i];
+    }
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+
     SYSTEM_STATS_UPDATE_LWIP_PBUF_COUNTS();
 }
 
@@ -104,6 +125,19 @@ bool Difference(Snapshot & result, Snapshot & after, Snapshot & before)
         result.mResourcesInUse[i] = static_cast<count_t>(after.mResourcesInUse[i] - before.mResourcesInUse[i]);
         result.mHighWatermarks[i] = static_cast<count_t>(after.mHighWatermarks[i] - before.mHighWatermarks[i]);
 
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+        // Running totals only ever grow
+        if (i >= kSystemLayer_NumPacketBufSlabAllocs && i <= kSystemLayer_NumPacketBufSlabBlocks)
+        {
+            continue;
+        }
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+
+        if (i == kExchangeMgr_NumContextAllocFailures)
+        {
+            continue;
+        }
+
         if (result.mResourcesInUse[i] > 0)
         {
             leak = true;
@@ -32,6 +32,7 @@
 // Include configuration headers
 #include <core/CHIPConfig.h>
 #include <inet/InetConfig.h>
+#include <system/SystemConfig.h>
 
 // Include dependent headers
 #include <support/DLLUtil.h>
@@ -58,6 +59,14 @@ enum
     kSystemLayer_NumPacketBufs,
 #endif
     kSystemLayer_NumTimers,
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+    // Running totals of the packet buffer slab allocator rather than resources in use; see PacketBufferSlab::GetStatistics.
+    kSystemLayer_NumPacketBufSlabAllocs,
+    kSystemLayer_NumPacketBufSlabCacheHits,
+    kSystemLayer_NumPacketBufSlabBlocks,
+    // Blocks of the slab allocator in use, with their high watermark.
+    kSystemLayer_NumPacketBufSlabBlocksInUse,
+#endif
 #if INET_CONFIG_NUM_RAW_ENDPOINTS
     kInetLayer_NumRawEps,
 #endif
@@ -71,15 +80,30 @@ enum
     kInetLayer_NumDNSResolvers,
 #endif
     kExchangeMgr_NumContexts,
+    kExchangeMgr_NumContextAllocFailures, // running total
     kExchangeMgr_NumUMHandlers,
     kExchangeMgr_NumBindings,
     kMessageLayer_NumConnections,
+    kTransport_NumPeerConnections,
+    kTransport_NumPeerConnectionSlots,
     kNumEntries
 };
 
+#if CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH == 32
+typedef int32_t count_t;
+#define PRI_CHIP_SYS_STATS_COUNT PRId32
+#define CHIP_SYS_STATS_COUNT_MAX INT32_MAX
+#elif CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH == 16
+typedef int16_t count_t;
+#define PRI_CHIP_SYS_STATS_COUNT PRId16
+#define CHIP_SYS_STATS_COUNT_MAX INT16_MAX
+#elif CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH == 8
 typedef int8_t count_t;
 #define PRI_CHIP_SYS_STATS_COUNT PRId8
 #define CHIP_SYS_STATS_COUNT_MAX INT8_MAX
+#else
+#error "CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH must be 8, 16 or 32"
+#endif // CHIP_SYSTEM_CONFIG_STATS_COUNT_WIDTH
 
 extern count_t ResourcesInUse[kNumEntries];
 extern count_t HighWatermarks[kNumEntries];
@@ -119,6 +143,16 @@ const Label * GetStrings();
         }                                                                                                                          \
     } while (0);
 
+#define SYSTEM_STATS_INCREMENT_BY_N(entry, count)                                                                                  \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        chip::System::Stats::count_t new_value = (chip::System::Stats::GetResourcesInUse()[entry] += (count));                     \
+        if (chip::System::Stats::GetHighWatermarks()[entry] < new_value)                                                           \
+        {                                                                                                                          \
+            chip::System::Stats::GetHighWatermarks()[entry] = new_value;                                                           \
+        }                                                                                                                          \
+    } while (0);
+
 #define SYSTEM_STATS_DECREMENT(entry)                                                                                              \
     do                                                                                                                             \
     {                                                                                                                              \
@@ -161,10 +195,14 @@ const Label * GetStrings();
 
 #define SYSTEM_STATS_INCREMENT(entry)
 
+#define SYSTEM_STATS_INCREMENT_BY_N(entry, count)
+
 #define SYSTEM_STATS_DECREMENT(entry)
 
 #define SYSTEM_STATS_DECREMENT_BY_N(entry, count)
 
+#define SYSTEM_STATS_SET(entry, count)
+
 #define SYSTEM_STATS_RESET(entry)
 
 #define SYSTEM_STATS_UPDATE_LWIP_PBUF_COUNTS()
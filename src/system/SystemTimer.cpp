@@ -135,38 +135,15 @@ Error Timer::Start(uint32_t aDelayMilliseconds, OnCompleteFunct aOnComplete, voi
         chipDie();
     }
 
-#if CHIP_SYSTEM_CONFIG_USE_LWIP
-    // add to the sorted list of timers. Earliest timer appears first.
-    if (lLayer.mTimerList == NULL || this->IsEarlierEpoch(this->mAwakenEpoch, lLayer.mTimerList->mAwakenEpoch))
-    {
-        this->mNextTimer  = lLayer.mTimerList;
-        lLayer.mTimerList = this;
+    lLayer.mTimerHeap.Insert(*this);
 
-        // this is the new earliest timer and so the timer needs (re-)starting provided that
-        // the system is not currently processing expired timers, in which case it is left to
-        // HandleExpiredTimers() to re-start the timer.
-        if (!lLayer.mTimerComplete)
-        {
-            lLayer.StartPlatformTimer(aDelayMilliseconds);
-        }
-    }
-    else
+#if CHIP_SYSTEM_CONFIG_USE_LWIP
+    // this is the new earliest timer and so the timer needs (re-)starting provided that
+    // the system is not currently processing expired timers, in which case it is left to
+    // HandleExpiredTimers() to re-start the timer.
+    if (lLayer.mTimerHeap.Earliest() == this && !lLayer.mTimerComplete)
     {
-        Timer * lTimer = lLayer.mTimerList;
-
-        while (lTimer->mNextTimer)
-        {
-            if (this->IsEarlierEpoch(this->mAwakenEpoch, lTimer->mNextTimer->mAwakenEpoch))
-            {
-                // found the insert location.
-                break;
-            }
-
-            lTimer = lTimer->mNextTimer;
-        }
-
-        this->mNextTimer   = lTimer->mNextTimer;
-        lTimer->mNextTimer = this;
+        lLayer.StartPlatformTimer(aDelayMilliseconds);
     }
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
@@ -192,6 +169,19 @@ Error Timer::ScheduleWork(OnCompleteFunct aOnComplete, void * aAppState)
     err = lLayer.PostEvent(*this, chip::System::kEvent_ScheduleWork, 0);
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 #if CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+    // Any thread may schedule work, while only the event loop touches the timer heap. The work is pushed on a lock-free list
+    // instead, which the event loop takes as a whole. The list holds a reference, so that cancelling the work before it runs
+    // does not return the timer to the pool while it is still linked.
+    this->Retain();
+
+    Timer * lHead;
+
+    do
+    {
+        lHead                = __atomic_load_n(&lLayer.mScheduledWork, __ATOMIC_RELAXED);
+        this->mNextScheduled = lHead;
+    } while (!__sync_bool_compare_and_swap(&lLayer.mScheduledWork, lHead, this));
+
     lLayer.WakeSelect();
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
 
@@ -205,9 +195,7 @@ Error Timer::ScheduleWork(OnCompleteFunct aOnComplete, void * aAppState)
  */
 Error Timer::Cancel()
 {
-#if CHIP_SYSTEM_CONFIG_USE_LWIP
-    Layer & lLayer = this->SystemLayer();
-#endif // CHIP_SYSTEM_CONFIG_USE_LWIP
+    Layer & lLayer              = this->SystemLayer();
     OnCompleteFunct lOnComplete = this->OnComplete;
 
     // Check if the timer is armed
@@ -217,34 +205,7 @@ Error Timer::Cancel()
 
     // Since this thread changed the state of OnComplete, release the timer.
     this->AppState = nullptr;
-
-#if CHIP_SYSTEM_CONFIG_USE_LWIP
-    if (lLayer.mTimerList)
-    {
-        if (this == lLayer.mTimerList)
-        {
-            lLayer.mTimerList = this->mNextTimer;
-        }
-        else
-        {
-            Timer * lTimer = lLayer.mTimerList;
-
-            while (lTimer->mNextTimer)
-            {
-                if (this == lTimer->mNextTimer)
-                {
-                    lTimer->mNextTimer = this->mNextTimer;
-                    break;
-                }
-
-                lTimer = lTimer->mNextTimer;
-            }
-        }
-
-        this->mNextTimer = NULL;
-    }
-#endif // CHIP_SYSTEM_CONFIG_USE_LWIP
-
+    lLayer.mTimerHeap.Remove(*this);
     this->Release();
 exit:
     return CHIP_SYSTEM_NO_ERROR;
@@ -267,6 +228,7 @@ void Timer::HandleComplete()
 
     // Since this thread changed the state of OnComplete, release the timer.
     AppState = nullptr;
+    lLayer.mTimerHeap.Remove(*this);
     this->Release();
 
     // Invoke the app's callback, if it's still valid.
@@ -301,18 +263,17 @@ Error Timer::HandleExpiredTimers(Layer & aLayer)
     // regardless how long the processing of the currently expired timers took
     Epoch currentEpoch = Timer::GetCurrentEpoch();
 
-    while (aLayer.mTimerList)
+    while (aLayer.mTimerHeap.Earliest() != nullptr)
     {
+        Timer & lTimer = *aLayer.mTimerHeap.Earliest();
+
         // limit the number of timers handled before the control is returned to the event queue.  The bound is similar to
         // (though not exactly same) as that on the sockets-based systems.
 
         // The platform timer API has MSEC resolution so expire any timer with less than 1 msec remaining.
-        if ((timersHandled < Timer::sPool.Size()) && Timer::IsEarlierEpoch(aLayer.mTimerList->mAwakenEpoch, currentEpoch + 1))
+        if ((timersHandled < Timer::sPool.Size()) && Timer::IsEarlierEpoch(lTimer.mAwakenEpoch, currentEpoch + 1))
         {
-            Timer & lTimer    = *aLayer.mTimerList;
-            aLayer.mTimerList = lTimer.mNextTimer;
-            lTimer.mNextTimer = NULL;
-
+            // HandleComplete() takes the timer out of the heap.
             aLayer.mTimerComplete = true;
             lTimer.HandleComplete();
             aLayer.mTimerComplete = false;
@@ -327,9 +288,9 @@ Error Timer::HandleExpiredTimers(Layer & aLayer)
             currentEpoch = Timer::GetCurrentEpoch();
 
             // the next timer expires in the future, so set the delayMilliseconds to a non-zero value
-            if (currentEpoch < aLayer.mTimerList->mAwakenEpoch)
+            if (currentEpoch < lTimer.mAwakenEpoch)
             {
-                delayMilliseconds = aLayer.mTimerList->mAwakenEpoch - currentEpoch;
+                delayMilliseconds = lTimer.mAwakenEpoch - currentEpoch;
             }
             /*
              * StartPlatformTimer() accepts a 32bit value in milliseconds.  Epochs are 64bit numbers.  The only way in which this
@@ -348,5 +309,88 @@ Error Timer::HandleExpiredTimers(Layer & aLayer)
 }
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 
+/**
+ *  Add an armed timer to the heap.
+ *
+ *  @param[in]  aTimer  The timer, which must not be in the heap already.
+ */
+void TimerHeap::Insert(Timer & aTimer)
+{
+    VerifyOrDie(aTimer.mHeapIndex == kNotQueued && mSize < CHIP_SYSTEM_CONFIG_NUM_TIMERS);
+
+    Place(aTimer, mSize++);
+    SiftUp(aTimer.mHeapIndex);
+}
+
+/**
+ *  Take a timer out of the heap. Does nothing if the timer is not in the heap.
+ *
+ *  @param[in]  aTimer  The timer.
+ */
+void TimerHeap::Remove(Timer & aTimer)
+{
+    const size_t lIndex = aTimer.mHeapIndex;
+
+    if (lIndex == kNotQueued)
+        return;
+
+    aTimer.mHeapIndex = kNotQueued;
+
+    if (lIndex == --mSize)
+        return;
+
+    // Fill the hole with the last timer, which may belong either above or below it.
+    Timer & lLast = *mTimers[mSize];
+
+    Place(lLast, lIndex);
+    SiftUp(lIndex);
+    SiftDown(lLast.mHeapIndex);
+}
+
+void TimerHeap::Place(Timer & aTimer, size_t aIndex)
+{
+    mTimers[aIndex]   = &aTimer;
+    aTimer.mHeapIndex = aIndex;
+}
+
+void TimerHeap::SiftUp(size_t aIndex)
+{
+    Timer & lTimer = *mTimers[aIndex];
+
+    while (aIndex > 0)
+    {
+        const size_t lParent = (aIndex - 1) / 2;
+
+        if (!Timer::IsEarlierEpoch(lTimer.mAwakenEpoch, mTimers[lParent]->mAwakenEpoch))
+            break;
+
+        Place(*mTimers[lParent], aIndex);
+        aIndex = lParent;
+    }
+
+    Place(lTimer, aIndex);
+}
+
+void TimerHeap::SiftDown(size_t aIndex)
+{
+    Timer & lTimer = *mTimers[aIndex];
+
+    while (2 * aIndex + 1 < mSize)
+    {
+        size_t lChild = 2 * aIndex + 1;
+
+        if (lChild + 1 < mSize && Timer::IsEarlierEpoch(mTimers[lChild + 1]->mAwakenEpoch, mTimers[lChild]->mAwakenEpoch))
+            lChild++;
+
+        if (!Timer::IsEarlierEpoch(mTimers[lChild]->mAwakenEpoch, lTimer.mAwakenEpoch))
+            break;
+
+        Place(*mTimers[lChild], aIndex);
+        aIndex = lChild;
+    }
+
+    Place(lTimer, aIndex);
+}
+
 } // namespace System
 } // namespace chip
@@ -53,6 +53,7 @@ class Layer;
 class DLL_EXPORT Timer : public Object
 {
     friend class Layer;
+    friend class TimerHeap;
 
 public:
     /**
@@ -77,14 +78,16 @@ private:
     static ObjectPool<Timer, CHIP_SYSTEM_CONFIG_NUM_TIMERS> sPool;
 
     Epoch mAwakenEpoch;
+    size_t mHeapIndex; /**< Position in the timer heap of the owning layer, or TimerHeap::kNotQueued. */
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
+    Timer * mNextScheduled; /**< Next work item on the scheduled work list of the owning layer. */
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
 
     void HandleComplete();
 
     Error ScheduleWork(OnCompleteFunct aOnComplete, void * aAppState);
 
 #if CHIP_SYSTEM_CONFIG_USE_LWIP
-    Timer * mNextTimer;
-
     static Error HandleExpiredTimers(Layer & aLayer);
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 
@@ -93,6 +96,40 @@ private:
     Timer & operator=(const Timer &) = delete;
 };
 
+/**
+ * @class TimerHeap
+ *
+ * @brief
+ *  The armed timers of a layer, as a binary min-heap ordered by expiration time.
+ *
+ *  The earliest timer is found in constant time, and timers are inserted and removed in logarithmic time. Each timer records
+ *  its own position in the heap, so that removing a cancelled timer does not need to search for it.
+ *
+ *  The heap has room for every timer of the pool, so inserting never fails.
+ */
+class TimerHeap
+{
+public:
+    static constexpr size_t kNotQueued = SIZE_MAX;
+
+    TimerHeap() : mSize(0) {}
+
+    size_t Size() const { return mSize; }
+    Timer * Earliest() const { return (mSize > 0) ? mTimers[0] : nullptr; }
+    Timer * At(size_t aIndex) const { return mTimers[aIndex]; }
+
+    void Insert(Timer & aTimer);
+    void Remove(Timer & aTimer);
+
+private:
+    Timer * mTimers[CHIP_SYSTEM_CONFIG_NUM_TIMERS];
+    size_t mSize;
+
+    void Place(Timer & aTimer, size_t aIndex);
+    void SiftUp(size_t aIndex);
+    void SiftDown(size_t aIndex);
+};
+
 inline void Timer::GetStatistics(chip::System::Stats::count_t & aNumInUse, chip::System::Stats::count_t & aHighWatermark)
 {
     sPool.GetStatistics(aNumInUse, aHighWatermark);
@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <support/CHIPMem.h>
 #include <support/CodeUtils.h>
 #include <support/UnitTestRegistration.h>
 #include <system/SystemPacketBuffer.h>
@@ -125,7 +126,8 @@ void BufferAlloc(struct TestContext * theContext)
 
     if (theContext->buf == nullptr)
     {
-        theContext->buf = TO_LWIP_PBUF(PacketBuffer::New(0).Release_ForNow());
+        theContext->buf =
+            TO_LWIP_PBUF(PacketBuffer::NewWithAvailableSize(0, CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX).Release_ForNow());
     }
 
     if (theContext->buf == nullptr)
@@ -149,7 +151,7 @@ void BufferAlloc(struct TestContext * theContext)
 #else  // !CHIP_SYSTEM_CONFIG_USE_LWIP
     memset(theContext->buf, 0, lAllocSize);
 #if CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
-    theContext->buf->alloc_size = lAllocSize;
+    theContext->buf->alloc_size = CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX;
 #endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 
@@ -393,6 +395,65 @@ void CheckTotalLength(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+/**
+ *  Test PacketBuffer::Read() function.
+ *
+ *  Description: Link three buffers from inContext, the second one empty,
+ *               holding consecutive bytes, and read ranges of every offset
+ *               and length out of them, across buffer boundaries and past
+ *               the end of the chain.
+ */
+void CheckRead(nlTestSuite * inSuite, void * inContext)
+{
+    struct TestContext * theContext = static_cast<struct TestContext *>(inContext);
+    const uint16_t lengths[]        = { 10, 0, 7 };
+    const uint16_t total            = 17;
+    PacketBuffer * head             = nullptr;
+    uint8_t next                    = 0;
+
+    for (uint16_t length : lengths)
+    {
+        PacketBuffer * buffer = PrepareTestBuffer(theContext);
+
+        for (uint16_t i = 0; i < length; i++)
+        {
+            buffer->Start()[i] = next++;
+        }
+        buffer->SetDataLength(length);
+
+        if (head == nullptr)
+        {
+            head = buffer;
+        }
+        else
+        {
+            head->AddToEnd_ForNow(buffer);
+        }
+
+        theContext++;
+    }
+    NL_TEST_ASSERT(inSuite, head->TotalLength() == total);
+
+    for (uint16_t offset = 0; offset <= total + 1; offset++)
+    {
+        for (uint16_t length = 0; length <= total + 1; length++)
+        {
+            uint8_t dest[total + 2];
+            const uint16_t remaining = (offset >= total) ? 0 : static_cast<uint16_t>(total - offset);
+            const uint16_t expected  = (length < remaining) ? length : remaining;
+
+            memset(dest, 0xFF, sizeof(dest));
+            NL_TEST_ASSERT(inSuite, head->Read(offset, dest, length) == expected);
+
+            for (uint16_t i = 0; i < expected; i++)
+            {
+                NL_TEST_ASSERT(inSuite, dest[i] == offset + i);
+            }
+            NL_TEST_ASSERT(inSuite, dest[expected] == 0xFF);
+        }
+    }
+}
+
 /**
  *  Test PacketBuffer::MaxDataLength() function.
  */
@@ -1145,6 +1206,7 @@ const nlTest sTests[] =
     NL_TEST_DEF("PacketBuffer::DataLength",                     CheckDataLength),
     NL_TEST_DEF("PacketBuffer::SetDataLength",                  CheckSetDataLength),
     NL_TEST_DEF("PacketBuffer::TotalLength",                    CheckTotalLength),
+    NL_TEST_DEF("PacketBuffer::Read",                           CheckRead),
     NL_TEST_DEF("PacketBuffer::MaxDataLength",                  CheckMaxDataLength),
     NL_TEST_DEF("PacketBuffer::AvailableDataLength",            CheckAvailableDataLength),
     NL_TEST_DEF("PacketBuffer::ReservedSize",                   CheckReservedSize),
@@ -1175,6 +1237,9 @@ int TestSetup(void * inContext)
 {
     struct TestContext * theContext = reinterpret_cast<TestContext *>(inContext);
 
+    if (chip::Platform::MemoryInit() != CHIP_NO_ERROR)
+        return FAILURE;
+
     for (size_t ith = 0; ith < kTestElements; ith++)
     {
         BufferAlloc(theContext);
@@ -1199,6 +1264,8 @@ int TestTeardown(void * inContext)
         theContext++;
     }
 
+    chip::Platform::MemoryShutdown();
+
     return (SUCCESS);
 }
 
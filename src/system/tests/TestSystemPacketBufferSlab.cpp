@@ -0,0 +1,308 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This is a unit test suite for the size-class slab allocator backing
+ *      <tt>chip::System::PacketBuffer</tt>.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <system/SystemConfig.h>
+
+#include <nlunit-test.h>
+#include <support/CHIPMem.h>
+#include <support/CodeUtils.h>
+#include <support/UnitTestRegistration.h>
+
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+#include <system/SystemPacketBuffer.h>
+#include <system/SystemPacketBufferSlab.h>
+
+#include <string.h>
+#include <thread>
+
+using namespace chip::System;
+
+namespace {
+
+constexpr size_t kThreadCount       = 4;
+constexpr size_t kBlocksPerThread   = 200;
+constexpr size_t kRoundsPerThread   = 50;
+constexpr uint32_t kBlockSizes[]    = { 1, 100, 200, 500, CHIP_SYSTEM_PACKETBUFFER_SIZE };
+constexpr size_t kBlockSizesCount   = sizeof(kBlockSizes) / sizeof(kBlockSizes[0]);
+constexpr uint16_t kSmallBufferSize = 20;
+
+/**
+ *  Test that requests are rounded up to the smallest class holding them.
+ */
+void CheckClassSizes(nlTestSuite * inSuite, void * inContext)
+{
+    for (size_t c = 1; c < PacketBufferSlab::kNumClasses; c++)
+    {
+        NL_TEST_ASSERT(inSuite, PacketBufferSlab::ClassSize(c - 1) < PacketBufferSlab::ClassSize(c));
+    }
+    NL_TEST_ASSERT(inSuite, PacketBufferSlab::ClassSize(PacketBufferSlab::kNumClasses - 1) >= CHIP_SYSTEM_PACKETBUFFER_SIZE);
+
+    for (size_t c = 0; c < PacketBufferSlab::kNumClasses; c++)
+    {
+        const size_t lClassSize = PacketBufferSlab::ClassSize(c);
+        size_t lSize            = lClassSize;
+        void * lBlock           = PacketBufferSlab::Allocate(lSize);
+
+        NL_TEST_ASSERT(inSuite, lBlock != nullptr);
+        NL_TEST_ASSERT(inSuite, lSize == lClassSize);
+        memset(lBlock, 0xA5, lSize);
+        PacketBufferSlab::Release(lBlock);
+
+        if (c + 1 < PacketBufferSlab::kNumClasses)
+        {
+            lSize  = lClassSize + 1;
+            lBlock = PacketBufferSlab::Allocate(lSize);
+
+            NL_TEST_ASSERT(inSuite, lBlock != nullptr);
+            NL_TEST_ASSERT(inSuite, lSize == PacketBufferSlab::ClassSize(c + 1));
+            PacketBufferSlab::Release(lBlock);
+        }
+    }
+
+    size_t lSize = PacketBufferSlab::ClassSize(PacketBufferSlab::kNumClasses - 1) + 1;
+    NL_TEST_ASSERT(inSuite, PacketBufferSlab::Allocate(lSize) == nullptr);
+}
+
+/**
+ *  Test that a released block is handed out again by the same thread, from its magazine.
+ */
+void CheckMagazineReuse(nlTestSuite * inSuite, void * inContext)
+{
+    Stats::count_t lAllocations, lCacheHits, lBlocks, lInUse, lHighWatermark;
+    Stats::count_t lAllocationsAfter, lCacheHitsAfter, lBlocksAfter;
+    size_t lSize = 100;
+
+    PacketBufferSlab::Release(PacketBufferSlab::Allocate(lSize));
+    PacketBufferSlab::GetStatistics(lAllocations, lCacheHits, lBlocks, lInUse, lHighWatermark);
+
+    for (int i = 0; i < 100; i++)
+    {
+        void * lFirst = PacketBufferSlab::Allocate(lSize);
+        PacketBufferSlab::Release(lFirst);
+        NL_TEST_ASSERT(inSuite, PacketBufferSlab::Allocate(lSize) == lFirst);
+        PacketBufferSlab::Release(lFirst);
+    }
+
+    PacketBufferSlab::GetStatistics(lAllocationsAfter, lCacheHitsAfter, lBlocksAfter, lInUse, lHighWatermark);
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    NL_TEST_ASSERT(inSuite, lAllocationsAfter - lAllocations == 200);
+    NL_TEST_ASSERT(inSuite, lCacheHitsAfter - lCacheHits == 200);
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    NL_TEST_ASSERT(inSuite, lBlocksAfter == lBlocks);
+}
+
+/**
+ *  Test that the blocks in use are counted, and their high watermark kept once they are released.
+ */
+void CheckHighWatermark(nlTestSuite * inSuite, void * inContext)
+{
+    void * lBlocks[kBlocksPerThread];
+    Stats::count_t lAllocations, lCacheHits, lCarved;
+    Stats::count_t lInUseBefore, lInUse, lInUseAfter;
+    Stats::count_t lHighWatermark, lHighWatermarkAfter;
+
+    PacketBufferSlab::GetStatistics(lAllocations, lCacheHits, lCarved, lInUseBefore, lHighWatermark);
+
+    for (size_t i = 0; i < kBlocksPerThread; i++)
+    {
+        size_t lSize = kBlockSizes[i % kBlockSizesCount];
+
+        lBlocks[i] = PacketBufferSlab::Allocate(lSize);
+        NL_TEST_ASSERT(inSuite, lBlocks[i] != nullptr);
+    }
+
+    PacketBufferSlab::GetStatistics(lAllocations, lCacheHits, lCarved, lInUse, lHighWatermark);
+
+    for (size_t i = 0; i < kBlocksPerThread; i++)
+    {
+        PacketBufferSlab::Release(lBlocks[i]);
+    }
+
+    PacketBufferSlab::GetStatistics(lAllocations, lCacheHits, lCarved, lInUseAfter, lHighWatermarkAfter);
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    NL_TEST_ASSERT(inSuite, lInUse - lInUseBefore == static_cast<Stats::count_t>(kBlocksPerThread));
+    NL_TEST_ASSERT(inSuite, lHighWatermark >= lInUse);
+    NL_TEST_ASSERT(inSuite, lInUseAfter == lInUseBefore);
+    NL_TEST_ASSERT(inSuite, lHighWatermarkAfter == lHighWatermark);
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+}
+
+/**
+ *  Test that packet buffers get the whole block of their class as capacity.
+ */
+void CheckPacketBufferCapacity(nlTestSuite * inSuite, void * inContext)
+{
+    PacketBufferHandle lSmall = PacketBuffer::NewWithAvailableSize(0, kSmallBufferSize);
+    PacketBufferHandle lLarge = PacketBuffer::New();
+
+    NL_TEST_ASSERT(inSuite, !lSmall.IsNull());
+    NL_TEST_ASSERT(inSuite, !lLarge.IsNull());
+    NL_TEST_ASSERT(inSuite, lSmall->AvailableDataLength() == PacketBufferSlab::ClassSize(0) - CHIP_SYSTEM_PACKETBUFFER_HEADER_SIZE);
+    NL_TEST_ASSERT(inSuite, lLarge->MaxDataLength() <= CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX);
+
+    memset(lSmall->Start(), 0x5A, lSmall->AvailableDataLength());
+    lSmall->SetDataLength(lSmall->AvailableDataLength());
+}
+
+/**
+ *  Test blocks allocated by one thread and released by another.
+ */
+void CheckCrossThreadRelease(nlTestSuite * inSuite, void * inContext)
+{
+    void * lBlocks[kBlocksPerThread];
+
+    for (size_t i = 0; i < kBlocksPerThread; i++)
+    {
+        size_t lSize = kBlockSizes[i % kBlockSizesCount];
+
+        lBlocks[i] = PacketBufferSlab::Allocate(lSize);
+        NL_TEST_ASSERT(inSuite, lBlocks[i] != nullptr);
+        memset(lBlocks[i], static_cast<int>(i), lSize);
+    }
+
+    std::thread lReleaser([&lBlocks]() {
+        for (size_t i = 0; i < kBlocksPerThread; i++)
+        {
+            PacketBufferSlab::Release(lBlocks[i]);
+        }
+    });
+    lReleaser.join();
+
+    // The releasing thread gave its magazines back when it exited, so every block is free again
+    for (size_t i = 0; i < kBlocksPerThread; i++)
+    {
+        size_t lSize = kBlockSizes[i % kBlockSizesCount];
+
+        lBlocks[i] = PacketBufferSlab::Allocate(lSize);
+        NL_TEST_ASSERT(inSuite, lBlocks[i] != nullptr);
+    }
+    for (size_t i = 0; i < kBlocksPerThread; i++)
+    {
+        PacketBufferSlab::Release(lBlocks[i]);
+    }
+}
+
+/**
+ *  Test many threads allocating, filling and releasing blocks at once, none of them overlapping.
+ */
+void CheckConcurrentUse(nlTestSuite * inSuite, void * inContext)
+{
+    bool lOverlap[kThreadCount] = {};
+    std::thread lThreads[kThreadCount];
+
+    for (size_t t = 0; t < kThreadCount; t++)
+    {
+        lThreads[t] = std::thread([t, &lOverlap]() {
+            uint8_t * lBlocks[kBlocksPerThread];
+            size_t lSizes[kBlocksPerThread];
+
+            for (size_t r = 0; r < kRoundsPerThread; r++)
+            {
+                for (size_t i = 0; i < kBlocksPerThread; i++)
+                {
+                    lSizes[i]  = kBlockSizes[(i + t + r) % kBlockSizesCount];
+                    lBlocks[i] = static_cast<uint8_t *>(PacketBufferSlab::Allocate(lSizes[i]));
+                    if (lBlocks[i] != nullptr)
+                    {
+                        memset(lBlocks[i], static_cast<int>(t), lSizes[i]);
+                    }
+                }
+                for (size_t i = 0; i < kBlocksPerThread; i++)
+                {
+                    if (lBlocks[i] == nullptr || lBlocks[i][0] != t || lBlocks[i][lSizes[i] - 1] != t)
+                    {
+                        lOverlap[t] = true;
+                    }
+                    PacketBufferSlab::Release(lBlocks[i]);
+                }
+            }
+        });
+    }
+
+    for (size_t t = 0; t < kThreadCount; t++)
+    {
+        lThreads[t].join();
+        NL_TEST_ASSERT(inSuite, !lOverlap[t]);
+    }
+}
+
+int TestSetup(void * inContext)
+{
+    return (chip::Platform::MemoryInit() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int TestTeardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+// Test Suite
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("PacketBufferSlab::CheckClassSizes",           CheckClassSizes),
+    NL_TEST_DEF("PacketBufferSlab::CheckMagazineReuse",        CheckMagazineReuse),
+    NL_TEST_DEF("PacketBufferSlab::CheckHighWatermark",        CheckHighWatermark),
+    NL_TEST_DEF("PacketBufferSlab::CheckPacketBufferCapacity", CheckPacketBufferCapacity),
+    NL_TEST_DEF("PacketBufferSlab::CheckCrossThreadRelease",   CheckCrossThreadRelease),
+    NL_TEST_DEF("PacketBufferSlab::CheckConcurrentUse",        CheckConcurrentUse),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite kTheSuite =
+{
+    "chip-system-packetbuffer-slab",
+    sTests,
+    TestSetup,
+    TestTeardown
+};
+// clang-format on
+
+int TestSystemPacketBufferSlab(void)
+{
+    nlTestRunner(&kTheSuite, nullptr);
+
+    return nlTestRunnerStats(&kTheSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestSystemPacketBufferSlab)
+#else  // CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
+int TestSystemPacketBufferSlab(void)
+{
+    return SUCCESS;
+}
+#endif // CHIP_SYSTEM_CONFIG_PACKETBUFFER_SLAB
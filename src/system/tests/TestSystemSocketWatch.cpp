@@ -0,0 +1,237 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This is a unit test suite for the epoll based socket watches of
+ *      <tt>chip::System::Layer</tt>.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <system/SystemConfig.h>
+
+#include <nlunit-test.h>
+#include <support/CodeUtils.h>
+#include <support/UnitTestRegistration.h>
+#include <system/SystemError.h>
+#include <system/SystemLayer.h>
+
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace chip::System;
+
+namespace {
+
+struct TestContext
+{
+    Layer mLayer;
+    int mSockets[2];
+    int mWatcher; // only its address is used, to identify the watched socket
+
+    int ServiceEvents()
+    {
+        fd_set lReadSet, lWriteSet, lErrorSet;
+        timeval lSleepTime = {};
+        int lSetSize       = 0;
+
+        FD_ZERO(&lReadSet);
+        FD_ZERO(&lWriteSet);
+        FD_ZERO(&lErrorSet);
+
+        mLayer.PrepareSelect(lSetSize, &lReadSet, &lWriteSet, &lErrorSet, lSleepTime);
+        lSleepTime = {};
+
+        const int lSelectRes = select(lSetSize, &lReadSet, &lWriteSet, &lErrorSet, &lSleepTime);
+        mLayer.HandleSelectResult(lSelectRes, &lReadSet, &lWriteSet, &lErrorSet);
+
+        return lSelectRes;
+    }
+
+    uint32_t ReadyEvents()
+    {
+        int lCount;
+        uint32_t lEvents                  = 0;
+        const struct epoll_event * lReady = mLayer.GetReadySockets(lCount);
+
+        for (int i = 0; i < lCount; i++)
+        {
+            if (lReady[i].data.ptr == &mWatcher)
+                lEvents |= lReady[i].events;
+        }
+
+        return lEvents;
+    }
+
+    void Drain()
+    {
+        uint8_t lByte;
+        while (recv(mSockets[0], &lByte, sizeof(lByte), MSG_DONTWAIT) > 0)
+        {
+        }
+    }
+};
+
+void TestWatchReadable(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+    const uint8_t lByte    = 1;
+
+    NL_TEST_ASSERT(inSuite, lContext.mLayer.WatchSocket(lContext.mSockets[0], EPOLLIN, &lContext.mWatcher) == CHIP_SYSTEM_NO_ERROR);
+
+    // Nothing to read yet
+    NL_TEST_ASSERT(inSuite, lContext.ServiceEvents() == 0);
+    NL_TEST_ASSERT(inSuite, lContext.ReadyEvents() == 0);
+
+    // The registration persists: data sent now is reported without watching the socket again
+    NL_TEST_ASSERT(inSuite, send(lContext.mSockets[1], &lByte, sizeof(lByte), 0) == sizeof(lByte));
+    NL_TEST_ASSERT(inSuite, lContext.ServiceEvents() == 1);
+    NL_TEST_ASSERT(inSuite, (lContext.ReadyEvents() & EPOLLIN) != 0);
+
+    lContext.Drain();
+    NL_TEST_ASSERT(inSuite, lContext.ServiceEvents() == 0);
+    NL_TEST_ASSERT(inSuite, lContext.ReadyEvents() == 0);
+
+    NL_TEST_ASSERT(inSuite, lContext.mLayer.UnwatchSocket(lContext.mSockets[0], &lContext.mWatcher) == CHIP_SYSTEM_NO_ERROR);
+}
+
+void TestUpdateWatch(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+
+    NL_TEST_ASSERT(inSuite, lContext.mLayer.WatchSocket(lContext.mSockets[0], EPOLLIN, &lContext.mWatcher) == CHIP_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lContext.ServiceEvents() == 0);
+
+    // An empty socket is always writable
+    NL_TEST_ASSERT(inSuite,
+                   lContext.mLayer.UpdateSocketWatch(lContext.mSockets[0], EPOLLOUT, &lContext.mWatcher) == CHIP_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lContext.ServiceEvents() == 1);
+    NL_TEST_ASSERT(inSuite, lContext.ReadyEvents() == EPOLLOUT);
+
+    NL_TEST_ASSERT(inSuite, lContext.mLayer.UnwatchSocket(lContext.mSockets[0], &lContext.mWatcher) == CHIP_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lContext.ServiceEvents() == 0);
+}
+
+void TestUnwatchDropsReadiness(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+    const uint8_t lByte    = 1;
+
+    NL_TEST_ASSERT(inSuite, lContext.mLayer.WatchSocket(lContext.mSockets[0], EPOLLIN, &lContext.mWatcher) == CHIP_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, send(lContext.mSockets[1], &lByte, sizeof(lByte), 0) == sizeof(lByte));
+    NL_TEST_ASSERT(inSuite, lContext.ServiceEvents() == 1);
+    NL_TEST_ASSERT(inSuite, lContext.ReadyEvents() != 0);
+
+    // Readiness retrieved before the socket was unwatched must not be acted upon anymore
+    NL_TEST_ASSERT(inSuite, lContext.mLayer.UnwatchSocket(lContext.mSockets[0], &lContext.mWatcher) == CHIP_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lContext.ReadyEvents() == 0);
+
+    // ...and no more readiness is reported, even though data is still pending
+    NL_TEST_ASSERT(inSuite, lContext.ServiceEvents() == 0);
+
+    lContext.Drain();
+}
+
+void TestWakeSelect(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+    int lCount;
+
+    lContext.mLayer.WakeSelect();
+
+    // The wake event is reported through the epoll instance, but is not handed out as a ready socket
+    NL_TEST_ASSERT(inSuite, lContext.ServiceEvents() == 1);
+    lContext.mLayer.GetReadySockets(lCount);
+    NL_TEST_ASSERT(inSuite, lCount <= 1);
+    NL_TEST_ASSERT(inSuite, lContext.ReadyEvents() == 0);
+
+    // Handling the result confirmed the event
+    NL_TEST_ASSERT(inSuite, lContext.ServiceEvents() == 0);
+}
+
+int TestSetup(void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+
+    if (lContext.mLayer.Init(nullptr) != CHIP_SYSTEM_NO_ERROR)
+        return FAILURE;
+
+    if (socketpair(AF_UNIX, SOCK_DGRAM, 0, lContext.mSockets) != 0)
+        return FAILURE;
+
+    return SUCCESS;
+}
+
+int TestTeardown(void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+
+    close(lContext.mSockets[0]);
+    close(lContext.mSockets[1]);
+
+    return (lContext.mLayer.Shutdown() == CHIP_SYSTEM_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+} // namespace
+
+// Test Suite
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("SocketWatch::TestWatchReadable",          TestWatchReadable),
+    NL_TEST_DEF("SocketWatch::TestUpdateWatch",            TestUpdateWatch),
+    NL_TEST_DEF("SocketWatch::TestUnwatchDropsReadiness",  TestUnwatchDropsReadiness),
+    NL_TEST_DEF("SocketWatch::TestWakeSelect",             TestWakeSelect),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite kTheSuite =
+{
+    "chip-system-socket-watch",
+    sTests,
+    TestSetup,
+    TestTeardown
+};
+// clang-format on
+
+int TestSystemSocketWatch(void)
+{
+    TestContext context;
+
+    nlTestRunner(&kTheSuite, &context);
+
+    return nlTestRunnerStats(&kTheSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestSystemSocketWatch)
+#else  // CHIP_SYSTEM_CONFIG_USE_EPOLL
+int TestSystemSocketWatch(void)
+{
+    return SUCCESS;
+}
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
@@ -47,6 +47,10 @@
 #include <sys/select.h>
 #endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK
 
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <pthread.h>
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
 #include <errno.h>
 #include <stdint.h>
 #include <string.h>
@@ -206,6 +210,164 @@ static void CheckStarvation(nlTestSuite * inSuite, void * aContext)
     ServiceEvents(lSys, sleepTime);
 }
 
+static const size_t kNumOrderedTimers = 8;
+static size_t sNumOrderedTimersFired;
+static size_t sOrderedTimersFired[kNumOrderedTimers];
+static size_t sOrderedTimerIds[kNumOrderedTimers];
+
+void HandleOrderedTimer(Layer * aLayer, void * aState, Error aError)
+{
+    (void) aLayer, (void) aError;
+    sOrderedTimersFired[sNumOrderedTimersFired++] = *static_cast<size_t *>(aState);
+}
+
+static void CheckOrder(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+    Layer & lSys           = *lContext.mLayer;
+
+    sNumOrderedTimersFired = 0;
+
+    // Start the timers latest first, so that each one has to be placed ahead of the others.
+    for (size_t i = 0; i < kNumOrderedTimers; i++)
+    {
+        sOrderedTimerIds[i] = i;
+        NL_TEST_ASSERT(inSuite,
+                       lSys.StartTimer(static_cast<uint32_t>(2 * (kNumOrderedTimers - i)), HandleOrderedTimer,
+                                       &sOrderedTimerIds[i]) == CHIP_SYSTEM_NO_ERROR);
+    }
+
+    // Cancel the earliest, the latest and one in between.
+    lSys.CancelTimer(HandleOrderedTimer, &sOrderedTimerIds[kNumOrderedTimers - 1]);
+    lSys.CancelTimer(HandleOrderedTimer, &sOrderedTimerIds[0]);
+    lSys.CancelTimer(HandleOrderedTimer, &sOrderedTimerIds[3]);
+
+    const uint64_t lStart = Layer::GetClock_MonotonicMS();
+    while (sNumOrderedTimersFired < kNumOrderedTimers - 3 && Layer::GetClock_MonotonicMS() - lStart < 1000)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec  = 0;
+        sleepTime.tv_usec = 1000; // 1 ms tick
+        ServiceEvents(lSys, sleepTime);
+    }
+
+    // The remaining timers fire once each, earliest (highest id) first.
+    NL_TEST_ASSERT(inSuite, sNumOrderedTimersFired == kNumOrderedTimers - 3);
+    for (size_t i = 1; i < sNumOrderedTimersFired; i++)
+    {
+        NL_TEST_ASSERT(inSuite, sOrderedTimersFired[i - 1] > sOrderedTimersFired[i]);
+    }
+    for (size_t i = 0; i < sNumOrderedTimersFired; i++)
+    {
+        NL_TEST_ASSERT(inSuite, sOrderedTimersFired[i] != 0 && sOrderedTimersFired[i] != 3 &&
+                           sOrderedTimersFired[i] != kNumOrderedTimers - 1);
+    }
+}
+
+static const size_t kNumScheduledWork = 4;
+static size_t sNumScheduledWorkDone;
+static size_t sScheduledWorkDone[kNumScheduledWork];
+static size_t sScheduledWorkIds[kNumScheduledWork];
+
+void HandleScheduledWork(Layer * aLayer, void * aState, Error aError)
+{
+    (void) aLayer, (void) aError;
+    sScheduledWorkDone[sNumScheduledWorkDone++] = *static_cast<size_t *>(aState);
+}
+
+static void CheckScheduleWork(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+    Layer & lSys           = *lContext.mLayer;
+
+    sNumScheduledWorkDone = 0;
+
+    for (size_t i = 0; i < kNumScheduledWork; i++)
+    {
+        sScheduledWorkIds[i] = i;
+        NL_TEST_ASSERT(inSuite, lSys.ScheduleWork(HandleScheduledWork, &sScheduledWorkIds[i]) == CHIP_SYSTEM_NO_ERROR);
+    }
+
+    // Work that did not run yet can still be cancelled.
+    lSys.CancelTimer(HandleScheduledWork, &sScheduledWorkIds[1]);
+
+    const uint64_t lStart = Layer::GetClock_MonotonicMS();
+    while (sNumScheduledWorkDone < kNumScheduledWork - 1 && Layer::GetClock_MonotonicMS() - lStart < 1000)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec  = 0;
+        sleepTime.tv_usec = 1000; // 1 ms tick
+        ServiceEvents(lSys, sleepTime);
+    }
+
+    // The rest runs once each, in the order it was scheduled.
+    NL_TEST_ASSERT(inSuite, sNumScheduledWorkDone == kNumScheduledWork - 1);
+    NL_TEST_ASSERT(inSuite, sScheduledWorkDone[0] == 0 && sScheduledWorkDone[1] == 2 && sScheduledWorkDone[2] == 3);
+}
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+static const size_t kNumSchedulingThreads = 4;
+static const size_t kNumWorkPerThread     = 4;
+static size_t sNumThreadWorkDone;
+
+void HandleThreadWork(Layer * aLayer, void * aState, Error aError)
+{
+    (void) aLayer, (void) aState, (void) aError;
+    sNumThreadWorkDone++;
+}
+
+static void * ScheduleWorkThread(void * aLayer)
+{
+    Layer & lSys      = *static_cast<Layer *>(aLayer);
+    size_t lScheduled = 0;
+
+    for (size_t i = 0; i < kNumWorkPerThread; i++)
+    {
+        lScheduled += (lSys.ScheduleWork(HandleThreadWork, nullptr) == CHIP_SYSTEM_NO_ERROR) ? 1 : 0;
+    }
+
+    return reinterpret_cast<void *>(lScheduled);
+}
+
+static void CheckScheduleWorkFromThreads(nlTestSuite * inSuite, void * aContext)
+{
+    TestContext & lContext = *static_cast<TestContext *>(aContext);
+    Layer & lSys           = *lContext.mLayer;
+    pthread_t lThreads[kNumSchedulingThreads];
+    size_t lScheduled = 0;
+
+    sNumThreadWorkDone = 0;
+
+    // The event loop keeps running timers while other threads schedule work.
+    for (size_t i = 0; i < kNumSchedulingThreads; i++)
+    {
+        NL_TEST_ASSERT(inSuite, pthread_create(&lThreads[i], nullptr, ScheduleWorkThread, &lSys) == 0);
+        lSys.StartTimer(0, HandleTimerFailed, aContext);
+        lSys.CancelTimer(HandleTimerFailed, aContext);
+    }
+
+    for (size_t i = 0; i < kNumSchedulingThreads; i++)
+    {
+        void * lResult = nullptr;
+
+        pthread_join(lThreads[i], &lResult);
+        lScheduled += reinterpret_cast<size_t>(lResult);
+    }
+
+    const uint64_t lStart = Layer::GetClock_MonotonicMS();
+    while (sNumThreadWorkDone < lScheduled && Layer::GetClock_MonotonicMS() - lStart < 1000)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec  = 0;
+        sleepTime.tv_usec = 1000; // 1 ms tick
+        ServiceEvents(lSys, sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, lScheduled == kNumSchedulingThreads * kNumWorkPerThread);
+    NL_TEST_ASSERT(inSuite, sNumThreadWorkDone == lScheduled);
+}
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
 // Test Suite
 
 /**
@@ -215,7 +377,12 @@ static void CheckStarvation(nlTestSuite * inSuite, void * aContext)
 static const nlTest sTests[] =
 {
     NL_TEST_DEF("Timer::TestOverflow",             CheckOverflow),
+    NL_TEST_DEF("Timer::TestTimerOrder",           CheckOrder),
     NL_TEST_DEF("Timer::TestTimerStarvation",      CheckStarvation),
+    NL_TEST_DEF("Timer::TestScheduleWork",         CheckScheduleWork),
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    NL_TEST_DEF("Timer::TestScheduleWorkThreads",  CheckScheduleWorkFromThreads),
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
     NL_TEST_SENTINEL()
 };
 // clang-format on
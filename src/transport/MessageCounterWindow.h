@@ -0,0 +1,111 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @brief Defines a sliding window of message counters received on a session.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <core/CHIPError.h>
+
+namespace chip {
+namespace Transport {
+
+/**
+ * Remembers which of the most recently received message counters were
+ * already accepted, so duplicates can be dropped before any decryption.
+ *
+ * The window covers the highest accepted counter and the kWindowSize - 1
+ * counters below it. Counters older than that can not be told apart from
+ * duplicates and are rejected as well.
+ *
+ * Checking and recording a counter are separate steps: a counter must only
+ * be committed once the message carrying it authenticated, otherwise a forged
+ * packet could advance the window and get genuine messages dropped.
+ */
+class MessageCounterWindow
+{
+public:
+    static constexpr uint32_t kWindowSize = 32;
+
+    /**
+     * Checks whether a message with the given counter may be accepted.
+     *
+     * @return CHIP_NO_ERROR if the counter was not seen yet,
+     *         CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED otherwise.
+     */
+    CHIP_ERROR VerifyCounter(uint32_t counter) const
+    {
+        if (!mInitialized || counter > mMaxCounter)
+        {
+            return CHIP_NO_ERROR;
+        }
+
+        uint32_t offset = mMaxCounter - counter;
+
+        if (offset >= kWindowSize || (mSeen & (1u << offset)) != 0)
+        {
+            return CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED;
+        }
+
+        return CHIP_NO_ERROR;
+    }
+
+    /**
+     * Records a counter as received. The counter MUST have passed
+     * VerifyCounter and its message MUST have been authenticated.
+     */
+    void CommitCounter(uint32_t counter)
+    {
+        if (!mInitialized)
+        {
+            mInitialized = true;
+            mMaxCounter  = counter;
+            mSeen        = 1;
+        }
+        else if (counter > mMaxCounter)
+        {
+            uint32_t shift = counter - mMaxCounter;
+
+            mSeen       = (shift < kWindowSize) ? ((mSeen << shift) | 1) : 1;
+            mMaxCounter = counter;
+        }
+        else
+        {
+            mSeen |= 1u << (mMaxCounter - counter);
+        }
+    }
+
+    /// Forgets every received counter, e.g. when the session keys change.
+    void Reset()
+    {
+        mInitialized = false;
+        mMaxCounter  = 0;
+        mSeen        = 0;
+    }
+
+private:
+    uint32_t mMaxCounter = 0;     ///< highest counter committed so far
+    uint32_t mSeen       = 0;     ///< bit N set if mMaxCounter - N was committed
+    bool mInitialized    = false; ///< true once any counter was committed
+};
+
+} // namespace Transport
+} // namespace chip
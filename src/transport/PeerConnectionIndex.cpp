@@ -0,0 +1,301 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the hashed secondary indexes used by
+ *      PeerConnections to look up connection states.
+ */
+
+#include <transport/PeerConnectionIndex.h>
+
+#include <support/CodeUtils.h>
+#include <support/HashUtils.h>
+#include <transport/PeerConnectionState.h>
+
+namespace chip {
+namespace Transport {
+
+namespace {
+
+bool NodeMatches(const Optional<NodeId> & nodeId, const PeerConnectionState * state)
+{
+    return !nodeId.HasValue() || state->GetPeerNodeId() == kUndefinedNodeId || state->GetPeerNodeId() == nodeId.Value();
+}
+
+} // namespace
+
+uint32_t PeerConnectionIndex::Hash(uint16_t keyId)
+{
+    return HashMix(keyId);
+}
+
+uint32_t PeerConnectionIndex::Hash(NodeId nodeId)
+{
+    return HashCombine(HashMix(static_cast<uint32_t>(nodeId)), static_cast<uint32_t>(nodeId >> 32));
+}
+
+uint32_t PeerConnectionIndex::Hash(const PeerAddress & address)
+{
+    return address.Hash();
+}
+
+void PeerConnectionIndex::Init(PeerConnectionState ** buckets, size_t bucketCount)
+{
+    VerifyOrDie(buckets != nullptr && bucketCount != 0 && (bucketCount & (bucketCount - 1)) == 0);
+
+    mBuckets     = buckets;
+    mBucketCount = bucketCount;
+
+    for (size_t i = 0; i < kKeyCount * bucketCount; i++)
+    {
+        mBuckets[i] = nullptr;
+    }
+}
+
+void PeerConnectionIndex::Rehash(PeerConnectionState ** buckets, size_t bucketCount)
+{
+    PeerConnectionState ** oldBuckets = mBuckets;
+    size_t oldBucketCount             = mBucketCount;
+
+    Init(buckets, bucketCount);
+
+    if (oldBuckets == nullptr)
+    {
+        return;
+    }
+
+    // Every linked state is on exactly one local key chain: walk those and relink
+    // each state under the hashes it already carries.
+    for (size_t i = 0; i < oldBucketCount; i++)
+    {
+        PeerConnectionState * iter = oldBuckets[static_cast<size_t>(kLocalKeyId) * oldBucketCount + i];
+
+        while (iter != nullptr)
+        {
+            PeerConnectionState * next = iter->mIndexHook.mNext[kLocalKeyId];
+            LinkChains(iter);
+            iter = next;
+        }
+    }
+}
+
+bool PeerConnectionIndex::IsAttached(const PeerConnectionState * state) const
+{
+    return state != nullptr && state->mIndexHook.mIndex == this;
+}
+
+void PeerConnectionIndex::Attach(PeerConnectionState * state)
+{
+    PeerConnectionIndexHook & hook = state->mIndexHook;
+
+    VerifyOrDie(hook.mIndex == nullptr || hook.mIndex == this);
+
+    hook.mIndex = this;
+    Update(state);
+}
+
+void PeerConnectionIndex::Detach(PeerConnectionState * state)
+{
+    PeerConnectionIndexHook & hook = state->mIndexHook;
+
+    if (hook.mIndex != this)
+    {
+        return;
+    }
+
+    if (hook.mLinked)
+    {
+        Unlink(state);
+    }
+
+    hook.mIndex = nullptr;
+}
+
+void PeerConnectionIndex::Update(PeerConnectionState * state)
+{
+    if (state->mIndexHook.mLinked)
+    {
+        Unlink(state);
+    }
+
+    if (state->IsInitialized())
+    {
+        Link(state);
+    }
+}
+
+void PeerConnectionIndex::Link(PeerConnectionState * state)
+{
+    PeerConnectionIndexHook & hook = state->mIndexHook;
+
+    hook.mHash[kLocalKeyId]  = Hash(state->GetLocalKeyID());
+    hook.mHash[kPeerKeyId]   = Hash(state->GetPeerKeyID());
+    hook.mHash[kPeerNodeId]  = Hash(state->GetPeerNodeId());
+    hook.mHash[kPeerAddress] = Hash(state->GetPeerAddress());
+
+    LinkChains(state);
+
+    if (state->GetPeerAddress().IsInitialized())
+    {
+        InsertByActivity(state);
+    }
+}
+
+void PeerConnectionIndex::LinkChains(PeerConnectionState * state)
+{
+    PeerConnectionIndexHook & hook = state->mIndexHook;
+
+    for (uint8_t key = 0; key < kKeyCount; key++)
+    {
+        PeerConnectionState ** link = Bucket(static_cast<Key>(key), hook.mHash[key]);
+
+        // Keep chains ordered by address, so cursors behave like a scan over the pool.
+        while (*link != nullptr && *link < state)
+        {
+            link = &(*link)->mIndexHook.mNext[key];
+        }
+
+        hook.mNext[key] = *link;
+        *link           = state;
+    }
+
+    hook.mLinked = true;
+}
+
+void PeerConnectionIndex::Unlink(PeerConnectionState * state)
+{
+    PeerConnectionIndexHook & hook = state->mIndexHook;
+
+    for (uint8_t key = 0; key < kKeyCount; key++)
+    {
+        PeerConnectionState ** link = Bucket(static_cast<Key>(key), hook.mHash[key]);
+
+        while (*link != nullptr && *link != state)
+        {
+            link = &(*link)->mIndexHook.mNext[key];
+        }
+
+        VerifyOrDie(*link == state);
+        *link           = hook.mNext[key];
+        hook.mNext[key] = nullptr;
+    }
+
+    if (hook.mOnActivityList)
+    {
+        RemoveByActivity(state);
+    }
+
+    hook.mLinked = false;
+}
+
+void PeerConnectionIndex::ActivityChanged(PeerConnectionState * state)
+{
+    if (state->mIndexHook.mOnActivityList)
+    {
+        RemoveByActivity(state);
+        InsertByActivity(state);
+    }
+}
+
+void PeerConnectionIndex::InsertByActivity(PeerConnectionState * state)
+{
+    PeerConnectionIndexHook & hook = state->mIndexHook;
+    PeerConnectionState * older    = mNewest;
+
+    // Searching from the newest end makes the common case, a state that just
+    // became active, constant time.
+    while (older != nullptr && older->GetLastActivityTimeMs() > state->GetLastActivityTimeMs())
+    {
+        older = older->mIndexHook.mOlder;
+    }
+
+    hook.mOlder = older;
+    hook.mNewer = (older != nullptr) ? older->mIndexHook.mNewer : mOldest;
+
+    (hook.mOlder != nullptr ? hook.mOlder->mIndexHook.mNewer : mOldest) = state;
+    (hook.mNewer != nullptr ? hook.mNewer->mIndexHook.mOlder : mNewest) = state;
+
+    hook.mOnActivityList = true;
+}
+
+void PeerConnectionIndex::RemoveByActivity(PeerConnectionState * state)
+{
+    PeerConnectionIndexHook & hook = state->mIndexHook;
+
+    (hook.mOlder != nullptr ? hook.mOlder->mIndexHook.mNewer : mOldest) = hook.mNewer;
+    (hook.mNewer != nullptr ? hook.mNewer->mIndexHook.mOlder : mNewest) = hook.mOlder;
+
+    hook.mOlder          = nullptr;
+    hook.mNewer          = nullptr;
+    hook.mOnActivityList = false;
+}
+
+template <typename Matcher>
+PeerConnectionState * PeerConnectionIndex::Find(Key key, uint32_t hash, const PeerConnectionState * begin, Matcher match) const
+{
+    if (mBuckets == nullptr)
+    {
+        return nullptr;
+    }
+
+    for (PeerConnectionState * iter = *Bucket(key, hash); iter != nullptr; iter = iter->mIndexHook.mNext[key])
+    {
+        if (begin != nullptr && iter <= begin)
+        {
+            continue;
+        }
+
+        if (iter->mIndexHook.mHash[key] == hash && match(iter))
+        {
+            return iter;
+        }
+    }
+
+    return nullptr;
+}
+
+PeerConnectionState * PeerConnectionIndex::FindByPeerAddress(const PeerAddress & address, const PeerConnectionState * begin) const
+{
+    return Find(kPeerAddress, Hash(address), begin,
+                [&address](const PeerConnectionState * state) { return state->GetPeerAddress() == address; });
+}
+
+PeerConnectionState * PeerConnectionIndex::FindByPeerNodeId(NodeId nodeId, const PeerConnectionState * begin) const
+{
+    return Find(kPeerNodeId, Hash(nodeId), begin,
+                [nodeId](const PeerConnectionState * state) { return state->GetPeerNodeId() == nodeId; });
+}
+
+PeerConnectionState * PeerConnectionIndex::FindByPeerKeyId(const Optional<NodeId> & nodeId, uint16_t peerKeyId,
+                                                           const PeerConnectionState * begin) const
+{
+    return Find(kPeerKeyId, Hash(peerKeyId), begin, [&nodeId, peerKeyId](const PeerConnectionState * state) {
+        return state->GetPeerKeyID() == peerKeyId && NodeMatches(nodeId, state);
+    });
+}
+
+PeerConnectionState * PeerConnectionIndex::FindByLocalKeyId(const Optional<NodeId> & nodeId, uint16_t localKeyId,
+                                                            const PeerConnectionState * begin) const
+{
+    return Find(kLocalKeyId, Hash(localKeyId), begin, [&nodeId, localKeyId](const PeerConnectionState * state) {
+        return state->GetLocalKeyID() == localKeyId && NodeMatches(nodeId, state);
+    });
+}
+
+} // namespace Transport
+} // namespace chip
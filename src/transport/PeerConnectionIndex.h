@@ -0,0 +1,173 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @brief Defines hashed secondary indexes over a pool of peer connection states.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <core/Optional.h>
+#include <transport/raw/MessageHeader.h>
+#include <transport/raw/PeerAddress.h>
+
+namespace chip {
+namespace Transport {
+
+class PeerConnectionIndex;
+class PeerConnectionState;
+
+/**
+ * Per-state bookkeeping used by PeerConnectionIndex.
+ *
+ * The hook is intrusive in PeerConnectionState so that indexing needs no
+ * allocation. It is deliberately NOT carried over when a state is copied or
+ * assigned: index membership belongs to the pool slot, not to the value.
+ */
+class PeerConnectionIndexHook
+{
+public:
+    static constexpr size_t kKeyCount = 4;
+
+    PeerConnectionIndexHook() {}
+    PeerConnectionIndexHook(const PeerConnectionIndexHook &) {}
+    PeerConnectionIndexHook & operator=(const PeerConnectionIndexHook &) { return *this; }
+
+private:
+    friend class PeerConnectionIndex;
+    friend class PeerConnectionState;
+
+    PeerConnectionIndex * mIndex           = nullptr;     ///< index notified about key changes, if any
+    PeerConnectionState * mNext[kKeyCount] = { nullptr }; ///< bucket chain link, one per key
+    uint32_t mHash[kKeyCount]              = { 0 };       ///< hash the state was linked under, one per key
+    PeerConnectionState * mOlder           = nullptr;     ///< previous state on the activity list
+    PeerConnectionState * mNewer           = nullptr;     ///< next state on the activity list
+    bool mLinked                           = false;       ///< true if currently present in the bucket chains
+    bool mOnActivityList                   = false;       ///< true if currently present on the activity list
+};
+
+/**
+ * Hashed lookup of peer connection states by local key ID, peer key ID, peer
+ * node ID and peer address.
+ *
+ * Buckets are provided by the owning pool. Every chain is kept sorted by state
+ * address, which lets the `begin` cursor of the PeerConnections Find* methods
+ * continue a search exactly where a linear scan over the pool would.
+ *
+ * States that have a peer address are also kept on a list ordered by last
+ * activity time. Activity times normally only move forward, so marking a state
+ * active moves it to the newest end in constant time, and the states to expire
+ * are always found at the oldest end.
+ *
+ * States that are attached to an index report any change of their lookup keys
+ * or activity time back to it, so the index stays consistent no matter who
+ * mutates the state.
+ */
+class PeerConnectionIndex
+{
+public:
+    enum Key : uint8_t
+    {
+        kLocalKeyId  = 0,
+        kPeerKeyId   = 1,
+        kPeerNodeId  = 2,
+        kPeerAddress = 3,
+    };
+
+    static constexpr size_t kKeyCount = PeerConnectionIndexHook::kKeyCount;
+
+    PeerConnectionIndex() {}
+    PeerConnectionIndex(const PeerConnectionIndex &) = delete;
+    PeerConnectionIndex & operator=(const PeerConnectionIndex &) = delete;
+
+    /**
+     * Sets the bucket storage used by the index.
+     *
+     * @param buckets      storage for kKeyCount * bucketCount chain heads
+     * @param bucketCount  number of buckets per key, MUST be a power of two
+     */
+    void Init(PeerConnectionState ** buckets, size_t bucketCount);
+
+    /**
+     * Moves every indexed state over to new bucket storage, e.g. when the
+     * owning pool grows or shrinks. The previous storage is no longer
+     * referenced once this returns.
+     *
+     * @param buckets      storage for kKeyCount * bucketCount chain heads
+     * @param bucketCount  number of buckets per key, MUST be a power of two
+     */
+    void Rehash(PeerConnectionState ** buckets, size_t bucketCount);
+
+    size_t GetBucketCount() const { return mBucketCount; }
+
+    /// Returns true if the given state is currently tracked by this index.
+    bool IsAttached(const PeerConnectionState * state) const;
+
+    /// Starts tracking the given state, indexing it if it is initialized.
+    void Attach(PeerConnectionState * state);
+
+    /// Stops tracking the given state and removes it from all chains.
+    void Detach(PeerConnectionState * state);
+
+    /// Re-indexes a state after any of its lookup keys changed.
+    void Update(PeerConnectionState * state);
+
+    /// Moves a state to its place on the activity list after its last activity time changed.
+    void ActivityChanged(PeerConnectionState * state);
+
+    /// Returns the state with a peer address that has been idle the longest, if any.
+    PeerConnectionState * GetLeastRecentlyActive() const { return mOldest; }
+
+    PeerConnectionState * FindByPeerAddress(const PeerAddress & address, const PeerConnectionState * begin) const;
+    PeerConnectionState * FindByPeerNodeId(NodeId nodeId, const PeerConnectionState * begin) const;
+    PeerConnectionState * FindByPeerKeyId(const Optional<NodeId> & nodeId, uint16_t peerKeyId,
+                                          const PeerConnectionState * begin) const;
+    PeerConnectionState * FindByLocalKeyId(const Optional<NodeId> & nodeId, uint16_t localKeyId,
+                                           const PeerConnectionState * begin) const;
+
+    static uint32_t Hash(uint16_t keyId);
+    static uint32_t Hash(NodeId nodeId);
+    static uint32_t Hash(const PeerAddress & address);
+
+private:
+    PeerConnectionState ** Bucket(Key key, uint32_t hash) const
+    {
+        return &mBuckets[static_cast<size_t>(key) * mBucketCount + (hash & (mBucketCount - 1))];
+    }
+
+    /// Returns the first state following `begin` on the chain of `hash` that satisfies `match`.
+    template <typename Matcher>
+    PeerConnectionState * Find(Key key, uint32_t hash, const PeerConnectionState * begin, Matcher match) const;
+
+    void Link(PeerConnectionState * state);
+    void LinkChains(PeerConnectionState * state);
+    void Unlink(PeerConnectionState * state);
+
+    void InsertByActivity(PeerConnectionState * state);
+    void RemoveByActivity(PeerConnectionState * state);
+
+    PeerConnectionState ** mBuckets = nullptr;
+    size_t mBucketCount             = 0;
+    PeerConnectionState * mOldest   = nullptr; ///< oldest end of the activity list
+    PeerConnectionState * mNewest   = nullptr; ///< newest end of the activity list
+};
+
+} // namespace Transport
+} // namespace chip
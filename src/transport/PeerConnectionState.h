@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include <transport/MessageCounterWindow.h>
+#include <transport/PeerConnectionIndex.h>
 #include <transport/SecureSession.h>
 #include <transport/raw/MessageHeader.h>
 #include <transport/raw/PeerAddress.h>
@@ -35,6 +37,7 @@ namespace Transport {
  *   - PeerAddress represents how to talk to the peer
  *   - PeerNodeId is the unique ID of the peer
  *   - SendMessageIndex is an ever increasing index for sending messages
+ *   - ReceiveWindow tracks recently received message IDs to drop duplicates
  *   - LastActivityTimeMs is a monotonic timestamp of when this connection was
  *     last used. Inactive connections can expire.
  *   - SecureSession contains the encryption context of a connection
@@ -54,28 +57,54 @@ public:
     PeerConnectionState & operator=(PeerConnectionState &&) = default;
 
     const PeerAddress & GetPeerAddress() const { return mPeerAddress; }
-    PeerAddress & GetPeerAddress() { return mPeerAddress; }
-    void SetPeerAddress(const PeerAddress & address) { mPeerAddress = address; }
+    void SetPeerAddress(const PeerAddress & address)
+    {
+        mPeerAddress = address;
+        LookupKeysChanged();
+    }
 
     NodeId GetPeerNodeId() const { return mPeerNodeId; }
-    void SetPeerNodeId(NodeId peerNodeId) { mPeerNodeId = peerNodeId; }
+    void SetPeerNodeId(NodeId peerNodeId)
+    {
+        mPeerNodeId = peerNodeId;
+        LookupKeysChanged();
+    }
 
     uint32_t GetSendMessageIndex() const { return mSendMessageIndex; }
     void IncrementSendMessageIndex() { mSendMessageIndex++; }
 
+    MessageCounterWindow & GetReceiveWindow() { return mReceiveWindow; }
+    const MessageCounterWindow & GetReceiveWindow() const { return mReceiveWindow; }
+
     uint16_t GetPeerKeyID() const { return mPeerKeyID; }
-    void SetPeerKeyID(uint16_t id) { mPeerKeyID = id; }
+    void SetPeerKeyID(uint16_t id)
+    {
+        mPeerKeyID = id;
+        LookupKeysChanged();
+    }
 
     uint16_t GetLocalKeyID() const { return mLocalKeyID; }
-    void SetLocalKeyID(uint16_t id) { mLocalKeyID = id; }
+    void SetLocalKeyID(uint16_t id)
+    {
+        mLocalKeyID = id;
+        LookupKeysChanged();
+    }
 
     uint64_t GetLastActivityTimeMs() const { return mLastActityTimeMs; }
-    void SetLastActivityTimeMs(uint64_t value) { mLastActityTimeMs = value; }
+    void SetLastActivityTimeMs(uint64_t value)
+    {
+        mLastActityTimeMs = value;
+
+        if (mIndexHook.mIndex != nullptr)
+        {
+            mIndexHook.mIndex->ActivityChanged(this);
+        }
+    }
 
     SecureSession & GetSecureSession() { return mSecureSession; }
     const SecureSession & GetSecureSession() const { return mSecureSession; }
 
-    bool IsInitialized()
+    bool IsInitialized() const
     {
         return (mPeerAddress.IsInitialized() || mPeerNodeId != kUndefinedNodeId || mPeerKeyID != UINT16_MAX ||
                 mLocalKeyID != UINT16_MAX);
@@ -90,17 +119,32 @@ public:
         mPeerNodeId       = kUndefinedNodeId;
         mSendMessageIndex = 0;
         mLastActityTimeMs = 0;
+        mReceiveWindow.Reset();
         mSecureSession.Reset();
+        LookupKeysChanged();
     }
 
 private:
+    friend class PeerConnectionIndex;
+
+    /// Keeps the owning pool's lookup index in sync with the address, node and key IDs.
+    void LookupKeysChanged()
+    {
+        if (mIndexHook.mIndex != nullptr)
+        {
+            mIndexHook.mIndex->Update(this);
+        }
+    }
+
     PeerAddress mPeerAddress;
     NodeId mPeerNodeId         = kUndefinedNodeId;
     uint32_t mSendMessageIndex = 0;
     uint16_t mPeerKeyID        = UINT16_MAX;
     uint16_t mLocalKeyID       = UINT16_MAX;
     uint64_t mLastActityTimeMs = 0;
+    MessageCounterWindow mReceiveWindow;
     SecureSession mSecureSession;
+    PeerConnectionIndexHook mIndexHook;
 };
 
 } // namespace Transport
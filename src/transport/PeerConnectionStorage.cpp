@@ -0,0 +1,237 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the runtime sized storage backend of
+ *      PeerConnections.
+ */
+
+#include <transport/PeerConnectionStorage.h>
+
+#include <new>
+#include <stddef.h>
+#include <type_traits>
+
+#include <support/CHIPMem.h>
+#include <support/CodeUtils.h>
+#include <system/SystemStats.h>
+
+namespace chip {
+namespace Transport {
+
+namespace {
+
+/// Slots added to or removed from the pool statistics along with a chunk.
+constexpr System::Stats::count_t kChunkSlots = static_cast<System::Stats::count_t>(DynamicPeerConnectionStorage::kChunkSize);
+
+} // namespace
+
+DynamicPeerConnectionStorage::Chunk::Chunk()
+{
+    for (size_t i = kChunkSize; i > 0; i--)
+    {
+        mSlots[i - 1].mChunk    = this;
+        mSlots[i - 1].mNextFree = mFreeSlots;
+        mFreeSlots              = &mSlots[i - 1];
+    }
+}
+
+DynamicPeerConnectionStorage::~DynamicPeerConnectionStorage()
+{
+    while (mChunks != nullptr)
+    {
+        Chunk * chunk = mChunks;
+        mChunks       = chunk->mNext;
+
+        for (size_t i = 0; i < kChunkSize; i++)
+        {
+            mIndex.Detach(&chunk->mSlots[i].mState);
+        }
+
+        chunk->~Chunk();
+        Platform::MemoryFree(chunk);
+    }
+
+    SYSTEM_STATS_DECREMENT_BY_N(System::Stats::kTransport_NumPeerConnections, static_cast<System::Stats::count_t>(mInUse));
+    SYSTEM_STATS_DECREMENT_BY_N(System::Stats::kTransport_NumPeerConnectionSlots, static_cast<System::Stats::count_t>(mCapacity));
+
+    Platform::MemoryFree(mIndexBuckets);
+}
+
+PeerConnectionState * DynamicPeerConnectionStorage::Allocate()
+{
+    Chunk * chunk = mChunksWithFree;
+
+    if (chunk == nullptr)
+    {
+        void * memory = (mCapacity < mMaxConnectionCount) ? Platform::MemoryAlloc(sizeof(Chunk)) : nullptr;
+
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+
+        chunk        = new (memory) Chunk();
+        chunk->mNext = mChunks;
+        mChunks      = chunk;
+        LinkWithFree(chunk);
+        mCapacity += kChunkSize;
+        SYSTEM_STATS_INCREMENT_BY_N(System::Stats::kTransport_NumPeerConnectionSlots, kChunkSlots);
+
+        ResizeIndex();
+    }
+
+    if (mIndexBuckets == nullptr)
+    {
+        return nullptr; // no memory left to index the state
+    }
+
+    Slot * slot       = chunk->mFreeSlots;
+    chunk->mFreeSlots = slot->mNextFree;
+    slot->mNextFree   = nullptr;
+
+    if (++chunk->mInUse == kChunkSize)
+    {
+        UnlinkWithFree(chunk);
+    }
+
+    mInUse++;
+    mHighWatermark = (mInUse > mHighWatermark) ? mInUse : mHighWatermark;
+    SYSTEM_STATS_INCREMENT(System::Stats::kTransport_NumPeerConnections);
+
+    return &slot->mState;
+}
+
+void DynamicPeerConnectionStorage::Release(PeerConnectionState * state)
+{
+    Slot * slot   = SlotOf(state);
+    Chunk * chunk = slot->mChunk;
+
+    VerifyOrDie(chunk != nullptr && chunk->mInUse > 0);
+
+    if (chunk->mInUse == kChunkSize)
+    {
+        LinkWithFree(chunk);
+    }
+
+    chunk->mInUse--;
+    slot->mNextFree   = chunk->mFreeSlots;
+    chunk->mFreeSlots = slot;
+    mInUse--;
+    SYSTEM_STATS_DECREMENT(System::Stats::kTransport_NumPeerConnections);
+}
+
+void DynamicPeerConnectionStorage::Compact()
+{
+    bool keptSpare = false;
+    bool freed     = false;
+
+    for (Chunk ** link = &mChunks; *link != nullptr;)
+    {
+        Chunk * chunk = *link;
+
+        if (chunk->mInUse != 0 || !keptSpare)
+        {
+            keptSpare = keptSpare || chunk->mInUse == 0;
+            link      = &chunk->mNext;
+            continue;
+        }
+
+        *link = chunk->mNext;
+        UnlinkWithFree(chunk);
+        chunk->~Chunk();
+        Platform::MemoryFree(chunk);
+        mCapacity -= kChunkSize;
+        SYSTEM_STATS_DECREMENT_BY_N(System::Stats::kTransport_NumPeerConnectionSlots, kChunkSlots);
+        freed = true;
+    }
+
+    if (freed)
+    {
+        ResizeIndex();
+    }
+}
+
+DynamicPeerConnectionStorage::Slot * DynamicPeerConnectionStorage::SlotOf(PeerConnectionState * state)
+{
+    static_assert(std::is_standard_layout<Slot>::value && offsetof(Slot, mState) == 0,
+                  "a state must share the address of its slot");
+
+    return reinterpret_cast<Slot *>(state);
+}
+
+void DynamicPeerConnectionStorage::LinkWithFree(Chunk * chunk)
+{
+    chunk->mPrevWithFree = nullptr;
+    chunk->mNextWithFree = mChunksWithFree;
+
+    if (mChunksWithFree != nullptr)
+    {
+        mChunksWithFree->mPrevWithFree = chunk;
+    }
+
+    mChunksWithFree = chunk;
+}
+
+void DynamicPeerConnectionStorage::UnlinkWithFree(Chunk * chunk)
+{
+    if (chunk->mPrevWithFree != nullptr)
+    {
+        chunk->mPrevWithFree->mNextWithFree = chunk->mNextWithFree;
+    }
+    else
+    {
+        mChunksWithFree = chunk->mNextWithFree;
+    }
+
+    if (chunk->mNextWithFree != nullptr)
+    {
+        chunk->mNextWithFree->mPrevWithFree = chunk->mPrevWithFree;
+    }
+
+    chunk->mNextWithFree = nullptr;
+    chunk->mPrevWithFree = nullptr;
+}
+
+void DynamicPeerConnectionStorage::ResizeIndex()
+{
+    const size_t bucketCount  = HashBucketCountFor(mCapacity);
+    const size_t currentCount = mIndex.GetBucketCount();
+
+    // Shrinking lags growth by a factor of four so a pool hovering around a
+    // chunk boundary does not rehash on every allocation.
+    if (mIndexBuckets != nullptr && bucketCount <= currentCount && bucketCount * 4 > currentCount)
+    {
+        return;
+    }
+
+    PeerConnectionState ** buckets = static_cast<PeerConnectionState **>(
+        Platform::MemoryAlloc(sizeof(PeerConnectionState *) * PeerConnectionIndex::kKeyCount * bucketCount));
+
+    if (buckets == nullptr)
+    {
+        return; // keep the current buckets, lookups remain correct with longer chains
+    }
+
+    mIndex.Rehash(buckets, bucketCount);
+    Platform::MemoryFree(mIndexBuckets);
+    mIndexBuckets = buckets;
+}
+
+} // namespace Transport
+} // namespace chip
@@ -0,0 +1,202 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @brief Defines the storage backends a PeerConnections pool can be built on.
+ *
+ * A storage owns the PeerConnectionState objects and the index over them, and
+ * exposes:
+ *   - Index(): the PeerConnectionIndex tracking allocated states
+ *   - Allocate(): a state that is not currently in use, or nullptr
+ *   - Release(state): bookkeeping once a state was detached from the index
+ *   - Compact(): opportunity to give back memory after states were released
+ *   - IsMember(state): whether a state can be used as a search cursor
+ *   - ForEachAllocated(fn): visits every state in use
+ */
+
+#pragma once
+
+#include <core/CHIPConfig.h>
+#include <support/HashUtils.h>
+#include <transport/PeerConnectionIndex.h>
+#include <transport/PeerConnectionState.h>
+
+namespace chip {
+namespace Transport {
+
+/**
+ * Storage for a compile-time sized array of peer connection states.
+ *
+ * Intended for memory constrained devices that know their peer count upfront.
+ */
+template <size_t kMaxConnectionCount>
+class FixedPeerConnectionStorage
+{
+public:
+    FixedPeerConnectionStorage() { mIndex.Init(mIndexBuckets, kIndexBucketCount); }
+
+    FixedPeerConnectionStorage(const FixedPeerConnectionStorage &) = delete;
+    FixedPeerConnectionStorage & operator=(const FixedPeerConnectionStorage &) = delete;
+
+    PeerConnectionIndex & Index() { return mIndex; }
+
+    PeerConnectionState * Allocate()
+    {
+        for (size_t i = 0; i < kMaxConnectionCount; i++)
+        {
+            if (!mIndex.IsAttached(&mStates[i]))
+            {
+                return &mStates[i];
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Release(PeerConnectionState * state) {}
+
+    void Compact() {}
+
+    bool IsMember(const PeerConnectionState * state) const
+    {
+        return state >= &mStates[0] && state < &mStates[kMaxConnectionCount];
+    }
+
+    template <typename Function>
+    void ForEachAllocated(Function function)
+    {
+        for (size_t i = 0; i < kMaxConnectionCount; i++)
+        {
+            if (mIndex.IsAttached(&mStates[i]))
+            {
+                function(&mStates[i]);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kIndexBucketCount = HashBucketCountFor(kMaxConnectionCount);
+
+    PeerConnectionState mStates[kMaxConnectionCount];
+    PeerConnectionIndex mIndex;
+    PeerConnectionState * mIndexBuckets[PeerConnectionIndex::kKeyCount * kIndexBucketCount];
+};
+
+/**
+ * Storage for a runtime sized set of peer connection states.
+ *
+ * States live in fixed size chunks allocated from chip::Platform memory, so
+ * their addresses stay stable while the pool grows. Chunks are added when all
+ * existing states are in use, and given back once they become empty (keeping
+ * one spare chunk to avoid churn). The index buckets are resized along with the
+ * capacity so chains stay short.
+ *
+ * Chunks with free slots are kept on their own list, and each chunk keeps a
+ * list of its free slots, so Allocate() and Release() take constant time no
+ * matter how many chunks the pool has.
+ *
+ * Intended for controllers and hubs that may talk to a large, unknown number
+ * of peers.
+ */
+class DynamicPeerConnectionStorage
+{
+public:
+    static constexpr size_t kChunkSize = CHIP_CONFIG_PEER_CONNECTION_POOL_CHUNK_SIZE;
+
+    /**
+     * @param maxConnectionCount upper bound on the number of states, rounded up to a whole chunk.
+     */
+    explicit DynamicPeerConnectionStorage(size_t maxConnectionCount = CHIP_CONFIG_PEER_CONNECTION_POOL_MAX_SIZE) :
+        mMaxConnectionCount(maxConnectionCount)
+    {}
+    ~DynamicPeerConnectionStorage();
+
+    DynamicPeerConnectionStorage(const DynamicPeerConnectionStorage &) = delete;
+    DynamicPeerConnectionStorage & operator=(const DynamicPeerConnectionStorage &) = delete;
+
+    PeerConnectionIndex & Index() { return mIndex; }
+
+    PeerConnectionState * Allocate();
+    void Release(PeerConnectionState * state);
+    void Compact();
+
+    bool IsMember(const PeerConnectionState * state) const { return mIndex.IsAttached(state); }
+
+    template <typename Function>
+    void ForEachAllocated(Function function)
+    {
+        for (Chunk * chunk = mChunks; chunk != nullptr; chunk = chunk->mNext)
+        {
+            for (size_t i = 0; i < kChunkSize && chunk->mInUse > 0; i++)
+            {
+                if (mIndex.IsAttached(&chunk->mSlots[i].mState))
+                {
+                    function(&chunk->mSlots[i].mState);
+                }
+            }
+        }
+    }
+
+    /// Number of states that can be handed out without allocating a new chunk.
+    size_t GetCapacity() const { return mCapacity; }
+
+    /// Number of states currently in use.
+    size_t GetInUseCount() const { return mInUse; }
+
+    /// Highest number of states that were in use at the same time.
+    size_t GetHighWatermark() const { return mHighWatermark; }
+
+private:
+    struct Chunk;
+
+    /// A state along with the bookkeeping of its slot. The state comes first, so a state converts back to its slot.
+    struct Slot
+    {
+        PeerConnectionState mState;
+        Chunk * mChunk   = nullptr; ///< chunk the slot belongs to
+        Slot * mNextFree = nullptr; ///< next free slot of the chunk, while this one is free
+    };
+
+    struct Chunk
+    {
+        Chunk();
+
+        Chunk * mNext         = nullptr; ///< next chunk of the pool
+        Chunk * mNextWithFree = nullptr; ///< next chunk that has free slots, while this one has some
+        Chunk * mPrevWithFree = nullptr; ///< previous chunk that has free slots, while this one has some
+        Slot * mFreeSlots     = nullptr; ///< free slots, most recently released first
+        size_t mInUse         = 0;
+        Slot mSlots[kChunkSize];
+    };
+
+    static Slot * SlotOf(PeerConnectionState * state);
+    void LinkWithFree(Chunk * chunk);
+    void UnlinkWithFree(Chunk * chunk);
+    void ResizeIndex();
+
+    PeerConnectionIndex mIndex;
+    PeerConnectionState ** mIndexBuckets = nullptr;
+    Chunk * mChunks                      = nullptr;
+    Chunk * mChunksWithFree              = nullptr;
+    size_t mMaxConnectionCount;
+    size_t mCapacity      = 0;
+    size_t mInUse         = 0;
+    size_t mHighWatermark = 0;
+};
+
+} // namespace Transport
+} // namespace chip
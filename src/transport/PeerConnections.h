@@ -16,10 +16,15 @@
  */
 #pragma once
 
+#include <utility>
+
 #include <core/CHIPError.h>
+#include <core/Optional.h>
 #include <support/CodeUtils.h>
 #include <system/TimeSource.h>
+#include <transport/PeerConnectionIndex.h>
 #include <transport/PeerConnectionState.h>
+#include <transport/PeerConnectionStorage.h>
 
 namespace chip {
 namespace Transport {
@@ -29,12 +34,29 @@ namespace Transport {
  *
  * Intended for:
  *   - handle connection active time and expiration
- *   - allocate and free space for connection states.
+ *   - allocate and free space for connection states, through the given Storage
+ *     (see PeerConnectionStorage.h).
+ *   - look up connection states by address, node ID or key ID in constant
+ *     average time, through a PeerConnectionIndex kept in sync with the states.
+ *
+ * A state is in use from its creation until it is expired.
  */
-template <size_t kMaxConnectionCount, Time::Source kTimeSource = Time::Source::kSystem>
-class PeerConnections
+template <class Storage, Time::Source kTimeSource = Time::Source::kSystem>
+class PeerConnectionPool
 {
 public:
+    template <typename... Args>
+    PeerConnectionPool(Args &&... args) : mStorage(std::forward<Args>(args)...)
+    {}
+
+    ~PeerConnectionPool()
+    {
+        mStorage.ForEachAllocated([this](PeerConnectionState * state) { Free(state); });
+    }
+
+    PeerConnectionPool(const PeerConnectionPool &) = delete;
+    PeerConnectionPool & operator=(const PeerConnectionPool &) = delete;
+
     /**
      * Allocates a new peer connection state state object out of the internal resource pool.
      *
@@ -56,21 +78,20 @@ public:
             *state = nullptr;
         }
 
-        for (size_t i = 0; i < kMaxConnectionCount; i++)
-        {
-            if (!mStates[i].IsInitialized())
-            {
-                mStates[i] = PeerConnectionState(address);
-                mStates[i].SetLastActivityTimeMs(mTimeSource.GetCurrentMonotonicTimeMs());
+        PeerConnectionState * newState = mStorage.Allocate();
 
-                if (state)
-                {
-                    *state = &mStates[i];
-                }
+        if (newState != nullptr)
+        {
+            *newState = PeerConnectionState(address);
+            newState->SetLastActivityTimeMs(mTimeSource.GetCurrentMonotonicTimeMs());
+            mStorage.Index().Attach(newState);
 
-                err = CHIP_NO_ERROR;
-                break;
+            if (state)
+            {
+                *state = newState;
             }
+
+            err = CHIP_NO_ERROR;
         }
 
         return err;
@@ -100,28 +121,28 @@ public:
             *state = nullptr;
         }
 
-        for (size_t i = 0; i < kMaxConnectionCount; i++)
+        PeerConnectionState * newState = mStorage.Allocate();
+
+        if (newState != nullptr)
         {
-            if (!mStates[i].IsInitialized())
+            *newState = PeerConnectionState();
+            newState->SetPeerKeyID(peerKeyId);
+            newState->SetLocalKeyID(localKeyId);
+            newState->SetLastActivityTimeMs(mTimeSource.GetCurrentMonotonicTimeMs());
+
+            if (peerNode.HasValue())
             {
-                mStates[i] = PeerConnectionState();
-                mStates[i].SetPeerKeyID(peerKeyId);
-                mStates[i].SetLocalKeyID(localKeyId);
-                mStates[i].SetLastActivityTimeMs(mTimeSource.GetCurrentMonotonicTimeMs());
-
-                if (peerNode.HasValue())
-                {
-                    mStates[i].SetPeerNodeId(peerNode.Value());
-                }
-
-                if (state)
-                {
-                    *state = &mStates[i];
-                }
-
-                err = CHIP_NO_ERROR;
-                break;
+                newState->SetPeerNodeId(peerNode.Value());
             }
+
+            mStorage.Index().Attach(newState);
+
+            if (state)
+            {
+                *state = newState;
+            }
+
+            err = CHIP_NO_ERROR;
         }
 
         return err;
@@ -138,23 +159,7 @@ public:
     CHECK_RETURN_VALUE
     PeerConnectionState * FindPeerConnectionState(const PeerAddress & address, PeerConnectionState * begin)
     {
-        PeerConnectionState * state = nullptr;
-        PeerConnectionState * iter  = &mStates[0];
-
-        if (begin >= iter && begin < &mStates[kMaxConnectionCount])
-        {
-            iter = begin + 1;
-        }
-
-        for (; iter < &mStates[kMaxConnectionCount]; iter++)
-        {
-            if (iter->GetPeerAddress() == address)
-            {
-                state = iter;
-                break;
-            }
-        }
-        return state;
+        return mStorage.Index().FindByPeerAddress(address, Cursor(begin));
     }
 
     /**
@@ -169,27 +174,7 @@ public:
     CHECK_RETURN_VALUE
     PeerConnectionState * FindPeerConnectionState(NodeId nodeId, PeerConnectionState * begin)
     {
-        PeerConnectionState * state = nullptr;
-        PeerConnectionState * iter  = &mStates[0];
-
-        if (begin >= iter && begin < &mStates[kMaxConnectionCount])
-        {
-            iter = begin + 1;
-        }
-
-        for (; iter < &mStates[kMaxConnectionCount]; iter++)
-        {
-            if (!iter->IsInitialized())
-            {
-                continue;
-            }
-            if (iter->GetPeerNodeId() == nodeId)
-            {
-                state = iter;
-                break;
-            }
-        }
-        return state;
+        return mStorage.Index().FindByPeerNodeId(nodeId, Cursor(begin));
     }
 
     /**
@@ -205,30 +190,7 @@ public:
     CHECK_RETURN_VALUE
     PeerConnectionState * FindPeerConnectionState(Optional<NodeId> nodeId, uint16_t peerKeyId, PeerConnectionState * begin)
     {
-        PeerConnectionState * state = nullptr;
-        PeerConnectionState * iter  = &mStates[0];
-
-        if (begin >= iter && begin < &mStates[kMaxConnectionCount])
-        {
-            iter = begin + 1;
-        }
-
-        for (; iter < &mStates[kMaxConnectionCount]; iter++)
-        {
-            if (!iter->IsInitialized())
-            {
-                continue;
-            }
-            if (iter->GetPeerKeyID() == peerKeyId)
-            {
-                if (!nodeId.HasValue() || iter->GetPeerNodeId() == kUndefinedNodeId || iter->GetPeerNodeId() == nodeId.Value())
-                {
-                    state = iter;
-                    break;
-                }
-            }
-        }
-        return state;
+        return mStorage.Index().FindByPeerKeyId(nodeId, peerKeyId, Cursor(begin));
     }
 
     /**
@@ -245,30 +207,7 @@ public:
     PeerConnectionState * FindPeerConnectionStateByLocalKey(Optional<NodeId> nodeId, uint16_t localKeyId,
                                                             PeerConnectionState * begin)
     {
-        PeerConnectionState * state = nullptr;
-        PeerConnectionState * iter  = &mStates[0];
-
-        if (begin >= iter && begin < &mStates[kMaxConnectionCount])
-        {
-            iter = begin + 1;
-        }
-
-        for (; iter < &mStates[kMaxConnectionCount]; iter++)
-        {
-            if (!iter->IsInitialized())
-            {
-                continue;
-            }
-            if (iter->GetLocalKeyID() == localKeyId)
-            {
-                if (!nodeId.HasValue() || iter->GetPeerNodeId() == kUndefinedNodeId || iter->GetPeerNodeId() == nodeId.Value())
-                {
-                    state = iter;
-                    break;
-                }
-            }
-        }
-        return state;
+        return mStorage.Index().FindByLocalKeyId(nodeId, localKeyId, Cursor(begin));
     }
 
     /// Convenience method to mark a peer connection state as active
@@ -282,12 +221,15 @@ public:
     void MarkConnectionExpired(PeerConnectionState * state, Callback callback)
     {
         callback(*state);
-        *state = PeerConnectionState(PeerAddress::Uninitialized());
+        Free(state);
+        mStorage.Compact();
     }
 
     /**
-     * Iterates through all active connections and expires any connection with an idle time
-     * larger than the given amount.
+     * Expires any active connection with an idle time larger than the given amount.
+     *
+     * Only connections that are due are visited: they are taken from the oldest end of
+     * the index activity list, so the cost does not depend on the number of connections.
      *
      * Expiring a connection involves callback execution and then clearing the internal state.
      */
@@ -295,31 +237,73 @@ public:
     void ExpireInactiveConnections(uint64_t maxIdleTimeMs, Callback callback)
     {
         const uint64_t currentTime = mTimeSource.GetCurrentMonotonicTimeMs();
+        PeerConnectionState * state;
 
-        for (size_t i = 0; i < kMaxConnectionCount; i++)
+        while ((state = mStorage.Index().GetLeastRecentlyActive()) != nullptr &&
+               state->GetLastActivityTimeMs() + maxIdleTimeMs < currentTime)
         {
-            if (!mStates[i].GetPeerAddress().IsInitialized())
-            {
-                continue; // not an active connection
-            }
+            callback(*state);
+            Free(state);
+        }
 
-            uint64_t connectionActiveTime = mStates[i].GetLastActivityTimeMs();
-            if (connectionActiveTime + maxIdleTimeMs >= currentTime)
-            {
-                continue; // not expired
-            }
+        mStorage.Compact();
+    }
 
-            MarkConnectionExpired(&mStates[i], callback);
+    /**
+     * Computes when ExpireInactiveConnections should run next.
+     *
+     * @param maxIdleTimeMs the idle time after which connections expire
+     *
+     * @return the time in milliseconds until the least recently active connection expires (0 if
+     *         it already has), or no value if there is no active connection.
+     */
+    Optional<uint64_t> GetTimeUntilNextExpiryMs(uint64_t maxIdleTimeMs)
+    {
+        const PeerConnectionState * state = mStorage.Index().GetLeastRecentlyActive();
+
+        if (state == nullptr)
+        {
+            return Optional<uint64_t>::Missing();
         }
+
+        const uint64_t currentTime = mTimeSource.GetCurrentMonotonicTimeMs();
+        const uint64_t expiryTime  = state->GetLastActivityTimeMs() + maxIdleTimeMs + 1;
+
+        return Optional<uint64_t>::Value((expiryTime > currentTime) ? expiryTime - currentTime : 0);
     }
 
     /// Allows access to the underlying time source used for keeping track of connection active time
     Time::TimeSource<kTimeSource> & GetTimeSource() { return mTimeSource; }
 
+    /// Allows access to the underlying storage, e.g. for statistics
+    Storage & GetStorage() { return mStorage; }
+
 private:
+    /// Searches start from the beginning of the pool unless `begin` is one of its members.
+    const PeerConnectionState * Cursor(const PeerConnectionState * begin) const
+    {
+        return mStorage.IsMember(begin) ? begin : nullptr;
+    }
+
+    /// Returns a state to the storage. Does not give memory back: callers run Compact() once done.
+    void Free(PeerConnectionState * state)
+    {
+        mStorage.Index().Detach(state);
+        *state = PeerConnectionState(PeerAddress::Uninitialized());
+        mStorage.Release(state);
+    }
+
     Time::TimeSource<kTimeSource> mTimeSource;
-    PeerConnectionState mStates[kMaxConnectionCount];
+    Storage mStorage;
 };
 
+/// Peer connection states held in a fixed array, for memory constrained devices.
+template <size_t kMaxConnectionCount, Time::Source kTimeSource = Time::Source::kSystem>
+using PeerConnections = PeerConnectionPool<FixedPeerConnectionStorage<kMaxConnectionCount>, kTimeSource>;
+
+/// Peer connection states allocated in chunks at runtime, for controllers tracking many peers.
+template <Time::Source kTimeSource = Time::Source::kSystem>
+using DynamicPeerConnections = PeerConnectionPool<DynamicPeerConnectionStorage, kTimeSource>;
+
 } // namespace Transport
 } // namespace chip
@@ -44,6 +44,28 @@ using namespace Crypto;
 
 SecureSession::SecureSession() : mKeyAvailable(false) {}
 
+SecureSession::~SecureSession()
+{
+    Reset();
+}
+
+SecureSession::SecureSession(const SecureSession & other) : mKeyAvailable(false)
+{
+    *this = other;
+}
+
+SecureSession & SecureSession::operator=(const SecureSession & other)
+{
+    if (this != &other)
+    {
+        mCipher.Clear();
+        mKeyAvailable = other.mKeyAvailable;
+        memcpy(mKey, other.mKey, sizeof(mKey));
+    }
+
+    return *this;
+}
+
 CHIP_ERROR SecureSession::InitFromSecret(const uint8_t * secret, const size_t secret_length, const uint8_t * salt,
                                          const size_t salt_length, const uint8_t * info, const size_t info_length)
 {
@@ -81,6 +103,20 @@ void SecureSession::Reset()
 {
     mKeyAvailable = false;
     memset(mKey, 0, sizeof(mKey));
+    mCipher.Clear();
+}
+
+CHIP_ERROR SecureSession::GetCipher(AES_CCM_Context *& cipher)
+{
+    VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
+
+    if (!mCipher.HasKey())
+    {
+        ReturnErrorOnFailure(mCipher.SetKey(mKey, sizeof(mKey)));
+    }
+
+    cipher = &mCipher;
+    return CHIP_NO_ERROR;
 }
 
 CHIP_ERROR SecureSession::GetIV(const PacketHeader & header, uint8_t * iv, size_t len)
@@ -130,11 +166,87 @@ CHIP_ERROR SecureSession::Encrypt(const uint8_t * input, size_t input_length, ui
     uint8_t IV[kAESCCMIVLen];
     uint16_t aadLen = sizeof(AAD);
     uint8_t tag[kMaxTagLen];
+    AES_CCM_Context * cipher = nullptr;
+
+    ReturnErrorOnFailure(GetCipher(cipher));
+    ReturnErrorOnFailure(GetIV(header, IV, sizeof(IV)));
+    ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
+    ReturnErrorOnFailure(cipher->Encrypt(input, input_length, AAD, aadLen, IV, sizeof(IV), output, tag, taglen));
+
+    mac.SetTag(&header, encType, tag, taglen);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SecureSession::Encrypt(System::PacketBuffer * msgBuf, PacketHeader & header, MessageAuthenticationCode & mac)
+{
+    constexpr Header::EncryptionType encType = Header::EncryptionType::kAESCCMTagLen16;
+
+    const size_t taglen = MessageAuthenticationCode::TagLenForEncryptionType(encType);
+    assert(taglen <= kMaxTagLen);
+
+    VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
+    VerifyOrReturnError(msgBuf != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(msgBuf->TotalLength() > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    uint8_t AAD[kMaxAADLen];
+    uint8_t IV[kAESCCMIVLen];
+    uint16_t aadLen = sizeof(AAD);
+    uint8_t tag[kMaxTagLen];
+    AES_CCM_Context * cipher = nullptr;
 
+    ReturnErrorOnFailure(GetCipher(cipher));
     ReturnErrorOnFailure(GetIV(header, IV, sizeof(IV)));
     ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
-    ReturnErrorOnFailure(
-        AES_CCM_encrypt(input, input_length, AAD, aadLen, mKey, sizeof(mKey), IV, sizeof(IV), output, tag, taglen));
+    ReturnErrorOnFailure(cipher->EncryptBegin(msgBuf->TotalLength(), AAD, aadLen, IV, sizeof(IV), taglen));
+
+    for (System::PacketBuffer * segment = msgBuf; segment != nullptr; segment = segment->Next())
+    {
+        ReturnErrorOnFailure(cipher->EncryptUpdate(segment->Start(), segment->DataLength(), segment->Start()));
+    }
+
+    ReturnErrorOnFailure(cipher->EncryptFinish(tag, taglen));
+
+    mac.SetTag(&header, encType, tag, taglen);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SecureSession::Encrypt(const uint8_t * prefix, size_t prefix_length, const System::PacketBuffer * payload,
+                                  uint8_t * output, PacketHeader & header, MessageAuthenticationCode & mac)
+{
+    constexpr Header::EncryptionType encType = Header::EncryptionType::kAESCCMTagLen16;
+
+    const size_t taglen = MessageAuthenticationCode::TagLenForEncryptionType(encType);
+    assert(taglen <= kMaxTagLen);
+
+    VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
+    VerifyOrReturnError(prefix != nullptr || prefix_length == 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(payload != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(prefix_length + payload->TotalLength() > 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(output != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    uint8_t AAD[kMaxAADLen];
+    uint8_t IV[kAESCCMIVLen];
+    uint16_t aadLen = sizeof(AAD);
+    uint8_t tag[kMaxTagLen];
+    AES_CCM_Context * cipher = nullptr;
+
+    ReturnErrorOnFailure(GetCipher(cipher));
+    ReturnErrorOnFailure(GetIV(header, IV, sizeof(IV)));
+    ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
+    ReturnErrorOnFailure(cipher->EncryptBegin(prefix_length + payload->TotalLength(), AAD, aadLen, IV, sizeof(IV), taglen));
+
+    ReturnErrorOnFailure(cipher->EncryptUpdate(prefix, prefix_length, output));
+    output += prefix_length;
+
+    for (const System::PacketBuffer * segment = payload; segment != nullptr; segment = segment->Next())
+    {
+        ReturnErrorOnFailure(cipher->EncryptUpdate(segment->Start(), segment->DataLength(), output));
+        output += segment->DataLength();
+    }
+
+    ReturnErrorOnFailure(cipher->EncryptFinish(tag, taglen));
 
     mac.SetTag(&header, encType, tag, taglen);
 
@@ -148,17 +260,45 @@ CHIP_ERROR SecureSession::Decrypt(const uint8_t * input, size_t input_length, ui
     const uint8_t * tag = mac.GetTag();
     uint8_t IV[kAESCCMIVLen];
     uint8_t AAD[kMaxAADLen];
-    uint16_t aadLen = sizeof(AAD);
+    uint16_t aadLen          = sizeof(AAD);
+    AES_CCM_Context * cipher = nullptr;
 
     VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
     VerifyOrReturnError(input != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(input_length > 0, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(output != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
 
+    ReturnErrorOnFailure(GetCipher(cipher));
     ReturnErrorOnFailure(GetIV(header, IV, sizeof(IV)));
     ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
 
-    return AES_CCM_decrypt(input, input_length, AAD, aadLen, tag, taglen, mKey, sizeof(mKey), IV, sizeof(IV), output);
+    return cipher->Decrypt(input, input_length, AAD, aadLen, tag, taglen, IV, sizeof(IV), output);
+}
+
+CHIP_ERROR SecureSession::Decrypt(System::PacketBuffer * msgBuf, const PacketHeader & header, const MessageAuthenticationCode & mac)
+{
+    const size_t taglen = MessageAuthenticationCode::TagLenForEncryptionType(header.GetEncryptionType());
+    const uint8_t * tag = mac.GetTag();
+    uint8_t IV[kAESCCMIVLen];
+    uint8_t AAD[kMaxAADLen];
+    uint16_t aadLen          = sizeof(AAD);
+    AES_CCM_Context * cipher = nullptr;
+
+    VerifyOrReturnError(mKeyAvailable, CHIP_ERROR_INVALID_USE_OF_SESSION_KEY);
+    VerifyOrReturnError(msgBuf != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(msgBuf->TotalLength() > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    ReturnErrorOnFailure(GetCipher(cipher));
+    ReturnErrorOnFailure(GetIV(header, IV, sizeof(IV)));
+    ReturnErrorOnFailure(GetAdditionalAuthData(header, AAD, aadLen));
+    ReturnErrorOnFailure(cipher->DecryptBegin(msgBuf->TotalLength(), AAD, aadLen, IV, sizeof(IV), taglen));
+
+    for (System::PacketBuffer * segment = msgBuf; segment != nullptr; segment = segment->Next())
+    {
+        ReturnErrorOnFailure(cipher->DecryptUpdate(segment->Start(), segment->DataLength(), segment->Start()));
+    }
+
+    return cipher->DecryptFinish(tag, taglen);
 }
 
 } // namespace chip
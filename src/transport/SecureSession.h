@@ -27,6 +27,7 @@
 
 #include <core/CHIPCore.h>
 #include <crypto/CHIPCryptoPAL.h>
+#include <system/SystemPacketBuffer.h>
 #include <transport/raw/MessageHeader.h>
 
 namespace chip {
@@ -35,10 +36,11 @@ class DLL_EXPORT SecureSession
 {
 public:
     SecureSession();
-    SecureSession(SecureSession &&)      = default;
-    SecureSession(const SecureSession &) = default;
-    SecureSession & operator=(const SecureSession &) = default;
-    SecureSession & operator=(SecureSession &&) = default;
+    ~SecureSession();
+
+    // Copies share the key, but not the cipher context: it is set up again on first use.
+    SecureSession(const SecureSession & other);
+    SecureSession & operator=(const SecureSession & other);
 
     /**
      * @brief
@@ -87,6 +89,39 @@ public:
     CHIP_ERROR Encrypt(const uint8_t * input, size_t input_length, uint8_t * output, PacketHeader & header,
                        MessageAuthenticationCode & mac);
 
+    /**
+     * @brief
+     *   Encrypt in place a message spread over a chain of buffers, using keys
+     *   established in the secure channel. Produces the same result as encrypting
+     *   the coalesced message.
+     *
+     * @param msgBuf First buffer of the chain holding the unencrypted data
+     * @param header message header structure. Encryption type will be set on the header.
+     * @param mac - output the resulting mac
+     *
+     * @return CHIP_ERROR The result of encryption
+     */
+    CHIP_ERROR Encrypt(System::PacketBuffer * msgBuf, PacketHeader & header, MessageAuthenticationCode & mac);
+
+    /**
+     * @brief
+     *   Encrypt a message made of a prefix followed by the data of a chain of
+     *   buffers, into a contiguous output, using keys established in the secure
+     *   channel. The chain is left untouched, so that the same payload can be
+     *   encrypted for several peers.
+     *
+     * @param prefix Unencrypted data preceding the payload, such as the payload header; may be the start of output
+     * @param prefix_length Length of the prefix
+     * @param payload First buffer of the chain holding the unencrypted payload
+     * @param output Output buffer for the encrypted prefix and payload
+     * @param header message header structure. Encryption type will be set on the header.
+     * @param mac - output the resulting mac
+     *
+     * @return CHIP_ERROR The result of encryption
+     */
+    CHIP_ERROR Encrypt(const uint8_t * prefix, size_t prefix_length, const System::PacketBuffer * payload, uint8_t * output,
+                       PacketHeader & header, MessageAuthenticationCode & mac);
+
     /**
      * @brief
      *   Decrypt the input data using keys established in the secure channel
@@ -101,6 +136,20 @@ public:
     CHIP_ERROR Decrypt(const uint8_t * input, size_t input_length, uint8_t * output, const PacketHeader & header,
                        const MessageAuthenticationCode & mac);
 
+    /**
+     * @brief
+     *   Decrypt in place a message spread over a chain of buffers, using keys
+     *   established in the secure channel. The content of the chain MUST NOT be
+     *   used if decryption fails.
+     *
+     * @param msgBuf First buffer of the chain holding the encrypted data, without the MAC
+     * @param header message header structure
+     * @param mac Input mac
+     *
+     * @return CHIP_ERROR The result of decryption
+     */
+    CHIP_ERROR Decrypt(System::PacketBuffer * msgBuf, const PacketHeader & header, const MessageAuthenticationCode & mac);
+
     /**
      * @brief
      *   Memory overhead of encrypting data. The overhead is indepedent of size of
@@ -121,6 +170,11 @@ private:
     bool mKeyAvailable;
     uint8_t mKey[kAES_CCM128_Key_Length];
 
+    // Keeps mKey expanded across messages. Keyed lazily, see GetCipher().
+    Crypto::AES_CCM_Context mCipher;
+
+    CHIP_ERROR GetCipher(Crypto::AES_CCM_Context *& cipher);
+
     static CHIP_ERROR GetIV(const PacketHeader & header, uint8_t * iv, size_t len);
 
     // Use unencrypted header as additional authenticated data (AAD) during encryption and decryption.
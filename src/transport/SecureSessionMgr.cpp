@@ -54,6 +54,36 @@ using Transport::PeerConnectionState;
 // TODO: this should be checked within the transport message sending instead of the session management layer.
 static const size_t kMax_SecureSDU_Length = 1024;
 
+namespace {
+
+// Shortens a buffer chain to `length` bytes. Segments past the end are left empty.
+void TruncateChain(PacketBuffer * head, uint16_t length)
+{
+    for (PacketBuffer * buffer = head; buffer != nullptr; buffer = buffer->Next())
+    {
+        const uint16_t count = (buffer->DataLength() < length) ? buffer->DataLength() : length;
+
+        buffer->SetDataLength(count, head);
+        length = static_cast<uint16_t>(length - count);
+    }
+}
+
+// Returns true if every segment of a buffer chain can be decrypted in place.
+bool IsChainInline(const PacketBuffer * buffer)
+{
+    for (; buffer != nullptr; buffer = buffer->Next())
+    {
+        if (!buffer->IsDataInline())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
 SecureSessionMgr::SecureSessionMgr() : mState(State::kNotReady) {}
 
 SecureSessionMgr::~SecureSessionMgr()
@@ -94,14 +124,25 @@ CHIP_ERROR SecureSessionMgr::SendMessage(NodeId peerNodeId, System::PacketBuffer
 
 CHIP_ERROR SecureSessionMgr::SendMessage(PayloadHeader & payloadHeader, NodeId peerNodeId, System::PacketBufferHandle msgBuf)
 {
-    CHIP_ERROR err              = CHIP_NO_ERROR;
-    PeerConnectionState * state = mPeerConnections.FindPeerConnectionState(peerNodeId, nullptr);
+    return EncryptAndSendMessage(payloadHeader, peerNodeId, std::move(msgBuf), nullptr);
+}
+
+CHIP_ERROR SecureSessionMgr::SendSharedMessage(PayloadHeader & payloadHeader, NodeId peerNodeId, const PacketBufferHandle & payload)
+{
+    return EncryptAndSendMessage(payloadHeader, peerNodeId, PacketBufferHandle(), payload.Get_ForNow());
+}
+
+CHIP_ERROR SecureSessionMgr::EncryptAndSendMessage(PayloadHeader & payloadHeader, NodeId peerNodeId, PacketBufferHandle msgBuf,
+                                                   const PacketBuffer * sharedPayload)
+{
+    CHIP_ERROR err               = CHIP_NO_ERROR;
+    PeerConnectionState * state  = mPeerConnections.FindPeerConnectionState(peerNodeId, nullptr);
+    const PacketBuffer * payload = (sharedPayload != nullptr) ? sharedPayload : msgBuf.Get_ForNow();
 
     VerifyOrExit(mState == State::kInitialized, err = CHIP_ERROR_INCORRECT_STATE);
 
-    VerifyOrExit(!msgBuf.IsNull(), err = CHIP_ERROR_INVALID_ARGUMENT);
-    VerifyOrExit(msgBuf->Next() == nullptr, err = CHIP_ERROR_INVALID_MESSAGE_LENGTH);
-    VerifyOrExit(msgBuf->TotalLength() < kMax_SecureSDU_Length, err = CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+    VerifyOrExit(payload != nullptr, err = CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(payload->TotalLength() < kMax_SecureSDU_Length, err = CHIP_ERROR_INVALID_MESSAGE_LENGTH);
 
     // Find an active connection to the specified peer node
     VerifyOrExit(state != nullptr, err = CHIP_ERROR_INVALID_DESTINATION_NODE_ID);
@@ -110,20 +151,20 @@ CHIP_ERROR SecureSessionMgr::SendMessage(PayloadHeader & payloadHeader, NodeId p
     mPeerConnections.MarkConnectionActive(state);
 
     {
-        uint8_t * data = nullptr;
         PacketHeader packetHeader;
         MessageAuthenticationCode mac;
+        System::PacketBuffer * tail = nullptr;
+        uint8_t tag[kMaxTagLen];
 
         const uint16_t headerSize = payloadHeader.EncodeSizeBytes();
         uint16_t actualEncodedHeaderSize;
-        uint16_t totalLen = 0;
-        uint16_t taglen   = 0;
+        uint16_t taglen = 0;
         uint32_t payloadLength; // Make sure it's big enough to add two 16-bit
                                 // ints without overflowing.
-        static_assert(std::is_same<decltype(msgBuf->TotalLength()), uint16_t>::value,
+        static_assert(std::is_same<decltype(payload->TotalLength()), uint16_t>::value,
                       "Addition to generate payloadLength might overflow");
-        payloadLength = static_cast<uint32_t>(headerSize + msgBuf->TotalLength());
-        VerifyOrExit(CanCastTo<uint16_t>(payloadLength), err = CHIP_ERROR_NO_MEMORY);
+        payloadLength = static_cast<uint32_t>(headerSize + payload->TotalLength());
+        VerifyOrExit(CanCastTo<uint16_t>(payloadLength + kMaxTagLen), err = CHIP_ERROR_NO_MEMORY);
 
         packetHeader
             .SetSourceNodeId(mLocalNodeId)              //
@@ -135,23 +176,60 @@ CHIP_ERROR SecureSessionMgr::SendMessage(PayloadHeader & payloadHeader, NodeId p
 
         ChipLogProgress(Inet, "Sending msg from %llu to %llu", mLocalNodeId, peerNodeId);
 
-        VerifyOrExit(msgBuf->EnsureReservedSize(headerSize), err = CHIP_ERROR_NO_MEMORY);
+        if (sharedPayload == nullptr)
+        {
+            // The message may be a chain of buffers: it is encrypted in place, segment by segment, and
+            // transports send the chain as is.
+            VerifyOrExit(msgBuf->EnsureReservedSize(headerSize), err = CHIP_ERROR_NO_MEMORY);
 
-        msgBuf->SetStart(msgBuf->Start() - headerSize);
-        data     = msgBuf->Start();
-        totalLen = msgBuf->TotalLength();
+            msgBuf->SetStart(msgBuf->Start() - headerSize);
 
-        err = payloadHeader.Encode(data, totalLen, &actualEncodedHeaderSize);
-        SuccessOrExit(err);
+            err = payloadHeader.Encode(msgBuf->Start(), msgBuf->DataLength(), &actualEncodedHeaderSize);
+            SuccessOrExit(err);
+
+            if (msgBuf->Next() == nullptr)
+            {
+                err = state->GetSecureSession().Encrypt(msgBuf->Start(), msgBuf->DataLength(), msgBuf->Start(), packetHeader, mac);
+            }
+            else
+            {
+                err = state->GetSecureSession().Encrypt(msgBuf.Get_ForNow(), packetHeader, mac);
+            }
+        }
+        else
+        {
+            // Only the payload header and the tag are specific to this peer
+            msgBuf = PacketBuffer::NewWithAvailableSize(static_cast<uint16_t>(payloadLength + kMaxTagLen));
+            VerifyOrExit(!msgBuf.IsNull(), err = CHIP_ERROR_NO_MEMORY);
 
-        err = state->GetSecureSession().Encrypt(data, totalLen, data, packetHeader, mac);
+            err = payloadHeader.Encode(msgBuf->Start(), headerSize, &actualEncodedHeaderSize);
+            SuccessOrExit(err);
+
+            err = state->GetSecureSession().Encrypt(msgBuf->Start(), actualEncodedHeaderSize, sharedPayload, msgBuf->Start(),
+                                                    packetHeader, mac);
+            msgBuf->SetDataLength(static_cast<uint16_t>(payloadLength));
+        }
         SuccessOrExit(err);
 
-        err = mac.Encode(packetHeader, &data[totalLen], kMaxTagLen, &taglen);
+        err = mac.Encode(packetHeader, tag, sizeof(tag), &taglen);
         SuccessOrExit(err);
 
-        VerifyOrExit(CanCastTo<uint16_t>(totalLen + taglen), err = CHIP_ERROR_INTERNAL);
-        msgBuf->SetDataLength(static_cast<uint16_t>(totalLen + taglen), nullptr);
+        // Append the tag to the last segment, or to a segment of its own if it does not fit.
+        for (tail = msgBuf.Get_ForNow(); tail->Next() != nullptr; tail = tail->Next())
+        {
+        }
+
+        if (tail->AvailableDataLength() < taglen)
+        {
+            System::PacketBufferHandle tagBuf = System::PacketBuffer::NewWithAvailableSize(0, taglen);
+            VerifyOrExit(!tagBuf.IsNull(), err = CHIP_ERROR_NO_MEMORY);
+
+            tail = tagBuf.Get_ForNow();
+            msgBuf->AddToEnd(std::move(tagBuf));
+        }
+
+        memcpy(tail->Start() + tail->DataLength(), tag, taglen);
+        tail->SetDataLength(static_cast<uint16_t>(tail->DataLength() + taglen), msgBuf.Get_ForNow());
 
         ChipLogDetail(Inet, "Secure transport transmitting msg %u after encryption", state->GetSendMessageIndex());
 
@@ -161,7 +239,7 @@ CHIP_ERROR SecureSessionMgr::SendMessage(PayloadHeader & payloadHeader, NodeId p
     state->IncrementSendMessageIndex();
 
 exit:
-    if (!msgBuf.IsNull())
+    if (err != CHIP_NO_ERROR)
     {
         const char * errStr = ErrorStr(err);
         if (state == nullptr)
@@ -170,7 +248,7 @@ exit:
         }
         else
         {
-            ChipLogError(Inet, "Secure transport failed to encrypt msg %u: %s", state->GetSendMessageIndex(), errStr);
+            ChipLogError(Inet, "Secure transport failed to send msg %u: %s", state->GetSendMessageIndex(), errStr);
         }
     }
 
@@ -202,6 +280,7 @@ CHIP_ERROR SecureSessionMgr::NewPairing(const Optional<Transport::PeerAddress> &
     if (peerAddr.HasValue() && peerAddr.Value().GetIPAddress() != Inet::IPAddress::Any)
     {
         state->SetPeerAddress(peerAddr.Value());
+        ScheduleExpiryTimer();
     }
     else if (peerAddr.HasValue() &&
              (peerAddr.Value().GetTransportType() == Transport::Type::kTcp ||
@@ -254,6 +333,7 @@ void SecureSessionMgr::HandleNodeIdResolve(CHIP_ERROR error, NodeId nodeId, cons
         }
         if (hasAddressUpdate)
         {
+            ScheduleExpiryTimer();
             mCB->OnAddressResolved(CHIP_NO_ERROR, nodeId, this);
         }
     }
@@ -261,10 +341,32 @@ void SecureSessionMgr::HandleNodeIdResolve(CHIP_ERROR error, NodeId nodeId, cons
 
 void SecureSessionMgr::ScheduleExpiryTimer()
 {
-    CHIP_ERROR err =
-        mSystemLayer->StartTimer(CHIP_PEER_CONNECTION_TIMEOUT_CHECK_FREQUENCY_MS, SecureSessionMgr::ExpiryTimerCallback, this);
+#if CHIP_CONFIG_SESSION_REKEYING
+    // Only wake up once the least recently active connection is due, but no more
+    // often than the check frequency so that expiries close in time are batched.
+    Optional<uint64_t> delayMs = mPeerConnections.GetTimeUntilNextExpiryMs(CHIP_PEER_CONNECTION_TIMEOUT_MS);
+
+    if (!delayMs.HasValue())
+    {
+        CancelExpiryTimer(); // nothing can expire until a connection gets an address
+        return;
+    }
+
+    uint64_t timeoutMs = delayMs.Value();
+
+    if (timeoutMs < CHIP_PEER_CONNECTION_TIMEOUT_CHECK_FREQUENCY_MS)
+    {
+        timeoutMs = CHIP_PEER_CONNECTION_TIMEOUT_CHECK_FREQUENCY_MS;
+    }
+    else if (timeoutMs > UINT32_MAX)
+    {
+        timeoutMs = UINT32_MAX;
+    }
+
+    CHIP_ERROR err = mSystemLayer->StartTimer(static_cast<uint32_t>(timeoutMs), SecureSessionMgr::ExpiryTimerCallback, this);
 
     VerifyOrDie(err == CHIP_NO_ERROR);
+#endif // CHIP_CONFIG_SESSION_REKEYING
 }
 
 void SecureSessionMgr::CancelExpiryTimer()
@@ -281,7 +383,6 @@ void SecureSessionMgr::OnMessageReceived(const PacketHeader & packetHeader, cons
     CHIP_ERROR err = CHIP_NO_ERROR;
     PeerConnectionState * state =
         mPeerConnections.FindPeerConnectionState(packetHeader.GetSourceNodeId(), packetHeader.GetEncryptionKeyID(), nullptr);
-    PacketBufferHandle origMsg;
 
     VerifyOrExit(!msg.IsNull(), ChipLogError(Inet, "Secure transport received NULL packet, discarding"));
 
@@ -291,9 +392,19 @@ void SecureSessionMgr::OnMessageReceived(const PacketHeader & packetHeader, cons
         ExitNow(err = CHIP_ERROR_KEY_NOT_FOUND_FROM_PEER);
     }
 
+    // Retransmissions of messages already received are dropped before any
+    // decryption. They are expected, so the application is not notified.
+    if (state->GetReceiveWindow().VerifyCounter(packetHeader.GetMessageId()) != CHIP_NO_ERROR)
+    {
+        ChipLogDetail(Inet, "Dropping duplicate message %" PRIu32 " on key %d", packetHeader.GetMessageId(),
+                      packetHeader.GetEncryptionKeyID());
+        ExitNow();
+    }
+
     if (!state->GetPeerAddress().IsInitialized())
     {
         state->SetPeerAddress(peerAddress);
+        ScheduleExpiryTimer();
     }
 
     mPeerConnections.MarkConnectionActive(state);
@@ -303,41 +414,64 @@ void SecureSessionMgr::OnMessageReceived(const PacketHeader & packetHeader, cons
         PayloadHeader payloadHeader;
         MessageAuthenticationCode mac;
 
-        uint8_t * data       = msg->Start();
-        uint8_t * plainText  = nullptr;
+        uint8_t tag[kMaxTagLen];
         uint16_t len         = msg->TotalLength();
         uint16_t headerSize  = 0;
         uint16_t decodedSize = 0;
         uint16_t taglen      = 0;
         uint16_t payloadlen  = 0;
 
-#if CHIP_SYSTEM_CONFIG_USE_LWIP
-        /* This is a workaround for the case where PacketBuffer payload is not
-           allocated as an inline buffer to PacketBuffer structure */
-        origMsg = std::move(msg);
-        msg     = PacketBuffer::NewWithAvailableSize(len);
-        VerifyOrExit(!msg.IsNull(), ChipLogError(Inet, "Insufficient memory for packet buffer."));
-        msg->SetDataLength(len);
-#endif
-        plainText = msg->Start();
-
         payloadlen = packetHeader.GetPayloadLength();
         VerifyOrExit(
             payloadlen <= len,
             (ChipLogError(Inet, "Secure transport can't find MAC Tag; buffer too short"), err = CHIP_ERROR_INVALID_MESSAGE_LENGTH));
-        err = mac.Decode(packetHeader, &data[payloadlen], static_cast<uint16_t>(len - payloadlen), &taglen);
+
+        // The MAC follows the payload, and may be split over several buffers of a chain
+        len = msg->Read(payloadlen, tag, sizeof(tag));
+        err = mac.Decode(packetHeader, tag, len, &taglen);
         VerifyOrExit(err == CHIP_NO_ERROR, ChipLogError(Inet, "Secure transport failed to decode MAC Tag: err %d", err));
-        len = static_cast<uint16_t>(len - taglen);
-        msg->SetDataLength(len, nullptr);
+        len = static_cast<uint16_t>(msg->TotalLength() - taglen);
+        TruncateChain(msg.Get_ForNow(), len);
 
-        err = state->GetSecureSession().Decrypt(data, len, plainText, packetHeader, mac);
+        if (!IsChainInline(msg.Get_ForNow()))
+        {
+            // Data that LwIP references rather than owns can not be decrypted in place
+            PacketBufferHandle copy = PacketBuffer::NewWithAvailableSize(len);
+            VerifyOrExit(!copy.IsNull(), ChipLogError(Inet, "Insufficient memory for packet buffer."));
+            copy->SetDataLength(msg->Read(0, copy->Start(), len));
+            msg = std::move(copy);
+        }
+
+        // Decrypt in place, so receiving does not need another buffer
+        if (msg->Next() == nullptr)
+        {
+            err = state->GetSecureSession().Decrypt(msg->Start(), len, msg->Start(), packetHeader, mac);
+        }
+        else
+        {
+            err = state->GetSecureSession().Decrypt(msg.Get_ForNow(), packetHeader, mac);
+        }
         VerifyOrExit(err == CHIP_NO_ERROR, ChipLogError(Inet, "Secure transport failed to decrypt msg: err %d", err));
 
-        err        = payloadHeader.Decode(plainText, len, &decodedSize);
-        headerSize = payloadHeader.EncodeSizeBytes();
+        // Only an authenticated message may move the window forward
+        state->GetReceiveWindow().CommitCounter(packetHeader.GetMessageId());
+
+        // The payload header may be split over several buffers of a chain
+        {
+            uint8_t headerBytes[kMaxPayloadHeaderLen];
+
+            len        = msg->Read(0, headerBytes, sizeof(headerBytes));
+            err        = payloadHeader.Decode(headerBytes, len, &decodedSize);
+            headerSize = payloadHeader.EncodeSizeBytes();
+        }
         VerifyOrExit(err == CHIP_NO_ERROR, ChipLogError(Inet, "Secure transport failed to decode encrypted header: err %d", err));
         VerifyOrExit(headerSize == decodedSize, ChipLogError(Inet, "Secure transport decode encrypted header length mismatched"));
 
+        while (headerSize > msg->DataLength() && msg->Next() != nullptr)
+        {
+            headerSize = static_cast<uint16_t>(headerSize - msg->DataLength());
+            msg.FreeHead();
+        }
         msg->ConsumeHead(headerSize);
 
         if (state->GetPeerNodeId() == kUndefinedNodeId && packetHeader.GetSourceNodeId().HasValue())
@@ -381,9 +515,9 @@ void SecureSessionMgr::ExpiryTimerCallback(System::Layer * layer, void * param,
     // the #ifdef should be removed after that.
     mgr->mPeerConnections.ExpireInactiveConnections(
         CHIP_PEER_CONNECTION_TIMEOUT_MS,
-        [this](const Transport::PeerConnectionState & state1) { HandleConnectionExpired(state1); });
+        [mgr](const Transport::PeerConnectionState & state1) { mgr->HandleConnectionExpired(state1); });
 #endif
-    mgr->ScheduleExpiryTimer(); // re-schedule the oneshot timer
+    mgr->ScheduleExpiryTimer(); // re-schedule the oneshot timer for the next connection due
 }
 
 } // namespace chip
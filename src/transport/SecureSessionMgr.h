@@ -120,6 +120,20 @@ public:
      */
     CHIP_ERROR SendMessage(NodeId peerNodeId, System::PacketBufferHandle msgBuf);
     CHIP_ERROR SendMessage(PayloadHeader & payloadHeader, NodeId peerNodeId, System::PacketBufferHandle msgBuf);
+
+    /**
+     * @brief
+     *   Send a payload shared by several messages to a currently connected peer.
+     *
+     * @details
+     *   Unlike SendMessage, which encrypts the message in place, the payload is
+     *   left untouched and encrypted straight into a buffer holding this peer's
+     *   message, so that the same payload can be sent to many peers without
+     *   copying it for each of them first. The payload may be a chain of buffers,
+     *   but the message sent must fit in a single buffer.
+     */
+    CHIP_ERROR SendSharedMessage(PayloadHeader & payloadHeader, NodeId peerNodeId, const System::PacketBufferHandle & payload);
+
     SecureSessionMgr();
     ~SecureSessionMgr() override;
 
@@ -183,13 +197,30 @@ private:
 
     System::Layer * mSystemLayer = nullptr;
     NodeId mLocalNodeId;                                                                // < Id of the current node
+#if CHIP_CONFIG_PEER_CONNECTION_POOL_DYNAMIC
+    Transport::DynamicPeerConnections<> mPeerConnections; // < Active connections to other peers
+#else
     Transport::PeerConnections<CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE> mPeerConnections; // < Active connections to other peers
+#endif
     State mState;                                                                       // < Initialization state of the object
 
     SecureSessionMgrDelegate * mCB   = nullptr;
     TransportMgrBase * mTransportMgr = nullptr;
 
-    /** Schedules a new oneshot timer for checking connection expiry. */
+    /**
+     * Encrypts a message and sends it to a currently connected peer.
+     *
+     * When sharedPayload is null, msgBuf holds the payload and is encrypted in
+     * place. Otherwise msgBuf is null, and the message is encrypted into a new
+     * buffer, leaving sharedPayload untouched.
+     */
+    CHIP_ERROR EncryptAndSendMessage(PayloadHeader & payloadHeader, NodeId peerNodeId, System::PacketBufferHandle msgBuf,
+                                     const System::PacketBuffer * sharedPayload);
+
+    /**
+     * Schedules a new oneshot timer for when the least recently active connection
+     * expires. No timer runs while no connection can expire.
+     */
     void ScheduleExpiryTimer();
 
     /** Cancels any active timers for connection expiry checks. */
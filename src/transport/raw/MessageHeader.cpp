@@ -77,6 +77,10 @@ constexpr size_t kVendorIdSizeBytes = 2;
 /// size of a serialized ack id inside a header
 constexpr size_t kAckIdSizeBytes = 4;
 
+static_assert(kFixedUnencryptedHeaderSizeBytes + 2 * kNodeIdSizeBytes == kMaxPacketHeaderLen, "kMaxPacketHeaderLen is stale");
+static_assert(kEncryptedHeaderSizeBytes + kVendorIdSizeBytes + kAckIdSizeBytes == kMaxPayloadHeaderLen,
+              "kMaxPayloadHeaderLen is stale");
+
 /// Mask to extract just the version part from a 16bit header prefix.
 constexpr uint16_t kVersionMask = 0xF000;
 /// Shift to convert to/from a masked version 16bit value to a 4bit version.
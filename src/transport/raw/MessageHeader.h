@@ -39,6 +39,10 @@ static constexpr NodeId kUndefinedNodeId = 0ULL;
 static constexpr NodeId kAnyNodeId       = 0xFFFFFFFFFFFFFFFFULL;
 static constexpr size_t kMaxTagLen       = 16;
 
+/// Largest encoded sizes of the packet and payload headers, see EncodeSizeBytes
+static constexpr size_t kMaxPacketHeaderLen  = 26;
+static constexpr size_t kMaxPayloadHeaderLen = 12;
+
 typedef int PacketHeaderFlags;
 
 namespace Header {
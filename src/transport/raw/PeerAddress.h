@@ -28,6 +28,7 @@
 #include <core/CHIPConfig.h>
 #include <inet/IPAddress.h>
 #include <inet/InetInterface.h>
+#include <support/HashUtils.h>
 
 namespace chip {
 namespace Transport {
@@ -105,6 +106,22 @@ public:
 
     bool operator!=(const PeerAddress & other) const { return !(*this == other); }
 
+    /**
+     * Hash of the address, for looking it up in hash tables. The interface is left out: it is not a plain integer on
+     * every platform, and addresses differing only by interface are rare enough to share a chain.
+     */
+    uint32_t Hash() const
+    {
+        uint32_t hash = HashMix(static_cast<uint32_t>(mTransportType));
+
+        for (uint32_t word : mIPAddress.Addr)
+        {
+            hash = HashCombine(hash, word);
+        }
+
+        return HashCombine(hash, mPort);
+    }
+
     /// Maximum size of an Inet address ToString format, that can hold both IPV6 and IPV4 addresses.
 #ifdef INET6_ADDRSTRLEN
     static constexpr size_t kInetMaxAddrLen = INET6_ADDRSTRLEN;
@@ -29,6 +29,7 @@
 #include <support/CodeUtils.h>
 #include <support/ReturnMacros.h>
 #include <support/logging/CHIPLogging.h>
+#include <system/SystemClock.h>
 #include <transport/raw/MessageHeader.h>
 
 #include <inttypes.h>
@@ -45,25 +46,98 @@ constexpr size_t kPacketSizeBytes = 2;
 constexpr int kListenBacklogSize = 2;
 
 /**
- *  Determine if the given buffer contains a complete message
+ * Consume the first `length` bytes of a buffer chain, freeing the buffers
+ * emptied but the last one.
  */
-bool ContainsCompleteMessage(const System::PacketBufferHandle & buffer, uint8_t ** start, uint16_t * size)
+void ConsumeFromChain(System::PacketBufferHandle & chain, uint16_t length)
 {
-    bool completeMessage = false;
+    while (length > chain->DataLength() && chain->Next() != nullptr)
+    {
+        length = static_cast<uint16_t>(length - chain->DataLength());
+        chain.FreeHead();
+    }
+
+    chain->ConsumeHead(length);
+}
+
+/**
+ * Move the first `length` bytes of a buffer chain, which spans more than its
+ * head, into a chain of their own.
+ *
+ * Whole buffers are moved as they are. The buffer holding the last bytes of
+ * the message and the first bytes of what follows is shared by copying the
+ * smaller of the two parts into a new buffer, so data is never copied more than
+ * once and at most one buffer's worth per message.
+ *
+ * @return the new chain, or a null handle if no buffer was available for the copy,
+ *         in which case the chain is left untouched.
+ */
+System::PacketBufferHandle SplitChain(System::PacketBufferHandle & chain, uint16_t length)
+{
+    System::PacketBufferHandle split;
+    System::PacketBufferHandle copy;
+    const System::PacketBuffer * boundary = chain.Get_ForNow();
+    uint16_t boundaryOffset               = length;
 
-    if (buffer->DataLength() >= kPacketSizeBytes)
+    // Find the buffer the message ends in
+    while (boundaryOffset > boundary->DataLength())
     {
-        *size           = LittleEndian::Get16(buffer->Start());
-        *start          = buffer->Start() + kPacketSizeBytes;
-        completeMessage = (buffer->DataLength() >= *size + kPacketSizeBytes);
+        boundaryOffset = static_cast<uint16_t>(boundaryOffset - boundary->DataLength());
+        boundary       = boundary->Next();
     }
 
-    if (!completeMessage)
+    const uint16_t following   = static_cast<uint16_t>(boundary->DataLength() - boundaryOffset);
+    const bool copyMessagePart = (boundaryOffset <= following);
+
+    if (following > 0)
     {
-        *start = nullptr;
+        // Allocate first, so failing leaves the chain as it was
+        copy = System::PacketBuffer::NewWithAvailableSize(0, copyMessagePart ? boundaryOffset : following);
+        if (copy.IsNull())
+        {
+            return System::PacketBufferHandle();
+        }
+    }
+
+    split = chain.PopHead();
+    for (uint16_t moved = split->DataLength(); moved < length;)
+    {
+        if (chain.Get_ForNow() == boundary && following > 0)
+        {
+            break;
+        }
+
+        moved = static_cast<uint16_t>(moved + chain->DataLength());
+        split->AddToEnd(chain.PopHead());
     }
 
-    return completeMessage;
+    if (following > 0)
+    {
+        if (copyMessagePart)
+        {
+            memcpy(copy->Start(), chain->Start(), boundaryOffset);
+            copy->SetDataLength(boundaryOffset);
+            chain->ConsumeHead(boundaryOffset);
+            split->AddToEnd(std::move(copy));
+        }
+        else
+        {
+            System::PacketBufferHandle tail = chain.PopHead();
+
+            memcpy(copy->Start(), tail->Start() + boundaryOffset, following);
+            copy->SetDataLength(following);
+            tail->SetDataLength(boundaryOffset);
+            split->AddToEnd(std::move(tail));
+
+            if (!chain.IsNull())
+            {
+                copy->AddToEnd(std::move(chain));
+            }
+            chain = std::move(copy);
+        }
+    }
+
+    return split;
 }
 
 } // namespace
@@ -77,29 +151,40 @@ TCPBase::~TCPBase()
         mListenSocket = nullptr;
     }
 
+    if (mFlushScheduled)
+    {
+        mSystemLayer->CancelTimer(OnFlushTimer, this);
+        mFlushScheduled = false;
+    }
+
     CloseActiveConnections();
+}
 
-    for (size_t i = 0; i < mPendingPacketsSize; i++)
+void TCPBase::CloseActiveConnections()
+{
+    for (size_t i = 0; i < mActiveConnectionsSize; i++)
     {
-        if (mPendingPackets[i].packetBuffer != nullptr)
+        if (mActiveConnections[i].mInUse)
         {
-            System::PacketBuffer::Free(mPendingPackets[i].packetBuffer);
-            mPendingPackets[i].packetBuffer = nullptr;
+            ReleaseConnection(&mActiveConnections[i]);
         }
     }
 }
 
-void TCPBase::CloseActiveConnections()
+TCPConnectionStatistics TCPBase::GetStatistics() const
 {
+    TCPConnectionStatistics statistics = mStatistics;
+
+    // The writes of the open connections are still counted by their end points
     for (size_t i = 0; i < mActiveConnectionsSize; i++)
     {
-        if (mActiveConnections[i] != nullptr)
+        if (mActiveConnections[i].mInUse && mActiveConnections[i].mEndPoint != nullptr)
         {
-            mActiveConnections[i]->Free();
-            mActiveConnections[i] = nullptr;
-            mUsedEndPointCount--;
+            statistics.mWrites += mActiveConnections[i].mEndPoint->GetWriteCount();
         }
     }
+
+    return statistics;
 }
 
 CHIP_ERROR TCPBase::Init(TcpListenParameters & params)
@@ -107,6 +192,7 @@ CHIP_ERROR TCPBase::Init(TcpListenParameters & params)
     CHIP_ERROR err = CHIP_NO_ERROR;
 
     VerifyOrExit(mState == State::kNotReady, err = CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrExit(params.GetMaxPendingPacketsPerPeer() > 0, err = CHIP_ERROR_INVALID_ARGUMENT);
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
     err = params.GetInetLayer()->NewTCPEndPoint(&mListenSocket);
@@ -129,6 +215,12 @@ CHIP_ERROR TCPBase::Init(TcpListenParameters & params)
     mListenSocket->OnAcceptError        = OnAcceptError;
     mEndpointType                       = params.GetAddressType();
 
+    mMaxPendingPacketsPerPeer = params.GetMaxPendingPacketsPerPeer();
+    mSystemLayer              = params.GetInetLayer()->SystemLayer();
+    mWriteCoalescing          = params.IsWriteCoalescingEnabled();
+    mWriteCoalescingDelayMs   = params.GetWriteCoalescingDelayMs();
+    mWriteCoalescingThreshold = params.GetWriteCoalescingThreshold();
+
     mState = State::kInitialized;
 
 exit:
@@ -145,32 +237,237 @@ exit:
     return err;
 }
 
-Inet::TCPEndPoint * TCPBase::FindActiveConnection(const PeerAddress & address)
+ActiveTCPConnectionState ** TCPBase::Bucket(const PeerAddress & address) const
+{
+    return &mBuckets[address.Hash() & (mBucketCount - 1)];
+}
+
+ActiveTCPConnectionState * TCPBase::FindActiveConnection(const PeerAddress & address)
 {
     if (address.GetTransportType() != Type::kTcp)
     {
         return nullptr;
     }
 
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
+    for (ActiveTCPConnectionState * connection = *Bucket(address); connection != nullptr; connection = connection->mNext)
     {
-        if (mActiveConnections[i] == nullptr)
+        // Like connections reported by end points, which know no interface, match on IP address and port only
+        if ((connection->mPeerAddress.GetIPAddress() == address.GetIPAddress()) &&
+            (connection->mPeerAddress.GetPort() == address.GetPort()))
         {
-            continue;
+            return connection;
         }
-        Inet::IPAddress addr;
-        uint16_t port;
-        mActiveConnections[i]->GetPeerInfo(&addr, &port);
+    }
+
+    return nullptr;
+}
 
-        if ((addr == address.GetIPAddress()) && (port == address.GetPort()))
+ActiveTCPConnectionState ** TCPBase::EndPointBucket(const Inet::TCPEndPoint * endPoint) const
+{
+    // End points come from a pool, so consecutive ones fall in consecutive buckets
+    return &mEndPointBuckets[(reinterpret_cast<uintptr_t>(endPoint) / sizeof(Inet::TCPEndPoint)) & (mBucketCount - 1)];
+}
+
+ActiveTCPConnectionState * TCPBase::FindActiveConnection(const Inet::TCPEndPoint * endPoint)
+{
+    for (ActiveTCPConnectionState * connection = *EndPointBucket(endPoint); connection != nullptr;
+         connection                            = connection->mNextByEndPoint)
+    {
+        if (connection->mEndPoint == endPoint)
         {
-            return mActiveConnections[i];
+            return connection;
         }
     }
 
     return nullptr;
 }
 
+void TCPBase::SetEndPoint(ActiveTCPConnectionState * connection, Inet::TCPEndPoint * endPoint)
+{
+    ActiveTCPConnectionState ** bucket = EndPointBucket(endPoint);
+
+    connection->mEndPoint       = endPoint;
+    connection->mNextByEndPoint = *bucket;
+    *bucket                     = connection;
+}
+
+bool TCPBase::QueuePendingPacket(ActiveTCPConnectionState * connection, System::PacketBuffer * msg)
+{
+    PendingTCPPacket * packet = mFreePendingPackets;
+
+    if (packet == nullptr || connection->mPendingCount >= mMaxPendingPacketsPerPeer)
+    {
+        return false;
+    }
+
+    mFreePendingPackets = packet->mNext;
+    packet->mPacket     = msg;
+    packet->mNext       = nullptr;
+
+    if (connection->mPendingTail != nullptr)
+    {
+        connection->mPendingTail->mNext = packet;
+    }
+    else
+    {
+        connection->mPendingHead = packet;
+    }
+    connection->mPendingTail = packet;
+    connection->mPendingCount++;
+
+    return true;
+}
+
+ActiveTCPConnectionState * TCPBase::AllocateConnection(const PeerAddress & address)
+{
+    if (mFreeConnections == nullptr)
+    {
+        // Evict the connection idle for the longest time, skipping those still sending data
+        ActiveTCPConnectionState * victim = mOldest;
+        while (victim != nullptr && victim->mEndPoint->PendingSendLength() != 0)
+        {
+            victim = victim->mNewer;
+        }
+        if (victim == nullptr)
+        {
+            return nullptr;
+        }
+
+        ChipLogProgress(Inet, "Evicting idle TCP connection to make room for a new one");
+        mStatistics.mEvicted++;
+        ReleaseConnection(victim);
+    }
+
+    ActiveTCPConnectionState * connection = mFreeConnections;
+    ActiveTCPConnectionState ** bucket    = Bucket(address);
+
+    mFreeConnections         = connection->mNext;
+    connection->mPeerAddress = address;
+    connection->mInUse       = true;
+    connection->mNext        = *bucket;
+    *bucket                  = connection;
+    mUsedConnectionCount++;
+
+    return connection;
+}
+
+void TCPBase::ReleaseConnection(ActiveTCPConnectionState * connection)
+{
+    ActiveTCPConnectionState ** link = Bucket(connection->mPeerAddress);
+
+    while (*link != connection)
+    {
+        link = &(*link)->mNext;
+    }
+    *link = connection->mNext;
+
+    if (connection->mConnected)
+    {
+        UnlinkFromActivityList(connection);
+        mStatistics.mClosed++;
+        mStatistics.mLifetimeMs += System::Platform::Layer::GetClock_MonotonicMS() - connection->mEstablishedTimeMs;
+    }
+
+    while (connection->mPendingHead != nullptr)
+    {
+        PendingTCPPacket * packet = connection->mPendingHead;
+
+        connection->mPendingHead = packet->mNext;
+        System::PacketBuffer::Free(packet->mPacket);
+        packet->mPacket     = nullptr;
+        packet->mNext       = mFreePendingPackets;
+        mFreePendingPackets = packet;
+    }
+
+    if (connection->mEndPoint != nullptr)
+    {
+        link = EndPointBucket(connection->mEndPoint);
+        while (*link != connection)
+        {
+            link = &(*link)->mNextByEndPoint;
+        }
+        *link = connection->mNextByEndPoint;
+
+        mStatistics.mWrites += connection->mEndPoint->GetWriteCount();
+
+        // NOTE: this leaves the socket in TIME_WAIT.
+        // Calling Abort() would clean it since SO_LINGER would be set to 0,
+        // however this seems not to be useful.
+        connection->mEndPoint->Free();
+    }
+
+    connection->mEndPoint       = nullptr;
+    connection->mPeerAddress    = PeerAddress::Uninitialized();
+    connection->mPendingTail    = nullptr;
+    connection->mPendingCount   = 0;
+    connection->mCoalescedBytes = 0;
+    connection->mInUse          = false;
+    connection->mConnected      = false;
+    connection->mNext           = mFreeConnections;
+    connection->mNextByEndPoint = nullptr;
+    mFreeConnections            = connection;
+    mUsedConnectionCount--;
+}
+
+void TCPBase::MarkConnected(ActiveTCPConnectionState * connection)
+{
+    connection->mConnected         = true;
+    connection->mEstablishedTimeMs = System::Platform::Layer::GetClock_MonotonicMS();
+    connection->mOlder             = mNewest;
+    connection->mNewer             = nullptr;
+
+    if (mNewest != nullptr)
+    {
+        mNewest->mNewer = connection;
+    }
+    else
+    {
+        mOldest = connection;
+    }
+    mNewest = connection;
+
+    mStatistics.mOpened++;
+}
+
+void TCPBase::MarkActive(ActiveTCPConnectionState * connection)
+{
+    if (connection == mNewest)
+    {
+        return;
+    }
+
+    UnlinkFromActivityList(connection);
+
+    connection->mOlder = mNewest;
+    connection->mNewer = nullptr;
+    mNewest->mNewer    = connection;
+    mNewest            = connection;
+}
+
+void TCPBase::UnlinkFromActivityList(ActiveTCPConnectionState * connection)
+{
+    if (connection->mOlder != nullptr)
+    {
+        connection->mOlder->mNewer = connection->mNewer;
+    }
+    else
+    {
+        mOldest = connection->mNewer;
+    }
+
+    if (connection->mNewer != nullptr)
+    {
+        connection->mNewer->mOlder = connection->mOlder;
+    }
+    else
+    {
+        mNewest = connection->mOlder;
+    }
+
+    connection->mOlder = nullptr;
+    connection->mNewer = nullptr;
+}
+
 CHIP_ERROR TCPBase::SendMessage(const PacketHeader & header, const Transport::PeerAddress & address, System::PacketBuffer * msgBuf)
 {
     System::PacketBufferHandle autofree;
@@ -184,19 +481,20 @@ CHIP_ERROR TCPBase::SendMessage(const PacketHeader & header, const Transport::Pe
 
     VerifyOrReturnError(address.GetTransportType() == Type::kTcp, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(mState == State::kInitialized, CHIP_ERROR_INCORRECT_STATE);
-    VerifyOrReturnError(prefixSize + msgBuf->DataLength() <= std::numeric_limits<uint16_t>::max(), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(prefixSize + msgBuf->TotalLength() <= std::numeric_limits<uint16_t>::max(), CHIP_ERROR_INVALID_ARGUMENT);
 
-    // The check above about prefixSize + msgBuf->DataLength() means prefixSize
+    // The check above about prefixSize + msgBuf->TotalLength() means prefixSize
     // definitely fits in uint16_t.
     VerifyOrReturnError(msgBuf->EnsureReservedSize(static_cast<uint16_t>(prefixSize)), CHIP_ERROR_NO_MEMORY);
 
     msgBuf->SetStart(msgBuf->Start() - prefixSize);
 
-    // Length is actual data, without considering the length bytes themselves
-    VerifyOrReturnError(msgBuf->DataLength() >= kPacketSizeBytes, CHIP_ERROR_INTERNAL);
+    // Length is actual data, without considering the length bytes themselves. The message may be
+    // a chain of buffers, which the end point sends without coalescing.
+    VerifyOrReturnError(msgBuf->TotalLength() >= kPacketSizeBytes, CHIP_ERROR_INTERNAL);
 
     uint8_t * output = msgBuf->Start();
-    LittleEndian::Write16(output, static_cast<uint16_t>(msgBuf->DataLength() - kPacketSizeBytes));
+    LittleEndian::Write16(output, static_cast<uint16_t>(msgBuf->TotalLength() - kPacketSizeBytes));
 
     uint16_t actualEncodedHeaderSize;
     ReturnErrorOnFailure(header.Encode(output, msgBuf->DataLength(), &actualEncodedHeaderSize));
@@ -206,11 +504,19 @@ CHIP_ERROR TCPBase::SendMessage(const PacketHeader & header, const Transport::Pe
 
     // Reuse existing connection if one exists, otherwise a new one
     // will be established
-    Inet::TCPEndPoint * endPoint = FindActiveConnection(address);
+    ActiveTCPConnectionState * connection = FindActiveConnection(address);
 
-    if (endPoint != nullptr)
+    if (connection != nullptr && connection->mConnected)
     {
-        return endPoint->Send(autofree.Release_ForNow());
+        mStatistics.mMessagesSent++;
+        mStatistics.mReused++;
+        MarkActive(connection);
+
+        if (mWriteCoalescing)
+        {
+            return SendCoalesced(connection, autofree.Release_ForNow());
+        }
+        return connection->mEndPoint->Send(autofree.Release_ForNow());
     }
     else
     {
@@ -218,50 +524,82 @@ CHIP_ERROR TCPBase::SendMessage(const PacketHeader & header, const Transport::Pe
     }
 }
 
-CHIP_ERROR TCPBase::SendAfterConnect(const PeerAddress & addr, System::PacketBuffer * msg)
+CHIP_ERROR TCPBase::SendCoalesced(ActiveTCPConnectionState * connection, System::PacketBuffer * msg)
 {
-    // This will initiate a connection to the specified peer
-    CHIP_ERROR err               = CHIP_NO_ERROR;
-    PendingPacket * packet       = nullptr;
-    bool alreadyConnecting       = false;
-    Inet::TCPEndPoint * endPoint = nullptr;
+    const size_t length = msg->TotalLength();
+
+    ReturnErrorOnFailure(connection->mEndPoint->Send(msg, false));
+    connection->mCoalescedBytes += length;
+    mStatistics.mCoalesced++;
 
-    // Iterate through the ENTIRE array. If a pending packet for
-    // the address already exists, this means a connection is pending and
-    // does NOT need to be re-established.
-    for (size_t i = 0; i < mPendingPacketsSize; i++)
+    if (connection->mCoalescedBytes >= mWriteCoalescingThreshold)
     {
-        if (mPendingPackets[i].packetBuffer == nullptr)
+        return FlushConnection(connection);
+    }
+
+    if (!mFlushScheduled)
+    {
+        if (mSystemLayer->StartTimer(mWriteCoalescingDelayMs, OnFlushTimer, this) != CHIP_SYSTEM_NO_ERROR)
         {
-            if (packet == nullptr)
-            {
-                // found a slot to store the packet into
-                packet = mPendingPackets + i;
-            }
+            // Without a timer to write them later, the messages have to be written now
+            return FlushConnection(connection);
         }
-        else if (mPendingPackets[i].peerAddress == addr)
-        {
-            // same destination exists.
-            alreadyConnecting = true;
+        mFlushScheduled = true;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR TCPBase::FlushConnection(ActiveTCPConnectionState * connection)
+{
+    connection->mCoalescedBytes = 0;
+    mStatistics.mFlushes++;
+
+    return connection->mEndPoint->PushSendQueue();
+}
+
+void TCPBase::OnFlushTimer(System::Layer * systemLayer, void * appState, System::Error error)
+{
+    TCPBase * tcp = reinterpret_cast<TCPBase *>(appState);
+
+    tcp->mFlushScheduled = false;
+
+    for (size_t i = 0; i < tcp->mActiveConnectionsSize; i++)
+    {
+        ActiveTCPConnectionState & connection = tcp->mActiveConnections[i];
 
-            // ensure packets are ORDERED
-            if (packet != nullptr)
+        if (connection.mInUse && connection.mCoalescedBytes > 0)
+        {
+            CHIP_ERROR err = tcp->FlushConnection(&connection);
+            if (err != CHIP_NO_ERROR)
             {
-                packet->peerAddress             = addr;
-                packet->packetBuffer            = mPendingPackets[i].packetBuffer;
-                mPendingPackets[i].packetBuffer = nullptr;
-                packet                          = mPendingPackets + i;
+                ChipLogError(Inet, "Failed to write coalesced TCP messages: %s", ErrorStr(err));
             }
         }
     }
+}
 
-    VerifyOrExit(packet != nullptr, err = CHIP_ERROR_NO_MEMORY);
+CHIP_ERROR TCPBase::SendAfterConnect(const PeerAddress & addr, System::PacketBuffer * msg)
+{
+    // This will initiate a connection to the specified peer
+    CHIP_ERROR err                        = CHIP_NO_ERROR;
+    ActiveTCPConnectionState * connection = FindActiveConnection(addr);
+    Inet::TCPEndPoint * endPoint          = nullptr;
+
+    if (connection != nullptr)
+    {
+        // A connection is pending and does NOT need to be re-established: packets are queued in order behind
+        // the ones already waiting for it, while the shared pool and the share of the peer in it last.
+        VerifyOrExit(QueuePendingPacket(connection, msg), err = CHIP_ERROR_NO_MEMORY);
+
+        msg = nullptr;
+        ExitNow();
+    }
 
-    // If already connecting, buffer was just enqueued for more sending
-    VerifyOrExit(!alreadyConnecting, err = CHIP_NO_ERROR);
+    VerifyOrExit(mFreePendingPackets != nullptr, err = CHIP_ERROR_NO_MEMORY);
 
-    // Ensures sufficient active connections size exist
-    VerifyOrExit(mUsedEndPointCount < mActiveConnectionsSize, err = CHIP_ERROR_NO_MEMORY);
+    connection = AllocateConnection(addr);
+    VerifyOrExit(connection != nullptr, err = CHIP_ERROR_NO_MEMORY);
 
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT
     err = mListenSocket->Layer().NewTCPEndPoint(&endPoint);
@@ -270,6 +608,8 @@ CHIP_ERROR TCPBase::SendAfterConnect(const PeerAddress & addr, System::PacketBuf
 #endif
     SuccessOrExit(err);
 
+    SetEndPoint(connection, endPoint);
+
     endPoint->AppState             = reinterpret_cast<void *>(this);
     endPoint->OnDataReceived       = OnTcpReceive;
     endPoint->OnConnectComplete    = OnConnectionComplete;
@@ -282,10 +622,8 @@ CHIP_ERROR TCPBase::SendAfterConnect(const PeerAddress & addr, System::PacketBuf
     SuccessOrExit(err);
 
     // enqueue the packet once the connection succeeds
-    packet->peerAddress  = addr;
-    packet->packetBuffer = msg;
-    msg                  = nullptr;
-    mUsedEndPointCount++;
+    QueuePendingPacket(connection, msg);
+    msg = nullptr;
 
 exit:
     if (err != CHIP_NO_ERROR)
@@ -295,9 +633,9 @@ exit:
             System::PacketBuffer::Free(msg);
             msg = nullptr;
         }
-        if (endPoint != nullptr)
+        if (connection != nullptr && connection->mPendingHead == nullptr)
         {
-            endPoint->Free();
+            ReleaseConnection(connection);
         }
     }
     return err;
@@ -306,9 +644,16 @@ exit:
 CHIP_ERROR TCPBase::ProcessSingleMessageFromBufferHead(const PeerAddress & peerAddress, const System::PacketBufferHandle & buffer,
                                                        uint16_t messageSize)
 {
-    CHIP_ERROR err     = CHIP_NO_ERROR;
-    uint8_t * oldStart = buffer->Start();
-    uint16_t oldLength = buffer->DataLength();
+    CHIP_ERROR err              = CHIP_NO_ERROR;
+    uint8_t * oldStart          = buffer->Start();
+    uint16_t oldLength          = buffer->DataLength();
+    System::PacketBuffer * tail = nullptr;
+
+    // Hide the rest of the chain from the receiver
+    if (buffer->Next() != nullptr)
+    {
+        tail = buffer->DetachTail_ForNow();
+    }
 
     buffer->SetDataLength(messageSize);
 
@@ -328,9 +673,48 @@ exit:
     buffer->SetStart(oldStart);
     buffer->SetDataLength(oldLength);
 
+    if (tail != nullptr)
+    {
+        buffer->AddToEnd_ForNow(tail);
+    }
+
     return err;
 }
 
+CHIP_ERROR TCPBase::ProcessSingleMessage(const PeerAddress & peerAddress, System::PacketBufferHandle message)
+{
+    uint8_t headerBytes[kMaxPacketHeaderLen];
+    uint16_t headerSize = 0;
+    PacketHeader header;
+
+    ConsumeFromChain(message, kPacketSizeBytes);
+
+    // The header may be split over several buffers
+    ReturnErrorOnFailure(header.Decode(headerBytes, message->Read(0, headerBytes, sizeof(headerBytes)), &headerSize));
+    ConsumeFromChain(message, headerSize);
+
+    if (message->Next() != nullptr)
+    {
+        message->CompactHead();
+    }
+
+    if (message->Next() != nullptr && message->TotalLength() <= CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX)
+    {
+        // The head was too small to hold the message, but a buffer of its own can
+        const uint16_t messageLength         = message->TotalLength();
+        System::PacketBufferHandle flattened = System::PacketBuffer::NewWithAvailableSize(0, messageLength);
+        VerifyOrReturnError(!flattened.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+        message->Read(0, flattened->Start(), messageLength);
+        flattened->SetDataLength(messageLength);
+        message = std::move(flattened);
+    }
+
+    HandleMessageReceived(header, peerAddress, std::move(message));
+
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR TCPBase::ProcessReceivedBuffer(Inet::TCPEndPoint * endPoint, const PeerAddress & peerAddress,
                                           System::PacketBufferHandle buffer)
 {
@@ -345,51 +729,55 @@ CHIP_ERROR TCPBase::ProcessReceivedBuffer(Inet::TCPEndPoint * endPoint, const Pe
             continue;
         }
 
-        uint8_t * messageData = nullptr;
-        uint16_t messageSize  = 0;
-        if (ContainsCompleteMessage(buffer, &messageData, &messageSize))
+        // The size, like the message, may be split over several buffers
+        uint8_t sizeBytes[kPacketSizeBytes];
+        if (buffer->Read(0, sizeBytes, kPacketSizeBytes) < kPacketSizeBytes)
         {
-            // length was read and is not needed anymore
-            buffer->ConsumeHead(kPacketSizeBytes);
-
-            // Sanity checks. These are more like an assert for invariants
-            VerifyOrExit(messageData == buffer->Start(), err = CHIP_ERROR_INTERNAL);
-            VerifyOrExit(buffer->DataLength() >= messageSize, err = CHIP_ERROR_INTERNAL);
-
-            // messagesize is always consumed once processed, even on error. This is done
-            // on purpose:
-            //   - we already consumed the packet size above
-            //   - there is no reason to believe that an error would not occur again on the
-            //     same parameters (errors are likely not transient)
-            //   - this guarantees data is received and progress is made.
-            err = ProcessSingleMessageFromBufferHead(peerAddress, buffer, messageSize);
-            buffer->ConsumeHead(messageSize);
-            SuccessOrExit(err);
-
-            err = endPoint->AckReceive(messageSize);
-            SuccessOrExit(err);
-            continue;
+            // Buffer is incomplete and we cannot get more data
+            break;
         }
 
-        // Buffer is incomplete if we reach this point
-        if (buffer->Next() != nullptr)
-        {
-            buffer->CompactHead();
-            continue;
-        }
+        const uint16_t messageSize = LittleEndian::Get16(sizeBytes);
+        const size_t frameSize     = kPacketSizeBytes + messageSize;
 
-        if (messageSize > 0)
+        if (buffer->TotalLength() < frameSize)
         {
             // Open the receive window just enough to allow the remainder of the message to be received.
             // This is necessary in the case where the message size exceeds the TCP window size to ensure
             // the peer has enough window to send us the entire message.
-            uint16_t neededLen = static_cast<uint16_t>(messageSize - buffer->DataLength());
+            uint16_t neededLen = static_cast<uint16_t>(frameSize - buffer->TotalLength());
             err                = endPoint->AckReceive(neededLen);
             SuccessOrExit(err);
+
+            // Buffer is incomplete and we cannot get more data
+            break;
+        }
+
+        // messagesize is always consumed once processed, even on error. This is done
+        // on purpose:
+        //   - there is no reason to believe that an error would not occur again on the
+        //     same parameters (errors are likely not transient)
+        //   - this guarantees data is received and progress is made.
+        if (frameSize < buffer->DataLength())
+        {
+            // More data follows in the same buffer: process the message in place
+            buffer->ConsumeHead(kPacketSizeBytes);
+            err = ProcessSingleMessageFromBufferHead(peerAddress, buffer, messageSize);
+            buffer->ConsumeHead(messageSize);
+        }
+        else
+        {
+            // Take the buffers of the message off the chain, ProcessSingleMessage flattens them if they fit in one
+            System::PacketBufferHandle message =
+                (frameSize == buffer->DataLength()) ? buffer.PopHead() : SplitChain(buffer, static_cast<uint16_t>(frameSize));
+            VerifyOrExit(!message.IsNull(), err = CHIP_ERROR_NO_MEMORY);
+
+            err = ProcessSingleMessage(peerAddress, std::move(message));
         }
+        SuccessOrExit(err);
 
-        // Buffer is incomplete and we cannot get more data
-        break;
+        err = endPoint->AckReceive(messageSize);
+        SuccessOrExit(err);
     }
 
 exit:
@@ -410,7 +798,14 @@ void TCPBase::OnTcpReceive(Inet::TCPEndPoint * endPoint, System::PacketBufferHan
     endPoint->GetPeerInfo(&ipAddress, &port);
     PeerAddress peerAddress = PeerAddress::TCP(ipAddress, port);
 
-    TCPBase * tcp  = reinterpret_cast<TCPBase *>(endPoint->AppState);
+    TCPBase * tcp                         = reinterpret_cast<TCPBase *>(endPoint->AppState);
+    ActiveTCPConnectionState * connection = tcp->FindActiveConnection(peerAddress);
+
+    if (connection != nullptr && connection->mConnected)
+    {
+        tcp->MarkActive(connection);
+    }
+
     CHIP_ERROR err = tcp->ProcessReceivedBuffer(endPoint, peerAddress, std::move(buffer));
 
     if (err != CHIP_NO_ERROR)
@@ -422,114 +817,98 @@ void TCPBase::OnTcpReceive(Inet::TCPEndPoint * endPoint, System::PacketBufferHan
 
 void TCPBase::OnConnectionComplete(Inet::TCPEndPoint * endPoint, INET_ERROR inetErr)
 {
-    CHIP_ERROR err          = CHIP_NO_ERROR;
-    bool foundPendingPacket = false;
-    TCPBase * tcp           = reinterpret_cast<TCPBase *>(endPoint->AppState);
-    Inet::IPAddress ipAddress;
-    uint16_t port;
-
-    endPoint->GetPeerInfo(&ipAddress, &port);
-    PeerAddress addr = PeerAddress::TCP(ipAddress, port);
-
-    // Send any pending packets
-    for (size_t i = 0; i < tcp->mPendingPacketsSize; i++)
-    {
-        if ((tcp->mPendingPackets[i].peerAddress != addr) || (tcp->mPendingPackets[i].packetBuffer == nullptr))
-        {
-            continue;
-        }
-        foundPendingPacket = true;
-
-        if ((inetErr == CHIP_NO_ERROR) && (err == CHIP_NO_ERROR))
-        {
-            err = endPoint->Send(tcp->mPendingPackets[i].packetBuffer);
-        }
-        else
-        {
-            System::PacketBuffer::Free(tcp->mPendingPackets[i].packetBuffer);
-        }
-
-        tcp->mPendingPackets[i].packetBuffer = nullptr;
-        tcp->mPendingPackets[i].peerAddress  = PeerAddress::Uninitialized();
-    }
+    CHIP_ERROR err                        = CHIP_NO_ERROR;
+    TCPBase * tcp                         = reinterpret_cast<TCPBase *>(endPoint->AppState);
+    ActiveTCPConnectionState * connection = tcp->FindActiveConnection(endPoint);
 
-    if (err == CHIP_NO_ERROR)
+    if (connection == nullptr)
     {
-        err = inetErr;
+        ChipLogError(Inet, "Internal logic error: connection completed for an unknown end point");
+        endPoint->Free();
+        return;
     }
 
-    if (!foundPendingPacket && (err == CHIP_NO_ERROR))
+    if (connection->mPendingHead == nullptr && inetErr == CHIP_NO_ERROR)
     {
         // Force a close: new connections are only expected when a
         // new buffer is being sent.
         ChipLogError(Inet, "Connection accepted without pending buffers");
-        err = CHIP_ERROR_CONNECTION_CLOSED_UNEXPECTEDLY;
+        inetErr = CHIP_ERROR_CONNECTION_CLOSED_UNEXPECTEDLY;
     }
 
-    // cleanup packets or mark as free
-    if (err != CHIP_NO_ERROR)
-    {
-        ChipLogError(Inet, "Connection complete encountered an error: %s", ErrorStr(err));
-        endPoint->Free();
-        tcp->mUsedEndPointCount--;
-    }
-    else
+    if (inetErr == CHIP_NO_ERROR)
     {
-        bool connectionStored = false;
-        for (size_t i = 0; i < tcp->mActiveConnectionsSize; i++)
+        tcp->MarkConnected(connection);
+
+        // Send any pending packets
+        while (connection->mPendingHead != nullptr)
         {
-            if (tcp->mActiveConnections[i] == nullptr)
+            PendingTCPPacket * pending    = connection->mPendingHead;
+            System::PacketBuffer * packet = pending->mPacket;
+
+            connection->mPendingHead = pending->mNext;
+            pending->mPacket         = nullptr;
+            pending->mNext           = tcp->mFreePendingPackets;
+            tcp->mFreePendingPackets = pending;
+
+            if (err == CHIP_NO_ERROR)
+            {
+                // Write the packets queued while connecting together
+                tcp->mStatistics.mMessagesSent++;
+                err = endPoint->Send(packet, connection->mPendingHead == nullptr);
+            }
+            else
             {
-                tcp->mActiveConnections[i] = endPoint;
-                connectionStored           = true;
-                break;
+                System::PacketBuffer::Free(packet);
             }
         }
+        connection->mPendingTail    = nullptr;
+        connection->mPendingCount   = 0;
+        connection->mCoalescedBytes = 0;
+    }
+    else
+    {
+        err = inetErr;
+    }
 
-        // since we track end points counts, we always expect to store the
-        // connection.
-        if (!connectionStored)
-        {
-            endPoint->Free();
-            ChipLogError(Inet, "Internal logic error: insufficient space to store active connection");
-        }
+    // cleanup packets or mark as free
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Inet, "Connection complete encountered an error: %s", ErrorStr(err));
+        tcp->ReleaseConnection(connection);
     }
 }
 
 void TCPBase::OnConnectionClosed(Inet::TCPEndPoint * endPoint, INET_ERROR err)
 {
-    TCPBase * tcp = reinterpret_cast<TCPBase *>(endPoint->AppState);
+    TCPBase * tcp                         = reinterpret_cast<TCPBase *>(endPoint->AppState);
+    ActiveTCPConnectionState * connection = tcp->FindActiveConnection(endPoint);
 
     ChipLogProgress(Inet, "Connection closed.");
 
-    for (size_t i = 0; i < tcp->mActiveConnectionsSize; i++)
+    if (connection != nullptr)
     {
-        if (tcp->mActiveConnections[i] == endPoint)
-        {
-            ChipLogProgress(Inet, "Freeing closed connection.");
-            tcp->mActiveConnections[i]->Free();
-            tcp->mActiveConnections[i] = nullptr;
-            tcp->mUsedEndPointCount--;
-        }
+        ChipLogProgress(Inet, "Freeing closed connection.");
+        tcp->ReleaseConnection(connection);
     }
 }
 
 void TCPBase::OnConnectionReceived(Inet::TCPEndPoint * listenEndPoint, Inet::TCPEndPoint * endPoint,
                                    const Inet::IPAddress & peerAddress, uint16_t peerPort)
 {
-    TCPBase * tcp = reinterpret_cast<TCPBase *>(listenEndPoint->AppState);
+    TCPBase * tcp                         = reinterpret_cast<TCPBase *>(listenEndPoint->AppState);
+    PeerAddress addr                      = PeerAddress::TCP(peerAddress, peerPort);
+    ActiveTCPConnectionState * connection = nullptr;
 
-    if (tcp->mUsedEndPointCount < tcp->mActiveConnectionsSize)
+    if (tcp->FindActiveConnection(addr) == nullptr)
     {
-        // have space to use one more (even if considering pending connections)
-        for (size_t i = 0; i < tcp->mActiveConnectionsSize; i++)
-        {
-            if (tcp->mActiveConnections[i] == nullptr)
-            {
-                tcp->mActiveConnections[i] = endPoint;
-                break;
-            }
-        }
+        connection = tcp->AllocateConnection(addr);
+    }
+
+    if (connection != nullptr)
+    {
+        tcp->SetEndPoint(connection, endPoint);
+        tcp->MarkConnected(connection);
 
         endPoint->AppState             = listenEndPoint->AppState;
         endPoint->OnDataReceived       = OnTcpReceive;
@@ -554,54 +933,29 @@ void TCPBase::OnAcceptError(Inet::TCPEndPoint * endPoint, INET_ERROR err)
 void TCPBase::Disconnect(const PeerAddress & address)
 {
     // Closes an existing connection
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
-    {
-        if (mActiveConnections[i] != nullptr)
-        {
-            Inet::IPAddress ipAddress;
-            uint16_t port;
+    ActiveTCPConnectionState * connection = FindActiveConnection(address);
 
-            mActiveConnections[i]->GetPeerInfo(&ipAddress, &port);
-            if (address == PeerAddress::TCP(ipAddress, port))
-            {
-                // NOTE: this leaves the socket in TIME_WAIT.
-                // Calling Abort() would clean it since SO_LINGER would be set to 0,
-                // however this seems not to be useful.
-                mActiveConnections[i]->Free();
-                mActiveConnections[i] = nullptr;
-                mUsedEndPointCount--;
-            }
-        }
+    if (connection != nullptr)
+    {
+        ReleaseConnection(connection);
     }
 }
 
 void TCPBase::OnPeerClosed(Inet::TCPEndPoint * endPoint)
 {
-    TCPBase * tcp = reinterpret_cast<TCPBase *>(endPoint->AppState);
+    TCPBase * tcp                         = reinterpret_cast<TCPBase *>(endPoint->AppState);
+    ActiveTCPConnectionState * connection = tcp->FindActiveConnection(endPoint);
 
-    for (size_t i = 0; i < tcp->mActiveConnectionsSize; i++)
+    if (connection != nullptr)
     {
-        if (tcp->mActiveConnections[i] == endPoint)
-        {
-            ChipLogProgress(Inet, "Freeing connection: connection closed by peer");
-            tcp->mActiveConnections[i]->Free();
-            tcp->mActiveConnections[i] = nullptr;
-            tcp->mUsedEndPointCount--;
-        }
+        ChipLogProgress(Inet, "Freeing connection: connection closed by peer");
+        tcp->ReleaseConnection(connection);
     }
 }
 
 bool TCPBase::HasActiveConnections() const
 {
-    for (size_t i = 0; i < mActiveConnectionsSize; i++)
-    {
-        if (mActiveConnections[i] != nullptr)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return mUsedConnectionCount != 0;
 }
 
 } // namespace Transport
@@ -32,6 +32,7 @@
 #include <inet/IPEndPointBasis.h>
 #include <inet/InetInterface.h>
 #include <inet/TCPEndPoint.h>
+#include <support/HashUtils.h>
 #include <transport/raw/Base.h>
 
 namespace chip {
@@ -71,20 +72,95 @@ public:
         return *this;
     }
 
+    size_t GetMaxPendingPacketsPerPeer() const { return mMaxPendingPacketsPerPeer; }
+
+    /// Limit the packets queued for a single peer while connecting to it. MUST be at least 1.
+    TcpListenParameters & SetMaxPendingPacketsPerPeer(size_t count)
+    {
+        mMaxPendingPacketsPerPeer = count;
+
+        return *this;
+    }
+
+    bool IsWriteCoalescingEnabled() const { return mWriteCoalescing; }
+    uint32_t GetWriteCoalescingDelayMs() const { return mWriteCoalescingDelayMs; }
+    size_t GetWriteCoalescingThreshold() const { return mWriteCoalescingThreshold; }
+
+    /**
+     * Batch the messages sent over a connection into as few writes as possible.
+     *
+     * Messages are held back until maxDelayMs after the first of them was, 0
+     * meaning once the event loop iteration sending it is over, or until at
+     * least maxBytes of them are held back.
+     */
+    TcpListenParameters & EnableWriteCoalescing(uint32_t maxDelayMs, size_t maxBytes)
+    {
+        mWriteCoalescing          = true;
+        mWriteCoalescingDelayMs   = maxDelayMs;
+        mWriteCoalescingThreshold = maxBytes;
+
+        return *this;
+    }
+
 private:
-    Inet::InetLayer * mLayer         = nullptr;                   ///< Associated inet layer
-    Inet::IPAddressType mAddressType = Inet::kIPAddressType_IPv6; ///< type of listening socket
-    uint16_t mListenPort             = CHIP_PORT;                 ///< TCP listen port
-    Inet::InterfaceId mInterfaceId   = INET_NULL_INTERFACEID;     ///< Interface to listen on
+    Inet::InetLayer * mLayer         = nullptr;                                      ///< Associated inet layer
+    Inet::IPAddressType mAddressType = Inet::kIPAddressType_IPv6;                    ///< type of listening socket
+    uint16_t mListenPort             = CHIP_PORT;                                    ///< TCP listen port
+    Inet::InterfaceId mInterfaceId   = INET_NULL_INTERFACEID;                        ///< Interface to listen on
+    size_t mMaxPendingPacketsPerPeer = CHIP_CONFIG_TCP_MAX_PENDING_PACKETS_PER_PEER; ///< packets queued per peer while connecting
+    bool mWriteCoalescing            = false;                                        ///< whether to batch the messages sent
+    uint32_t mWriteCoalescingDelayMs = 0;                                            ///< longest time a message is held back
+    size_t mWriteCoalescingThreshold = 0;                                            ///< bytes held back that trigger a write
 };
 
 /**
- * Packets scheduled for sending once a connection has been established.
+ * A packet queued for a peer while connecting to it, or a free slot for one.
+ * Slots are taken from a pool shared by all the connections of a transport.
  */
-struct PendingPacket
+struct PendingTCPPacket
 {
-    PeerAddress peerAddress;             // where the packet is being sent to
-    System::PacketBuffer * packetBuffer; // what data needs to be sent
+    System::PacketBuffer * mPacket; ///< null if the slot is free
+    PendingTCPPacket * mNext;       ///< next packet queued for the same peer, or free list link
+};
+
+/**
+ * A connection of a TCP transport to a peer, or a free slot for one.
+ *
+ * Slots in use are found by peer address and by end point through hash
+ * chains, and those connected are kept on a list ordered by last activity,
+ * from which idle connections are evicted when a new one needs a slot.
+ */
+struct ActiveTCPConnectionState
+{
+    Inet::TCPEndPoint * mEndPoint;              ///< null until the end point is created
+    PeerAddress mPeerAddress;                   ///< key the connection is found by
+    PendingTCPPacket * mPendingHead;            ///< packets to send once connected, oldest first
+    PendingTCPPacket * mPendingTail;            ///< last packet of mPendingHead
+    size_t mPendingCount;                       ///< number of packets on mPendingHead
+    size_t mCoalescedBytes;                     ///< bytes queued on the end point but not written yet
+    uint64_t mEstablishedTimeMs;                ///< when the connection got established
+    ActiveTCPConnectionState * mNext;           ///< hash chain link by peer address, or free list link
+    ActiveTCPConnectionState * mNextByEndPoint; ///< hash chain link by end point
+    ActiveTCPConnectionState * mOlder;          ///< previous connection on the activity list
+    ActiveTCPConnectionState * mNewer;          ///< next connection on the activity list
+    bool mInUse;                                ///< false if the slot is free
+    bool mConnected;                            ///< true once established or accepted
+};
+
+/**
+ * Running totals kept by a TCP transport about its connections.
+ */
+struct TCPConnectionStatistics
+{
+    uint32_t mOpened       = 0; ///< connections established or accepted
+    uint32_t mClosed       = 0; ///< connections closed after being established, including evicted ones
+    uint32_t mEvicted      = 0; ///< idle connections closed to make room for new ones
+    uint32_t mMessagesSent = 0; ///< messages handed to a connection
+    uint32_t mReused       = 0; ///< messages sent over an already established connection
+    uint32_t mCoalesced    = 0; ///< messages held back to be written together with others
+    uint32_t mFlushes      = 0; ///< pushes of the messages held back to their end point
+    uint32_t mWrites       = 0; ///< writes to the sockets of the connections
+    uint64_t mLifetimeMs   = 0; ///< total time the closed connections were open
 };
 
 /** Implements a transport using TCP. */
@@ -100,18 +176,51 @@ class DLL_EXPORT TCPBase : public Base
     };
 
 public:
-    TCPBase(Inet::TCPEndPoint ** activeConnectionsBuffer, size_t bufferSize, PendingPacket * packetBuffers,
-            size_t packetsBuffersSize) :
-        mActiveConnections(activeConnectionsBuffer),
-        mActiveConnectionsSize(bufferSize), mPendingPackets(packetBuffers), mPendingPacketsSize(packetsBuffersSize)
+    /**
+     * @param connections        storage for the connections
+     * @param connectionsSize    maximum number of connections
+     * @param buckets            storage for the hash chain heads by peer address
+     * @param endPointBuckets    storage for the hash chain heads by end point
+     * @param bucketCount        number of buckets of each kind, MUST be a power of two
+     * @param pendingPackets     storage for the packets queued while connecting
+     * @param pendingPacketsSize maximum number of packets queued, for all peers, while connecting to them; each peer
+     *                           is further limited by TcpListenParameters::SetMaxPendingPacketsPerPeer
+     */
+    TCPBase(ActiveTCPConnectionState * connections, size_t connectionsSize, ActiveTCPConnectionState ** buckets,
+            ActiveTCPConnectionState ** endPointBuckets, size_t bucketCount, PendingTCPPacket * pendingPackets,
+            size_t pendingPacketsSize) :
+        mActiveConnections(connections),
+        mActiveConnectionsSize(connectionsSize), mBuckets(buckets), mEndPointBuckets(endPointBuckets), mBucketCount(bucketCount)
     {
-        PendingPacket emptyPending{
-            .peerAddress  = PeerAddress::Uninitialized(),
-            .packetBuffer = nullptr,
-        };
-
-        std::fill(mActiveConnections, mActiveConnections + mActiveConnectionsSize, nullptr);
-        std::fill(mPendingPackets, mPendingPackets + mPendingPacketsSize, emptyPending);
+        std::fill(mBuckets, mBuckets + mBucketCount, nullptr);
+        std::fill(mEndPointBuckets, mEndPointBuckets + mBucketCount, nullptr);
+
+        for (size_t i = mActiveConnectionsSize; i > 0; i--)
+        {
+            ActiveTCPConnectionState & connection = mActiveConnections[i - 1];
+
+            connection.mEndPoint          = nullptr;
+            connection.mPeerAddress       = PeerAddress::Uninitialized();
+            connection.mPendingHead       = nullptr;
+            connection.mPendingTail       = nullptr;
+            connection.mPendingCount      = 0;
+            connection.mCoalescedBytes    = 0;
+            connection.mEstablishedTimeMs = 0;
+            connection.mNext              = mFreeConnections;
+            connection.mNextByEndPoint    = nullptr;
+            connection.mOlder             = nullptr;
+            connection.mNewer             = nullptr;
+            connection.mInUse             = false;
+            connection.mConnected         = false;
+            mFreeConnections              = &connection;
+        }
+
+        for (size_t i = pendingPacketsSize; i > 0; i--)
+        {
+            pendingPackets[i - 1].mPacket = nullptr;
+            pendingPackets[i - 1].mNext   = mFreePendingPackets;
+            mFreePendingPackets           = &pendingPackets[i - 1];
+        }
     }
     ~TCPBase() override;
 
@@ -149,12 +258,59 @@ public:
      */
     void CloseActiveConnections();
 
+    /// Running totals about the connections of this transport.
+    TCPConnectionStatistics GetStatistics() const;
+
 private:
     /**
-     * Find an active connection to the given peer or return nullptr if
-     * no active connection exists.
+     * Find the connection to the given peer, established or not, or return
+     * nullptr if there is none.
+     */
+    ActiveTCPConnectionState * FindActiveConnection(const PeerAddress & addr);
+
+    /**
+     * Find the connection using the given end point, or return nullptr if
+     * there is none.
      */
-    Inet::TCPEndPoint * FindActiveConnection(const PeerAddress & addr);
+    ActiveTCPConnectionState * FindActiveConnection(const Inet::TCPEndPoint * endPoint);
+
+    /**
+     * Take a slot for a connection to the given peer, evicting the least
+     * recently active idle connection if none is free.
+     *
+     * @return the slot, or nullptr if every connection is busy.
+     */
+    ActiveTCPConnectionState * AllocateConnection(const PeerAddress & addr);
+
+    /**
+     * Close a connection, drop the packets still queued for it and give its
+     * slot back.
+     */
+    void ReleaseConnection(ActiveTCPConnectionState * connection);
+
+    /// Record that a connection got established or accepted.
+    void MarkConnected(ActiveTCPConnectionState * connection);
+
+    /// Move a connection to the most recently active end of the activity list.
+    void MarkActive(ActiveTCPConnectionState * connection);
+
+    void UnlinkFromActivityList(ActiveTCPConnectionState * connection);
+
+    ActiveTCPConnectionState ** Bucket(const PeerAddress & addr) const;
+    ActiveTCPConnectionState ** EndPointBucket(const Inet::TCPEndPoint * endPoint) const;
+
+    /// Give a connection the end point it goes through, and make it findable by it.
+    void SetEndPoint(ActiveTCPConnectionState * connection, Inet::TCPEndPoint * endPoint);
+
+    /**
+     * Queue a packet on a connection being established, taking a slot from
+     * the pool shared by all connections.
+     *
+     * @return false if the pool is empty or the connection has as many
+     *         packets queued as a peer may have, in which case msg is left to
+     *         the caller.
+     */
+    bool QueuePendingPacket(ActiveTCPConnectionState * connection, System::PacketBuffer * msg);
 
     /**
      * Sends the specified message once a connection has been established.
@@ -167,6 +323,21 @@ private:
      */
     CHIP_ERROR SendAfterConnect(const PeerAddress & addr, System::PacketBuffer * msg);
 
+    /**
+     * Queue a message on an established connection, to be written together
+     * with the others sent shortly after it.
+     *
+     * Ownership of msg is taken over.
+     */
+    CHIP_ERROR SendCoalesced(ActiveTCPConnectionState * connection, System::PacketBuffer * msg);
+
+    /// Write the messages held back on a connection.
+    CHIP_ERROR FlushConnection(ActiveTCPConnectionState * connection);
+
+    // Timer handler writing the messages held back on every connection. The end points do not write what
+    // Send() queued without pushing it, so this timer is what bounds how long a message is held back.
+    static void OnFlushTimer(System::Layer * systemLayer, void * appState, System::Error error);
+
     /**
      * Process a single received buffer from the specified peer address.
      *
@@ -190,6 +361,19 @@ private:
     CHIP_ERROR ProcessSingleMessageFromBufferHead(const PeerAddress & peerAddress, const System::PacketBufferHandle & buffer,
                                                   uint16_t messageSize);
 
+    /**
+     * Process a single message, with its size prefix, that is the whole content
+     * of a buffer chain.
+     *
+     * Receivers may only look at the first buffer of a message, so a message
+     * that fits in a single buffer is flattened into one before being handed
+     * up. Only larger messages are handed up as a chain.
+     *
+     * @param peerAddress the peer the data is coming from
+     * @param message the chain holding the message, which may be split anywhere
+     */
+    CHIP_ERROR ProcessSingleMessage(const PeerAddress & peerAddress, System::PacketBufferHandle message);
+
     // Callback handler for TCPEndPoint. TCP message receive handler.
     // @see TCPEndpoint::OnDataReceivedFunct
     static void OnTcpReceive(Inet::TCPEndPoint * endPoint, System::PacketBufferHandle buffer);
@@ -219,27 +403,55 @@ private:
     Inet::IPAddressType mEndpointType = Inet::IPAddressType::kIPAddressType_Unknown; ///< Socket listening type
     State mState                      = State::kNotReady;                            ///< State of the TCP transport
 
-    // Number of active and 'pending connection' endpoints
-    size_t mUsedEndPointCount = 0;
-
-    // Currently active connections
-    Inet::TCPEndPoint ** mActiveConnections;
+    // Connections, established or being established
+    ActiveTCPConnectionState * mActiveConnections;
     const size_t mActiveConnectionsSize;
-
-    // Data to be sent when connections succeed
-    PendingPacket * mPendingPackets;
-    const size_t mPendingPacketsSize;
+    size_t mUsedConnectionCount                 = 0;
+    ActiveTCPConnectionState * mFreeConnections = nullptr;
+
+    // Hash chains of the connections in use, by peer address and by end point
+    ActiveTCPConnectionState ** mBuckets;
+    ActiveTCPConnectionState ** mEndPointBuckets;
+    const size_t mBucketCount;
+
+    // Connections established, from the least to the most recently active
+    ActiveTCPConnectionState * mOldest = nullptr;
+    ActiveTCPConnectionState * mNewest = nullptr;
+
+    // Slots left for the packets queued while connecting, and how many of them a single peer may take
+    PendingTCPPacket * mFreePendingPackets = nullptr;
+    size_t mMaxPendingPacketsPerPeer       = CHIP_CONFIG_TCP_MAX_PENDING_PACKETS_PER_PEER;
+
+    // Write coalescing, see TcpListenParameters::EnableWriteCoalescing
+    System::Layer * mSystemLayer     = nullptr;
+    bool mWriteCoalescing            = false;
+    bool mFlushScheduled             = false;
+    uint32_t mWriteCoalescingDelayMs = 0;
+    size_t mWriteCoalescingThreshold = 0;
+
+    TCPConnectionStatistics mStatistics;
 };
 
+/**
+ * TCP transport keeping up to kActiveConnectionsSize connections, and queueing
+ * up to kPendingPacketSize packets in all while connecting to peers.
+ */
 template <size_t kActiveConnectionsSize, size_t kPendingPacketSize>
 class TCP : public TCPBase
 {
 public:
-    TCP() : TCPBase(mConnectionsBuffer, kActiveConnectionsSize, mPendingPackets, kPendingPacketSize) {}
+    TCP() :
+        TCPBase(mConnectionsBuffer, kActiveConnectionsSize, mBucketsBuffer, mEndPointBucketsBuffer, kBucketCount, mPendingPackets,
+                kPendingPacketSize)
+    {}
 
 private:
-    Inet::TCPEndPoint * mConnectionsBuffer[kActiveConnectionsSize];
-    PendingPacket mPendingPackets[kPendingPacketSize];
+    static constexpr size_t kBucketCount = HashBucketCountFor(kActiveConnectionsSize);
+
+    ActiveTCPConnectionState mConnectionsBuffer[kActiveConnectionsSize];
+    ActiveTCPConnectionState * mBucketsBuffer[kBucketCount];
+    ActiveTCPConnectionState * mEndPointBucketsBuffer[kBucketCount];
+    PendingTCPPacket mPendingPackets[kPendingPacketSize];
 };
 
 } // namespace Transport
@@ -27,6 +27,7 @@
 #include <support/ReturnMacros.h>
 #include <support/logging/CHIPLogging.h>
 #include <transport/raw/MessageHeader.h>
+#include <transport/raw/UDPShardGroup.h>
 
 #include <inttypes.h>
 
@@ -53,6 +54,15 @@ CHIP_ERROR UDP::Init(UdpListenParameters & params)
     err = mUDPEndPoint->Bind(params.GetAddressType(), Inet::IPAddress::Any, params.GetListenPort(), params.GetInterfaceId());
     SuccessOrExit(err);
 
+    if (params.GetShardGroup() != nullptr)
+    {
+        err = params.GetShardGroup()->Join(params.GetShardIndex(), this, mUDPEndPoint, params.GetInetLayer()->SystemLayer());
+        SuccessOrExit(err);
+
+        mShardGroup = params.GetShardGroup();
+        mShardIndex = params.GetShardIndex();
+    }
+
     err = mUDPEndPoint->Listen();
     SuccessOrExit(err);
 
@@ -66,6 +76,11 @@ exit:
     if (err != CHIP_NO_ERROR)
     {
         ChipLogProgress(Inet, "Failed to initialize Udp transport: %s", ErrorStr(err));
+        if (mShardGroup)
+        {
+            mShardGroup->Leave(mShardIndex);
+            mShardGroup = nullptr;
+        }
         if (mUDPEndPoint)
         {
             mUDPEndPoint->Free();
@@ -78,6 +93,20 @@ exit:
 
 void UDP::Close()
 {
+    for (size_t i = 0; i < mBatchCount; i++)
+    {
+        System::PacketBuffer::Free(mBatchMsgs[i]);
+    }
+    mBatchCount = 0;
+    mBatchError = CHIP_NO_ERROR;
+    mBatching   = false;
+
+    if (mShardGroup)
+    {
+        mShardGroup->Leave(mShardIndex);
+        mShardGroup = nullptr;
+    }
+
     if (mUDPEndPoint)
     {
         // Udp endpoint is only non null if udp endpoint is initialized and listening
@@ -115,7 +144,52 @@ CHIP_ERROR UDP::SendMessage(const PacketHeader & header, const Transport::PeerAd
 
     VerifyOrReturnError(headerSize == actualEncodedHeaderSize, CHIP_ERROR_INTERNAL);
 
-    return mUDPEndPoint->SendMsg(&addrInfo, msgBuf.Release_ForNow());
+    if (!mBatching)
+    {
+        return mUDPEndPoint->SendMsg(&addrInfo, msgBuf.Release_ForNow());
+    }
+
+    if (mBatchCount == INET_CONFIG_UDP_SEND_BATCH_SIZE)
+    {
+        SendBatch();
+    }
+
+    mBatchInfo[mBatchCount] = addrInfo;
+    mBatchMsgs[mBatchCount] = msgBuf.Release_ForNow();
+    mBatchCount++;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR UDP::FlushBatch()
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    SendBatch();
+
+    err         = mBatchError;
+    mBatchError = CHIP_NO_ERROR;
+    mBatching   = false;
+
+    return err;
+}
+
+void UDP::SendBatch()
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    if (mBatchCount == 0)
+    {
+        return;
+    }
+
+    err         = mUDPEndPoint->SendMsgs(mBatchInfo, mBatchMsgs, mBatchCount);
+    mBatchCount = 0;
+
+    if (mBatchError == CHIP_NO_ERROR)
+    {
+        mBatchError = err;
+    }
 }
 
 void UDP::OnUdpReceive(Inet::IPEndPointBasis * endPoint, System::PacketBufferHandle buffer, const Inet::IPPacketInfo * pktInfo)
@@ -130,6 +204,14 @@ void UDP::OnUdpReceive(Inet::IPEndPointBasis * endPoint, System::PacketBufferHan
     SuccessOrExit(err);
 
     buffer->ConsumeHead(headerSize);
+
+    if (udp->mShardGroup != nullptr && udp->mShardGroup->ShardForKeyId(header.GetEncryptionKeyID()) != udp->mShardIndex)
+    {
+        // Messages of sessions owned by another shard are processed by that shard's thread
+        udp->mShardGroup->HandOffMessage(header, peerAddress, std::move(buffer));
+        ExitNow();
+    }
+
     udp->HandleMessageReceived(header, peerAddress, std::move(buffer));
 
 exit:
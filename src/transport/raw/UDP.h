@@ -36,6 +36,8 @@
 namespace chip {
 namespace Transport {
 
+class UDPShardGroup;
+
 /** Defines listening parameters for setting up a UDP transport */
 class UdpListenParameters
 {
@@ -70,11 +72,28 @@ public:
         return *this;
     }
 
+    UDPShardGroup * GetShardGroup() const { return mShardGroup; }
+    uint16_t GetShardIndex() const { return mShardIndex; }
+
+    /**
+     * Make the transport one of the shards of a group sharing the listen
+     * port. Shards must be initialized in index order.
+     */
+    UdpListenParameters & SetShard(UDPShardGroup * group, uint16_t index)
+    {
+        mShardGroup = group;
+        mShardIndex = index;
+
+        return *this;
+    }
+
 private:
     Inet::InetLayer * mLayer         = nullptr;                   ///< Associated inet layer
     Inet::IPAddressType mAddressType = Inet::kIPAddressType_IPv6; ///< type of listening socket
     uint16_t mListenPort             = CHIP_PORT;                 ///< UDP listen port
     Inet::InterfaceId mInterfaceId   = INET_NULL_INTERFACEID;     ///< Interface to listen on
+    UDPShardGroup * mShardGroup      = nullptr;                   ///< Group of transports sharing the port, if any
+    uint16_t mShardIndex             = 0;                         ///< Index of the transport within its shard group
 };
 
 /** Implements a transport using UDP. */
@@ -119,14 +138,45 @@ public:
             (address.GetIPAddress().Type() == mUDPEndpointType);
     }
 
+    /**
+     * Queue messages passed to SendMessage instead of sending them right away.
+     *
+     * @details
+     *   Queued messages are handed to the network together, with as few
+     *   system calls as the platform allows, when FlushBatch is called or
+     *   once INET_CONFIG_UDP_SEND_BATCH_SIZE messages are queued. Useful to
+     *   fan a message out to many peers.
+     */
+    void StartBatch() { mBatching = true; }
+
+    /**
+     * Send every queued message and stop queueing.
+     *
+     * @return the error of the first queued message that failed to send, if any.
+     */
+    CHIP_ERROR FlushBatch();
+
 private:
+    friend class UDPShardGroup;
+
     // UDP message receive handler.
     static void OnUdpReceive(Inet::IPEndPointBasis * endPoint, System::PacketBufferHandle buffer,
                              const Inet::IPPacketInfo * pktInfo);
 
+    /// Sends the queued messages, remembering the first error for FlushBatch.
+    void SendBatch();
+
     Inet::UDPEndPoint * mUDPEndPoint     = nullptr;                                     ///< UDP socket used by the transport
     Inet::IPAddressType mUDPEndpointType = Inet::IPAddressType::kIPAddressType_Unknown; ///< Socket listening type
     State mState                         = State::kNotReady;                            ///< State of the UDP transport
+    UDPShardGroup * mShardGroup          = nullptr;                                     ///< Group the transport is a shard of
+    uint16_t mShardIndex                 = 0;                                           ///< Index of the transport in its group
+
+    Inet::IPPacketInfo mBatchInfo[INET_CONFIG_UDP_SEND_BATCH_SIZE];     ///< Destinations of the queued messages
+    System::PacketBuffer * mBatchMsgs[INET_CONFIG_UDP_SEND_BATCH_SIZE]; ///< Queued messages
+    size_t mBatchCount     = 0;                                         ///< Number of queued messages
+    CHIP_ERROR mBatchError = CHIP_NO_ERROR;                             ///< First error sending the current batch
+    bool mBatching         = false;                                     ///< Whether SendMessage queues messages
 };
 
 } // namespace Transport
@@ -0,0 +1,193 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   This file implements a group of UDP transports sharing a listening port.
+ */
+
+#include <transport/raw/UDPShardGroup.h>
+
+#include <support/CodeUtils.h>
+#include <support/ErrorStr.h>
+#include <support/ReturnMacros.h>
+#include <support/logging/CHIPLogging.h>
+#include <transport/raw/UDP.h>
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS && defined(__linux__)
+#include <linux/filter.h>
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS && defined(__linux__)
+
+namespace chip {
+namespace Transport {
+
+namespace {
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS && defined(__linux__)
+/**
+ * Socket filter returning ShardForKeyId() of the encryption key ID of a
+ * datagram, which is found after the 16-bit message header and 32-bit message
+ * ID, and after the 64-bit source and destination node IDs when present (see
+ * PacketHeader::Decode). Multi-byte fields are little endian.
+ *
+ * Datagrams too short to hold a key ID abort the filter, which delivers them
+ * to the first shard.
+ */
+constexpr uint8_t kNodeIdFlagsOffset = 1;    // high byte of the message header
+constexpr uint8_t kNodeIdFlagsMask   = 0x03; // node ID presence flags, within the high byte
+constexpr uint8_t kKeyIdOffset       = 6;    // offset of the key ID without node IDs
+
+static_assert(static_cast<uint16_t>(Header::FlagValues::kDestinationNodeIdPresent) == 0x0100 &&
+                  static_cast<uint16_t>(Header::FlagValues::kSourceNodeIdPresent) == 0x0200,
+              "The steering filter counts node IDs from the two lowest flags of the header's high byte");
+
+constexpr uint16_t kSteeringFilterLength = 22;
+
+void BuildSteeringFilter(uint16_t shardCount, struct sock_filter (&filter)[kSteeringFilterLength])
+{
+    const struct sock_filter program[kSteeringFilterLength] = {
+        // X = offset of the key ID = kKeyIdOffset + 8 * number of node IDs
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, kNodeIdFlagsOffset),
+        BPF_STMT(BPF_ALU | BPF_AND | BPF_K, kNodeIdFlagsMask),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 1),
+        BPF_STMT(BPF_ST, 0),
+        BPF_STMT(BPF_MISC | BPF_TXA, 0),
+        BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 1),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_MEM, 0),
+        BPF_STMT(BPF_ALU | BPF_ADD | BPF_X, 0),
+        BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 3),
+        BPF_STMT(BPF_ALU | BPF_ADD | BPF_K, kKeyIdOffset),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+
+        // A = key ID
+        BPF_STMT(BPF_LD | BPF_B | BPF_IND, 1),
+        BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 8),
+        BPF_STMT(BPF_ST, 0),
+        BPF_STMT(BPF_LD | BPF_B | BPF_IND, 0),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_MEM, 0),
+        BPF_STMT(BPF_ALU | BPF_OR | BPF_X, 0),
+
+        // Index of the receiving socket
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, shardCount),
+        BPF_STMT(BPF_RET | BPF_A, 0),
+    };
+
+    for (uint16_t i = 0; i < kSteeringFilterLength; i++)
+    {
+        filter[i] = program[i];
+    }
+}
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS && defined(__linux__)
+
+} // namespace
+
+CHIP_ERROR UDPShardGroup::Init(uint16_t shardCount)
+{
+    VerifyOrReturnError(shardCount > 0 && shardCount <= kMaxShards, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mShardCount = shardCount;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR UDPShardGroup::Join(uint16_t shard, UDP * transport, Inet::UDPEndPoint * endPoint, System::Layer * systemLayer)
+{
+    VerifyOrReturnError(shard < mShardCount, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mShards[shard].mTransport == nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+#if CHIP_SYSTEM_CONFIG_USE_SOCKETS && defined(__linux__)
+    if (mShardCount > 1)
+    {
+        struct sock_filter filter[kSteeringFilterLength];
+
+        BuildSteeringFilter(mShardCount, filter);
+
+        // Without steering, every message still reaches its shard through a hand-off
+        INET_ERROR err = endPoint->AttachReusePortFilter(filter, kSteeringFilterLength);
+        if (err != INET_NO_ERROR)
+        {
+            ChipLogError(Inet, "Failed to steer UDP shard messages: %s", ErrorStr(err));
+        }
+    }
+#endif // CHIP_SYSTEM_CONFIG_USE_SOCKETS && defined(__linux__)
+
+    mShards[shard].mTransport   = transport;
+    mShards[shard].mSystemLayer = systemLayer;
+
+    return CHIP_NO_ERROR;
+}
+
+void UDPShardGroup::Leave(uint16_t shard)
+{
+    HandOff handOff;
+
+    // Drop the messages nobody is going to process anymore
+    while (mShards[shard].mHandOffs.TryPop(handOff))
+    {
+        System::PacketBuffer::Free(handOff.mBuffer);
+    }
+
+    mShards[shard].mTransport   = nullptr;
+    mShards[shard].mSystemLayer = nullptr;
+}
+
+void UDPShardGroup::HandOffMessage(const PacketHeader & header, const PeerAddress & source, System::PacketBufferHandle buffer)
+{
+    Shard & owner = mShards[ShardForKeyId(header.GetEncryptionKeyID())];
+
+    if (owner.mTransport == nullptr)
+    {
+        ChipLogError(Inet, "No UDP shard for key %d, dropping message", header.GetEncryptionKeyID());
+        return;
+    }
+
+    System::PacketBuffer * message = buffer.Release_ForNow();
+    if (!owner.mHandOffs.TryPush(HandOff{ header, source, message }))
+    {
+        ChipLogError(Inet, "UDP shard hand-off queue full, dropping message");
+        System::PacketBuffer::Free(message);
+        return;
+    }
+
+    // Only the first hand-off since the owner last processed them needs to wake its thread up
+    if (!owner.mPending.exchange(true, std::memory_order_acq_rel))
+    {
+        owner.mSystemLayer->WakeSelect();
+    }
+}
+
+void UDPShardGroup::ProcessHandOffs(uint16_t shard)
+{
+    Shard & self = mShards[shard];
+    HandOff handOff;
+
+    self.mPending.exchange(false, std::memory_order_acq_rel);
+
+    while (self.mHandOffs.TryPop(handOff))
+    {
+        System::PacketBufferHandle buffer;
+        buffer.Adopt(handOff.mBuffer);
+
+        self.mTransport->HandleMessageReceived(handOff.mHeader, handOff.mSource, std::move(buffer));
+    }
+}
+
+} // namespace Transport
+} // namespace chip
@@ -0,0 +1,118 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *   This file defines a group of UDP transports sharing a listening port,
+ *   each serviced by its own thread.
+ */
+
+#pragma once
+
+#include <atomic>
+
+#include <core/CHIPConfig.h>
+#include <core/CHIPError.h>
+#include <inet/UDPEndPoint.h>
+#include <support/MPSCQueue.h>
+#include <system/SystemLayer.h>
+#include <system/SystemPacketBuffer.h>
+#include <transport/raw/MessageHeader.h>
+#include <transport/raw/PeerAddress.h>
+
+namespace chip {
+namespace Transport {
+
+class UDP;
+
+/**
+ * Spreads the messages received on a UDP port over several shards, each made
+ * of a UDP transport with its own System::Layer, InetLayer and session stack
+ * running on a dedicated thread.
+ *
+ * Every message belongs to the shard given by ShardForKeyId() of the
+ * encryption key ID in its packet header, which is the key ID chosen by the
+ * sending peer. Secure sessions must therefore be established on the shard
+ * owning the peer's key ID. Unencrypted messages, which carry key ID 0,
+ * belong to the first shard.
+ *
+ * All shards bind the same port with SO_REUSEPORT. On Linux, a socket filter
+ * makes the kernel deliver each datagram straight to the socket of the shard
+ * it belongs to; this relies on shards binding in index order. Datagrams that
+ * still reach the wrong shard, e.g. on other platforms, are handed off to the
+ * right one through a lock-free queue, and delivered by that shard's thread
+ * when it calls ProcessHandOffs().
+ *
+ * Shards join the group from UDP::Init, before any message flows; joining and
+ * leaving are not synchronized with message delivery.
+ */
+class UDPShardGroup
+{
+public:
+    static constexpr uint16_t kMaxShards = CHIP_CONFIG_MAX_UDP_SHARDS;
+
+    /**
+     * Set the number of shards of the group.
+     *
+     * @return CHIP_ERROR_INVALID_ARGUMENT if the count is 0 or above kMaxShards.
+     */
+    CHIP_ERROR Init(uint16_t shardCount);
+
+    uint16_t GetShardCount() const { return mShardCount; }
+
+    /// Index of the shard owning messages with the given encryption key ID.
+    uint16_t ShardForKeyId(uint16_t keyId) const { return static_cast<uint16_t>(keyId % mShardCount); }
+
+    /**
+     * Deliver the messages handed off to a shard by the other shards.
+     *
+     * Must be called from the thread of that shard, each time its event loop
+     * wakes up.
+     */
+    void ProcessHandOffs(uint16_t shard);
+
+private:
+    friend class UDP;
+
+    struct HandOff
+    {
+        PacketHeader mHeader;
+        PeerAddress mSource;
+        System::PacketBuffer * mBuffer;
+    };
+
+    struct Shard
+    {
+        UDP * mTransport             = nullptr;
+        System::Layer * mSystemLayer = nullptr;
+        std::atomic<bool> mPending{ false }; ///< set by the first hand-off since the shard last processed them
+        MPSCQueue<HandOff, CHIP_CONFIG_UDP_SHARD_HANDOFF_QUEUE_SIZE> mHandOffs;
+    };
+
+    /// Called by a shard's transport once its endpoint is bound.
+    CHIP_ERROR Join(uint16_t shard, UDP * transport, Inet::UDPEndPoint * endPoint, System::Layer * systemLayer);
+    void Leave(uint16_t shard);
+
+    /// Queue a message received by another shard for its owner. May be called from any shard's thread.
+    void HandOffMessage(const PacketHeader & header, const PeerAddress & source, System::PacketBufferHandle buffer);
+
+    uint16_t mShardCount = 1;
+    Shard mShards[kMaxShards];
+};
+
+} // namespace Transport
+} // namespace chip
@@ -25,13 +25,20 @@
 
 #include <core/CHIPCore.h>
 #include <support/CodeUtils.h>
+#include <support/ReturnMacros.h>
 #include <support/UnitTestRegistration.h>
 #include <transport/raw/TCP.h>
 
 #include <nlbyteorder.h>
 #include <nlunit-test.h>
 
+#include <arpa/inet.h>
 #include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
 
 using namespace chip;
 using namespace chip::Inet;
@@ -156,6 +163,420 @@ void CheckMessageTest6(nlTestSuite * inSuite, void * inContext)
     CheckMessageTest(inSuite, inContext, addr);
 }
 
+/////////////////////////// Connection pool test
+
+CHIP_ERROR SendPayload(Transport::TCPBase & tcp, const Transport::PeerAddress & address)
+{
+    chip::System::PacketBufferHandle buffer = chip::System::PacketBuffer::NewWithAvailableSize(sizeof(PAYLOAD));
+    VerifyOrReturnError(!buffer.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    memmove(buffer->Start(), PAYLOAD, sizeof(PAYLOAD));
+    buffer->SetDataLength(sizeof(PAYLOAD));
+
+    PacketHeader header;
+    header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageId(kMessageId);
+
+    return tcp.SendMessage(header, address, buffer.Release_ForNow());
+}
+
+void CheckConnectionPoolTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    constexpr uint16_t kClientPort  = CHIP_PORT + 10;
+    constexpr uint16_t kServer2Port = CHIP_PORT + 11;
+
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+
+    // A single connection slot, shared by both servers
+    Transport::TCP<1, kMaxTcpPendingPackets> client;
+    TCPImpl server1;
+    TCPImpl server2;
+
+    NL_TEST_ASSERT(inSuite,
+                   client.Init(Transport::TcpListenParameters(&ctx.GetInetLayer())
+                                   .SetAddressType(kIPAddressType_IPv4)
+                                   .SetListenPort(kClientPort)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   server1.Init(Transport::TcpListenParameters(&ctx.GetInetLayer()).SetAddressType(kIPAddressType_IPv4)) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   server2.Init(Transport::TcpListenParameters(&ctx.GetInetLayer())
+                                    .SetAddressType(kIPAddressType_IPv4)
+                                    .SetListenPort(kServer2Port)) == CHIP_NO_ERROR);
+
+    server1.SetMessageReceiveHandler(MessageReceiveHandler, inSuite);
+    server2.SetMessageReceiveHandler(MessageReceiveHandler, inSuite);
+    ReceiveHandlerCallCount = 0;
+
+    // Packets are queued while connecting, up to a limit
+    for (size_t i = 0; i < kMaxTcpPendingPackets; i++)
+    {
+        NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr)) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr)) == CHIP_ERROR_NO_MEMORY);
+
+    ctx.DriveIOUntil(5000 /* ms */, []() { return ReceiveHandlerCallCount == static_cast<int>(kMaxTcpPendingPackets); });
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == static_cast<int>(kMaxTcpPendingPackets));
+
+    // The established connection is reused
+    NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr)) == CHIP_NO_ERROR);
+    ctx.DriveIOUntil(5000 /* ms */, []() { return ReceiveHandlerCallCount == static_cast<int>(kMaxTcpPendingPackets + 1); });
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == static_cast<int>(kMaxTcpPendingPackets + 1));
+
+    // Connecting to another peer evicts the idle connection
+    NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr, kServer2Port)) == CHIP_NO_ERROR);
+    ctx.DriveIOUntil(5000 /* ms */, []() { return ReceiveHandlerCallCount == static_cast<int>(kMaxTcpPendingPackets + 2); });
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == static_cast<int>(kMaxTcpPendingPackets + 2));
+
+    const Transport::TCPConnectionStatistics & statistics = client.GetStatistics();
+    NL_TEST_ASSERT(inSuite, statistics.mOpened == 2);
+    NL_TEST_ASSERT(inSuite, statistics.mEvicted == 1);
+    NL_TEST_ASSERT(inSuite, statistics.mClosed == 1);
+    NL_TEST_ASSERT(inSuite, statistics.mMessagesSent == kMaxTcpPendingPackets + 2);
+    NL_TEST_ASSERT(inSuite, statistics.mReused == 1);
+
+    client.CloseActiveConnections();
+    ctx.DriveIOUntil(5000 /* ms */, [&server1, &server2]() {
+        return !server1.HasActiveConnections() && !server2.HasActiveConnections();
+    });
+}
+
+/////////////////////////// Pending packets test
+
+void CheckPendingPacketsTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    constexpr uint16_t kClientPort  = CHIP_PORT + 13;
+    constexpr uint16_t kServer2Port = CHIP_PORT + 14;
+
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+
+    // The limit on pending packets holds for all peers together, not for each of them
+    Transport::TCP<2, kMaxTcpPendingPackets> client;
+    TCPImpl server1;
+    TCPImpl server2;
+
+    NL_TEST_ASSERT(inSuite,
+                   client.Init(Transport::TcpListenParameters(&ctx.GetInetLayer())
+                                   .SetAddressType(kIPAddressType_IPv4)
+                                   .SetListenPort(kClientPort)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   server1.Init(Transport::TcpListenParameters(&ctx.GetInetLayer()).SetAddressType(kIPAddressType_IPv4)) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   server2.Init(Transport::TcpListenParameters(&ctx.GetInetLayer())
+                                    .SetAddressType(kIPAddressType_IPv4)
+                                    .SetListenPort(kServer2Port)) == CHIP_NO_ERROR);
+
+    server1.SetMessageReceiveHandler(MessageReceiveHandler, inSuite);
+    server2.SetMessageReceiveHandler(MessageReceiveHandler, inSuite);
+    ReceiveHandlerCallCount = 0;
+
+    for (size_t i = 0; i < kMaxTcpPendingPackets; i++)
+    {
+        const uint16_t port = (i % 2 == 0) ? CHIP_PORT : kServer2Port;
+        NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr, port)) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr)) == CHIP_ERROR_NO_MEMORY);
+    NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr, kServer2Port)) == CHIP_ERROR_NO_MEMORY);
+
+    ctx.DriveIOUntil(5000 /* ms */, []() { return ReceiveHandlerCallCount == static_cast<int>(kMaxTcpPendingPackets); });
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == static_cast<int>(kMaxTcpPendingPackets));
+
+    // Once connected, the packets sent no longer wait in the pool
+    NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr)) == CHIP_NO_ERROR);
+    ctx.DriveIOUntil(5000 /* ms */, []() { return ReceiveHandlerCallCount == static_cast<int>(kMaxTcpPendingPackets + 1); });
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == static_cast<int>(kMaxTcpPendingPackets + 1));
+
+    client.CloseActiveConnections();
+    ctx.DriveIOUntil(5000 /* ms */, [&server1, &server2]() {
+        return !server1.HasActiveConnections() && !server2.HasActiveConnections();
+    });
+}
+
+/////////////////////////// Pending packets per peer test
+
+void CheckPendingPacketsPerPeerTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    constexpr uint16_t kClientPort      = CHIP_PORT + 15;
+    constexpr uint16_t kServer2Port     = CHIP_PORT + 16;
+    constexpr size_t kMaxPendingPerPeer = kMaxTcpPendingPackets / 2;
+
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+
+    // A peer that has queued its share of the pool does not keep others from queueing theirs
+    Transport::TCP<2, kMaxTcpPendingPackets> client;
+    TCPImpl server1;
+    TCPImpl server2;
+
+    NL_TEST_ASSERT(inSuite,
+                   client.Init(Transport::TcpListenParameters(&ctx.GetInetLayer())
+                                   .SetAddressType(kIPAddressType_IPv4)
+                                   .SetListenPort(kClientPort)
+                                   .SetMaxPendingPacketsPerPeer(kMaxPendingPerPeer)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   server1.Init(Transport::TcpListenParameters(&ctx.GetInetLayer()).SetAddressType(kIPAddressType_IPv4)) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   server2.Init(Transport::TcpListenParameters(&ctx.GetInetLayer())
+                                    .SetAddressType(kIPAddressType_IPv4)
+                                    .SetListenPort(kServer2Port)) == CHIP_NO_ERROR);
+
+    server1.SetMessageReceiveHandler(MessageReceiveHandler, inSuite);
+    server2.SetMessageReceiveHandler(MessageReceiveHandler, inSuite);
+    ReceiveHandlerCallCount = 0;
+
+    for (size_t i = 0; i < kMaxPendingPerPeer; i++)
+    {
+        NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr)) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr)) == CHIP_ERROR_NO_MEMORY);
+
+    for (size_t i = 0; i < kMaxPendingPerPeer; i++)
+    {
+        NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr, kServer2Port)) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr, kServer2Port)) == CHIP_ERROR_NO_MEMORY);
+
+    ctx.DriveIOUntil(5000 /* ms */, []() { return ReceiveHandlerCallCount == static_cast<int>(2 * kMaxPendingPerPeer); });
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == static_cast<int>(2 * kMaxPendingPerPeer));
+
+    const Transport::TCPConnectionStatistics & statistics = client.GetStatistics();
+    NL_TEST_ASSERT(inSuite, statistics.mOpened == 2);
+    NL_TEST_ASSERT(inSuite, statistics.mMessagesSent == 2 * kMaxPendingPerPeer);
+
+    client.CloseActiveConnections();
+    ctx.DriveIOUntil(5000 /* ms */, [&server1, &server2]() {
+        return !server1.HasActiveConnections() && !server2.HasActiveConnections();
+    });
+}
+
+/////////////////////////// Write coalescing test
+
+/**
+ * Send a message over an established connection with write coalescing, and
+ * check that it is held back on the end point, unwritten, until either the
+ * next message fills the coalescing threshold or the flush timer fires.
+ */
+void CheckWriteCoalescing(nlTestSuite * inSuite, void * inContext, uint16_t clientPort, bool byTimer)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    // A held back message is the 2 size bytes, the packet header and the payload
+    PacketHeader header;
+    header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageId(kMessageId);
+    const size_t messageBytes = 2 + header.EncodeSizeBytes() + sizeof(PAYLOAD);
+
+    // Either the timer never fires during the test, or the threshold is never reached
+    const uint32_t flushDelayMs = byTimer ? 10 : 60000;
+    const size_t flushBytes     = byTimer ? SIZE_MAX : 2 * messageBytes;
+
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+
+    TCPImpl client;
+    TCPImpl server;
+
+    NL_TEST_ASSERT(inSuite,
+                   client.Init(Transport::TcpListenParameters(&ctx.GetInetLayer())
+                                   .SetAddressType(kIPAddressType_IPv4)
+                                   .SetListenPort(clientPort)
+                                   .EnableWriteCoalescing(flushDelayMs, flushBytes)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   server.Init(Transport::TcpListenParameters(&ctx.GetInetLayer()).SetAddressType(kIPAddressType_IPv4)) ==
+                       CHIP_NO_ERROR);
+
+    server.SetMessageReceiveHandler(MessageReceiveHandler, inSuite);
+    ReceiveHandlerCallCount = 0;
+
+    // The first message goes out once connected, without coalescing
+    NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr)) == CHIP_NO_ERROR);
+    ctx.DriveIOUntil(5000 /* ms */, []() { return ReceiveHandlerCallCount == 1; });
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == 1);
+
+    const Transport::TCPConnectionStatistics before = client.GetStatistics();
+    Transport::TCPConnectionStatistics statistics;
+
+    // The next one is corked on the end point
+    NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr)) == CHIP_NO_ERROR);
+    statistics = client.GetStatistics();
+    NL_TEST_ASSERT(inSuite, statistics.mCoalesced == before.mCoalesced + 1);
+    NL_TEST_ASSERT(inSuite, statistics.mFlushes == before.mFlushes);
+    NL_TEST_ASSERT(inSuite, statistics.mWrites == before.mWrites);
+
+    if (byTimer)
+    {
+        // The flush timer writes it
+        ctx.DriveIOUntil(5000 /* ms */, []() { return ReceiveHandlerCallCount == 2; });
+        NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == 2);
+
+        statistics = client.GetStatistics();
+        NL_TEST_ASSERT(inSuite, statistics.mFlushes == before.mFlushes + 1);
+        NL_TEST_ASSERT(inSuite, statistics.mWrites == before.mWrites + 1);
+    }
+    else
+    {
+        // However long the event loop runs, it is not written
+        ctx.DriveIOUntil(200 /* ms */, []() { return ReceiveHandlerCallCount != 1; });
+        NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == 1);
+        NL_TEST_ASSERT(inSuite, client.GetStatistics().mWrites == before.mWrites);
+
+        // Until the next message reaches the threshold, and both are pushed in a single write
+        NL_TEST_ASSERT(inSuite, SendPayload(client, Transport::PeerAddress::TCP(addr)) == CHIP_NO_ERROR);
+        statistics = client.GetStatistics();
+        NL_TEST_ASSERT(inSuite, statistics.mCoalesced == before.mCoalesced + 2);
+        NL_TEST_ASSERT(inSuite, statistics.mFlushes == before.mFlushes + 1);
+        NL_TEST_ASSERT(inSuite, statistics.mWrites == before.mWrites + 1);
+
+        ctx.DriveIOUntil(5000 /* ms */, []() { return ReceiveHandlerCallCount == 3; });
+        NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == 3);
+    }
+
+    client.CloseActiveConnections();
+    ctx.DriveIOUntil(5000 /* ms */, [&server]() { return !server.HasActiveConnections(); });
+}
+
+void CheckCoalescingThresholdTest(nlTestSuite * inSuite, void * inContext)
+{
+    CheckWriteCoalescing(inSuite, inContext, CHIP_PORT + 17, false);
+}
+
+void CheckCoalescingTimerTest(nlTestSuite * inSuite, void * inContext)
+{
+    CheckWriteCoalescing(inSuite, inContext, CHIP_PORT + 18, true);
+}
+
+/////////////////////////// Split message test
+
+// The first message of PASE: a SPAKE2+ pA point, parsed by SecurePairingSession from the first buffer of the message
+constexpr uint16_t kPaseProtocolId   = 0x0001; // Protocols::kProtocol_SecurityChannel
+constexpr uint8_t kPaseCompute_pA    = 0;      // SecurePairingSession::kSpake2pCompute_pA
+constexpr uint16_t kPasePointLength  = 65;     // uncompressed P-256 point
+constexpr uint16_t kFillerProtocolId = 0x0002;
+constexpr uint16_t kSplitMessagePort = CHIP_PORT + 12;
+
+// Bytes of the PASE message, size prefix included, sharing the receive buffer of the filler message sent before it
+constexpr uint16_t kPaseBytesInFirstBuffer = 40;
+
+int PaseHandlerCallCount   = 0;
+int FillerHandlerCallCount = 0;
+
+void PaseMessageReceiveHandler(const PacketHeader & header, const Transport::PeerAddress & source,
+                               System::PacketBufferHandle msgBuf, nlTestSuite * inSuite)
+{
+    PayloadHeader payloadHeader;
+    uint16_t headerSize = 0;
+
+    // Messages must be handed up in a single buffer, however many buffers they arrived in
+    NL_TEST_ASSERT(inSuite, msgBuf->Next() == nullptr);
+    NL_TEST_ASSERT(inSuite, payloadHeader.Decode(msgBuf->Start(), msgBuf->DataLength(), &headerSize) == CHIP_NO_ERROR);
+
+    if (payloadHeader.GetProtocolID() == kFillerProtocolId)
+    {
+        FillerHandlerCallCount++;
+        return;
+    }
+
+    NL_TEST_ASSERT(inSuite, payloadHeader.GetProtocolID() == kPaseProtocolId);
+    NL_TEST_ASSERT(inSuite, payloadHeader.GetMessageType() == kPaseCompute_pA);
+
+    msgBuf->ConsumeHead(headerSize);
+    NL_TEST_ASSERT(inSuite, msgBuf->DataLength() == kPasePointLength);
+    for (uint16_t i = 0; i < msgBuf->DataLength(); i++)
+    {
+        NL_TEST_ASSERT(inSuite, msgBuf->Start()[i] == static_cast<uint8_t>(i));
+    }
+
+    PaseHandlerCallCount++;
+}
+
+/// Append a message with its size prefix to a stream, the payload following the payload header.
+void AppendMessage(nlTestSuite * inSuite, std::vector<uint8_t> & stream, PayloadHeader & payloadHeader, size_t payloadLength)
+{
+    PacketHeader header;
+    uint8_t headerBytes[kMaxPacketHeaderLen + kMaxPayloadHeaderLen];
+    uint16_t headerSize        = 0;
+    uint16_t payloadHeaderSize = 0;
+
+    header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageId(kMessageId);
+
+    NL_TEST_ASSERT(inSuite, header.Encode(headerBytes, kMaxPacketHeaderLen, &headerSize) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   payloadHeader.Encode(&headerBytes[headerSize], kMaxPayloadHeaderLen, &payloadHeaderSize) == CHIP_NO_ERROR);
+
+    const size_t messageSize = headerSize + payloadHeaderSize + payloadLength;
+    stream.push_back(static_cast<uint8_t>(messageSize));
+    stream.push_back(static_cast<uint8_t>(messageSize >> 8));
+    stream.insert(stream.end(), headerBytes, headerBytes + headerSize + payloadHeaderSize);
+    for (size_t i = 0; i < payloadLength; i++)
+    {
+        stream.push_back(static_cast<uint8_t>(i));
+    }
+}
+
+void CheckSplitMessageTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    TCPImpl tcp;
+    PayloadHeader fillerHeader;
+    PayloadHeader paseHeader;
+    std::vector<uint8_t> stream;
+    int noDelay = 1;
+
+    fillerHeader.SetProtocolID(kFillerProtocolId);
+    paseHeader.SetProtocolID(kPaseProtocolId).SetMessageType(kPaseCompute_pA);
+
+    // The filler leaves room for the start of the PASE message only in the first receive buffer, so that the rest of it
+    // is read into a second buffer
+    AppendMessage(inSuite, stream, fillerHeader, 0);
+    const size_t fillerOverhead = stream.size();
+    stream.clear();
+    AppendMessage(inSuite, stream, fillerHeader,
+                  CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX - kPaseBytesInFirstBuffer - fillerOverhead);
+    AppendMessage(inSuite, stream, paseHeader, kPasePointLength);
+
+    NL_TEST_ASSERT(inSuite,
+                   tcp.Init(Transport::TcpListenParameters(&ctx.GetInetLayer())
+                                .SetAddressType(kIPAddressType_IPv4)
+                                .SetListenPort(kSplitMessagePort)) == CHIP_NO_ERROR);
+    tcp.SetMessageReceiveHandler(PaseMessageReceiveHandler, inSuite);
+    PaseHandlerCallCount   = 0;
+    FillerHandlerCallCount = 0;
+
+    int sender                    = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in listenAddr = {};
+    listenAddr.sin_family         = AF_INET;
+    listenAddr.sin_port           = htons(kSplitMessagePort);
+    listenAddr.sin_addr.s_addr    = htonl(INADDR_LOOPBACK);
+
+    NL_TEST_ASSERT(inSuite, connect(sender, reinterpret_cast<struct sockaddr *>(&listenAddr), sizeof(listenAddr)) == 0);
+    setsockopt(sender, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    ctx.DriveIOUntil(5000 /* ms */, [&tcp]() { return tcp.HasActiveConnections(); });
+
+    // The first segment fills a receive buffer, ending inside the PASE message
+    const size_t firstSegment = CHIP_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX;
+    NL_TEST_ASSERT(inSuite, send(sender, stream.data(), firstSegment, 0) == static_cast<ssize_t>(firstSegment));
+    ctx.DriveIOUntil(5000 /* ms */, []() { return FillerHandlerCallCount != 0; });
+    NL_TEST_ASSERT(inSuite, FillerHandlerCallCount == 1);
+
+    NL_TEST_ASSERT(inSuite,
+                   send(sender, &stream[firstSegment], stream.size() - firstSegment, 0) ==
+                       static_cast<ssize_t>(stream.size() - firstSegment));
+    ctx.DriveIOUntil(5000 /* ms */, []() { return PaseHandlerCallCount != 0; });
+    NL_TEST_ASSERT(inSuite, PaseHandlerCallCount == 1);
+
+    close(sender);
+    ctx.DriveIOUntil(5000 /* ms */, [&tcp]() { return !tcp.HasActiveConnections(); });
+}
+
 } // namespace
 
 // Test Suite
@@ -167,12 +588,18 @@ void CheckMessageTest6(nlTestSuite * inSuite, void * inContext)
 static const nlTest sTests[] =
 {
 #if INET_CONFIG_ENABLE_IPV4
-    NL_TEST_DEF("Simple Init Test IPV4",   CheckSimpleInitTest4),
-    NL_TEST_DEF("Message Self Test IPV4",  CheckMessageTest4),
+    NL_TEST_DEF("Simple Init Test IPV4",         CheckSimpleInitTest4),
+    NL_TEST_DEF("Message Self Test IPV4",        CheckMessageTest4),
+    NL_TEST_DEF("Connection Pool Test",          CheckConnectionPoolTest),
+    NL_TEST_DEF("Pending Packets Test",          CheckPendingPacketsTest),
+    NL_TEST_DEF("Pending Packets Per Peer Test", CheckPendingPacketsPerPeerTest),
+    NL_TEST_DEF("Coalescing Threshold Test",     CheckCoalescingThresholdTest),
+    NL_TEST_DEF("Coalescing Timer Test",         CheckCoalescingTimerTest),
+    NL_TEST_DEF("Split Message Test",            CheckSplitMessageTest),
 #endif
 
-    NL_TEST_DEF("Simple Init Test IPV6",   CheckSimpleInitTest6),
-    NL_TEST_DEF("Message Self Test IPV6",  CheckMessageTest6),
+    NL_TEST_DEF("Simple Init Test IPV6",         CheckSimpleInitTest6),
+    NL_TEST_DEF("Message Self Test IPV6",        CheckMessageTest6),
 
     NL_TEST_SENTINEL()
 };
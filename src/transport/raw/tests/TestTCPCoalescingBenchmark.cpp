@@ -0,0 +1,227 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a loopback benchmark of the throughput of small
+ *      messages sent over a TCP transport in bursts, each message written on
+ *      its own and with write coalescing. Every message received is checked,
+ *      and the throughput and number of writes are printed for each mode.
+ *
+ */
+
+#include "NetworkTestHelpers.h"
+
+#include <core/CHIPCore.h>
+#include <support/CodeUtils.h>
+#include <support/ReturnMacros.h>
+#include <support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+#include <transport/raw/TCP.h>
+
+#include <nlbyteorder.h>
+#include <nlunit-test.h>
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace chip;
+using namespace chip::Inet;
+
+static int Initialize(void * aContext);
+static int Finalize(void * aContext);
+
+namespace {
+
+constexpr size_t kMaxTcpActiveConnectionCount = 4;
+constexpr size_t kMaxTcpPendingPackets        = 4;
+
+using TCPImpl = Transport::TCP<kMaxTcpActiveConnectionCount, kMaxTcpPendingPackets>;
+
+constexpr uint16_t kReceiverPort  = 11101;
+constexpr uint16_t kSenderPort    = 11102;
+constexpr NodeId kSourceNodeId    = 123654;
+constexpr uint16_t kPayloadSize   = 16;
+constexpr uint32_t kMessageCount  = 20000;
+constexpr uint32_t kBurstSize     = 32;
+constexpr size_t kCoalescingBytes = 1400; // about one segment
+constexpr unsigned kDrainTimeout  = 5000; // ms
+
+using TestContext = chip::Test::IOContext;
+TestContext sContext;
+
+struct ReceiveState
+{
+    uint32_t mReceived;
+    uint32_t mCorrupted;
+};
+
+void MessageReceiveHandler(const PacketHeader & header, const Transport::PeerAddress & source, System::PacketBufferHandle msgBuf,
+                           ReceiveState * state)
+{
+    const uint8_t expected = static_cast<uint8_t>(header.GetMessageId());
+    bool intact            = (header.GetMessageId() == state->mReceived) && (msgBuf->TotalLength() == kPayloadSize);
+
+    // Messages may be handed up split over a chain of buffers
+    for (const System::PacketBuffer * buffer = msgBuf.Get_ForNow(); intact && buffer != nullptr; buffer = buffer->Next())
+    {
+        for (uint16_t i = 0; intact && i < buffer->DataLength(); i++)
+        {
+            intact = (buffer->Start()[i] == expected);
+        }
+    }
+
+    if (!intact)
+    {
+        state->mCorrupted++;
+    }
+    state->mReceived++;
+}
+
+CHIP_ERROR SendSmallMessage(TCPImpl & sender, const Transport::PeerAddress & address, uint32_t messageId)
+{
+    System::PacketBufferHandle buffer = System::PacketBuffer::NewWithAvailableSize(kPayloadSize);
+    VerifyOrReturnError(!buffer.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    memset(buffer->Start(), static_cast<uint8_t>(messageId), kPayloadSize);
+    buffer->SetDataLength(kPayloadSize);
+
+    PacketHeader header;
+    header.SetSourceNodeId(kSourceNodeId).SetMessageId(messageId);
+
+    return sender.SendMessage(header, address, buffer.Release_ForNow());
+}
+
+/**
+ * Send the messages in bursts, letting the event loop run once between
+ * bursts, wait for all of them and print the throughput. Returns the number
+ * of writes to the socket of the sender.
+ */
+uint32_t RunBursts(nlTestSuite * inSuite, TestContext & ctx, bool coalescing)
+{
+    TCPImpl receiver;
+    TCPImpl sender;
+    ReceiveState state = { 0, 0 };
+    IPAddress addr;
+
+    IPAddress::FromString("127.0.0.1", addr);
+    const Transport::PeerAddress receiverAddress = Transport::PeerAddress::TCP(addr, kReceiverPort);
+
+    Transport::TcpListenParameters senderParams(&ctx.GetInetLayer());
+    senderParams.SetAddressType(kIPAddressType_IPv4).SetListenPort(kSenderPort);
+    if (coalescing)
+    {
+        senderParams.EnableWriteCoalescing(0, kCoalescingBytes);
+    }
+
+    NL_TEST_ASSERT(inSuite,
+                   receiver.Init(Transport::TcpListenParameters(&ctx.GetInetLayer())
+                                     .SetAddressType(kIPAddressType_IPv4)
+                                     .SetListenPort(kReceiverPort)) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sender.Init(senderParams) == CHIP_NO_ERROR);
+    receiver.SetMessageReceiveHandler(MessageReceiveHandler, &state);
+
+    // Connect with the first message
+    NL_TEST_ASSERT(inSuite, SendSmallMessage(sender, receiverAddress, 0) == CHIP_NO_ERROR);
+    ctx.DriveIOUntil(kDrainTimeout, [&state]() { return state.mReceived > 0; });
+    NL_TEST_ASSERT(inSuite, state.mReceived == 1);
+
+    const uint32_t writesBefore = sender.GetStatistics().mWrites;
+    uint64_t start              = System::Platform::Layer::GetClock_MonotonicHiRes();
+    for (uint32_t messageId = 1; messageId < kMessageCount;)
+    {
+        for (uint32_t i = 0; i < kBurstSize && messageId < kMessageCount; i++, messageId++)
+        {
+            NL_TEST_ASSERT(inSuite, SendSmallMessage(sender, receiverAddress, messageId) == CHIP_NO_ERROR);
+        }
+        ctx.DriveIO();
+    }
+    ctx.DriveIOUntil(kDrainTimeout, [&state]() { return state.mReceived >= kMessageCount; });
+    uint64_t elapsed = System::Platform::Layer::GetClock_MonotonicHiRes() - start;
+
+    NL_TEST_ASSERT(inSuite, state.mReceived == kMessageCount);
+    NL_TEST_ASSERT(inSuite, state.mCorrupted == 0);
+
+    const uint32_t writes = sender.GetStatistics().mWrites - writesBefore;
+
+    sender.CloseActiveConnections();
+    ctx.DriveIOUntil(kDrainTimeout,
+                     [&receiver, &sender]() { return !receiver.HasActiveConnections() && !sender.HasActiveConnections(); });
+
+    printf("%-15s %6u messages of %u bytes, %6u writes: %10.0f messages/s\n", coalescing ? "coalescing" : "no coalescing",
+           state.mReceived, kPayloadSize, writes, static_cast<double>(state.mReceived) * 1e6 / static_cast<double>(elapsed));
+
+    return writes;
+}
+
+void TestSmallMessageThroughput(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    const uint32_t plainWrites      = RunBursts(inSuite, ctx, false);
+    const uint32_t coalescingWrites = RunBursts(inSuite, ctx, true);
+
+    NL_TEST_ASSERT(inSuite, coalescingWrites < plainWrites);
+}
+
+} // namespace
+
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("SmallMessageThroughput", TestSmallMessageThroughput),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite sSuite =
+{
+    "Test-CHIP-Tcp-Coalescing-Benchmark",
+    &sTests[0],
+    Initialize,
+    Finalize
+};
+// clang-format on
+
+/**
+ *  Initialize the test suite.
+ */
+static int Initialize(void * aContext)
+{
+    CHIP_ERROR err = reinterpret_cast<TestContext *>(aContext)->Init(&sSuite);
+    return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+/**
+ *  Finalize the test suite.
+ */
+static int Finalize(void * aContext)
+{
+    CHIP_ERROR err = reinterpret_cast<TestContext *>(aContext)->Shutdown();
+    return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int TestTCPCoalescingBenchmark()
+{
+    nlTestRunner(&sSuite, &sContext);
+
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestTCPCoalescingBenchmark);
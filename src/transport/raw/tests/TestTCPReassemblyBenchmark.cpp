@@ -0,0 +1,282 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a loopback benchmark of the reassembly of
+ *      messages out of a TCP stream. The stream is written in segments cut
+ *      at adversarial boundaries - single bytes, sizes drifting over the
+ *      length prefixes and headers, messages spanning several buffers - and
+ *      every message received is checked, in the buffer chain it is handed
+ *      up in. Throughput is printed for each way of cutting the stream.
+ *
+ */
+
+#include "NetworkTestHelpers.h"
+
+#include <core/CHIPCore.h>
+#include <support/CodeUtils.h>
+#include <support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+#include <transport/raw/TCP.h>
+
+#include <nlbyteorder.h>
+#include <nlunit-test.h>
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace chip;
+using namespace chip::Inet;
+
+static int Initialize(void * aContext);
+static int Finalize(void * aContext);
+
+namespace {
+
+constexpr size_t kMaxTcpActiveConnectionCount = 4;
+constexpr size_t kMaxTcpPendingPackets        = 4;
+
+using TCPImpl = Transport::TCP<kMaxTcpActiveConnectionCount, kMaxTcpPendingPackets>;
+
+constexpr uint16_t kListenPort   = 11099;
+constexpr NodeId kSourceNodeId   = 123654;
+constexpr unsigned kDrainTimeout = 5000; // ms
+
+using TestContext = chip::Test::IOContext;
+TestContext sContext;
+
+/**
+ * A way of cutting the stream: messages of the given payload size are written
+ * in segments whose sizes cycle through the given list.
+ */
+struct SplitPattern
+{
+    const char * mName;
+    uint16_t mPayloadSize;
+    uint32_t mMessageCount;
+    std::vector<size_t> mSegmentSizes;
+};
+
+// clang-format off
+const SplitPattern sPatterns[] =
+{
+    { "1-byte segments",       32,   100, { 1 } },
+    { "drifting boundaries",   200,  5000, { 3, 17, 127, 509 } },
+    { "multi-buffer messages", 4000, 1000, { 1499, 1 } },
+    { "bulk",                  4000, 1000, { 16384 } },
+};
+// clang-format on
+
+struct ReceiveState
+{
+    nlTestSuite * mSuite;
+    uint16_t mPayloadSize;
+    uint32_t mReceived;
+    uint32_t mChained;
+    uint32_t mCorrupted;
+};
+
+uint8_t PayloadByte(uint32_t messageId, size_t offset)
+{
+    return static_cast<uint8_t>(messageId + offset);
+}
+
+void MessageReceiveHandler(const PacketHeader & header, const Transport::PeerAddress & source, System::PacketBufferHandle msgBuf,
+                           ReceiveState * state)
+{
+    const uint32_t messageId = header.GetMessageId();
+    size_t offset            = 0;
+    bool intact              = (messageId == state->mReceived) && (msgBuf->TotalLength() == state->mPayloadSize);
+
+    if (msgBuf->Next() != nullptr)
+    {
+        state->mChained++;
+    }
+
+    // Check the payload where it lies, without flattening the chain
+    for (const System::PacketBuffer * buffer = msgBuf.Get_ForNow(); intact && buffer != nullptr; buffer = buffer->Next())
+    {
+        for (uint16_t i = 0; intact && i < buffer->DataLength(); i++, offset++)
+        {
+            intact = (buffer->Start()[i] == PayloadByte(messageId, offset));
+        }
+    }
+
+    if (!intact)
+    {
+        state->mCorrupted++;
+    }
+    state->mReceived++;
+}
+
+/// Build the stream of length-prefixed messages of a pattern.
+std::vector<uint8_t> BuildStream(nlTestSuite * inSuite, const SplitPattern & pattern)
+{
+    std::vector<uint8_t> stream;
+
+    for (uint32_t messageId = 0; messageId < pattern.mMessageCount; messageId++)
+    {
+        PacketHeader header;
+        uint8_t headerBytes[kMaxPacketHeaderLen];
+        uint16_t headerSize = 0;
+
+        header.SetSourceNodeId(kSourceNodeId).SetMessageId(messageId);
+        NL_TEST_ASSERT(inSuite, header.Encode(headerBytes, sizeof(headerBytes), &headerSize) == CHIP_NO_ERROR);
+
+        const uint16_t messageSize = static_cast<uint16_t>(headerSize + pattern.mPayloadSize);
+        stream.push_back(static_cast<uint8_t>(messageSize));
+        stream.push_back(static_cast<uint8_t>(messageSize >> 8));
+        stream.insert(stream.end(), headerBytes, headerBytes + headerSize);
+        for (size_t i = 0; i < pattern.mPayloadSize; i++)
+        {
+            stream.push_back(PayloadByte(messageId, i));
+        }
+    }
+
+    return stream;
+}
+
+/**
+ * Write the stream of a pattern to the transport, one segment at a time, wait
+ * for all its messages and print the throughput.
+ */
+void RunPattern(nlTestSuite * inSuite, TestContext & ctx, const SplitPattern & pattern)
+{
+    TCPImpl tcp;
+    ReceiveState state          = { inSuite, pattern.mPayloadSize, 0, 0, 0 };
+    std::vector<uint8_t> stream = BuildStream(inSuite, pattern);
+    int noDelay                 = 1;
+
+    CHIP_ERROR err = tcp.Init(
+        Transport::TcpListenParameters(&ctx.GetInetLayer()).SetAddressType(kIPAddressType_IPv4).SetListenPort(kListenPort));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    tcp.SetMessageReceiveHandler(MessageReceiveHandler, &state);
+
+    int sender                    = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in listenAddr = {};
+    listenAddr.sin_family         = AF_INET;
+    listenAddr.sin_port           = htons(kListenPort);
+    listenAddr.sin_addr.s_addr    = htonl(INADDR_LOOPBACK);
+
+    NL_TEST_ASSERT(inSuite, connect(sender, reinterpret_cast<struct sockaddr *>(&listenAddr), sizeof(listenAddr)) == 0);
+    setsockopt(sender, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    fcntl(sender, F_SETFL, fcntl(sender, F_GETFL) | O_NONBLOCK);
+    ctx.DriveIOUntil(kDrainTimeout, [&tcp]() { return tcp.HasActiveConnections(); });
+
+    uint64_t start = System::Platform::Layer::GetClock_MonotonicHiRes();
+    for (size_t offset = 0, segment = 0; offset < stream.size(); segment++)
+    {
+        size_t length = std::min(pattern.mSegmentSizes[segment % pattern.mSegmentSizes.size()], stream.size() - offset);
+
+        while (length > 0)
+        {
+            ssize_t sent = send(sender, &stream[offset], length, 0);
+            if (sent > 0)
+            {
+                offset += static_cast<size_t>(sent);
+                length -= static_cast<size_t>(sent);
+            }
+            else if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                NL_TEST_ASSERT(inSuite, false);
+                close(sender);
+                return;
+            }
+
+            // Have the transport read the segment before the next one is written, so they stay apart
+            ctx.DriveIO();
+        }
+    }
+    ctx.DriveIOUntil(kDrainTimeout, [&state, &pattern]() { return state.mReceived >= pattern.mMessageCount; });
+    uint64_t elapsed = System::Platform::Layer::GetClock_MonotonicHiRes() - start;
+
+    NL_TEST_ASSERT(inSuite, state.mReceived == pattern.mMessageCount);
+    NL_TEST_ASSERT(inSuite, state.mCorrupted == 0);
+
+    close(sender);
+    ctx.DriveIOUntil(kDrainTimeout, [&tcp]() { return !tcp.HasActiveConnections(); });
+
+    printf("%-22s %6u messages, %6u chained: %8.2f MB/s\n", pattern.mName, state.mReceived, state.mChained,
+           static_cast<double>(stream.size()) / static_cast<double>(elapsed));
+}
+
+void TestReassembly(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    for (const SplitPattern & pattern : sPatterns)
+    {
+        RunPattern(inSuite, ctx, pattern);
+    }
+}
+
+} // namespace
+
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("Reassembly", TestReassembly),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite sSuite =
+{
+    "Test-CHIP-Tcp-Reassembly-Benchmark",
+    &sTests[0],
+    Initialize,
+    Finalize
+};
+// clang-format on
+
+/**
+ *  Initialize the test suite.
+ */
+static int Initialize(void * aContext)
+{
+    CHIP_ERROR err = reinterpret_cast<TestContext *>(aContext)->Init(&sSuite);
+    return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+/**
+ *  Finalize the test suite.
+ */
+static int Finalize(void * aContext)
+{
+    CHIP_ERROR err = reinterpret_cast<TestContext *>(aContext)->Shutdown();
+    return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int TestTCPReassemblyBenchmark()
+{
+    nlTestRunner(&sSuite, &sContext);
+
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestTCPReassemblyBenchmark);
@@ -150,6 +150,54 @@ void CheckMessageTest6(nlTestSuite * inSuite, void * inContext)
     CheckMessageTest(inSuite, inContext, addr);
 }
 
+/////////////////////////// Batched messaging test
+
+void CheckBatchMessageTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    // More messages than fit in one batch, so queueing flushes on its own too.
+    constexpr int kMessageCount = 2 * INET_CONFIG_UDP_SEND_BATCH_SIZE + 1;
+    uint16_t payload_len        = sizeof(PAYLOAD);
+
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    Transport::UDP udp;
+
+    err = udp.Init(Transport::UdpListenParameters(&ctx.GetInetLayer()).SetAddressType(addr.Type()));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    udp.SetMessageReceiveHandler(MessageReceiveHandler, inSuite);
+    ReceiveHandlerCallCount = 0;
+
+    PacketHeader header;
+    header.SetSourceNodeId(kSourceNodeId).SetDestinationNodeId(kDestinationNodeId).SetMessageId(kMessageId);
+
+    udp.StartBatch();
+
+    for (int i = 0; i < kMessageCount; i++)
+    {
+        chip::System::PacketBufferHandle buffer = chip::System::PacketBuffer::NewWithAvailableSize(payload_len);
+        NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+
+        memmove(buffer->Start(), PAYLOAD, payload_len);
+        buffer->SetDataLength(payload_len);
+
+        err = udp.SendMessage(header, Transport::PeerAddress::UDP(addr), buffer.Release_ForNow());
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    err = udp.FlushBatch();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    ctx.DriveIOUntil(1000 /* ms */, []() { return ReceiveHandlerCallCount >= kMessageCount; });
+
+    NL_TEST_ASSERT(inSuite, ReceiveHandlerCallCount == kMessageCount);
+}
+
 // Test Suite
 
 /**
@@ -161,6 +209,7 @@ static const nlTest sTests[] =
 #if INET_CONFIG_ENABLE_IPV4
     NL_TEST_DEF("Simple Init Test IPV4",   CheckSimpleInitTest4),
     NL_TEST_DEF("Message Self Test IPV4",  CheckMessageTest4),
+    NL_TEST_DEF("Batch Message Test IPV4", CheckBatchMessageTest),
 #endif
 
     NL_TEST_DEF("Simple Init Test IPV6",   CheckSimpleInitTest6),
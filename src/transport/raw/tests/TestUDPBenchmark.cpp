@@ -0,0 +1,203 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a loopback throughput benchmark of UDP end
+ *      points, sending and receiving one datagram per system call and
+ *      event loop iteration, against batches of datagrams. Throughput and
+ *      event loop iterations are printed for both modes.
+ *
+ */
+
+#include "NetworkTestHelpers.h"
+
+#include <core/CHIPCore.h>
+#include <support/CodeUtils.h>
+#include <support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+
+#include <nlunit-test.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+
+using namespace chip;
+using namespace chip::Inet;
+
+static int Initialize(void * aContext);
+static int Finalize(void * aContext);
+
+namespace {
+
+using TestContext = chip::Test::IOContext;
+TestContext sContext;
+
+constexpr uint16_t kReceivePort    = 11097;
+constexpr size_t kDatagramCount    = 20000;
+constexpr size_t kBurstSize        = 32; // small enough for the socket receive buffer to hold a whole burst
+constexpr uint16_t kDatagramSize   = 64;
+constexpr unsigned kBurstTimeoutMs = 1000;
+
+size_t sReceivedCount = 0;
+
+void OnReceive(IPEndPointBasis * endPoint, System::PacketBufferHandle buffer, const IPPacketInfo * pktInfo)
+{
+    sReceivedCount++;
+}
+
+System::PacketBuffer * NewDatagram()
+{
+    System::PacketBufferHandle buffer = System::PacketBuffer::NewWithAvailableSize(kDatagramSize);
+    VerifyOrDie(!buffer.IsNull());
+
+    memset(buffer->Start(), 0xA5, kDatagramSize);
+    buffer->SetDataLength(kDatagramSize);
+
+    return buffer.Release_ForNow();
+}
+
+void RunBenchmark(nlTestSuite * inSuite, TestContext & ctx, bool batched)
+{
+    UDPEndPoint * sender   = nullptr;
+    UDPEndPoint * receiver = nullptr;
+    IPPacketInfo pktInfos[kBurstSize];
+    System::PacketBuffer * msgs[kBurstSize];
+    IPAddress addr;
+    size_t loops = 0;
+
+    IPAddress::FromString("127.0.0.1", addr);
+
+    INET_ERROR err = ctx.GetInetLayer().NewUDPEndPoint(&receiver);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = receiver->Bind(kIPAddressType_IPv4, addr, kReceivePort);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    receiver->OnMessageReceived = OnReceive;
+    receiver->SetReceiveBatchSize(batched ? INET_CONFIG_UDP_RECEIVE_BATCH_SIZE : 1);
+    err = receiver->Listen();
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    err = ctx.GetInetLayer().NewUDPEndPoint(&sender);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = sender->Bind(kIPAddressType_IPv4, addr, 0);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    for (IPPacketInfo & pktInfo : pktInfos)
+    {
+        pktInfo.Clear();
+        pktInfo.DestAddress = addr;
+        pktInfo.DestPort    = kReceivePort;
+    }
+
+    sReceivedCount = 0;
+
+    uint64_t start = System::Platform::Layer::GetClock_MonotonicHiRes();
+    for (size_t sent = 0; sent < kDatagramCount; sent += kBurstSize)
+    {
+        if (batched)
+        {
+            for (System::PacketBuffer *& msg : msgs)
+            {
+                msg = NewDatagram();
+            }
+
+            err = sender->SendMsgs(pktInfos, msgs, kBurstSize);
+            NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+        }
+        else
+        {
+            for (const IPPacketInfo & pktInfo : pktInfos)
+            {
+                err = sender->SendMsg(&pktInfo, NewDatagram());
+                NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+            }
+        }
+
+        uint64_t burstStart = System::Platform::Layer::GetClock_MonotonicMS();
+        while (sReceivedCount < sent + kBurstSize &&
+               System::Platform::Layer::GetClock_MonotonicMS() - burstStart < kBurstTimeoutMs)
+        {
+            ctx.DriveIO();
+            loops++;
+        }
+    }
+    uint64_t elapsed = System::Platform::Layer::GetClock_MonotonicHiRes() - start;
+
+    NL_TEST_ASSERT(inSuite, sReceivedCount == kDatagramCount);
+
+    printf("%-13s %8.0f datagrams/s, %6zu event loop iterations for %zu datagrams\n", batched ? "batched:" : "one by one:",
+           static_cast<double>(sReceivedCount) * 1000000 / static_cast<double>(elapsed), loops, kDatagramCount);
+
+    sender->Free();
+    receiver->Free();
+}
+
+void TestLoopbackThroughput(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    RunBenchmark(inSuite, ctx, false);
+    RunBenchmark(inSuite, ctx, true);
+}
+
+} // namespace
+
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("LoopbackThroughput", TestLoopbackThroughput),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite sSuite =
+{
+    "Test-CHIP-Udp-Benchmark",
+    &sTests[0],
+    Initialize,
+    Finalize
+};
+// clang-format on
+
+/**
+ *  Initialize the test suite.
+ */
+static int Initialize(void * aContext)
+{
+    CHIP_ERROR err = reinterpret_cast<TestContext *>(aContext)->Init(&sSuite);
+    return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+/**
+ *  Finalize the test suite.
+ */
+static int Finalize(void * aContext)
+{
+    CHIP_ERROR err = reinterpret_cast<TestContext *>(aContext)->Shutdown();
+    return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int TestUDPBenchmark()
+{
+    nlTestRunner(&sSuite, &sContext);
+
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestUDPBenchmark);
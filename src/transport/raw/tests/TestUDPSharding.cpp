@@ -0,0 +1,262 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for UDP transports sharded with a
+ *      UDPShardGroup.
+ */
+
+#include "NetworkTestHelpers.h"
+
+#include <core/CHIPCore.h>
+#include <support/CodeUtils.h>
+#include <support/UnitTestRegistration.h>
+#include <transport/raw/UDP.h>
+#include <transport/raw/UDPShardGroup.h>
+
+#include <nlunit-test.h>
+
+using namespace chip;
+using namespace chip::Inet;
+using namespace chip::Transport;
+
+static int Initialize(void * aContext);
+static int Finalize(void * aContext);
+
+namespace {
+
+constexpr uint16_t kListenPort = CHIP_PORT + 20;
+constexpr uint16_t kSendPort   = CHIP_PORT + 21;
+constexpr uint16_t kShardCount = 3;
+
+using TestContext = chip::Test::IOContext;
+TestContext sContext;
+
+const char PAYLOAD[] = "Hello!";
+
+/// Messages sent to the group, identified by their message ID, with the shard that must receive them.
+struct
+{
+    uint16_t mKeyId;
+    uint16_t mShard;
+} const sMessages[] = {
+    { 0, 0 }, { 1, 1 }, { 2, 2 }, { 3, 0 }, { 4, 1 }, { 7, 1 }, { 11, 2 }, { 300, 0 }, { 1000, 1 }, { 65535, 0 },
+};
+
+constexpr size_t kMessageCount                  = sizeof(sMessages) / sizeof(sMessages[0]);
+constexpr size_t kExpectedPerShard[kShardCount] = { 4, 4, 2 };
+size_t sReceivedPerShard[kShardCount]           = {};
+size_t sMisdeliveredCount                       = 0;
+UDPShardGroup * sGroup                          = nullptr;
+
+struct Shard
+{
+    UDP mTransport;
+    uint16_t mIndex;
+};
+
+void MessageReceiveHandler(const PacketHeader & header, const PeerAddress & source, System::PacketBufferHandle msgBuf,
+                           Shard * shard)
+{
+    const uint32_t messageId = header.GetMessageId();
+
+    if (messageId >= kMessageCount || sMessages[messageId].mKeyId != header.GetEncryptionKeyID() ||
+        sMessages[messageId].mShard != shard->mIndex)
+    {
+        sMisdeliveredCount++;
+    }
+
+    sReceivedPerShard[shard->mIndex]++;
+}
+
+size_t TotalReceived()
+{
+    size_t total = 0;
+
+    for (size_t received : sReceivedPerShard)
+    {
+        total += received;
+    }
+
+    return total;
+}
+
+/**
+ * Bind the shards of a group in the given order, send each message of
+ * sMessages once to their port, and check that every shard received exactly
+ * the messages of its key IDs.
+ */
+void CheckShardDelivery(nlTestSuite * inSuite, void * inContext, bool reverseBindOrder)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    UDPShardGroup group;
+    Shard shards[kShardCount];
+    UDP sender;
+    IPAddress addr;
+    CHIP_ERROR err;
+
+    IPAddress::FromString("127.0.0.1", addr);
+
+    NL_TEST_ASSERT(inSuite, group.Init(kShardCount) == CHIP_NO_ERROR);
+    sGroup             = &group;
+    sMisdeliveredCount = 0;
+
+    for (uint16_t n = 0; n < kShardCount; n++)
+    {
+        const uint16_t i = reverseBindOrder ? static_cast<uint16_t>(kShardCount - 1 - n) : n;
+
+        shards[i].mIndex     = i;
+        sReceivedPerShard[i] = 0;
+
+        err = shards[i].mTransport.Init(UdpListenParameters(&ctx.GetInetLayer())
+                                            .SetAddressType(kIPAddressType_IPv4)
+                                            .SetListenPort(kListenPort)
+                                            .SetShard(&group, i));
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        shards[i].mTransport.SetMessageReceiveHandler(MessageReceiveHandler, &shards[i]);
+    }
+
+    err = sender.Init(UdpListenParameters(&ctx.GetInetLayer()).SetAddressType(kIPAddressType_IPv4).SetListenPort(kSendPort));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    for (size_t i = 0; i < kMessageCount; i++)
+    {
+        System::PacketBufferHandle buffer = System::PacketBuffer::NewWithAvailableSize(sizeof(PAYLOAD));
+        NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+
+        memmove(buffer->Start(), PAYLOAD, sizeof(PAYLOAD));
+        buffer->SetDataLength(sizeof(PAYLOAD));
+
+        PacketHeader header;
+        header.SetMessageId(static_cast<uint32_t>(i)).SetEncryptionKeyID(sMessages[i].mKeyId);
+        if (i % 2 == 0)
+        {
+            // Moves the key ID further into the header
+            header.SetSourceNodeId(static_cast<NodeId>(i));
+        }
+
+        err = sender.SendMessage(header, PeerAddress::UDP(addr, kListenPort), buffer.Release_ForNow());
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    // All shards run on the test thread, which delivers the messages handed off between them
+    ctx.DriveIOUntil(1000 /* ms */, []() {
+        for (uint16_t i = 0; i < kShardCount; i++)
+        {
+            sGroup->ProcessHandOffs(i);
+        }
+        return TotalReceived() >= kMessageCount;
+    });
+
+    NL_TEST_ASSERT(inSuite, TotalReceived() == kMessageCount);
+    NL_TEST_ASSERT(inSuite, sMisdeliveredCount == 0);
+    for (uint16_t i = 0; i < kShardCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, sReceivedPerShard[i] == kExpectedPerShard[i]);
+    }
+
+    sender.Close();
+    for (Shard & shard : shards)
+    {
+        shard.mTransport.Close();
+    }
+    sGroup = nullptr;
+}
+
+void CheckShardForKeyIdTest(nlTestSuite * inSuite, void * inContext)
+{
+    UDPShardGroup group;
+
+    NL_TEST_ASSERT(inSuite, group.Init(0) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, group.Init(UDPShardGroup::kMaxShards + 1) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, group.Init(kShardCount) == CHIP_NO_ERROR);
+
+    for (const auto & message : sMessages)
+    {
+        NL_TEST_ASSERT(inSuite, group.ShardForKeyId(message.mKeyId) == message.mShard);
+    }
+}
+
+void CheckSteeredDeliveryTest(nlTestSuite * inSuite, void * inContext)
+{
+    CheckShardDelivery(inSuite, inContext, false);
+}
+
+void CheckHandOffDeliveryTest(nlTestSuite * inSuite, void * inContext)
+{
+    // Bound in reverse order, the kernel steers the messages of the first shard to the last one and conversely,
+    // so they only reach their owner through a hand-off.
+    CheckShardDelivery(inSuite, inContext, true);
+}
+
+} // namespace
+
+// Test Suite
+
+/**
+ *  Test Suite that lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("Shard For Key ID Test",   CheckShardForKeyIdTest),
+    NL_TEST_DEF("Steered Delivery Test",   CheckSteeredDeliveryTest),
+    NL_TEST_DEF("Hand-off Delivery Test",  CheckHandOffDeliveryTest),
+
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite sSuite =
+{
+    "Test-CHIP-Udp-Sharding",
+    &sTests[0],
+    Initialize,
+    Finalize
+};
+// clang-format on
+
+/**
+ *  Initialize the test suite.
+ */
+static int Initialize(void * aContext)
+{
+    CHIP_ERROR err = reinterpret_cast<TestContext *>(aContext)->Init(&sSuite);
+    return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+/**
+ *  Finalize the test suite.
+ */
+static int Finalize(void * aContext)
+{
+    CHIP_ERROR err = reinterpret_cast<TestContext *>(aContext)->Shutdown();
+    return (err == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int TestUDPSharding()
+{
+    // Run test suit against one context
+    nlTestRunner(&sSuite, &sContext);
+
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestUDPSharding);
@@ -0,0 +1,297 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a loopback throughput benchmark of UDP
+ *      transports sharded over several threads, each pinned to a core and
+ *      running its own System and Inet layers. Throughput and the number of
+ *      messages received are printed for each number of shards. It also
+ *      checks that every message is delivered intact by the shard owning its
+ *      key ID, whether the kernel steered it there or another shard handed
+ *      it off. Loopback UDP may still drop messages when a receive buffer
+ *      fills, so only most of them are required to arrive.
+ *
+ */
+
+#include <core/CHIPCore.h>
+#include <support/CHIPMem.h>
+#include <support/CodeUtils.h>
+#include <support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+#include <transport/raw/UDP.h>
+#include <transport/raw/UDPShardGroup.h>
+
+#include <nlunit-test.h>
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace chip;
+using namespace chip::Transport;
+
+namespace {
+
+constexpr uint16_t kListenPort     = 11098;
+constexpr size_t kMessageCount     = 20000;
+constexpr size_t kBurstSize        = 64; // small enough for the socket receive buffers to hold a whole burst
+constexpr uint16_t kPayloadSize    = 32;
+constexpr unsigned kBurstTimeoutMs = 1000;
+constexpr size_t kMinReceived      = kMessageCount / 2;
+
+struct Shard
+{
+    System::Layer mSystemLayer;
+    Inet::InetLayer mInetLayer;
+    UDP mTransport;
+    uint16_t mIndex;
+    UDPShardGroup * mGroup;
+    std::atomic<size_t> mReceived{ 0 };
+    std::atomic<size_t> mMisdelivered{ 0 };
+    std::atomic<size_t> mCorrupted{ 0 };
+    std::thread mThread;
+};
+
+std::atomic<bool> sStop{ false };
+
+void OnMessageReceived(const PacketHeader & header, const PeerAddress & source, System::PacketBufferHandle msgBuf, Shard * shard)
+{
+    if (shard->mGroup->ShardForKeyId(header.GetEncryptionKeyID()) != shard->mIndex)
+    {
+        shard->mMisdelivered++;
+    }
+
+    const uint8_t * payload = msgBuf->Start();
+    if (msgBuf->DataLength() != kPayloadSize ||
+        std::any_of(payload, payload + kPayloadSize, [](uint8_t byte) { return byte != 0xA5; }))
+    {
+        shard->mCorrupted++;
+    }
+    shard->mReceived++;
+}
+
+void RunShard(Shard * shard)
+{
+    cpu_set_t cpus;
+
+    CPU_ZERO(&cpus);
+    CPU_SET(shard->mIndex % std::thread::hardware_concurrency(), &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+    while (!sStop)
+    {
+        fd_set readFDs, writeFDs, exceptFDs;
+        struct timeval sleepTime = { 0, 10 * 1000 };
+        int numFDs               = 0;
+
+        FD_ZERO(&readFDs);
+        FD_ZERO(&writeFDs);
+        FD_ZERO(&exceptFDs);
+
+        shard->mSystemLayer.PrepareSelect(numFDs, &readFDs, &writeFDs, &exceptFDs, sleepTime);
+        shard->mInetLayer.PrepareSelect(numFDs, &readFDs, &writeFDs, &exceptFDs, sleepTime);
+
+        int selectRes = select(numFDs, &readFDs, &writeFDs, &exceptFDs, &sleepTime);
+
+        shard->mSystemLayer.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
+        shard->mInetLayer.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
+        shard->mGroup->ProcessHandOffs(shard->mIndex);
+    }
+}
+
+size_t TotalReceived(Shard * shards, uint16_t shardCount)
+{
+    size_t total = 0;
+    for (uint16_t i = 0; i < shardCount; i++)
+    {
+        total += shards[i].mReceived;
+    }
+    return total;
+}
+
+/**
+ * Start shards listening on the same port, bound in the given order, send
+ * messages with varied key IDs to them and wait for them to be received,
+ * then print the throughput under the given label.
+ */
+void RunShards(nlTestSuite * inSuite, const char * label, uint16_t shardCount, bool reverseBindOrder)
+{
+    UDPShardGroup group;
+    Shard * shards = new Shard[shardCount];
+    uint8_t message[64];
+    uint16_t headerSize = 0;
+    size_t misdelivered = 0;
+    size_t corrupted    = 0;
+
+    NL_TEST_ASSERT(inSuite, group.Init(shardCount) == CHIP_NO_ERROR);
+
+    for (uint16_t n = 0; n < shardCount; n++)
+    {
+        const uint16_t i = reverseBindOrder ? static_cast<uint16_t>(shardCount - 1 - n) : n;
+        Shard & shard    = shards[i];
+
+        shard.mIndex = i;
+        shard.mGroup = &group;
+
+        NL_TEST_ASSERT(inSuite, shard.mSystemLayer.Init(nullptr) == CHIP_SYSTEM_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, shard.mInetLayer.Init(shard.mSystemLayer, nullptr) == INET_NO_ERROR);
+
+        CHIP_ERROR err = shard.mTransport.Init(UdpListenParameters(&shard.mInetLayer)
+                                                   .SetAddressType(Inet::kIPAddressType_IPv4)
+                                                   .SetListenPort(kListenPort)
+                                                   .SetShard(&group, i));
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        shard.mTransport.SetMessageReceiveHandler(OnMessageReceived, &shard);
+    }
+
+    sStop = false;
+    for (uint16_t i = 0; i < shardCount; i++)
+    {
+        shards[i].mThread = std::thread(RunShard, &shards[i]);
+    }
+
+    int sender                   = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in listenAddr = {};
+    listenAddr.sin_family         = AF_INET;
+    listenAddr.sin_port           = htons(kListenPort);
+    listenAddr.sin_addr.s_addr    = htonl(INADDR_LOOPBACK);
+
+    uint64_t start = System::Platform::Layer::GetClock_MonotonicHiRes();
+    for (size_t sent = 0; sent < kMessageCount;)
+    {
+        for (size_t burstEnd = std::min(sent + kBurstSize, kMessageCount); sent < burstEnd; sent++)
+        {
+            PacketHeader header;
+
+            header.SetMessageId(static_cast<uint32_t>(sent)).SetEncryptionKeyID(static_cast<uint16_t>(sent % 1000 + 1));
+            if (sent % 3 == 0)
+            {
+                // Moves the key ID further into the header
+                header.SetSourceNodeId(static_cast<NodeId>(sent));
+            }
+
+            NL_TEST_ASSERT(inSuite, header.Encode(message, sizeof(message), &headerSize) == CHIP_NO_ERROR);
+            memset(message + headerSize, 0xA5, kPayloadSize);
+
+            sendto(sender, message, headerSize + kPayloadSize, 0, reinterpret_cast<struct sockaddr *>(&listenAddr),
+                   sizeof(listenAddr));
+        }
+
+        uint64_t burstStart = System::Platform::Layer::GetClock_MonotonicMS();
+        while (TotalReceived(shards, shardCount) < sent &&
+               System::Platform::Layer::GetClock_MonotonicMS() - burstStart < kBurstTimeoutMs)
+        {
+            sched_yield();
+        }
+    }
+    uint64_t elapsed = System::Platform::Layer::GetClock_MonotonicHiRes() - start;
+
+    close(sender);
+
+    sStop = true;
+    for (uint16_t i = 0; i < shardCount; i++)
+    {
+        shards[i].mThread.join();
+        misdelivered += shards[i].mMisdelivered;
+        corrupted += shards[i].mCorrupted;
+    }
+
+    const size_t received = TotalReceived(shards, shardCount);
+    NL_TEST_ASSERT(inSuite, received >= kMinReceived && received <= kMessageCount);
+    NL_TEST_ASSERT(inSuite, misdelivered == 0);
+    NL_TEST_ASSERT(inSuite, corrupted == 0);
+
+    const double throughput = static_cast<double>(received) * 1000000 / static_cast<double>(elapsed);
+    printf("%s %8.0f messages/s, %zu of %zu received\n", label, throughput, received, kMessageCount);
+
+    for (uint16_t i = 0; i < shardCount; i++)
+    {
+        shards[i].mTransport.Close();
+        shards[i].mInetLayer.Shutdown();
+        shards[i].mSystemLayer.Shutdown();
+    }
+    delete[] shards;
+}
+
+void TestShardScaling(nlTestSuite * inSuite, void * inContext)
+{
+    printf("%u core(s) online\n", std::thread::hardware_concurrency());
+
+    for (uint16_t shardCount = 1; shardCount <= 4 && shardCount <= UDPShardGroup::kMaxShards; shardCount *= 2)
+    {
+        char label[16];
+
+        snprintf(label, sizeof(label), "%u shard(s):", shardCount);
+        RunShards(inSuite, label, shardCount, false);
+    }
+}
+
+void TestHandOff(nlTestSuite * inSuite, void * inContext)
+{
+    // Bound in reverse order, the kernel steers every message of the first shard to the last one and conversely,
+    // so they only reach their owner through a hand-off.
+    RunShards(inSuite, "hand-offs:  ", 2, true);
+}
+
+} // namespace
+
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("ShardScaling", TestShardScaling),
+    NL_TEST_DEF("HandOff",      TestHandOff),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+static int Initialize(void * aContext)
+{
+    return (Platform::MemoryInit() == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+static int Finalize(void * aContext)
+{
+    Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+// clang-format off
+static nlTestSuite sSuite =
+{
+    "Test-CHIP-Udp-Sharding-Benchmark",
+    &sTests[0],
+    Initialize,
+    Finalize
+};
+// clang-format on
+
+int TestUDPShardingBenchmark()
+{
+    nlTestRunner(&sSuite, nullptr);
+
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestUDPShardingBenchmark);
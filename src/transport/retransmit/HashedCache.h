@@ -0,0 +1,285 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <core/CHIPError.h>
+#include <support/HashUtils.h>
+#include <system/SystemLayer.h>
+#include <transport/retransmit/Cache.h>
+
+namespace chip {
+namespace Retransmit {
+
+/**
+ * Counters describing the use of a HashedCache.
+ */
+struct CacheStats
+{
+    size_t occupancy;   ///< number of entries in the cache
+    uint32_t hits;      ///< lookups that found their entry
+    uint32_t misses;    ///< lookups that did not
+    uint32_t evictions; ///< entries evicted for being too old
+};
+
+/**
+ * This class maintains a cache of data that is sufficient to retransmit,
+ * like Cache, but finds entries by hashing their key instead of scanning
+ * the whole cache.
+ *
+ * Every entry records when it was added, so that the entries that were not
+ * acknowledged in time can be evicted together.
+ *
+ * @tparam KeyType the key to identify a single message, which must be equality comparable
+ * @tparam PayloadType the type of payload to cache for the given peer address
+ * @tparam N size of the available cache
+ * @tparam Hash the function object hashing keys
+ *
+ * Payloads are reference counted through Lifetime<PayloadType>, as for Cache.
+ */
+template <typename KeyType, typename PayloadType, size_t N, typename Hash = std::hash<KeyType>>
+class HashedCache
+{
+public:
+    HashedCache()
+    {
+        for (size_t i = 0; i < kBucketCount; i++)
+        {
+            mBuckets[i] = kNone;
+        }
+        for (size_t i = 0; i < N; i++)
+        {
+            mEntries[i].next = (i + 1 < N) ? i + 1 : kNone;
+        }
+    }
+    HashedCache(const HashedCache &) = delete;
+    HashedCache & operator=(const HashedCache &) = delete;
+
+    ~HashedCache() { RemoveIf([](const Entry &) { return true; }); }
+
+    /**
+     * Add a payload to the cache, added now.
+     */
+    CHIP_ERROR Add(const KeyType & key, PayloadType & payload) { return Add(key, payload, System::Layer::GetClock_MonotonicMS()); }
+
+    /**
+     * Add a payload to the cache.
+     *
+     * @param key the key of the payload, which must not be in the cache yet
+     * @param payload the payload to cache
+     * @param addedAtMs when the payload was added, on the clock EvictOlderThan deadlines are on
+     */
+    CHIP_ERROR Add(const KeyType & key, PayloadType & payload, uint64_t addedAtMs)
+    {
+        if (mFree == kNone)
+        {
+            return CHIP_ERROR_NO_MEMORY;
+        }
+
+        size_t & bucket = mBuckets[BucketFor(key)];
+        for (size_t i = bucket; i != kNone; i = mEntries[i].next)
+        {
+            if (mEntries[i].key == key)
+            {
+                return CHIP_ERROR_DUPLICATE_KEY_ID;
+            }
+        }
+
+        const size_t i = mFree;
+        Entry & entry  = mEntries[i];
+        mFree          = entry.next;
+
+        entry.key       = key;
+        entry.payload   = Lifetime<PayloadType>::Acquire(payload);
+        entry.addedAtMs = addedAtMs;
+        entry.next      = bucket;
+        bucket          = i;
+        mCount++;
+
+        return CHIP_NO_ERROR;
+    }
+
+    /**
+     * Remove a payload from the cache given the key.
+     */
+    CHIP_ERROR Remove(const KeyType & key)
+    {
+        for (size_t * link = &mBuckets[BucketFor(key)]; *link != kNone; link = &mEntries[*link].next)
+        {
+            if (mEntries[*link].key == key)
+            {
+                Release(link);
+                return CHIP_NO_ERROR;
+            }
+        }
+
+        return CHIP_ERROR_KEY_NOT_FOUND;
+    }
+
+    /**
+     * Remove any matching payloads. Used for mass removal, e.g. when a connection
+     * is closed, relevant payloads need/can be cleared for the entire connection.
+     *
+     * @tparam Matcher is a generic matcher object defining a bool Matches method.
+     */
+    template <typename Matcher>
+    void RemoveMatching(const Matcher & matcher)
+    {
+        RemoveIf([&matcher](const Entry & entry) { return matcher.Matches(entry.key); });
+    }
+
+    /**
+     * Evict the payloads added before a deadline, e.g. those that were not
+     * acknowledged in time.
+     *
+     * @return the number of payloads evicted
+     */
+    size_t EvictOlderThan(uint64_t deadlineMs)
+    {
+        const size_t evicted = RemoveIf([deadlineMs](const Entry & entry) { return entry.addedAtMs < deadlineMs; });
+
+        mStats.evictions += static_cast<uint32_t>(evicted);
+        return evicted;
+    }
+
+    /**
+     * Look up the payload of a key.
+     *
+     * @return the payload, or nullptr if the key is not in the cache. It is
+     *         only valid as long as no remove methods are called on the class.
+     */
+    const PayloadType * Lookup(const KeyType & key)
+    {
+        for (size_t i = mBuckets[BucketFor(key)]; i != kNone; i = mEntries[i].next)
+        {
+            if (mEntries[i].key == key)
+            {
+                mStats.hits++;
+                return &mEntries[i].payload;
+            }
+        }
+
+        mStats.misses++;
+        return nullptr;
+    }
+
+    /**
+     * Search for a specific entry within the cache.
+     *
+     * @tparam Matcher is a generic macher object defining a bool Maches method.
+     *
+     * @param matcher the entry to find
+     * @param key - out set the key if found
+     * @param payload - the payload if found
+     *
+     * Unlike Lookup(), this goes through the whole cache. Key and payload are
+     * only valid as long as no remove methods are called on the class.
+     */
+    template <typename Matcher>
+    bool Find(const Matcher & matcher, const KeyType ** key, const PayloadType ** payload)
+    {
+        *key     = nullptr;
+        *payload = nullptr;
+
+        for (size_t b = 0; b < kBucketCount; b++)
+        {
+            for (size_t i = mBuckets[b]; i != kNone; i = mEntries[i].next)
+            {
+                if (matcher.Matches(mEntries[i].key))
+                {
+                    *key     = &mEntries[i].key;
+                    *payload = &mEntries[i].payload;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    CacheStats GetStats() const
+    {
+        CacheStats stats = mStats;
+
+        stats.occupancy = mCount;
+        return stats;
+    }
+
+private:
+    struct Entry
+    {
+        KeyType key;
+        PayloadType payload;
+        uint64_t addedAtMs;
+        size_t next; // next entry of the same bucket, or of the free list
+    };
+
+    static constexpr size_t kNone = N;
+
+    // As many buckets as entries, so that chains stay short when the cache is full
+    static constexpr size_t kBucketCount = HashBucketCountFor(N);
+
+    size_t BucketFor(const KeyType & key) const { return Hash()(key) & (kBucketCount - 1); }
+
+    /// Release the entry a link points to, and unlink it.
+    void Release(size_t * link)
+    {
+        const size_t i = *link;
+        Entry & entry  = mEntries[i];
+
+        *link = entry.next;
+        Lifetime<PayloadType>::Release(entry.payload);
+        entry.next = mFree;
+        mFree      = i;
+        mCount--;
+    }
+
+    template <typename Predicate>
+    size_t RemoveIf(const Predicate & predicate)
+    {
+        size_t removed = 0;
+
+        for (size_t b = 0; b < kBucketCount; b++)
+        {
+            size_t * link = &mBuckets[b];
+            while (*link != kNone)
+            {
+                if (predicate(mEntries[*link]))
+                {
+                    Release(link);
+                    removed++;
+                }
+                else
+                {
+                    link = &mEntries[*link].next;
+                }
+            }
+        }
+        return removed;
+    }
+
+    Entry mEntries[N];             // payload entries
+    size_t mBuckets[kBucketCount]; // first entry of each bucket
+    size_t mFree      = 0;         // first entry of the free list
+    size_t mCount     = 0;         // number of entries in use
+    CacheStats mStats = {};        // hit, miss and eviction counters
+};
+
+} // namespace Retransmit
+} // namespace chip
@@ -19,6 +19,7 @@
 
 #include <support/UnitTestRegistration.h>
 #include <transport/retransmit/Cache.h>
+#include <transport/retransmit/HashedCache.h>
 
 #include <bitset>
 #include <nlunit-test.h>
@@ -256,6 +257,98 @@ void FindMatching(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, value == nullptr);
 }
 
+void HashedAddRemove(nlTestSuite * inSuite, void * inContext)
+{
+    {
+        chip::Retransmit::HashedCache<int, int, 3> test;
+        int payloads[] = { 1, 2, 4, 8 };
+
+        NL_TEST_ASSERT(inSuite, test.Add(1, payloads[0]) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, test.Add(2, payloads[1]) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, test.Add(2, payloads[3]) == CHIP_ERROR_DUPLICATE_KEY_ID);
+        NL_TEST_ASSERT(inSuite, test.Add(3, payloads[2]) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, test.Add(10, payloads[3]) == CHIP_ERROR_NO_MEMORY);
+        NL_TEST_ASSERT(inSuite, gPayloadTracker.Count() == 3);
+        NL_TEST_ASSERT(inSuite, test.GetStats().occupancy == 3);
+
+        NL_TEST_ASSERT(inSuite, test.Remove(2) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, test.Remove(2) == CHIP_ERROR_KEY_NOT_FOUND);
+        NL_TEST_ASSERT(inSuite, !gPayloadTracker.IsAquired(2));
+        NL_TEST_ASSERT(inSuite, test.Add(10, payloads[3]) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, gPayloadTracker.Count() == 3);
+
+        const chip::Retransmit::CacheStats stats = test.GetStats();
+        NL_TEST_ASSERT(inSuite, stats.occupancy == 3);
+        NL_TEST_ASSERT(inSuite, stats.hits == 0);
+        NL_TEST_ASSERT(inSuite, stats.misses == 0);
+    }
+
+    // destructor should release the items
+    NL_TEST_ASSERT(inSuite, gPayloadTracker.Count() == 0);
+}
+
+void HashedLookup(nlTestSuite * inSuite, void * inContext)
+{
+    chip::Retransmit::HashedCache<int, int, 8> test;
+
+    // Keys 8 apart share a bucket
+    for (int i = 1; i <= 8; i++)
+    {
+        int payload = i;
+        NL_TEST_ASSERT(inSuite, test.Add(i * 8, payload) == CHIP_NO_ERROR);
+    }
+
+    for (int i = 1; i <= 8; i++)
+    {
+        const int * payload = test.Lookup(i * 8);
+        NL_TEST_ASSERT(inSuite, payload != nullptr && *payload == i);
+    }
+    NL_TEST_ASSERT(inSuite, test.Lookup(9 * 8) == nullptr);
+    NL_TEST_ASSERT(inSuite, test.Lookup(1) == nullptr);
+
+    NL_TEST_ASSERT(inSuite, test.Remove(4 * 8) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, test.Lookup(4 * 8) == nullptr);
+    NL_TEST_ASSERT(inSuite, *test.Lookup(5 * 8) == 5);
+
+    test.RemoveMatching(DivisibleBy(16));
+    NL_TEST_ASSERT(inSuite, gPayloadTracker.Count() == 4);
+    NL_TEST_ASSERT(inSuite, gPayloadTracker.IsAquired(1));
+    NL_TEST_ASSERT(inSuite, !gPayloadTracker.IsAquired(2));
+
+    const chip::Retransmit::CacheStats stats = test.GetStats();
+    NL_TEST_ASSERT(inSuite, stats.occupancy == 4);
+    NL_TEST_ASSERT(inSuite, stats.hits == 9);
+    NL_TEST_ASSERT(inSuite, stats.misses == 3);
+}
+
+void HashedEvictOlderThan(nlTestSuite * inSuite, void * inContext)
+{
+    chip::Retransmit::HashedCache<int, int, 4> test;
+    int payloads[] = { 1, 2, 3, 4 };
+
+    NL_TEST_ASSERT(inSuite, test.Add(1, payloads[0], 100) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, test.Add(2, payloads[1], 300) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, test.Add(3, payloads[2], 200) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, test.Add(4, payloads[3], 400) == CHIP_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, test.EvictOlderThan(100) == 0);
+    NL_TEST_ASSERT(inSuite, test.EvictOlderThan(300) == 2);
+    NL_TEST_ASSERT(inSuite, !gPayloadTracker.IsAquired(1));
+    NL_TEST_ASSERT(inSuite, gPayloadTracker.IsAquired(2));
+    NL_TEST_ASSERT(inSuite, !gPayloadTracker.IsAquired(3));
+    NL_TEST_ASSERT(inSuite, gPayloadTracker.IsAquired(4));
+
+    const chip::Retransmit::CacheStats stats = test.GetStats();
+    NL_TEST_ASSERT(inSuite, stats.occupancy == 2);
+    NL_TEST_ASSERT(inSuite, stats.evictions == 2);
+
+    // Payloads added now are not older than a deadline in the past
+    NL_TEST_ASSERT(inSuite, test.Add(1, payloads[0]) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, test.EvictOlderThan(500) == 2);
+    NL_TEST_ASSERT(inSuite, test.GetStats().occupancy == 1);
+    NL_TEST_ASSERT(inSuite, gPayloadTracker.IsAquired(1));
+}
+
 } // namespace
 
 // clang-format off
@@ -267,6 +360,9 @@ static const nlTest sTests[] =
     NL_TEST_DEF("AddRemove", AddRemove),
     NL_TEST_DEF("RemoveMatching", RemoveMatching),
     NL_TEST_DEF("FindMatching", FindMatching),
+    NL_TEST_DEF("HashedAddRemove", HashedAddRemove),
+    NL_TEST_DEF("HashedLookup", HashedLookup),
+    NL_TEST_DEF("HashedEvictOlderThan", HashedEvictOlderThan),
     NL_TEST_SENTINEL()
 };
 // clang-format on
@@ -22,9 +22,11 @@
  *      the PeerConnections class within the transport layer
  *
  */
+#include <support/CHIPMem.h>
 #include <support/CodeUtils.h>
 #include <support/ErrorStr.h>
 #include <support/UnitTestRegistration.h>
+#include <system/SystemStats.h>
 #include <transport/PeerConnections.h>
 
 #include <nlunit-test.h>
@@ -192,6 +194,62 @@ void TestFindByKeyId(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, !connections.FindPeerConnectionStateByLocalKey(Optional<NodeId>::Value(kPeer2NodeId), 4, nullptr));
 }
 
+void TestIndexFollowsUpdates(nlTestSuite * inSuite, void * inContext)
+{
+    CHIP_ERROR err;
+    PeerConnectionState * state1 = nullptr;
+    PeerConnectionState * state2 = nullptr;
+    PeerConnectionState * state3 = nullptr;
+    PeerConnectionState * statePtr;
+    PeerConnections<3, Time::Source::kTest> connections;
+
+    err = connections.CreateNewPeerConnectionState(Optional<NodeId>::Missing(), 1, 2, &state1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = connections.CreateNewPeerConnectionState(Optional<NodeId>::Missing(), 3, 4, &state2);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = connections.CreateNewPeerConnectionState(Optional<NodeId>::Missing(), 5, 6, &state3);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // Keys set after creation must be visible to lookups
+    state3->SetPeerNodeId(kPeer1NodeId);
+    state1->SetPeerNodeId(kPeer1NodeId);
+    state2->SetPeerAddress(kPeer2Addr);
+
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(kPeer2Addr, nullptr) == state2);
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(kPeer1NodeId, nullptr) == state1);
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(kPeer1NodeId, state1) == state3);
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(kPeer1NodeId, state3) == nullptr);
+    NL_TEST_ASSERT(inSuite, !connections.FindPeerConnectionState(Optional<NodeId>::Value(kPeer2NodeId), 5, nullptr));
+
+    // Old keys must no longer match once changed
+    state2->SetPeerAddress(kPeer3Addr);
+    state2->SetPeerKeyID(7);
+    state2->SetLocalKeyID(8);
+    NL_TEST_ASSERT(inSuite, !connections.FindPeerConnectionState(kPeer2Addr, nullptr));
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(kPeer3Addr, nullptr) == state2);
+    NL_TEST_ASSERT(inSuite, !connections.FindPeerConnectionState(Optional<NodeId>::Missing(), 3, nullptr));
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(Optional<NodeId>::Missing(), 7, nullptr) == state2);
+    NL_TEST_ASSERT(inSuite, !connections.FindPeerConnectionStateByLocalKey(Optional<NodeId>::Missing(), 4, nullptr));
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionStateByLocalKey(Optional<NodeId>::Missing(), 8, nullptr) == state2);
+
+    // Expired states leave the index, and their slot can be reused
+    connections.MarkConnectionExpired(state1, [](const PeerConnectionState &) {});
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(kPeer1NodeId, nullptr) == state3);
+    NL_TEST_ASSERT(inSuite, !connections.FindPeerConnectionState(Optional<NodeId>::Missing(), 1, nullptr));
+
+    err = connections.CreateNewPeerConnectionState(kPeer1Addr, &statePtr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, statePtr == state1);
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(kPeer1Addr, nullptr) == state1);
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(kPeer1NodeId, nullptr) == state3);
+
+    // Copies of a state are not part of the pool
+    PeerConnectionState copy = *state3;
+    copy.SetPeerNodeId(kPeer2NodeId);
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(kPeer1NodeId, nullptr) == state3);
+    NL_TEST_ASSERT(inSuite, !connections.FindPeerConnectionState(kPeer2NodeId, nullptr));
+}
+
 struct ExpiredCallInfo
 {
     int callCount                   = 0;
@@ -284,6 +342,248 @@ void TestExpireConnections(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, !connections.FindPeerConnectionState(kPeer3Addr, nullptr));
 }
 
+void TestNextExpiry(nlTestSuite * inSuite, void * inContext)
+{
+    CHIP_ERROR err;
+    PeerConnectionState * peer1;
+    PeerConnectionState * peer2;
+    PeerConnectionState * unaddressed;
+    ExpiredCallInfo callInfo;
+    PeerConnections<3, Time::Source::kTest> connections;
+
+    NL_TEST_ASSERT(inSuite, !connections.GetTimeUntilNextExpiryMs(100).HasValue());
+
+    connections.GetTimeSource().SetCurrentMonotonicTimeMs(100);
+    err = connections.CreateNewPeerConnectionState(kPeer1Addr, &peer1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // connections without an address never expire
+    connections.GetTimeSource().SetCurrentMonotonicTimeMs(150);
+    err = connections.CreateNewPeerConnectionState(Optional<NodeId>::Value(kPeer3NodeId), 3, 4, &unaddressed);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    connections.GetTimeSource().SetCurrentMonotonicTimeMs(200);
+    err = connections.CreateNewPeerConnectionState(kPeer2Addr, &peer2);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, connections.GetTimeUntilNextExpiryMs(100).Value() == 1);
+
+    // Activity moves peer 1 behind peer 2
+    connections.GetTimeSource().SetCurrentMonotonicTimeMs(250);
+    connections.MarkConnectionActive(peer1);
+    NL_TEST_ASSERT(inSuite, connections.GetTimeUntilNextExpiryMs(100).Value() == 51);
+
+    // Activity times set out of order are handled as well
+    peer2->SetLastActivityTimeMs(300);
+    peer1->SetLastActivityTimeMs(120);
+    NL_TEST_ASSERT(inSuite, connections.GetTimeUntilNextExpiryMs(100).Value() == 0);
+
+    connections.ExpireInactiveConnections(100, [&callInfo](const PeerConnectionState & state) {
+        callInfo.callCount++;
+        callInfo.lastCallPeerAddress = state.GetPeerAddress();
+    });
+    NL_TEST_ASSERT(inSuite, callInfo.callCount == 1);
+    NL_TEST_ASSERT(inSuite, callInfo.lastCallPeerAddress == kPeer1Addr);
+    NL_TEST_ASSERT(inSuite, connections.GetTimeUntilNextExpiryMs(100).Value() == 151);
+
+    // Once it gets an address, the unaddressed connection is the oldest
+    unaddressed->SetPeerAddress(kPeer3Addr);
+    NL_TEST_ASSERT(inSuite, connections.GetTimeUntilNextExpiryMs(100).Value() == 1);
+
+    connections.GetTimeSource().SetCurrentMonotonicTimeMs(1000);
+    callInfo.callCount = 0;
+    connections.ExpireInactiveConnections(100, [&callInfo](const PeerConnectionState & state) { callInfo.callCount++; });
+    NL_TEST_ASSERT(inSuite, callInfo.callCount == 2);
+    NL_TEST_ASSERT(inSuite, !connections.GetTimeUntilNextExpiryMs(100).HasValue());
+}
+
+PeerAddress AddressForIndex(size_t index)
+{
+    Inet::IPAddress addr;
+
+    VerifyOrDie(Inet::IPAddress::FromString("fd00::1", addr));
+    addr.Addr[3] = static_cast<uint32_t>(index);
+
+    return PeerAddress::UDP(addr);
+}
+
+void TestDynamicGrowAndShrink(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kChunkSize = DynamicPeerConnectionStorage::kChunkSize;
+    constexpr size_t kCount     = 4 * kChunkSize + 1;
+
+    CHIP_ERROR err;
+    PeerConnectionState * statePtr;
+    DynamicPeerConnections<Time::Source::kTest> connections(kCount);
+    DynamicPeerConnectionStorage & storage = connections.GetStorage();
+
+    NL_TEST_ASSERT(inSuite, storage.GetCapacity() == 0);
+
+    connections.GetTimeSource().SetCurrentMonotonicTimeMs(100);
+
+    // Every chunk added rehashes the index: lookups must keep working throughout
+    for (size_t i = 0; i < kCount; i++)
+    {
+        err = connections.CreateNewPeerConnectionState(AddressForIndex(i), &statePtr);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        statePtr->SetPeerNodeId(1000 + i);
+
+        NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(AddressForIndex(0), nullptr));
+        NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(AddressForIndex(i), nullptr) == statePtr);
+    }
+
+    NL_TEST_ASSERT(inSuite, storage.GetInUseCount() == kCount);
+    NL_TEST_ASSERT(inSuite, storage.GetCapacity() == 5 * kChunkSize);
+
+    // Capacity is rounded up to a whole chunk
+    for (size_t i = kCount; i < 5 * kChunkSize; i++)
+    {
+        err = connections.CreateNewPeerConnectionState(AddressForIndex(i), nullptr);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+    err = connections.CreateNewPeerConnectionState(AddressForIndex(5 * kChunkSize), nullptr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_NO_MEMORY);
+
+    for (size_t i = 0; i < 5 * kChunkSize; i++)
+    {
+        statePtr = connections.FindPeerConnectionState(AddressForIndex(i), nullptr);
+        NL_TEST_ASSERT(inSuite, statePtr != nullptr);
+        NL_TEST_ASSERT(inSuite, i >= kCount || connections.FindPeerConnectionState(1000 + i, nullptr) == statePtr);
+    }
+
+    // Keep one peer alive and let all others idle out
+    connections.GetTimeSource().SetCurrentMonotonicTimeMs(1000);
+    statePtr = connections.FindPeerConnectionState(AddressForIndex(kCount - 1), nullptr);
+    connections.MarkConnectionActive(statePtr);
+
+    size_t expired = 0;
+    connections.ExpireInactiveConnections(100, [&expired](const PeerConnectionState & state) { expired++; });
+    NL_TEST_ASSERT(inSuite, expired == 5 * kChunkSize - 1);
+    NL_TEST_ASSERT(inSuite, storage.GetInUseCount() == 1);
+    NL_TEST_ASSERT(inSuite, storage.GetHighWatermark() == 5 * kChunkSize);
+
+    // Empty chunks are given back, except one spare
+    NL_TEST_ASSERT(inSuite, storage.GetCapacity() == 2 * kChunkSize);
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(AddressForIndex(kCount - 1), nullptr) == statePtr);
+    NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(1000 + kCount - 1, nullptr) == statePtr);
+    NL_TEST_ASSERT(inSuite, !connections.FindPeerConnectionState(AddressForIndex(0), nullptr));
+
+    connections.MarkConnectionExpired(statePtr, [](const PeerConnectionState & state) {});
+    NL_TEST_ASSERT(inSuite, storage.GetInUseCount() == 0);
+    NL_TEST_ASSERT(inSuite, storage.GetCapacity() == kChunkSize);
+}
+
+void TestDynamicReuseFreedSlots(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kChunkSize = DynamicPeerConnectionStorage::kChunkSize;
+
+    CHIP_ERROR err;
+    PeerConnectionState * states[3 * kChunkSize];
+    DynamicPeerConnections<Time::Source::kTest> connections(3 * kChunkSize);
+    DynamicPeerConnectionStorage & storage = connections.GetStorage();
+
+    for (size_t i = 0; i < 3 * kChunkSize; i++)
+    {
+        err = connections.CreateNewPeerConnectionState(AddressForIndex(i), &states[i]);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    // A slot freed in any full chunk is handed out again before the pool grows
+    for (size_t i = 0; i < 3 * kChunkSize; i += kChunkSize + 1)
+    {
+        connections.MarkConnectionExpired(states[i], [](const PeerConnectionState &) {});
+        NL_TEST_ASSERT(inSuite, storage.GetCapacity() == 3 * kChunkSize);
+
+        err = connections.CreateNewPeerConnectionState(AddressForIndex(3 * kChunkSize + i), &states[i]);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.GetCapacity() == 3 * kChunkSize);
+        NL_TEST_ASSERT(inSuite, connections.FindPeerConnectionState(AddressForIndex(3 * kChunkSize + i), nullptr) == states[i]);
+    }
+
+    err = connections.CreateNewPeerConnectionState(AddressForIndex(6 * kChunkSize), nullptr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_NO_MEMORY);
+    NL_TEST_ASSERT(inSuite, storage.GetInUseCount() == 3 * kChunkSize);
+}
+
+void TestDynamicStatistics(nlTestSuite * inSuite, void * inContext)
+{
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    constexpr System::Stats::count_t kChunkSize = DynamicPeerConnectionStorage::kChunkSize;
+
+    System::Stats::count_t * inUse      = System::Stats::GetResourcesInUse();
+    System::Stats::count_t * watermarks = System::Stats::GetHighWatermarks();
+    const System::Stats::count_t inUseBefore = inUse[System::Stats::kTransport_NumPeerConnections];
+    const System::Stats::count_t slotsBefore = inUse[System::Stats::kTransport_NumPeerConnectionSlots];
+
+    {
+        DynamicPeerConnections<Time::Source::kTest> connections;
+
+        for (System::Stats::count_t i = 0; i <= kChunkSize; i++)
+        {
+            CHIP_ERROR err = connections.CreateNewPeerConnectionState(AddressForIndex(static_cast<size_t>(i)), nullptr);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        }
+
+        NL_TEST_ASSERT(inSuite, inUse[System::Stats::kTransport_NumPeerConnections] == inUseBefore + kChunkSize + 1);
+        NL_TEST_ASSERT(inSuite, inUse[System::Stats::kTransport_NumPeerConnectionSlots] == slotsBefore + 2 * kChunkSize);
+        NL_TEST_ASSERT(inSuite, watermarks[System::Stats::kTransport_NumPeerConnections] >= inUseBefore + kChunkSize + 1);
+    }
+
+    NL_TEST_ASSERT(inSuite, inUse[System::Stats::kTransport_NumPeerConnections] == inUseBefore);
+    NL_TEST_ASSERT(inSuite, inUse[System::Stats::kTransport_NumPeerConnectionSlots] == slotsBefore);
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+}
+
+void TestReceiveWindow(nlTestSuite * inSuite, void * inContext)
+{
+    PeerConnectionState state;
+    MessageCounterWindow & window = state.GetReceiveWindow();
+
+    // Any counter is acceptable before the first message
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(100) == CHIP_NO_ERROR);
+    window.CommitCounter(100);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(100) == CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED);
+
+    // Counters only verified, e.g. of messages that failed to authenticate, remain acceptable
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(101) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(101) == CHIP_NO_ERROR);
+
+    // Reordered messages within the window are accepted exactly once
+    window.CommitCounter(105);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(103) == CHIP_NO_ERROR);
+    window.CommitCounter(103);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(103) == CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(100) == CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(104) == CHIP_NO_ERROR);
+
+    // Counters that fell out of the window can not be told apart from duplicates
+    window.CommitCounter(105 + MessageCounterWindow::kWindowSize);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(105) == CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(106) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(105 + MessageCounterWindow::kWindowSize) == CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED);
+
+    window.CommitCounter(1000);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(999) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(1000) == CHIP_ERROR_DUPLICATE_MESSAGE_RECEIVED);
+
+    // A reset connection accepts counters from scratch
+    state.Reset();
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(1000) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, window.VerifyCounter(0) == CHIP_NO_ERROR);
+}
+
+int Setup(void * inContext)
+{
+    CHIP_ERROR error = Platform::MemoryInit();
+    return (error == CHIP_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+int Teardown(void * inContext)
+{
+    Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
 } // namespace
 
 // clang-format off
@@ -293,14 +593,20 @@ static const nlTest sTests[] =
     NL_TEST_DEF("FindByPeerAddress", TestFindByAddress),
     NL_TEST_DEF("FindByNodeId", TestFindByNodeId),
     NL_TEST_DEF("FindByKeyId", TestFindByKeyId),
+    NL_TEST_DEF("IndexFollowsUpdates", TestIndexFollowsUpdates),
     NL_TEST_DEF("ExpireConnections", TestExpireConnections),
+    NL_TEST_DEF("NextExpiry", TestNextExpiry),
+    NL_TEST_DEF("DynamicGrowAndShrink", TestDynamicGrowAndShrink),
+    NL_TEST_DEF("DynamicReuseFreedSlots", TestDynamicReuseFreedSlots),
+    NL_TEST_DEF("DynamicStatistics", TestDynamicStatistics),
+    NL_TEST_DEF("ReceiveWindow", TestReceiveWindow),
     NL_TEST_SENTINEL()
 };
 // clang-format on
 
 int TestPeerConnectionsFn(void)
 {
-    nlTestSuite theSuite = { "Transport-PeerConnections", &sTests[0], nullptr, nullptr };
+    nlTestSuite theSuite = { "Transport-PeerConnections", &sTests[0], Setup, Teardown };
     nlTestRunner(&theSuite, nullptr);
     return nlTestRunnerStats(&theSuite);
 }
@@ -0,0 +1,132 @@
+/*
+ *
+ *    Copyright (c) 2020 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a benchmark of PeerConnections lookups for
+ *      session tables of increasing size. Lookup cost per call is printed
+ *      and is expected to stay flat as the table grows.
+ *
+ */
+#include <support/CodeUtils.h>
+#include <support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+#include <transport/PeerConnections.h>
+
+#include <nlunit-test.h>
+
+#include <inttypes.h>
+#include <memory>
+#include <stdio.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::Transport;
+
+constexpr size_t kLookupCount = 200000;
+
+PeerAddress AddressForIndex(size_t index)
+{
+    Inet::IPAddress addr;
+
+    VerifyOrDie(Inet::IPAddress::FromString("fd00::1", addr));
+    addr.Addr[3] = static_cast<uint32_t>(index);
+
+    return PeerAddress::UDP(addr, CHIP_PORT);
+}
+
+template <size_t kSessionCount>
+void BenchmarkLookups(nlTestSuite * inSuite)
+{
+    std::unique_ptr<PeerConnections<kSessionCount, Time::Source::kTest>> connections(
+        new PeerConnections<kSessionCount, Time::Source::kTest>());
+    size_t found = 0;
+
+    for (size_t i = 0; i < kSessionCount; i++)
+    {
+        PeerConnectionState * state = nullptr;
+        CHIP_ERROR err = connections->CreateNewPeerConnectionState(Optional<NodeId>::Value(1000 + i), static_cast<uint16_t>(i),
+                                                                   static_cast<uint16_t>(i), &state);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        if (state != nullptr)
+        {
+            state->SetPeerAddress(AddressForIndex(i));
+        }
+    }
+
+    uint64_t start = System::Platform::Layer::GetClock_MonotonicHiRes();
+    for (size_t i = 0; i < kLookupCount; i++)
+    {
+        // Stride through the table so lookups do not hit the same entry back to back.
+        size_t index = (i * 7919) % kSessionCount;
+        found += connections->FindPeerConnectionState(Optional<NodeId>::Value(1000 + index), static_cast<uint16_t>(index),
+                                                      nullptr) != nullptr;
+    }
+    uint64_t byKey = System::Platform::Layer::GetClock_MonotonicHiRes() - start;
+
+    start = System::Platform::Layer::GetClock_MonotonicHiRes();
+    for (size_t i = 0; i < kLookupCount; i++)
+    {
+        size_t index = (i * 7919) % kSessionCount;
+        found += connections->FindPeerConnectionState(static_cast<NodeId>(1000 + index), nullptr) != nullptr;
+    }
+    uint64_t byNode = System::Platform::Layer::GetClock_MonotonicHiRes() - start;
+
+    start = System::Platform::Layer::GetClock_MonotonicHiRes();
+    for (size_t i = 0; i < kLookupCount; i++)
+    {
+        size_t index = (i * 7919) % kSessionCount;
+        found += connections->FindPeerConnectionState(AddressForIndex(index), nullptr) != nullptr;
+    }
+    uint64_t byAddress = System::Platform::Layer::GetClock_MonotonicHiRes() - start;
+
+    NL_TEST_ASSERT(inSuite, found == 3 * kLookupCount);
+
+    printf("%5zu sessions: %7.1f ns/lookup by key, %7.1f ns/lookup by node, %7.1f ns/lookup by address\n", kSessionCount,
+           static_cast<double>(byKey) * 1000 / kLookupCount, static_cast<double>(byNode) * 1000 / kLookupCount,
+           static_cast<double>(byAddress) * 1000 / kLookupCount);
+}
+
+void TestLookupScaling(nlTestSuite * inSuite, void * inContext)
+{
+    BenchmarkLookups<16>(inSuite);
+    BenchmarkLookups<64>(inSuite);
+    BenchmarkLookups<256>(inSuite);
+    BenchmarkLookups<1024>(inSuite);
+    BenchmarkLookups<4096>(inSuite);
+}
+
+} // namespace
+
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("LookupScaling", TestLookupScaling),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+int TestPeerConnectionsBenchmarkFn(void)
+{
+    nlTestSuite theSuite = { "Transport-PeerConnections-Benchmark", &sTests[0], nullptr, nullptr };
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestPeerConnectionsBenchmarkFn)
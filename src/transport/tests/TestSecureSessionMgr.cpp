@@ -23,7 +23,9 @@
 
 #include <core/CHIPCore.h>
 #include <support/CodeUtils.h>
+#include <support/ReturnMacros.h>
 #include <support/UnitTestRegistration.h>
+#include <system/SystemStats.h>
 #include <transport/SecureSessionMgr.h>
 #include <transport/TransportMgr.h>
 #include <transport/raw/tests/NetworkTestHelpers.h>
@@ -57,13 +59,39 @@ public:
     {
         System::PacketBufferHandle msg_ForNow;
         msg_ForNow.Adopt(msgBuf);
+
+        LastSentSegmentCount = 0;
+        for (System::PacketBuffer * segment = msgBuf; segment != nullptr; segment = segment->Next())
+        {
+            LastSentSegmentCount++;
+        }
+
+        // Messages may be sent as a chain, but are received in a single buffer, as from the network
+        msg_ForNow->CompactHead();
+
+        // Simulate retransmissions: receiving decrypts in place, so every copy needs a buffer of its own
+        for (int i = 0; i < DuplicateCount; i++)
+        {
+            System::PacketBufferHandle copy = System::PacketBuffer::NewWithAvailableSize(msg_ForNow->DataLength());
+            VerifyOrReturnError(!copy.IsNull(), CHIP_ERROR_NO_MEMORY);
+            memcpy(copy->Start(), msg_ForNow->Start(), msg_ForNow->DataLength());
+            copy->SetDataLength(msg_ForNow->DataLength());
+            HandleMessageReceived(header, address, std::move(copy));
+        }
+
         HandleMessageReceived(header, address, std::move(msg_ForNow));
         return CHIP_NO_ERROR;
     }
 
     bool CanSendToPeer(const PeerAddress & address) override { return true; }
+
+    static size_t LastSentSegmentCount;
+    static int DuplicateCount;
 };
 
+size_t LoopbackTransport::LastSentSegmentCount = 0;
+int LoopbackTransport::DuplicateCount          = 0;
+
 class TestSessMgrCallback : public SecureSessionMgrDelegate
 {
 public:
@@ -79,14 +107,26 @@ public:
         int compare = memcmp(msgBuf->Start(), PAYLOAD, data_len);
         NL_TEST_ASSERT(mSuite, compare == 0);
 
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+        SYSTEM_STATS_UPDATE_LWIP_PBUF_COUNTS();
+        ReceivedPacketBufsInUse = System::Stats::GetResourcesInUse()[System::Stats::kSystemLayer_NumPacketBufs];
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
         ReceiveHandlerCallCount++;
     }
 
+    void OnReceiveError(CHIP_ERROR error, const Transport::PeerAddress & source, SecureSessionMgr * mgr) override
+    {
+        ReceiveErrorCallCount++;
+    }
+
     void OnNewConnection(const PeerConnectionState * state, SecureSessionMgr * mgr) override { NewConnectionHandlerCallCount++; }
 
-    nlTestSuite * mSuite              = nullptr;
-    int ReceiveHandlerCallCount       = 0;
-    int NewConnectionHandlerCallCount = 0;
+    nlTestSuite * mSuite                           = nullptr;
+    int ReceiveHandlerCallCount                    = 0;
+    int NewConnectionHandlerCallCount              = 0;
+    int ReceiveErrorCallCount                      = 0;
+    System::Stats::count_t ReceivedPacketBufsInUse = 0;
 };
 
 TestSessMgrCallback callback;
@@ -158,6 +198,260 @@ void CheckMessageTest(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, callback.ReceiveHandlerCallCount == 1);
 }
 
+void CheckChainedMessageTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    const uint16_t payload_len = sizeof(PAYLOAD);
+    const uint16_t split       = payload_len / 2;
+
+    ctx.GetInetLayer().SystemLayer()->Init(nullptr);
+
+    // The payload is split over two buffers
+    chip::System::PacketBufferHandle buffer = chip::System::PacketBuffer::NewWithAvailableSize(split);
+    NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+    chip::System::PacketBufferHandle tail = chip::System::PacketBuffer::NewWithAvailableSize(payload_len - split);
+    NL_TEST_ASSERT(inSuite, !tail.IsNull());
+
+    memmove(buffer->Start(), PAYLOAD, split);
+    buffer->SetDataLength(split);
+    memmove(tail->Start(), &PAYLOAD[split], payload_len - split);
+    tail->SetDataLength(static_cast<uint16_t>(payload_len - split));
+    buffer->AddToEnd(std::move(tail));
+    NL_TEST_ASSERT(inSuite, buffer->TotalLength() == payload_len);
+
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    TransportMgr<LoopbackTransport> transportMgr;
+    SecureSessionMgr secureSessionMgr;
+
+    err = transportMgr.Init("LOOPBACK");
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = secureSessionMgr.Init(kSourceNodeId, ctx.GetInetLayer().SystemLayer(), &transportMgr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    callback.mSuite = inSuite;
+
+    secureSessionMgr.SetDelegate(&callback);
+
+    SecurePairingUsingTestSecret pairing1(Optional<NodeId>::Value(kSourceNodeId), 1, 2);
+    Optional<Transport::PeerAddress> peer(Transport::PeerAddress::UDP(addr, CHIP_PORT));
+
+    err = secureSessionMgr.NewPairing(peer, kDestinationNodeId, &pairing1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    SecurePairingUsingTestSecret pairing2(Optional<NodeId>::Value(kDestinationNodeId), 2, 1);
+    err = secureSessionMgr.NewPairing(peer, kSourceNodeId, &pairing2);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // The chain is encrypted in place and handed to the transport without coalescing.
+    callback.ReceiveHandlerCallCount = 0;
+
+    err = secureSessionMgr.SendMessage(kDestinationNodeId, std::move(buffer));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    ctx.DriveIOUntil(1000 /* ms */, []() { return callback.ReceiveHandlerCallCount != 0; });
+
+    NL_TEST_ASSERT(inSuite, callback.ReceiveHandlerCallCount == 1);
+    NL_TEST_ASSERT(inSuite, LoopbackTransport::LastSentSegmentCount >= 2);
+}
+
+void CheckSharedMessageTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    const uint16_t payload_len = sizeof(PAYLOAD);
+    const uint16_t split       = payload_len / 2;
+    const int kSendCount       = 3;
+
+    ctx.GetInetLayer().SystemLayer()->Init(nullptr);
+
+    // The shared payload is split over two buffers, and must come out of every send untouched
+    chip::System::PacketBufferHandle buffer = chip::System::PacketBuffer::NewWithAvailableSize(split);
+    NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+    chip::System::PacketBufferHandle tail = chip::System::PacketBuffer::NewWithAvailableSize(payload_len - split);
+    NL_TEST_ASSERT(inSuite, !tail.IsNull());
+
+    memmove(buffer->Start(), PAYLOAD, split);
+    buffer->SetDataLength(split);
+    memmove(tail->Start(), &PAYLOAD[split], payload_len - split);
+    tail->SetDataLength(static_cast<uint16_t>(payload_len - split));
+    buffer->AddToEnd(std::move(tail));
+
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    TransportMgr<LoopbackTransport> transportMgr;
+    SecureSessionMgr secureSessionMgr;
+
+    err = transportMgr.Init("LOOPBACK");
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = secureSessionMgr.Init(kSourceNodeId, ctx.GetInetLayer().SystemLayer(), &transportMgr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    callback.mSuite = inSuite;
+
+    secureSessionMgr.SetDelegate(&callback);
+
+    SecurePairingUsingTestSecret pairing1(Optional<NodeId>::Value(kSourceNodeId), 1, 2);
+    Optional<Transport::PeerAddress> peer(Transport::PeerAddress::UDP(addr, CHIP_PORT));
+
+    err = secureSessionMgr.NewPairing(peer, kDestinationNodeId, &pairing1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    SecurePairingUsingTestSecret pairing2(Optional<NodeId>::Value(kDestinationNodeId), 2, 1);
+    err = secureSessionMgr.NewPairing(peer, kSourceNodeId, &pairing2);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    callback.ReceiveHandlerCallCount = 0;
+
+    for (int i = 0; i < kSendCount; i++)
+    {
+        PayloadHeader payloadHeader;
+
+        err = secureSessionMgr.SendSharedMessage(payloadHeader, kDestinationNodeId, buffer);
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, LoopbackTransport::LastSentSegmentCount == 1);
+
+        NL_TEST_ASSERT(inSuite, buffer->TotalLength() == payload_len);
+        NL_TEST_ASSERT(inSuite, memcmp(buffer->Start(), PAYLOAD, split) == 0);
+        NL_TEST_ASSERT(inSuite, memcmp(buffer->Next()->Start(), &PAYLOAD[split], payload_len - split) == 0);
+    }
+
+    ctx.DriveIOUntil(1000 /* ms */, [kSendCount]() { return callback.ReceiveHandlerCallCount == kSendCount; });
+
+    NL_TEST_ASSERT(inSuite, callback.ReceiveHandlerCallCount == kSendCount);
+}
+
+void CheckDuplicateMessageTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    uint16_t payload_len = sizeof(PAYLOAD);
+
+    ctx.GetInetLayer().SystemLayer()->Init(nullptr);
+
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    TransportMgr<LoopbackTransport> transportMgr;
+    SecureSessionMgr secureSessionMgr;
+
+    err = transportMgr.Init("LOOPBACK");
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = secureSessionMgr.Init(kSourceNodeId, ctx.GetInetLayer().SystemLayer(), &transportMgr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    callback.mSuite = inSuite;
+
+    secureSessionMgr.SetDelegate(&callback);
+
+    SecurePairingUsingTestSecret pairing1(Optional<NodeId>::Value(kSourceNodeId), 1, 2);
+    Optional<Transport::PeerAddress> peer(Transport::PeerAddress::UDP(addr, CHIP_PORT));
+
+    err = secureSessionMgr.NewPairing(peer, kDestinationNodeId, &pairing1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    SecurePairingUsingTestSecret pairing2(Optional<NodeId>::Value(kDestinationNodeId), 2, 1);
+    err = secureSessionMgr.NewPairing(peer, kSourceNodeId, &pairing2);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // Every message is received three times, but only dispatched once, and
+    // dropping the copies is not reported as an error.
+    callback.ReceiveHandlerCallCount  = 0;
+    callback.ReceiveErrorCallCount    = 0;
+    LoopbackTransport::DuplicateCount = 2;
+
+    for (int i = 0; i < 2; i++)
+    {
+        chip::System::PacketBufferHandle buffer = chip::System::PacketBuffer::NewWithAvailableSize(payload_len);
+        NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+
+        memmove(buffer->Start(), PAYLOAD, payload_len);
+        buffer->SetDataLength(payload_len);
+
+        err = secureSessionMgr.SendMessage(kDestinationNodeId, std::move(buffer));
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    }
+
+    LoopbackTransport::DuplicateCount = 0;
+
+    ctx.DriveIOUntil(1000 /* ms */, []() { return callback.ReceiveHandlerCallCount >= 2; });
+
+    NL_TEST_ASSERT(inSuite, callback.ReceiveHandlerCallCount == 2);
+    NL_TEST_ASSERT(inSuite, callback.ReceiveErrorCallCount == 0);
+}
+
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+void CheckReceiveInPlaceTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    uint16_t payload_len = sizeof(PAYLOAD);
+
+    ctx.GetInetLayer().SystemLayer()->Init(nullptr);
+
+    // Leave room for the MAC, so sending does not need a buffer of its own either
+    chip::System::PacketBufferHandle buffer = chip::System::PacketBuffer::NewWithAvailableSize(payload_len + kMaxTagLen);
+    NL_TEST_ASSERT(inSuite, !buffer.IsNull());
+
+    memmove(buffer->Start(), PAYLOAD, payload_len);
+    buffer->SetDataLength(payload_len);
+
+    IPAddress addr;
+    IPAddress::FromString("127.0.0.1", addr);
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    TransportMgr<LoopbackTransport> transportMgr;
+    SecureSessionMgr secureSessionMgr;
+
+    err = transportMgr.Init("LOOPBACK");
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    err = secureSessionMgr.Init(kSourceNodeId, ctx.GetInetLayer().SystemLayer(), &transportMgr);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    callback.mSuite = inSuite;
+
+    secureSessionMgr.SetDelegate(&callback);
+
+    SecurePairingUsingTestSecret pairing1(Optional<NodeId>::Value(kSourceNodeId), 1, 2);
+    Optional<Transport::PeerAddress> peer(Transport::PeerAddress::UDP(addr, CHIP_PORT));
+
+    err = secureSessionMgr.NewPairing(peer, kDestinationNodeId, &pairing1);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    SecurePairingUsingTestSecret pairing2(Optional<NodeId>::Value(kDestinationNodeId), 2, 1);
+    err = secureSessionMgr.NewPairing(peer, kSourceNodeId, &pairing2);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    SYSTEM_STATS_UPDATE_LWIP_PBUF_COUNTS();
+    const System::Stats::count_t packetBufsInUse = System::Stats::GetResourcesInUse()[System::Stats::kSystemLayer_NumPacketBufs];
+#if !CHIP_SYSTEM_CONFIG_USE_LWIP
+    // LwIP keeps its own high watermark, which can not be reset
+    System::Stats::GetHighWatermarks()[System::Stats::kSystemLayer_NumPacketBufs] = packetBufsInUse;
+#endif // !CHIP_SYSTEM_CONFIG_USE_LWIP
+
+    // The received message is decrypted within the buffer it arrived in.
+    callback.ReceiveHandlerCallCount = 0;
+    callback.ReceivedPacketBufsInUse = 0;
+
+    err = secureSessionMgr.SendMessage(kDestinationNodeId, std::move(buffer));
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    ctx.DriveIOUntil(1000 /* ms */, []() { return callback.ReceiveHandlerCallCount != 0; });
+
+    NL_TEST_ASSERT(inSuite, callback.ReceiveHandlerCallCount == 1);
+    NL_TEST_ASSERT(inSuite, callback.ReceivedPacketBufsInUse == packetBufsInUse);
+#if !CHIP_SYSTEM_CONFIG_USE_LWIP
+    NL_TEST_ASSERT(inSuite, System::Stats::GetHighWatermarks()[System::Stats::kSystemLayer_NumPacketBufs] == packetBufsInUse);
+#endif // !CHIP_SYSTEM_CONFIG_USE_LWIP
+}
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
 // Test Suite
 
 /**
@@ -168,6 +462,12 @@ const nlTest sTests[] =
 {
     NL_TEST_DEF("Simple Init Test",              CheckSimpleInitTest),
     NL_TEST_DEF("Message Self Test",             CheckMessageTest),
+    NL_TEST_DEF("Chained Message Self Test",     CheckChainedMessageTest),
+    NL_TEST_DEF("Shared Message Self Test",      CheckSharedMessageTest),
+    NL_TEST_DEF("Duplicate Message Test",        CheckDuplicateMessageTest),
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    NL_TEST_DEF("Receive In Place Test",         CheckReceiveInPlaceTest),
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
 
     NL_TEST_SENTINEL()
 };